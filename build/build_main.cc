@@ -2,10 +2,15 @@
 
 #include <windows.h>
 #include <shellapi.h>
+#include <stdio.h>
 #include <string>
 #include <vector>
 #include <optional>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
 #include "novebrowse/windows/taskbar_badge.h"
 
 namespace {
@@ -33,35 +38,81 @@ bool FileExists(const std::wstring& path) {
   return (attr != INVALID_FILE_ATTRIBUTES) && !(attr & FILE_ATTRIBUTE_DIRECTORY);
 }
 
+// Heuristic for the browser's main window: visible, top-level and with a
+// taskbar presence (tool windows have none).
+bool IsMainWindowCandidate(HWND hwnd) {
+  if (!IsWindowVisible(hwnd)) return false;
+  if (GetAncestor(hwnd, GA_ROOT) != hwnd) return false;
+  LONG ex_style = GetWindowLongW(hwnd, GWL_EXSTYLE);
+  return !(ex_style & WS_EX_TOOLWINDOW);
+}
+
 // Find the first top-level visible window belonging to a given process id.
-HWND FindMainWindowForProcess(DWORD process_id, DWORD timeout_ms) {
-  const DWORD start = GetTickCount();
-  HWND result = nullptr;
-  while (GetTickCount() - start < timeout_ms) {
-    result = nullptr;
-    EnumWindows(
-        [](HWND hwnd, LPARAM lparam) -> BOOL {
-          DWORD pid = 0;
-          GetWindowThreadProcessId(hwnd, &pid);
-          if (pid == 0) return TRUE;
-          if (pid != static_cast<DWORD>(lparam)) return TRUE;
-          if (!IsWindowVisible(hwnd)) return TRUE;
-          HWND root = GetAncestor(hwnd, GA_ROOT);
-          if (root != hwnd) return TRUE;
-          // Heuristic: skip tool windows without taskbar presence
-          LONG ex_style = GetWindowLongW(hwnd, GWL_EXSTYLE);
-          if (ex_style & WS_EX_TOOLWINDOW) return TRUE;
-          SetLastError(0);
-          SetWindowLongPtrW(hwnd, GWLP_USERDATA, GetWindowLongPtrW(hwnd, GWLP_USERDATA));
-          // Store as found
-          *((HWND*)&result) = hwnd;
-          return FALSE;  // stop enumeration
-        },
-        static_cast<LPARAM>(process_id));
-    if (result) return result;
-    Sleep(100);
-  }
-  return nullptr;
+HWND FindExistingMainWindow(DWORD process_id) {
+  struct Search {
+    DWORD process_id;
+    HWND result;
+  } search = {process_id, nullptr};
+  EnumWindows(
+      [](HWND hwnd, LPARAM lparam) -> BOOL {
+        auto* search = reinterpret_cast<Search*>(lparam);
+        DWORD pid = 0;
+        GetWindowThreadProcessId(hwnd, &pid);
+        if (pid != search->process_id) return TRUE;
+        if (!IsMainWindowCandidate(hwnd)) return TRUE;
+        search->result = hwnd;
+        return FALSE;  // stop enumeration
+      },
+      reinterpret_cast<LPARAM>(&search));
+  return search.result;
+}
+
+// Set by OnObjectShow, which runs on the waiting thread's message loop. Each
+// fleet worker waits on its own thread with its own hook.
+thread_local HWND g_shown_main_window = nullptr;
+
+void CALLBACK OnObjectShow(HWINEVENTHOOK, DWORD, HWND hwnd, LONG id_object,
+                           LONG id_child, DWORD, DWORD) {
+  if (hwnd == nullptr || id_object != OBJID_WINDOW || id_child != CHILDID_SELF) {
+    return;
+  }
+  if (g_shown_main_window == nullptr && IsMainWindowCandidate(hwnd)) {
+    g_shown_main_window = hwnd;
+  }
+}
+
+// Wait for the process to show its main window. An out-of-context
+// EVENT_OBJECT_SHOW hook scoped to the process wakes the message loop when a
+// window appears, so there is no polling; the wait also ends if the process
+// exits. Without the hook, wait for the browser to go idle and enumerate once.
+HWND WaitForMainWindow(HANDLE process, DWORD process_id, DWORD timeout_ms) {
+  g_shown_main_window = nullptr;
+  HWINEVENTHOOK hook = SetWinEventHook(EVENT_OBJECT_SHOW, EVENT_OBJECT_SHOW,
+                                       nullptr, OnObjectShow, process_id, 0,
+                                       WINEVENT_OUTOFCONTEXT);
+  if (hook == nullptr) {
+    WaitForInputIdle(process, timeout_ms);
+    return FindExistingMainWindow(process_id);
+  }
+
+  // The window may have been shown before the hook was installed.
+  HWND result = FindExistingMainWindow(process_id);
+  const ULONGLONG deadline = GetTickCount64() + timeout_ms;
+  while (result == nullptr) {
+    ULONGLONG now = GetTickCount64();
+    if (now >= deadline) break;
+    DWORD wait = MsgWaitForMultipleObjects(
+        1, &process, FALSE, static_cast<DWORD>(deadline - now), QS_ALLINPUT);
+    if (wait != WAIT_OBJECT_0 + 1) break;  // exited, timed out or failed
+    MSG msg;
+    while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE)) {
+      TranslateMessage(&msg);
+      DispatchMessageW(&msg);
+    }
+    result = g_shown_main_window;
+  }
+  UnhookWinEvent(hook);
+  return result;
 }
 
 std::optional<int> ParseBadgeNumberFromArgs(std::vector<std::wstring>* in_out_args) {
@@ -107,21 +158,35 @@ std::wstring Quote(const std::wstring& s) {
   return q;
 }
 
-int DoRun(HINSTANCE instance) {
-  int argc = 0;
-  wchar_t** argv = CommandLineToArgvW(GetCommandLineW(), &argc);
-  std::vector<std::wstring> args;
-  for (int i = 1; i < argc; ++i) args.emplace_back(argv[i]);
-  LocalFree(argv);
-
-  std::optional<int> badge = ParseBadgeNumberFromArgs(&args);
+// Removes "--name=value" or "--name value" from |args| and returns the value.
+std::optional<std::wstring> TakeSwitchValue(std::vector<std::wstring>* args,
+                                            const std::wstring& name) {
+  const std::wstring key = L"--" + name;
+  const std::wstring key_eq = key + L"=";
+  for (size_t i = 0; i < args->size(); ++i) {
+    const std::wstring& a = (*args)[i];
+    if (a.rfind(key_eq, 0) == 0) {
+      std::wstring value = a.substr(key_eq.size());
+      args->erase(args->begin() + i);
+      return value;
+    }
+    if (a == key && i + 1 < args->size()) {
+      std::wstring value = (*args)[i + 1];
+      args->erase(args->begin() + i, args->begin() + i + 2);
+      return value;
+    }
+  }
+  return std::nullopt;
+}
 
-  // Determine chrome.exe path
+// Determine chrome.exe path: --chrome-path, next to the launcher, or the
+// typical Chromium out dir. Returns an empty string if none exists.
+std::wstring ResolveChromePath(std::vector<std::wstring>* args) {
   std::wstring chrome_path;
-  for (size_t i = 0; i + 1 < args.size(); ++i) {
-    if (args[i] == L"--chrome-path") {
-      chrome_path = args[i + 1];
-      args.erase(args.begin() + i, args.begin() + i + 2);
+  for (size_t i = 0; i + 1 < args->size(); ++i) {
+    if ((*args)[i] == L"--chrome-path") {
+      chrome_path = (*args)[i + 1];
+      args->erase(args->begin() + i, args->begin() + i + 2);
       break;
     }
   }
@@ -141,12 +206,12 @@ int DoRun(HINSTANCE instance) {
     std::wstring candidate = JoinPath(JoinPath(cwd, L"out"), L"Default\\chrome.exe");
     if (FileExists(candidate)) chrome_path = candidate;
   }
-  if (chrome_path.empty()) {
-    MessageBoxW(nullptr, L"未找到 chrome.exe，请通过 --chrome-path 指定路径，或将启动器放到 chrome.exe 同目录。",
-                L"NoveBrowse 启动器", MB_ICONERROR | MB_OK);
-    return 2;
-  }
+  return chrome_path;
+}
 
+bool LaunchChrome(const std::wstring& chrome_path,
+                  const std::vector<std::wstring>& args,
+                  PROCESS_INFORMATION* pi) {
   // Build command line for chrome
   std::wstring cmd = Quote(chrome_path);
   for (const auto& a : args) {
@@ -160,20 +225,402 @@ int DoRun(HINSTANCE instance) {
   }
 
   STARTUPINFOW si = {sizeof(si)};
-  PROCESS_INFORMATION pi = {};
-  if (!CreateProcessW(
-          chrome_path.c_str(),
-          cmd.data(),  // mutable buffer OK
-          nullptr, nullptr, FALSE,
-          CREATE_UNICODE_ENVIRONMENT,
-          nullptr, nullptr, &si, &pi)) {
+  *pi = {};
+  return CreateProcessW(
+      chrome_path.c_str(),
+      cmd.data(),  // mutable buffer OK
+      nullptr, nullptr, FALSE,
+      CREATE_UNICODE_ENVIRONMENT,
+      nullptr, nullptr, &si, pi) != FALSE;
+}
+
+// ---------------------------------------------------------------------------
+// Fleet mode: --fleet=<manifest> starts one instance per manifest line.
+//
+// Manifest lines are "<badge> <device_profile> <user_data_dir>"; the
+// directory is the rest of the line, so it may contain spaces. Blank lines
+// and lines starting with '#' are ignored.
+
+constexpr int kDefaultFleetParallelism = 4;
+constexpr int kMaxFleetParallelism = 64;
+constexpr DWORD kFirstWindowTimeoutMs = 30000;
+
+struct FleetInstance {
+  int badge = 0;
+  std::wstring device_profile;
+  std::wstring user_data_dir;
+};
+
+std::wstring Trim(const std::wstring& s) {
+  const wchar_t* kSpace = L" \t\r";
+  size_t begin = s.find_first_not_of(kSpace);
+  if (begin == std::wstring::npos) return L"";
+  size_t end = s.find_last_not_of(kSpace);
+  return s.substr(begin, end - begin + 1);
+}
+
+bool ReadUtf8File(const std::wstring& path, std::wstring* out) {
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) return false;
+  LARGE_INTEGER size = {};
+  std::string bytes;
+  bool ok = GetFileSizeEx(file, &size) && size.QuadPart < (1 << 24);
+  if (ok) {
+    bytes.resize(static_cast<size_t>(size.QuadPart));
+    DWORD read = 0;
+    ok = bytes.empty() ||
+         (ReadFile(file, bytes.data(), static_cast<DWORD>(bytes.size()), &read,
+                   nullptr) &&
+          read == bytes.size());
+  }
+  CloseHandle(file);
+  if (!ok) return false;
+
+  // Skip a UTF-8 BOM, which Notepad likes to add.
+  size_t offset = bytes.rfind("\xEF\xBB\xBF", 0) == 0 ? 3 : 0;
+  int length = MultiByteToWideChar(CP_UTF8, 0, bytes.data() + offset,
+                                   static_cast<int>(bytes.size() - offset),
+                                   nullptr, 0);
+  out->assign(length, L'\0');
+  MultiByteToWideChar(CP_UTF8, 0, bytes.data() + offset,
+                      static_cast<int>(bytes.size() - offset), out->data(), length);
+  return true;
+}
+
+bool ParseFleetManifest(const std::wstring& path,
+                        std::vector<FleetInstance>* instances,
+                        std::wstring* error) {
+  std::wstring contents;
+  if (!ReadUtf8File(path, &contents)) {
+    *error = L"cannot read manifest " + path;
+    return false;
+  }
+
+  size_t line_number = 0;
+  size_t pos = 0;
+  while (pos <= contents.size()) {
+    size_t end = contents.find(L'\n', pos);
+    if (end == std::wstring::npos) end = contents.size();
+    std::wstring line = Trim(contents.substr(pos, end - pos));
+    pos = end + 1;
+    ++line_number;
+    if (line.empty() || line[0] == L'#') continue;
+
+    const std::wstring where = L"manifest line " + std::to_wstring(line_number);
+    size_t badge_end = line.find_first_of(L" \t");
+    size_t profile_begin = badge_end == std::wstring::npos
+                               ? std::wstring::npos
+                               : line.find_first_not_of(L" \t", badge_end);
+    // Profile names like "Windows Desktop" contain spaces and are quoted.
+    bool quoted = profile_begin != std::wstring::npos && line[profile_begin] == L'"';
+    size_t profile_end = profile_begin == std::wstring::npos
+                             ? std::wstring::npos
+                         : quoted ? line.find(L'"', profile_begin + 1)
+                                  : line.find_first_of(L" \t", profile_begin);
+    if (quoted && profile_end != std::wstring::npos) {
+      ++profile_begin;
+    }
+    if (profile_end == std::wstring::npos) {
+      *error = where + L": expected <badge> <device_profile> <user_data_dir>";
+      return false;
+    }
+
+    FleetInstance instance;
+    try {
+      instance.badge = std::stoi(line.substr(0, badge_end));
+    } catch (...) {
+      instance.badge = 0;
+    }
+    if (instance.badge <= 0 || instance.badge > novebrowse::TaskbarBadge::kMaxNumber) {
+      *error = where + L": badge must be 1-99";
+      return false;
+    }
+    for (const FleetInstance& other : *instances) {
+      if (other.badge == instance.badge) {
+        *error = where + L": duplicate badge " + std::to_wstring(instance.badge);
+        return false;
+      }
+    }
+    instance.device_profile = line.substr(profile_begin, profile_end - profile_begin);
+    instance.user_data_dir = Trim(line.substr(profile_end + (quoted ? 1 : 0)));
+    if (instance.device_profile.empty() || instance.user_data_dir.empty()) {
+      *error = where + L": expected <badge> <device_profile> <user_data_dir>";
+      return false;
+    }
+    if (instance.user_data_dir.size() >= 2 && instance.user_data_dir.front() == L'"' &&
+        instance.user_data_dir.back() == L'"') {
+      instance.user_data_dir =
+          instance.user_data_dir.substr(1, instance.user_data_dir.size() - 2);
+    }
+    instances->push_back(std::move(instance));
+  }
+
+  if (instances->empty()) {
+    *error = L"manifest lists no instances";
+    return false;
+  }
+  return true;
+}
+
+bool DirectoryExists(const std::wstring& path) {
+  DWORD attr = GetFileAttributesW(path.c_str());
+  return (attr != INVALID_FILE_ATTRIBUTES) && (attr & FILE_ATTRIBUTE_DIRECTORY);
+}
+
+// Copies |from| into the new directory |to|. CopyFile2 block-clones on
+// filesystems that support it (ReFS, Dev Drive) and copies elsewhere. Files
+// are never hardlinked: Chrome rewrites SQLite and LevelDB files in place,
+// so linked instances would corrupt each other's profiles.
+bool CopyDirectoryTree(const std::wstring& from, const std::wstring& to) {
+  if (!CreateDirectoryW(to.c_str(), nullptr)) return false;
+
+  WIN32_FIND_DATAW data;
+  HANDLE find = FindFirstFileExW(JoinPath(from, L"*").c_str(), FindExInfoBasic,
+                                 &data, FindExSearchNameMatch, nullptr,
+                                 FIND_FIRST_EX_LARGE_FETCH);
+  if (find == INVALID_HANDLE_VALUE) return false;
+
+  bool ok = true;
+  do {
+    const std::wstring name = data.cFileName;
+    if (name == L"." || name == L"..") continue;
+    // The template's profile lock would make every clone look in use.
+    if (name == L"lockfile") continue;
+    // Junctions and symlinks are not followed.
+    if (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) continue;
+
+    const std::wstring source = JoinPath(from, name);
+    const std::wstring target = JoinPath(to, name);
+    if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+      ok = CopyDirectoryTree(source, target);
+    } else {
+      COPYFILE2_EXTENDED_PARAMETERS params = {sizeof(params)};
+      params.dwCopyFlags = COPY_FILE_FAIL_IF_EXISTS;
+      ok = SUCCEEDED(CopyFile2(source.c_str(), target.c_str(), &params));
+    }
+  } while (ok && FindNextFileW(find, &data));
+  FindClose(find);
+  return ok;
+}
+
+void DeleteDirectoryTree(const std::wstring& path) {
+  WIN32_FIND_DATAW data;
+  HANDLE find = FindFirstFileExW(JoinPath(path, L"*").c_str(), FindExInfoBasic,
+                                 &data, FindExSearchNameMatch, nullptr, 0);
+  if (find != INVALID_HANDLE_VALUE) {
+    do {
+      const std::wstring name = data.cFileName;
+      if (name == L"." || name == L"..") continue;
+      const std::wstring child = JoinPath(path, name);
+      if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) &&
+          !(data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)) {
+        DeleteDirectoryTree(child);
+      } else if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+        RemoveDirectoryW(child.c_str());
+      } else {
+        DeleteFileW(child.c_str());
+      }
+    } while (FindNextFileW(find, &data));
+    FindClose(find);
+  }
+  RemoveDirectoryW(path.c_str());
+}
+
+// Clones the template into |user_data_dir| through a staging directory, so
+// an interrupted clone is never mistaken for a warm profile.
+bool CloneProfileTemplate(const std::wstring& template_dir,
+                          const std::wstring& user_data_dir) {
+  const std::wstring staging = user_data_dir + L".cloning";
+  if (DirectoryExists(staging)) DeleteDirectoryTree(staging);
+  if (CopyDirectoryTree(template_dir, staging) &&
+      MoveFileExW(staging.c_str(), user_data_dir.c_str(), 0)) {
+    return true;
+  }
+  // Keep the copy's error code for the report, not the cleanup's.
+  DWORD error = GetLastError();
+  DeleteDirectoryTree(staging);
+  SetLastError(error);
+  return false;
+}
+
+struct FleetOptions {
+  std::wstring chrome_path;
+  std::wstring template_dir;  // empty: instances start from whatever is there
+  int parallelism = kDefaultFleetParallelism;
+  std::vector<std::wstring> forwarded_args;
+};
+
+struct FleetResult {
+  bool cloned = false;
+  bool launched = false;
+  bool window_found = false;
+  double clone_ms = 0;
+  double first_window_ms = 0;
+  std::wstring error;
+};
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Clones (if needed), launches and badges one instance. Runs on a fleet
+// worker thread and keeps the worker busy until the first window shows,
+// which is when most of the startup I/O is done.
+FleetResult RunFleetInstance(const FleetOptions& options,
+                             const FleetInstance& instance) {
+  FleetResult result;
+  if (!options.template_dir.empty() && !DirectoryExists(instance.user_data_dir)) {
+    auto clone_start = std::chrono::steady_clock::now();
+    if (!CloneProfileTemplate(options.template_dir, instance.user_data_dir)) {
+      result.error = L"clone failed (" + std::to_wstring(GetLastError()) + L")";
+      return result;
+    }
+    result.cloned = true;
+    result.clone_ms = MillisecondsSince(clone_start);
+  }
+
+  std::vector<std::wstring> args = options.forwarded_args;
+  args.push_back(L"--user-data-dir=" + instance.user_data_dir);
+  args.push_back(L"--novebrowse-device-profile=" + instance.device_profile);
+
+  auto launch_start = std::chrono::steady_clock::now();
+  PROCESS_INFORMATION pi;
+  if (!LaunchChrome(options.chrome_path, args, &pi)) {
+    result.error = L"launch failed (" + std::to_wstring(GetLastError()) + L")";
+    return result;
+  }
+  result.launched = true;
+
+  HWND hwnd = WaitForMainWindow(pi.hProcess, pi.dwProcessId, kFirstWindowTimeoutMs);
+  if (hwnd != nullptr) {
+    result.window_found = true;
+    result.first_window_ms = MillisecondsSince(launch_start);
+    novebrowse::TaskbarBadge::SetOverlayNumber(hwnd, instance.badge);
+  } else {
+    result.error = L"no window";
+  }
+
+  CloseHandle(pi.hThread);
+  CloseHandle(pi.hProcess);
+  return result;
+}
+
+// Starts every manifest instance with at most |parallelism| in flight and
+// prints one report line per instance as it finishes, then a summary.
+// Returns the number of instances that did not show a window.
+int RunFleet(const FleetOptions& options,
+             const std::vector<FleetInstance>& instances) {
+  std::atomic<size_t> next{0};
+  std::mutex report_lock;
+  int failures = 0;
+  double total_first_window_ms = 0;
+  double max_first_window_ms = 0;
+
+  auto worker = [&] {
+    for (size_t i = next++; i < instances.size(); i = next++) {
+      const FleetInstance& instance = instances[i];
+      FleetResult result = RunFleetInstance(options, instance);
+
+      std::lock_guard<std::mutex> hold(report_lock);
+      if (result.window_found) {
+        total_first_window_ms += result.first_window_ms;
+        max_first_window_ms = std::max(max_first_window_ms, result.first_window_ms);
+        wprintf(L"fleet badge=%d profile=%ls clone_ms=%.0f first_window_ms=%.0f\n",
+                instance.badge, instance.device_profile.c_str(), result.clone_ms,
+                result.first_window_ms);
+      } else {
+        ++failures;
+        wprintf(L"fleet badge=%d profile=%ls error=\"%ls\"\n", instance.badge,
+                instance.device_profile.c_str(), result.error.c_str());
+      }
+      fflush(stdout);
+    }
+  };
+
+  int thread_count = std::min<int>(options.parallelism,
+                                   static_cast<int>(instances.size()));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_count; ++i) threads.emplace_back(worker);
+  for (std::thread& thread : threads) thread.join();
+
+  int started = static_cast<int>(instances.size()) - failures;
+  wprintf(L"fleet instances=%zu started=%d parallelism=%d mean_first_window_ms=%.0f "
+          L"max_first_window_ms=%.0f\n",
+          instances.size(), started, thread_count,
+          started > 0 ? total_first_window_ms / started : 0.0, max_first_window_ms);
+  return failures;
+}
+
+int DoFleet(const std::wstring& manifest_path, std::vector<std::wstring> args) {
+  FleetOptions options;
+  if (std::optional<std::wstring> dir = TakeSwitchValue(&args, L"fleet-template")) {
+    options.template_dir = *dir;
+  }
+  if (std::optional<std::wstring> value = TakeSwitchValue(&args, L"fleet-parallelism")) {
+    try {
+      options.parallelism = std::stoi(*value);
+    } catch (...) {
+    }
+  }
+  options.parallelism = std::clamp(options.parallelism, 1, kMaxFleetParallelism);
+
+  options.chrome_path = ResolveChromePath(&args);
+  if (options.chrome_path.empty()) {
+    fwprintf(stderr, L"fleet: chrome.exe not found, pass --chrome-path\n");
+    return 2;
+  }
+  if (!options.template_dir.empty() && !DirectoryExists(options.template_dir)) {
+    fwprintf(stderr, L"fleet: template directory %ls does not exist\n",
+             options.template_dir.c_str());
+    return 2;
+  }
+
+  std::vector<FleetInstance> instances;
+  std::wstring error;
+  if (!ParseFleetManifest(manifest_path, &instances, &error)) {
+    fwprintf(stderr, L"fleet: %ls\n", error.c_str());
+    return 2;
+  }
+
+  // Each instance gets its own profile and badge from the manifest.
+  (void)TakeSwitchValue(&args, L"user-data-dir");
+  (void)ParseBadgeNumberFromArgs(&args);
+  options.forwarded_args = std::move(args);
+  return RunFleet(options, instances) == 0 ? 0 : 3;
+}
+
+int DoRun(HINSTANCE instance) {
+  int argc = 0;
+  wchar_t** argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+  std::vector<std::wstring> args;
+  for (int i = 1; i < argc; ++i) args.emplace_back(argv[i]);
+  LocalFree(argv);
+
+  if (std::optional<std::wstring> manifest = TakeSwitchValue(&args, L"fleet")) {
+    return DoFleet(*manifest, std::move(args));
+  }
+
+  std::optional<int> badge = ParseBadgeNumberFromArgs(&args);
+
+  std::wstring chrome_path = ResolveChromePath(&args);
+  if (chrome_path.empty()) {
+    MessageBoxW(nullptr, L"未找到 chrome.exe，请通过 --chrome-path 指定路径，或将启动器放到 chrome.exe 同目录。",
+                L"NoveBrowse 启动器", MB_ICONERROR | MB_OK);
+    return 2;
+  }
+
+  PROCESS_INFORMATION pi;
+  if (!LaunchChrome(chrome_path, args, &pi)) {
     MessageBoxW(nullptr, L"启动 chrome.exe 失败。", L"NoveBrowse 启动器", MB_ICONERROR | MB_OK);
     return 3;
   }
 
   // Wait for main window and apply badge
   if (badge.has_value()) {
-    HWND hwnd = FindMainWindowForProcess(pi.dwProcessId, /*timeout_ms=*/30000);
+    HWND hwnd = WaitForMainWindow(pi.hProcess, pi.dwProcessId, /*timeout_ms=*/30000);
     if (hwnd != nullptr) {
       novebrowse::TaskbarBadge::SetOverlayNumber(hwnd, *badge);
     }
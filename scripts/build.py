@@ -8,15 +8,32 @@ GitHub Actions 构建脚本（示例）
 - 校验环境
 - 同步/更新 Chromium（可选：浅历史）
 - 使用 GN/Ninja 构建 NoveBrowse 目标（本例构建 build_novebrowse.exe）
+- 可选：运行性能测试并与基线比较，性能回退时构建失败（--perftests）
 """
 
+import argparse
+import json
 import os
+import re
 import sys
 import subprocess
 import shutil
 from pathlib import Path
 
 
+PERF_TARGET = "novebrowse_fingerprint_perftests"
+
+# 默认容差：单项结果比基线差超过该比例即视为回退
+DEFAULT_PERF_TOLERANCE = 0.15
+
+# perf_test::PerfResultReporter 的输出行，例如
+# *RESULT CanvasNoise..process_pixel_data: 1080p= 812.5 us
+PERF_RESULT_RE = re.compile(
+    r"^\*?RESULT (?P<metric>[^:]+): (?P<story>[^=]+)= "
+    r"(?P<value>[-+0-9.eE]+) (?P<units>\S+)\s*$"
+)
+
+
 def run(cmd, cwd=None, check=True, use_shell=False):
     if isinstance(cmd, (list, tuple)):
         printable = " ".join(map(str, cmd))
@@ -31,7 +48,116 @@ def ensure_dir(p: Path):
     p.mkdir(parents=True, exist_ok=True)
 
 
+def parse_args():
+    parser = argparse.ArgumentParser(description="Build NoveBrowse")
+    parser.add_argument("--perftests", action="store_true",
+                        help=f"also build and run {PERF_TARGET} and compare against the baseline")
+    parser.add_argument("--perf-baseline", type=Path, default=None,
+                        help="baseline JSON (default: test/data/perf_baseline.json)")
+    parser.add_argument("--update-perf-baseline", action="store_true",
+                        help="write this run's results as the new baseline instead of comparing")
+    parser.add_argument("--perf-tolerance", type=float, default=DEFAULT_PERF_TOLERANCE,
+                        help="allowed relative regression for baselines that set none")
+    return parser.parse_args()
+
+
+def parse_perf_results(output: str) -> dict:
+    """把 RESULT 行解析为 {"metric/story": {"value": float, "units": str}}"""
+    results = {}
+    for line in output.splitlines():
+        match = PERF_RESULT_RE.match(line.strip())
+        if not match:
+            continue
+        key = f"{match['metric']}/{match['story'].strip()}"
+        results[key] = {"value": float(match["value"]), "units": match["units"]}
+    return results
+
+
+def higher_is_better(units: str) -> bool:
+    # 吞吐量（MB/s、ops/s）越大越好；耗时与占比越小越好
+    return units.endswith("/s")
+
+
+def compare_perf_results(results: dict, baseline: dict, default_tolerance: float) -> list:
+    """返回回退项的说明列表，空列表表示通过"""
+    regressions = []
+    tolerance = baseline.get("tolerance", default_tolerance)
+    for key, expected in sorted(baseline.get("metrics", {}).items()):
+        actual = results.get(key)
+        if actual is None:
+            print(f"warning: baseline metric {key} was not reported")
+            continue
+        allowed = expected.get("tolerance", tolerance)
+        base_value = expected["value"]
+        value = actual["value"]
+        if base_value <= 0:
+            continue
+        if higher_is_better(actual["units"]):
+            change = (base_value - value) / base_value
+        else:
+            change = (value - base_value) / base_value
+        if change > allowed:
+            regressions.append(
+                f"{key}: {value:.4g} {actual['units']} vs baseline {base_value:.4g} "
+                f"({change:+.1%}, allowed {allowed:.0%})")
+    for key in sorted(set(results) - set(baseline.get("metrics", {}))):
+        print(f"note: {key} has no baseline yet")
+    return regressions
+
+
+def run_perftests(src_dir: Path, ninja_cmd: str, is_windows: bool, nove_dir: Path,
+                  artifacts: Path, args) -> int:
+    if is_windows:
+        run(f'"{ninja_cmd}" -C out/Default {PERF_TARGET}', cwd=str(src_dir), use_shell=True)
+    else:
+        run([ninja_cmd, "-C", "out/Default", PERF_TARGET], cwd=str(src_dir))
+
+    binary = src_dir / "out/Default" / (PERF_TARGET + (".exe" if is_windows else ""))
+    print("+", binary)
+    completed = subprocess.run([str(binary)], cwd=str(src_dir),
+                               capture_output=True, text=True)
+    sys.stdout.write(completed.stdout)
+    sys.stderr.write(completed.stderr)
+    if completed.returncode != 0:
+        print(f"{PERF_TARGET} failed with exit code {completed.returncode}")
+        return completed.returncode
+
+    results = parse_perf_results(completed.stdout)
+    results_path = artifacts / "perf_results.json"
+    results_path.write_text(json.dumps(results, indent=2, sort_keys=True) + "\n",
+                            encoding="utf-8")
+    print("Perf results at:", results_path)
+
+    baseline_path = args.perf_baseline or (nove_dir / "test" / "data" / "perf_baseline.json")
+    if args.update_perf_baseline:
+        ensure_dir(baseline_path.parent)
+        baseline = {"tolerance": args.perf_tolerance, "metrics": results}
+        baseline_path.write_text(json.dumps(baseline, indent=2, sort_keys=True) + "\n",
+                                 encoding="utf-8")
+        print("Perf baseline written to:", baseline_path)
+        return 0
+
+    if not baseline_path.exists():
+        # 没有基线时只跳过比较：结果已保存在产物中，基线只由
+        # --update-perf-baseline显式写入，不会把回退悄悄记成新基线
+        print("Perf baseline not found, skipping comparison:", baseline_path)
+        print("Run with --update-perf-baseline on a known-good build to create it")
+        return 0
+
+    baseline = json.loads(baseline_path.read_text(encoding="utf-8"))
+    regressions = compare_perf_results(results, baseline, args.perf_tolerance)
+    if regressions:
+        print("Performance regressions against", baseline_path)
+        for regression in regressions:
+            print("  " + regression)
+        return 1
+    print("Perf results within baseline tolerance")
+    return 0
+
+
 def main():
+    args = parse_args()
+
     # 在 GitHub Actions 中优先使用 GITHUB_WORKSPACE；否则退回到脚本上级目录（novebrowse）
     workspace = os.environ.get("GITHUB_WORKSPACE")
     if workspace:
@@ -155,6 +281,10 @@ def main():
     shutil.copy2(out, artifacts / "build_novebrowse.exe")
     print("Artifacts at:", artifacts)
 
+    if args.perftests:
+        return run_perftests(src_dir, ninja_cmd, is_windows, nove_dir, artifacts, args)
+    return 0
+
 
 if __name__ == "__main__":
     sys.exit(main())
@@ -0,0 +1,331 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+将 device_profiles.json / behavior_patterns.json 编译为二进制配置文件库
+
+运行时由 CompiledProfileStore（src/compiled_profile_store.h）通过
+base::MemoryMappedFile 映射，按名称 O(1) 查找，不再解析 JSON。
+JSON 仍是开发格式，也是二进制文件缺失或版本不符时的回退。
+
+文件布局（小端，所有偏移相对文件开头，按 8 字节对齐）：
+  头部（64 字节）
+  哈希桶     uint32[bucket_count]，值为记录下标 + 1，0 表示空
+  记录       定长记录数组
+  字符串引用 StringRef[]，供字符串列表（如 languages）引用
+  字符串池   去重后的 UTF-8 字符串
+
+格式变化时必须同步修改 src/compiled_profile_store.cc 并递增 FORMAT_VERSION。
+
+用法：
+  compile_profiles.py --kind device_profiles --input device_profiles.json --output device_profiles.bin
+"""
+
+import argparse
+import json
+import struct
+import sys
+from pathlib import Path
+
+MAGIC = b"NVBSTORE"
+FORMAT_VERSION = 1
+
+KIND_DEVICE_PROFILES = 1
+KIND_BEHAVIOR_PATTERNS = 2
+
+HEADER_FORMAT = "<8s12I8x"
+HEADER_SIZE = 64
+
+DEVICE_PROFILE_RECORD_FORMAT = "<12I2IQd5iI"
+DEVICE_PROFILE_RECORD_SIZE = 96
+
+BEHAVIOR_PATTERN_RECORD_FORMAT = "<4I11di3I"
+BEHAVIOR_PATTERN_RECORD_SIZE = 120
+
+# 设备配置文件字段存在位，与 DeviceProfileField 一致
+DEVICE_FIELDS = [
+    "user_agent",
+    "platform",
+    "languages",
+    "hardware_concurrency",
+    "device_memory",
+    "screen_width",
+    "screen_height",
+    "color_depth",
+    "pixel_depth",
+    "device_pixel_ratio",
+    "webgl_vendor",
+    "webgl_renderer",
+]
+
+# 行为模式中的浮点字段，顺序即记录中的存放顺序，与 BehaviorPatternRecord 一致
+PATTERN_DOUBLE_FIELDS = [
+    ("mouse", "movement_speed"),
+    ("mouse", "click_delay_ms"),
+    ("mouse", "random_movement_probability"),
+    ("keyboard", "typing_speed_wpm"),
+    ("keyboard", "key_press_delay_ms"),
+    ("keyboard", "error_probability"),
+    ("scroll", "scroll_speed"),
+    ("scroll", "pause_probability"),
+    ("interaction", "page_dwell_time_ms"),
+    ("interaction", "link_click_probability"),
+    ("interaction", "form_fill_speed"),
+]
+
+PATTERN_INT_FIELDS = [
+    ("scroll", "pause_duration_ms"),
+]
+
+PATTERN_BOOL_FIELDS = [
+    ("mouse", "add_random_movements"),
+    ("keyboard", "add_typing_errors"),
+    ("scroll", "smooth_scrolling"),
+    ("interaction", "simulate_reading"),
+]
+
+
+def fnv1a32(data: bytes) -> int:
+    """与 CompiledProfileStore::HashName 相同的 FNV-1a 32 位哈希"""
+    h = 0x811C9DC5
+    for b in data:
+        h ^= b
+        h = (h * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def align8(n: int) -> int:
+    return (n + 7) & ~7
+
+
+class StringPool:
+    """去重的字符串池，以及字符串列表所用的引用表"""
+
+    def __init__(self):
+        self.data = bytearray()
+        self.offsets = {}
+        self.list_refs = []
+
+    def add(self, value: str):
+        encoded = value.encode("utf-8")
+        offset = self.offsets.get(encoded)
+        if offset is None:
+            offset = len(self.data)
+            self.offsets[encoded] = offset
+            self.data += encoded
+        return offset, len(encoded)
+
+    def add_list(self, values):
+        first = len(self.list_refs)
+        for value in values:
+            self.list_refs.append(self.add(value))
+        return first, len(values)
+
+
+# JSON 读取规则与 FingerprintManager 的 JSON 加载保持一致：
+# FindInt 只接受整数，FindDouble 接受整数和浮点，类型不符视为缺失。
+def is_int(value) -> bool:
+    return isinstance(value, int) and not isinstance(value, bool)
+
+
+def is_number(value) -> bool:
+    return is_int(value) or isinstance(value, float)
+
+
+def section(entry, name):
+    value = entry.get(name)
+    return value if isinstance(value, dict) else {}
+
+
+def encode_device_profile(name, entry, pool):
+    fields = 0
+
+    def bit(field):
+        return 1 << DEVICE_FIELDS.index(field)
+
+    def get_string(sect, key, field):
+        nonlocal fields
+        value = sect.get(key)
+        if isinstance(value, str):
+            fields |= bit(field)
+            return pool.add(value)
+        return (0, 0)
+
+    def get_int(sect, key, field):
+        nonlocal fields
+        value = sect.get(key)
+        if is_int(value):
+            fields |= bit(field)
+            return value
+        return 0
+
+    navigator = section(entry, "navigator")
+    screen = section(entry, "screen")
+    webgl = section(entry, "webgl")
+
+    description = entry.get("description")
+    refs = [
+        pool.add(name),
+        pool.add(description if isinstance(description, str) else ""),
+        get_string(navigator, "user_agent", "user_agent"),
+        get_string(navigator, "platform", "platform"),
+        get_string(webgl, "vendor", "webgl_vendor"),
+        get_string(webgl, "renderer", "webgl_renderer"),
+    ]
+
+    languages = navigator.get("languages")
+    if isinstance(languages, list):
+        fields |= bit("languages")
+        languages_ref = pool.add_list([v for v in languages if isinstance(v, str)])
+    else:
+        languages_ref = (0, 0)
+
+    device_memory = navigator.get("device_memory")
+    if is_number(device_memory):
+        fields |= bit("device_memory")
+        device_memory = max(0, int(device_memory))
+    else:
+        device_memory = 0
+
+    device_pixel_ratio = screen.get("device_pixel_ratio")
+    if is_number(device_pixel_ratio):
+        fields |= bit("device_pixel_ratio")
+        device_pixel_ratio = float(device_pixel_ratio)
+    else:
+        device_pixel_ratio = 0.0
+
+    ints = [
+        get_int(navigator, "hardware_concurrency", "hardware_concurrency"),
+        get_int(screen, "width", "screen_width"),
+        get_int(screen, "height", "screen_height"),
+        get_int(screen, "color_depth", "color_depth"),
+        get_int(screen, "pixel_depth", "pixel_depth"),
+    ]
+
+    flat_refs = [v for ref in refs for v in ref]
+    return struct.pack(DEVICE_PROFILE_RECORD_FORMAT, *flat_refs, *languages_ref,
+                       device_memory, device_pixel_ratio, *ints, fields)
+
+
+def encode_behavior_pattern(name, entry, pool):
+    fields = 0
+    bools = 0
+    bit_index = 0
+
+    doubles = []
+    for sect_name, key in PATTERN_DOUBLE_FIELDS:
+        value = section(entry, sect_name).get(key)
+        if is_number(value):
+            fields |= 1 << bit_index
+            doubles.append(float(value))
+        else:
+            doubles.append(0.0)
+        bit_index += 1
+
+    ints = []
+    for sect_name, key in PATTERN_INT_FIELDS:
+        value = section(entry, sect_name).get(key)
+        if is_int(value):
+            fields |= 1 << bit_index
+            ints.append(value)
+        else:
+            ints.append(0)
+        bit_index += 1
+
+    for i, (sect_name, key) in enumerate(PATTERN_BOOL_FIELDS):
+        value = section(entry, sect_name).get(key)
+        if isinstance(value, bool):
+            fields |= 1 << bit_index
+            if value:
+                bools |= 1 << i
+        bit_index += 1
+
+    description = entry.get("description")
+    name_ref = pool.add(name)
+    description_ref = pool.add(description if isinstance(description, str) else "")
+    return struct.pack(BEHAVIOR_PATTERN_RECORD_FORMAT, *name_ref, *description_ref,
+                       *doubles, *ints, fields, bools, 0)
+
+
+def build_store(kind, entries) -> bytes:
+    pool = StringPool()
+    names = []
+    records = bytearray()
+
+    for name, entry in entries.items():
+        if not isinstance(entry, dict):
+            print(f"Skipping invalid entry: {name}", file=sys.stderr)
+            continue
+        if kind == KIND_DEVICE_PROFILES:
+            records += encode_device_profile(name, entry, pool)
+        else:
+            records += encode_behavior_pattern(name, entry, pool)
+        names.append(name)
+
+    record_size = (DEVICE_PROFILE_RECORD_SIZE if kind == KIND_DEVICE_PROFILES
+                   else BEHAVIOR_PATTERN_RECORD_SIZE)
+    assert len(records) == record_size * len(names)
+
+    # 开放寻址（线性探测），装载因子不超过 0.5
+    bucket_count = 1
+    while bucket_count < 2 * len(names):
+        bucket_count *= 2
+    buckets = [0] * bucket_count
+    for index, name in enumerate(names):
+        slot = fnv1a32(name.encode("utf-8")) & (bucket_count - 1)
+        while buckets[slot]:
+            slot = (slot + 1) & (bucket_count - 1)
+        buckets[slot] = index + 1
+
+    buckets_offset = HEADER_SIZE
+    records_offset = align8(buckets_offset + 4 * bucket_count)
+    string_refs_offset = align8(records_offset + len(records))
+    strings_offset = align8(string_refs_offset + 8 * len(pool.list_refs))
+    file_size = strings_offset + len(pool.data)
+
+    header = struct.pack(HEADER_FORMAT, MAGIC, FORMAT_VERSION, kind, len(names),
+                         record_size, bucket_count, buckets_offset, records_offset,
+                         string_refs_offset, len(pool.list_refs), strings_offset,
+                         len(pool.data), file_size)
+    assert len(header) == HEADER_SIZE
+
+    out = bytearray(file_size)
+    out[0:HEADER_SIZE] = header
+    out[buckets_offset:buckets_offset + 4 * bucket_count] = struct.pack(
+        f"<{bucket_count}I", *buckets)
+    out[records_offset:records_offset + len(records)] = records
+    for i, (offset, length) in enumerate(pool.list_refs):
+        struct.pack_into("<2I", out, string_refs_offset + 8 * i, offset, length)
+    out[strings_offset:] = pool.data
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile NoveBrowse profile JSON")
+    parser.add_argument("--kind", required=True,
+                        choices=["device_profiles", "behavior_patterns"])
+    parser.add_argument("--input", required=True, type=Path)
+    parser.add_argument("--output", required=True, type=Path)
+    args = parser.parse_args()
+
+    with args.input.open("r", encoding="utf-8") as f:
+        source = json.load(f)
+
+    if args.kind == "device_profiles":
+        kind, section_name = KIND_DEVICE_PROFILES, "profiles"
+    else:
+        kind, section_name = KIND_BEHAVIOR_PATTERNS, "patterns"
+
+    entries = source.get(section_name) if isinstance(source, dict) else None
+    if not isinstance(entries, dict):
+        print(f"{args.input}: missing '{section_name}' section", file=sys.stderr)
+        return 1
+
+    data = build_store(kind, entries)
+    args.output.parent.mkdir(parents=True, exist_ok=True)
+    args.output.write_bytes(data)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
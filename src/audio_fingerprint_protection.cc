@@ -0,0 +1,137 @@
+#include "novebrowse/audio_fingerprint_protection.h"
+
+#include <algorithm>
+
+#include "novebrowse/audio_noise_kernel.h"
+#include "novebrowse/blink_fingerprint_manager.h"
+#include "novebrowse/fingerprint_manager.h"
+#include "novebrowse/fingerprint_stats.h"
+#include "novebrowse/fingerprint_telemetry_reporter.h"
+#include "novebrowse/seed_service.h"
+#include "third_party/blink/renderer/core/execution_context/execution_context.h"
+#include "third_party/blink/renderer/core/frame/local_dom_window.h"
+#include "third_party/blink/renderer/core/frame/local_frame.h"
+#include "third_party/blink/renderer/platform/audio/audio_bus.h"
+#include "third_party/blink/renderer/platform/wtf/casting.h"
+
+namespace novebrowse {
+
+namespace {
+
+// Byte bins get their own stream so they do not move in lockstep with the
+// float bins of the same analyser.
+constexpr uint32_t kByteStreamIndex = 0xFFFFFFFFu;
+
+}  // namespace
+
+// static
+bool AudioFingerprintProtection::IsEnabled() {
+  return FingerprintManager::IsEnabled();
+}
+
+// static
+void AudioFingerprintProtection::ProcessFloatFrequencyData(
+    blink::ExecutionContext* context,
+    float* data,
+    size_t length) {
+  if (!IsEnabled() || !data || length == 0) {
+    return;
+  }
+  
+  BlinkFingerprintManager* manager = GetManager(context);
+  if (!manager || !manager->ShouldProtectAnalyserNode()) {
+    return;
+  }
+  
+  // Noise is addressed by bin, so repeated reads of an unchanged spectrum
+  // return identical values, as they would without protection.
+  float amplitude =
+      AudioNoiseKernel::DecibelAmplitudeForNoiseLevel(manager->GetAudioNoiseLevel());
+  uint32_t seed = SeedService::Fold32(manager->GetSeed(SeedSurface::kAudio));
+  AudioNoiseKernel::ApplyOffset(data, length, 0, seed, amplitude);
+}
+
+// static
+void AudioFingerprintProtection::ProcessByteFrequencyData(
+    blink::ExecutionContext* context,
+    uint8_t* data,
+    size_t length) {
+  if (!IsEnabled() || !data || length == 0) {
+    return;
+  }
+  
+  BlinkFingerprintManager* manager = GetManager(context);
+  if (!manager || !manager->ShouldProtectAnalyserNode() ||
+      !(manager->GetAudioNoiseLevel() > 0.0)) {
+    return;
+  }
+  
+  uint32_t seed = SeedService::Fold32(manager->GetSeed(SeedSurface::kAudio));
+  AudioNoiseKernel::ApplyToBytes(
+      data, length, 0, AudioNoiseKernel::HashIndex(seed, kByteStreamIndex));
+}
+
+// static
+AudioNoiseParams AudioFingerprintProtection::ParamsForOfflineContext(
+    blink::ExecutionContext* context) {
+  AudioNoiseParams params;
+  if (!IsEnabled()) {
+    return params;
+  }
+  
+  BlinkFingerprintManager* manager = GetManager(context);
+  if (!manager || !manager->ShouldProtectOfflineAudio()) {
+    return params;
+  }
+  
+  params.gain_amplitude =
+      AudioNoiseKernel::GainAmplitudeForNoiseLevel(manager->GetAudioNoiseLevel());
+  if (params.gain_amplitude == 0.0f) {
+    return params;
+  }
+  
+  params.seed = SeedService::Fold32(manager->GetSeed(SeedSurface::kAudio));
+  params.enabled = true;
+  
+  // Select the vector kernel here so the render thread never runs the
+  // one-time initialization.
+  AudioNoiseKernel::Initialize();
+  
+  INCREMENT_FINGERPRINT_STAT(kAudioContextsProtected);
+  FingerprintTelemetryReporter::Record(context,
+                                       FingerprintStat::kAudioContextsProtected);
+  return params;
+}
+
+// static
+void AudioFingerprintProtection::ProcessRenderQuantum(
+    const AudioNoiseParams& params,
+    blink::AudioBus* bus,
+    size_t frame_count,
+    size_t first_frame) {
+  if (!params.enabled || !bus || frame_count == 0) {
+    return;
+  }
+  
+  // Each channel gets its own seed, so identical channels (an upmixed mono
+  // source, say) do not end up with identical noise.
+  frame_count = std::min(frame_count, static_cast<size_t>(bus->length()));
+  for (unsigned channel = 0; channel < bus->NumberOfChannels(); ++channel) {
+    AudioNoiseKernel::ApplyGain(bus->Channel(channel)->MutableData(), frame_count,
+                                first_frame,
+                                AudioNoiseKernel::HashIndex(params.seed, channel),
+                                params.gain_amplitude);
+  }
+}
+
+// static
+BlinkFingerprintManager* AudioFingerprintProtection::GetManager(
+    blink::ExecutionContext* context) {
+  auto* window = blink::DynamicTo<blink::LocalDOMWindow>(context);
+  if (!window || !window->GetFrame()) {
+    return nullptr;
+  }
+  return BlinkFingerprintManager::FromFrameIfConfigured(window->GetFrame());
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,59 @@
+#ifndef NOVEBROWSE_AUDIO_FINGERPRINT_PROTECTION_H_
+#define NOVEBROWSE_AUDIO_FINGERPRINT_PROTECTION_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace blink {
+class AudioBus;
+class ExecutionContext;
+}
+
+namespace novebrowse {
+
+class BlinkFingerprintManager;
+
+// 离线渲染的噪声参数 - 在主线程解析，按值交给音频渲染线程后只读
+struct AudioNoiseParams {
+  bool enabled = false;
+  uint32_t seed = 0;
+  float gain_amplitude = 0.0f;
+};
+
+// 音频指纹保护实现类
+//
+// AnalyserNode的频域输出在主线程上加噪。OfflineAudioContext的渲染结果在
+// 音频线程上逐个渲染量子加噪，该路径只读取预先解析的AudioNoiseParams，
+// 不访问配置、不分配内存、不加锁。噪声按绝对帧下标寻址，与量子划分无关。
+class AudioFingerprintProtection {
+ public:
+  // 检查是否启用音频保护
+  static bool IsEnabled();
+  
+  // 处理getFloatFrequencyData的输出（分贝值）
+  static void ProcessFloatFrequencyData(blink::ExecutionContext* context,
+                                        float* data,
+                                        size_t length);
+  
+  // 处理getByteFrequencyData的输出
+  static void ProcessByteFrequencyData(blink::ExecutionContext* context,
+                                       uint8_t* data,
+                                       size_t length);
+  
+  // 解析离线渲染的噪声参数 - 主线程，渲染开始前调用一次
+  static AudioNoiseParams ParamsForOfflineContext(blink::ExecutionContext* context);
+  
+  // 对一个渲染量子加噪 - 音频渲染线程，first_frame为量子在整段渲染中的起始帧
+  static void ProcessRenderQuantum(const AudioNoiseParams& params,
+                                   blink::AudioBus* bus,
+                                   size_t frame_count,
+                                   size_t first_frame);
+  
+ private:
+  // 文档所在Frame的已配置管理器，没有时返回nullptr
+  static BlinkFingerprintManager* GetManager(blink::ExecutionContext* context);
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_AUDIO_FINGERPRINT_PROTECTION_H_
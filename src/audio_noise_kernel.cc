@@ -0,0 +1,346 @@
+#include "novebrowse/audio_noise_kernel.h"
+
+#include <algorithm>
+
+#include "base/cpu.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+#elif defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace novebrowse {
+
+namespace {
+
+// Hash constants shared by every kernel. Changing any of them changes the
+// noise pattern for every site, so treat them as part of the output format.
+constexpr uint32_t kIndexMultiplier = 0x27D4EB2Fu;
+constexpr uint32_t kMix1 = 0x7FEB352Du;
+constexpr uint32_t kMix2 = 0x846CA68Bu;
+
+// A hash read as int32 and scaled by 2^-31 is uniform on [-1, 1). The scale
+// is a power of two, so the product is exact on every path.
+constexpr float kInt32ToUnit = 1.0f / 2147483648.0f;
+
+// Byte deltas indexed by the top two hash bits: one bin in four moves down,
+// one in four moves up.
+constexpr int kByteDeltas[4] = {-1, 0, 0, 1};
+
+enum class NoiseOp {
+  kGain,
+  kOffset,
+};
+
+inline uint32_t MixHash(uint32_t h) {
+  h ^= h >> 16;
+  h *= kMix1;
+  h ^= h >> 15;
+  h *= kMix2;
+  h ^= h >> 16;
+  return h;
+}
+
+inline uint32_t IndexHash(uint32_t seed, uint32_t index) {
+  return MixHash(seed ^ (index * kIndexMultiplier));
+}
+
+using FloatKernel = void (*)(float* data,
+                             size_t count,
+                             size_t first_index,
+                             uint32_t seed,
+                             float amplitude);
+
+// Every step is its own statement so the compiler cannot contract it into
+// an FMA, which would round differently from the vector paths.
+template <NoiseOp kOp>
+void ApplyScalar(float* data,
+                 size_t count,
+                 size_t first_index,
+                 uint32_t seed,
+                 float amplitude) {
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t h = IndexHash(seed, static_cast<uint32_t>(first_index + i));
+    float unit = static_cast<float>(static_cast<int32_t>(h)) * kInt32ToUnit;
+    float scaled = amplitude * unit;
+    if constexpr (kOp == NoiseOp::kGain) {
+      float gain = 1.0f + scaled;
+      data[i] = data[i] * gain;
+    } else {
+      data[i] = data[i] + scaled;
+    }
+  }
+}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+#define NOVEBROWSE_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define NOVEBROWSE_TARGET_AVX2 __attribute__((target("avx2")))
+
+NOVEBROWSE_TARGET_SSE41 inline __m128i MixHashSSE41(__m128i h) {
+  h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+  h = _mm_mullo_epi32(h, _mm_set1_epi32(static_cast<int>(kMix1)));
+  h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+  h = _mm_mullo_epi32(h, _mm_set1_epi32(static_cast<int>(kMix2)));
+  h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+  return h;
+}
+
+template <NoiseOp kOp>
+NOVEBROWSE_TARGET_SSE41 void ApplySSE41(float* data,
+                                        size_t count,
+                                        size_t first_index,
+                                        uint32_t seed,
+                                        float amplitude) {
+  const __m128i key = _mm_set1_epi32(static_cast<int>(seed));
+  const __m128i multiplier = _mm_set1_epi32(static_cast<int>(kIndexMultiplier));
+  const __m128 to_unit = _mm_set1_ps(kInt32ToUnit);
+  const __m128 amp = _mm_set1_ps(amplitude);
+  const __m128i step = _mm_set1_epi32(4);
+  const int c0 = static_cast<int>(first_index);
+  __m128i counters = _mm_setr_epi32(c0, c0 + 1, c0 + 2, c0 + 3);
+
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128i h = MixHashSSE41(_mm_xor_si128(key, _mm_mullo_epi32(counters, multiplier)));
+    __m128 scaled = _mm_mul_ps(amp, _mm_mul_ps(_mm_cvtepi32_ps(h), to_unit));
+    __m128 values = _mm_loadu_ps(data + i);
+    if constexpr (kOp == NoiseOp::kGain) {
+      values = _mm_mul_ps(values, _mm_add_ps(_mm_set1_ps(1.0f), scaled));
+    } else {
+      values = _mm_add_ps(values, scaled);
+    }
+    _mm_storeu_ps(data + i, values);
+    counters = _mm_add_epi32(counters, step);
+  }
+
+  ApplyScalar<kOp>(data + i, count - i, first_index + i, seed, amplitude);
+}
+
+NOVEBROWSE_TARGET_AVX2 inline __m256i MixHashAVX2(__m256i h) {
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+  h = _mm256_mullo_epi32(h, _mm256_set1_epi32(static_cast<int>(kMix1)));
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+  h = _mm256_mullo_epi32(h, _mm256_set1_epi32(static_cast<int>(kMix2)));
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+  return h;
+}
+
+template <NoiseOp kOp>
+NOVEBROWSE_TARGET_AVX2 void ApplyAVX2(float* data,
+                                      size_t count,
+                                      size_t first_index,
+                                      uint32_t seed,
+                                      float amplitude) {
+  const __m256i key = _mm256_set1_epi32(static_cast<int>(seed));
+  const __m256i multiplier = _mm256_set1_epi32(static_cast<int>(kIndexMultiplier));
+  const __m256 to_unit = _mm256_set1_ps(kInt32ToUnit);
+  const __m256 amp = _mm256_set1_ps(amplitude);
+  const __m256i step = _mm256_set1_epi32(8);
+  const int c0 = static_cast<int>(first_index);
+  __m256i counters = _mm256_setr_epi32(c0, c0 + 1, c0 + 2, c0 + 3,
+                                       c0 + 4, c0 + 5, c0 + 6, c0 + 7);
+
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i h = MixHashAVX2(_mm256_xor_si256(key, _mm256_mullo_epi32(counters, multiplier)));
+    __m256 scaled = _mm256_mul_ps(amp, _mm256_mul_ps(_mm256_cvtepi32_ps(h), to_unit));
+    __m256 values = _mm256_loadu_ps(data + i);
+    if constexpr (kOp == NoiseOp::kGain) {
+      values = _mm256_mul_ps(values, _mm256_add_ps(_mm256_set1_ps(1.0f), scaled));
+    } else {
+      values = _mm256_add_ps(values, scaled);
+    }
+    _mm256_storeu_ps(data + i, values);
+    counters = _mm256_add_epi32(counters, step);
+  }
+
+  ApplySSE41<kOp>(data + i, count - i, first_index + i, seed, amplitude);
+}
+
+#elif defined(ARCH_CPU_ARM64)
+
+inline uint32x4_t MixHashNEON(uint32x4_t h) {
+  h = veorq_u32(h, vshrq_n_u32(h, 16));
+  h = vmulq_u32(h, vdupq_n_u32(kMix1));
+  h = veorq_u32(h, vshrq_n_u32(h, 15));
+  h = vmulq_u32(h, vdupq_n_u32(kMix2));
+  h = veorq_u32(h, vshrq_n_u32(h, 16));
+  return h;
+}
+
+inline uint32x4_t InitialCounters(uint32_t first) {
+  const uint32_t counters[4] = {first, first + 1, first + 2, first + 3};
+  return vld1q_u32(counters);
+}
+
+// vmulq/vaddq rather than vfmaq keep the rounding of the scalar path.
+template <NoiseOp kOp>
+void ApplyNEON(float* data,
+               size_t count,
+               size_t first_index,
+               uint32_t seed,
+               float amplitude) {
+  const uint32x4_t key = vdupq_n_u32(seed);
+  const uint32x4_t multiplier = vdupq_n_u32(kIndexMultiplier);
+  const float32x4_t to_unit = vdupq_n_f32(kInt32ToUnit);
+  const float32x4_t amp = vdupq_n_f32(amplitude);
+  const uint32x4_t step = vdupq_n_u32(4);
+  uint32x4_t counters = InitialCounters(static_cast<uint32_t>(first_index));
+
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    uint32x4_t h = MixHashNEON(veorq_u32(key, vmulq_u32(counters, multiplier)));
+    float32x4_t scaled =
+        vmulq_f32(amp, vmulq_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(h)), to_unit));
+    float32x4_t values = vld1q_f32(data + i);
+    if constexpr (kOp == NoiseOp::kGain) {
+      values = vmulq_f32(values, vaddq_f32(vdupq_n_f32(1.0f), scaled));
+    } else {
+      values = vaddq_f32(values, scaled);
+    }
+    vst1q_f32(data + i, values);
+    counters = vaddq_u32(counters, step);
+  }
+
+  ApplyScalar<kOp>(data + i, count - i, first_index + i, seed, amplitude);
+}
+
+#endif
+
+struct FloatKernels {
+  FloatKernel gain;
+  FloatKernel offset;
+};
+
+FloatKernels SelectKernels() {
+#if defined(ARCH_CPU_X86_FAMILY)
+  base::CPU cpu;
+  if (cpu.has_avx2()) {
+    return {&ApplyAVX2<NoiseOp::kGain>, &ApplyAVX2<NoiseOp::kOffset>};
+  }
+  if (cpu.has_sse41()) {
+    return {&ApplySSE41<NoiseOp::kGain>, &ApplySSE41<NoiseOp::kOffset>};
+  }
+  return {&ApplyScalar<NoiseOp::kGain>, &ApplyScalar<NoiseOp::kOffset>};
+#elif defined(ARCH_CPU_ARM64)
+  return {&ApplyNEON<NoiseOp::kGain>, &ApplyNEON<NoiseOp::kOffset>};
+#else
+  return {&ApplyScalar<NoiseOp::kGain>, &ApplyScalar<NoiseOp::kOffset>};
+#endif
+}
+
+// The first call takes the function-local static's initialization guard;
+// Initialize() makes sure that happens on the main thread.
+const FloatKernels& GetKernels() {
+  static const FloatKernels kernels = SelectKernels();
+  return kernels;
+}
+
+float AmplitudeForNoiseLevel(double noise_level, double scale) {
+  if (!(noise_level > 0.0)) {
+    return 0.0f;
+  }
+  return static_cast<float>(std::min(noise_level, 1.0) * scale);
+}
+
+}  // namespace
+
+// static
+float AudioNoiseKernel::GainAmplitudeForNoiseLevel(double noise_level) {
+  // At the default level of 0.001 this is a gain error of 1e-5 (-100 dB):
+  // inaudible, but it moves the sums audio fingerprints hash.
+  return AmplitudeForNoiseLevel(noise_level, kGainPerNoiseLevel);
+}
+
+// static
+float AudioNoiseKernel::DecibelAmplitudeForNoiseLevel(double noise_level) {
+  return AmplitudeForNoiseLevel(noise_level, kDecibelsPerNoiseLevel);
+}
+
+// static
+void AudioNoiseKernel::Initialize() {
+  GetKernels();
+}
+
+// static
+void AudioNoiseKernel::ApplyGain(float* samples,
+                                 size_t count,
+                                 size_t first_index,
+                                 uint32_t seed,
+                                 float amplitude) {
+  if (!samples || count == 0 || !(amplitude > 0.0f)) {
+    return;
+  }
+
+  GetKernels().gain(samples, count, first_index, seed, amplitude);
+}
+
+// static
+void AudioNoiseKernel::ApplyOffset(float* values,
+                                   size_t count,
+                                   size_t first_index,
+                                   uint32_t seed,
+                                   float amplitude) {
+  if (!values || count == 0 || !(amplitude > 0.0f)) {
+    return;
+  }
+
+  GetKernels().offset(values, count, first_index, seed, amplitude);
+}
+
+// static
+void AudioNoiseKernel::ApplyToBytes(uint8_t* values,
+                                    size_t count,
+                                    size_t first_index,
+                                    uint32_t seed) {
+  if (!values) {
+    return;
+  }
+
+  // Frequency bins number at most 16384, so this stays scalar. Silent bins
+  // stay silent; a nonzero floor would give the noise away.
+  for (size_t i = 0; i < count; ++i) {
+    if (values[i] == 0) {
+      continue;
+    }
+    uint32_t h = IndexHash(seed, static_cast<uint32_t>(first_index + i));
+    values[i] = static_cast<uint8_t>(
+        std::clamp(static_cast<int>(values[i]) + kByteDeltas[h >> 30], 1, 255));
+  }
+}
+
+// static
+void AudioNoiseKernel::ApplyGainScalar(float* samples,
+                                       size_t count,
+                                       size_t first_index,
+                                       uint32_t seed,
+                                       float amplitude) {
+  if (!samples || count == 0 || !(amplitude > 0.0f)) {
+    return;
+  }
+
+  ApplyScalar<NoiseOp::kGain>(samples, count, first_index, seed, amplitude);
+}
+
+// static
+void AudioNoiseKernel::ApplyOffsetScalar(float* values,
+                                         size_t count,
+                                         size_t first_index,
+                                         uint32_t seed,
+                                         float amplitude) {
+  if (!values || count == 0 || !(amplitude > 0.0f)) {
+    return;
+  }
+
+  ApplyScalar<NoiseOp::kOffset>(values, count, first_index, seed, amplitude);
+}
+
+// static
+uint32_t AudioNoiseKernel::HashIndex(uint32_t seed, uint32_t index) {
+  return IndexHash(seed, index);
+}
+
+}  // namespace novebrowse
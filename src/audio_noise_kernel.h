@@ -0,0 +1,66 @@
+#ifndef NOVEBROWSE_AUDIO_NOISE_KERNEL_H_
+#define NOVEBROWSE_AUDIO_NOISE_KERNEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace novebrowse {
+
+// 音频噪声内核 - 按样本下标加噪，使用计数器式哈希，无内部状态
+//
+// 第i个样本的扰动只由(seed, i)决定，渲染量子的划分不影响结果。
+// 不分配内存、不加锁、不记录统计，可以在音频渲染线程上调用。
+// 浮点路径有SSE4.1/AVX2/NEON实现，与标量路径的输出逐位一致。
+class AudioNoiseKernel {
+ public:
+  // noise_level为1.0时的最大相对增益偏移，以及频域数据的最大分贝偏移
+  static constexpr double kGainPerNoiseLevel = 0.01;
+  static constexpr double kDecibelsPerNoiseLevel = 10.0;
+
+  // 由noise_level换算噪声幅度，返回0表示不扰动
+  static float GainAmplitudeForNoiseLevel(double noise_level);
+  static float DecibelAmplitudeForNoiseLevel(double noise_level);
+
+  // 预先选择SIMD实现；应在主线程调用，使音频线程不触发首次初始化
+  static void Initialize();
+
+  // 时域样本乘以(1 + amplitude * u)，u在[-1, 1)内，静音保持静音
+  // first_index为samples[0]在整段数据中的下标
+  static void ApplyGain(float* samples,
+                        size_t count,
+                        size_t first_index,
+                        uint32_t seed,
+                        float amplitude);
+
+  // 频域分贝值加上amplitude * u，-Infinity保持不变
+  static void ApplyOffset(float* values,
+                          size_t count,
+                          size_t first_index,
+                          uint32_t seed,
+                          float amplitude);
+
+  // 字节频域数据偏移±1，零值保持为零
+  static void ApplyToBytes(uint8_t* values,
+                           size_t count,
+                           size_t first_index,
+                           uint32_t seed);
+
+  // 标量参考实现
+  static void ApplyGainScalar(float* samples,
+                              size_t count,
+                              size_t first_index,
+                              uint32_t seed,
+                              float amplitude);
+  static void ApplyOffsetScalar(float* values,
+                                size_t count,
+                                size_t first_index,
+                                uint32_t seed,
+                                float amplitude);
+
+  // 计数器哈希 - 第index个哈希值，也用于派生各声道的种子
+  static uint32_t HashIndex(uint32_t seed, uint32_t index);
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_AUDIO_NOISE_KERNEL_H_
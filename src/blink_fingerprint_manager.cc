@@ -4,14 +4,34 @@
 #include <random>
 
 #include "base/logging.h"
-#include "base/strings/stringprintf.h"
+#include "base/no_destructor.h"
 #include "novebrowse/fingerprint_manager.h"
+#include "novebrowse/fingerprint_trace.h"
+#include "novebrowse/protection_script_bundle.h"
 #include "third_party/blink/renderer/core/execution_context/execution_context.h"
 #include "third_party/blink/renderer/core/frame/local_dom_window.h"
+#include "third_party/blink/renderer/core/frame/web_local_frame_impl.h"
 #include "third_party/blink/renderer/core/script/classic_script.h"
+#include "third_party/blink/renderer/platform/wtf/text/string_builder.h"
 
 namespace novebrowse {
 
+namespace {
+
+// Null rather than empty so patched getters can tell "not spoofed" from a
+// configured empty value and fall back to the real one.
+const WTF::String& NullString() {
+  static const base::NoDestructor<WTF::String> null_string;
+  return *null_string;
+}
+
+const WTF::Vector<WTF::String>& EmptyStringVector() {
+  static const base::NoDestructor<WTF::Vector<WTF::String>> empty;
+  return *empty;
+}
+
+}  // namespace
+
 const char BlinkFingerprintManager::kSupplementName[] = "BlinkFingerprintManager";
 
 // static
@@ -28,6 +48,15 @@ BlinkFingerprintManager* BlinkFingerprintManager::FromFrame(blink::LocalFrame* f
   return manager;
 }
 
+// static
+BlinkFingerprintManager* BlinkFingerprintManager::FromWebFrame(
+    blink::WebLocalFrame* web_frame) {
+  if (!web_frame) {
+    return nullptr;
+  }
+  return FromFrame(blink::To<blink::WebLocalFrameImpl>(web_frame)->GetFrame());
+}
+
 // static
 BlinkFingerprintManager* BlinkFingerprintManager::Create(blink::LocalFrame* frame) {
   if (!frame) {
@@ -40,8 +69,17 @@ BlinkFingerprintManager* BlinkFingerprintManager::Create(blink::LocalFrame* fram
 }
 
 BlinkFingerprintManager::BlinkFingerprintManager(blink::LocalFrame& frame) 
-    : Supplement<blink::LocalFrame>(frame), frame_(&frame) {
-  InitializeDefaultConfig();
+    : Supplement<blink::LocalFrame>(frame), frame_(&frame) {}
+
+// static
+BlinkFingerprintManager* BlinkFingerprintManager::FromFrameIfConfigured(
+    blink::LocalFrame* frame) {
+  if (!frame) {
+    return nullptr;
+  }
+  
+  BlinkFingerprintManager* manager = Supplement<blink::LocalFrame>::From<BlinkFingerprintManager>(*frame);
+  return manager && manager->IsConfigured() ? manager : nullptr;
 }
 
 void BlinkFingerprintManager::UpdateConfig(const FingerprintConfig& config) {
@@ -50,393 +88,410 @@ void BlinkFingerprintManager::UpdateConfig(const FingerprintConfig& config) {
     return;
   }
   
-  config_ = config;
-  configured_ = true;
-  ClearCache();
+  // Frames sharing a config share one precomputed record, so a page with
+  // many same-profile iframes converts the strings only once.
+  record_ = SpoofRecord::GetOrCreate(config);
+  InjectProtectionBundleOnce();
   
-  LOG(INFO) << "Updated fingerprint configuration for frame";
+  DVLOG(1) << "Updated fingerprint configuration for frame";
 }
 
-WTF::String BlinkFingerprintManager::GetSpoofedUserAgent() const {
-  if (!configured_ || !config_.navigator.enabled) {
-    return WTF::String();
+bool BlinkFingerprintManager::ApplyConfigUpdate(
+    const mojom::FingerprintConfigUpdate& update) {
+  if (!update.config) {
+    // Hash only: the browser believes this process already has the config.
+    scoped_refptr<const SpoofRecord> record = SpoofRecord::Find(update.config_hash);
+    if (!record) {
+      return false;
+    }
+    
+    record_ = std::move(record);
+    InjectProtectionBundleOnce();
+    return true;
+  }
+  
+  FingerprintConfig config = FingerprintConfig::FromMojoStruct(update.config);
+  if (!ValidateConfig(config)) {
+    // The frame keeps its previous profile. Report it, so the browser does
+    // not count the hash as delivered; it does not resend a full config.
+    LOG(ERROR) << "Invalid fingerprint configuration provided";
+    return false;
   }
   
-  if (cached_user_agent_.IsEmpty()) {
-    cached_user_agent_ = WTF::String::FromUTF8(config_.navigator.user_agent.c_str());
+  record_ = SpoofRecord::GetOrCreate(config, update.config_hash);
+  InjectProtectionBundleOnce();
+  return true;
+}
+
+// static
+void BlinkFingerprintManager::PrimeConfigs(
+    const std::vector<mojom::FingerprintConfigUpdatePtr>& updates) {
+  for (const auto& update : updates) {
+    if (!update || !update->config) {
+      continue;
+    }
+    
+    // Not attached to any frame: the record stays in the process cache
+    // until a hash-only update picks it up or the cache needs the room.
+    FingerprintConfig config = FingerprintConfig::FromMojoStruct(update->config);
+    if (ValidateConfig(config)) {
+      SpoofRecord::GetOrCreate(config, update->config_hash);
+    }
   }
+}
+
+uint64_t BlinkFingerprintManager::GetProfileSeed() const {
+  return record_ ? record_->profile_seed : SpoofRecord::GetDefault()->profile_seed;
+}
+
+uint64_t BlinkFingerprintManager::GetSeed(SeedSurface surface) const {
+  uint64_t profile_seed = GetProfileSeed();
   
-  IncrementOperationCount("navigator_user_agent");
-  return cached_user_agent_;
+  // Keyed on the document's origin rather than the frame, so every frame of
+  // a site, in this process or any other, gets the same noise.
+  const blink::SecurityOrigin* origin = nullptr;
+  if (frame_ && frame_->DomWindow()) {
+    origin = frame_->DomWindow()->GetSecurityOrigin();
+  }
+  return seeds_.GetSeed(profile_seed, origin, surface);
 }
 
-WTF::String BlinkFingerprintManager::GetSpoofedPlatform() const {
-  if (!configured_ || !config_.navigator.enabled) {
-    return WTF::String();
+const FingerprintConfig& BlinkFingerprintManager::GetConfig() const {
+  if (record_) {
+    return record_->config;
   }
   
-  if (cached_platform_.IsEmpty()) {
-    cached_platform_ = WTF::String::FromUTF8(config_.navigator.platform.c_str());
+  // The built-in defaults are only materialized if someone asks for them;
+  // GetDefault() keeps the record alive for the life of the process.
+  return SpoofRecord::GetDefault()->config;
+}
+
+scoped_refptr<const SpoofRecord> BlinkFingerprintManager::GetRecord() const {
+  return record_ ? record_ : SpoofRecord::GetDefault();
+}
+
+void BlinkFingerprintManager::InjectProtectionBundleOnce() {
+  // The window-cleared hook runs before the document's scripts, but on a
+  // frame's first navigation the config usually arrives after commit; that
+  // document gets the bundle when its config lands. Later config switches
+  // do not re-run it, since the scripts redefine properties in place.
+  if (!record_ || !frame_) {
+    return;
+  }
+  blink::LocalDOMWindow* window = frame_->DomWindow();
+  if (!window || bundle_window_ == window) {
+    return;
+  }
+  bundle_window_ = window;
+  JSInjectionManager::InjectProtectionBundle(frame_, record_->config);
+}
+
+const WTF::String& BlinkFingerprintManager::GetSpoofedUserAgent() const {
+  if (!record_) {
+    return NullString();
   }
   
-  IncrementOperationCount("navigator_platform");
-  return cached_platform_;
+  IncrementOperationCount(SpoofedOperation::kNavigatorUserAgent);
+  return record_->user_agent;
 }
 
-WTF::Vector<WTF::String> BlinkFingerprintManager::GetSpoofedLanguages() const {
-  if (!configured_ || !config_.navigator.enabled) {
-    return WTF::Vector<WTF::String>();
+const WTF::String& BlinkFingerprintManager::GetSpoofedPlatform() const {
+  if (!record_) {
+    return NullString();
   }
   
-  if (cached_languages_.IsEmpty()) {
-    for (const auto& lang : config_.navigator.languages) {
-      cached_languages_.push_back(WTF::String::FromUTF8(lang.c_str()));
-    }
+  IncrementOperationCount(SpoofedOperation::kNavigatorPlatform);
+  return record_->platform;
+}
+
+const WTF::Vector<WTF::String>& BlinkFingerprintManager::GetSpoofedLanguages() const {
+  if (!record_) {
+    return EmptyStringVector();
   }
   
-  IncrementOperationCount("navigator_languages");
-  return cached_languages_;
+  IncrementOperationCount(SpoofedOperation::kNavigatorLanguages);
+  return record_->languages;
 }
 
 int BlinkFingerprintManager::GetSpoofedHardwareConcurrency() const {
-  if (!configured_ || !config_.navigator.enabled) {
+  if (!record_) {
     return 0;
   }
   
-  IncrementOperationCount("navigator_hardware_concurrency");
-  return config_.navigator.hardware_concurrency;
+  IncrementOperationCount(SpoofedOperation::kNavigatorHardwareConcurrency);
+  return record_->hardware_concurrency;
 }
 
 uint64_t BlinkFingerprintManager::GetSpoofedDeviceMemory() const {
-  if (!configured_ || !config_.navigator.enabled) {
+  if (!record_) {
     return 0;
   }
   
-  IncrementOperationCount("navigator_device_memory");
-  return config_.navigator.device_memory;
+  IncrementOperationCount(SpoofedOperation::kNavigatorDeviceMemory);
+  return record_->device_memory;
 }
 
 bool BlinkFingerprintManager::ShouldHideWebDriver() const {
-  if (!configured_ || !config_.navigator.enabled) {
+  if (!record_) {
     return false;
   }
   
-  IncrementOperationCount("navigator_webdriver");
-  return config_.navigator.hide_webdriver;
+  IncrementOperationCount(SpoofedOperation::kNavigatorWebDriver);
+  return record_->hide_webdriver;
 }
 
 int BlinkFingerprintManager::GetSpoofedScreenWidth() const {
-  if (!configured_ || !config_.screen.enabled) {
+  if (!record_) {
     return 0;
   }
   
-  IncrementOperationCount("screen_width");
-  return config_.screen.width;
+  IncrementOperationCount(SpoofedOperation::kScreenWidth);
+  return record_->screen_width;
 }
 
 int BlinkFingerprintManager::GetSpoofedScreenHeight() const {
-  if (!configured_ || !config_.screen.enabled) {
+  if (!record_) {
     return 0;
   }
   
-  IncrementOperationCount("screen_height");
-  return config_.screen.height;
+  IncrementOperationCount(SpoofedOperation::kScreenHeight);
+  return record_->screen_height;
 }
 
 int BlinkFingerprintManager::GetSpoofedScreenColorDepth() const {
-  if (!configured_ || !config_.screen.enabled) {
+  if (!record_) {
     return 0;
   }
   
-  IncrementOperationCount("screen_color_depth");
-  return config_.screen.color_depth;
+  IncrementOperationCount(SpoofedOperation::kScreenColorDepth);
+  return record_->screen_color_depth;
 }
 
 int BlinkFingerprintManager::GetSpoofedScreenPixelDepth() const {
-  if (!configured_ || !config_.screen.enabled) {
+  if (!record_) {
     return 0;
   }
   
-  IncrementOperationCount("screen_pixel_depth");
-  return config_.screen.pixel_depth;
+  IncrementOperationCount(SpoofedOperation::kScreenPixelDepth);
+  return record_->screen_pixel_depth;
 }
 
 double BlinkFingerprintManager::GetSpoofedDevicePixelRatio() const {
-  if (!configured_ || !config_.screen.enabled) {
+  if (!record_) {
     return 0.0;
   }
   
-  IncrementOperationCount("screen_device_pixel_ratio");
-  return config_.screen.device_pixel_ratio;
+  IncrementOperationCount(SpoofedOperation::kScreenDevicePixelRatio);
+  return record_->device_pixel_ratio;
 }
 
-WTF::String BlinkFingerprintManager::GetSpoofedTimezone() const {
-  if (!configured_ || !config_.timezone.enabled) {
-    return WTF::String();
+const WTF::String& BlinkFingerprintManager::GetSpoofedTimezone() const {
+  if (!record_) {
+    return NullString();
   }
   
-  IncrementOperationCount("timezone");
-  return WTF::String::FromUTF8(config_.timezone.timezone.c_str());
+  IncrementOperationCount(SpoofedOperation::kTimezone);
+  return record_->timezone;
 }
 
 int BlinkFingerprintManager::GetSpoofedTimezoneOffset() const {
-  if (!configured_ || !config_.timezone.enabled) {
+  if (!record_) {
     return 0;
   }
   
-  IncrementOperationCount("timezone_offset");
-  return config_.timezone.timezone_offset;
+  IncrementOperationCount(SpoofedOperation::kTimezoneOffset);
+  return record_->timezone_offset;
 }
 
 bool BlinkFingerprintManager::ShouldSpoofGeolocation() const {
-  return configured_ && config_.geolocation.enabled && config_.geolocation.spoof_location;
+  return record_ && record_->spoof_geolocation;
 }
 
 double BlinkFingerprintManager::GetSpoofedLatitude() const {
-  if (!ShouldSpoofGeolocation()) {
+  if (!record_) {
     return 0.0;
   }
   
-  IncrementOperationCount("geolocation_latitude");
-  return config_.geolocation.latitude;
+  IncrementOperationCount(SpoofedOperation::kGeolocationLatitude);
+  return record_->latitude;
 }
 
 double BlinkFingerprintManager::GetSpoofedLongitude() const {
-  if (!ShouldSpoofGeolocation()) {
+  if (!record_) {
     return 0.0;
   }
   
-  IncrementOperationCount("geolocation_longitude");
-  return config_.geolocation.longitude;
+  IncrementOperationCount(SpoofedOperation::kGeolocationLongitude);
+  return record_->longitude;
 }
 
 double BlinkFingerprintManager::GetSpoofedAccuracy() const {
-  if (!ShouldSpoofGeolocation()) {
+  if (!record_) {
     return 0.0;
   }
   
-  IncrementOperationCount("geolocation_accuracy");
-  return config_.geolocation.accuracy;
+  IncrementOperationCount(SpoofedOperation::kGeolocationAccuracy);
+  return record_->accuracy;
 }
 
 bool BlinkFingerprintManager::ShouldProtectCanvas() const {
-  return configured_ && config_.canvas.enabled;
+  return record_ && record_->protect_canvas;
 }
 
 double BlinkFingerprintManager::GetCanvasNoiseLevel() const {
-  if (!ShouldProtectCanvas()) {
-    return 0.0;
-  }
-  
-  return config_.canvas.noise_level;
+  return record_ ? record_->canvas_noise_level : 0.0;
 }
 
 bool BlinkFingerprintManager::ShouldSpoofTextMetrics() const {
-  return configured_ && config_.canvas.enabled && config_.canvas.spoof_text_metrics;
+  return record_ && record_->spoof_text_metrics;
 }
 
 bool BlinkFingerprintManager::ShouldProtectWebGL() const {
-  return configured_ && config_.webgl.enabled;
+  return record_ && record_->protect_webgl;
 }
 
-WTF::String BlinkFingerprintManager::GetSpoofedWebGLVendor() const {
-  if (!ShouldProtectWebGL()) {
-    return WTF::String();
+const WTF::String& BlinkFingerprintManager::GetSpoofedWebGLVendor() const {
+  if (!record_) {
+    return NullString();
   }
   
-  IncrementOperationCount("webgl_vendor");
-  return WTF::String::FromUTF8(config_.webgl.vendor.c_str());
+  IncrementOperationCount(SpoofedOperation::kWebGLVendor);
+  return record_->webgl_vendor;
 }
 
-WTF::String BlinkFingerprintManager::GetSpoofedWebGLRenderer() const {
-  if (!ShouldProtectWebGL()) {
-    return WTF::String();
+const WTF::String& BlinkFingerprintManager::GetSpoofedWebGLRenderer() const {
+  if (!record_) {
+    return NullString();
   }
   
-  IncrementOperationCount("webgl_renderer");
-  return WTF::String::FromUTF8(config_.webgl.renderer.c_str());
+  IncrementOperationCount(SpoofedOperation::kWebGLRenderer);
+  return record_->webgl_renderer;
 }
 
-WTF::String BlinkFingerprintManager::GetSpoofedWebGLVersion() const {
-  if (!ShouldProtectWebGL()) {
-    return WTF::String();
+const WTF::String& BlinkFingerprintManager::GetSpoofedWebGLVersion() const {
+  if (!record_) {
+    return NullString();
   }
   
-  IncrementOperationCount("webgl_version");
-  return WTF::String::FromUTF8(config_.webgl.version.c_str());
+  IncrementOperationCount(SpoofedOperation::kWebGLVersion);
+  return record_->webgl_version;
 }
 
-WTF::Vector<WTF::String> BlinkFingerprintManager::GetSpoofedWebGLExtensions() const {
-  if (!ShouldProtectWebGL()) {
-    return WTF::Vector<WTF::String>();
-  }
-  
-  if (cached_webgl_extensions_.IsEmpty()) {
-    for (const auto& ext : config_.webgl.extensions) {
-      cached_webgl_extensions_.push_back(WTF::String::FromUTF8(ext.c_str()));
-    }
+const WTF::Vector<WTF::String>& BlinkFingerprintManager::GetSpoofedWebGLExtensions() const {
+  if (!record_) {
+    return EmptyStringVector();
   }
   
-  IncrementOperationCount("webgl_extensions");
-  return cached_webgl_extensions_;
+  IncrementOperationCount(SpoofedOperation::kWebGLExtensions);
+  return record_->webgl_extensions;
 }
 
 bool BlinkFingerprintManager::ShouldProtectAudio() const {
-  return configured_ && config_.audio.enabled;
+  return record_ && record_->protect_audio;
 }
 
 double BlinkFingerprintManager::GetAudioNoiseLevel() const {
-  if (!ShouldProtectAudio()) {
-    return 0.0;
-  }
-  
-  return config_.audio.noise_level;
+  return record_ ? record_->audio_noise_level : 0.0;
+}
+
+bool BlinkFingerprintManager::ShouldProtectAnalyserNode() const {
+  return record_ && record_->protect_analyser_node;
+}
+
+bool BlinkFingerprintManager::ShouldProtectOfflineAudio() const {
+  return record_ && record_->protect_offline_audio;
 }
 
 int BlinkFingerprintManager::GetSpoofedSampleRate() const {
-  if (!ShouldProtectAudio()) {
+  if (!record_) {
     return 0;
   }
   
-  IncrementOperationCount("audio_sample_rate");
-  return config_.audio.sample_rate;
+  IncrementOperationCount(SpoofedOperation::kAudioSampleRate);
+  return record_->sample_rate;
 }
 
 bool BlinkFingerprintManager::ShouldProtectFonts() const {
-  return configured_ && config_.font.enabled;
+  return record_ && record_->protect_fonts;
 }
 
-WTF::Vector<WTF::String> BlinkFingerprintManager::GetSpoofedAvailableFonts() const {
-  if (!ShouldProtectFonts()) {
-    return WTF::Vector<WTF::String>();
+const WTF::Vector<WTF::String>& BlinkFingerprintManager::GetSpoofedAvailableFonts() const {
+  if (!record_) {
+    return EmptyStringVector();
   }
   
-  if (cached_fonts_.IsEmpty()) {
-    for (const auto& font : config_.font.available_fonts) {
-      cached_fonts_.push_back(WTF::String::FromUTF8(font.c_str()));
-    }
-  }
-  
-  IncrementOperationCount("font_enumeration");
-  return cached_fonts_;
+  IncrementOperationCount(SpoofedOperation::kFontEnumeration);
+  return record_->font_allowlist.families();
 }
 
-bool BlinkFingerprintManager::ShouldSpoofFontMetrics() const {
-  return configured_ && config_.font.enabled && config_.font.spoof_metrics;
+bool BlinkFingerprintManager::IsFontFamilyAllowed(const WTF::AtomicString& family) const {
+  return !record_ || !record_->block_unlisted_fonts ||
+         record_->font_allowlist.Contains(family);
 }
 
 bool BlinkFingerprintManager::ShouldProtectWebRTC() const {
-  return configured_ && config_.webrtc.enabled;
+  return record_ && record_->protect_webrtc;
 }
 
 bool BlinkFingerprintManager::ShouldMaskLocalIPs() const {
-  return ShouldProtectWebRTC() && config_.webrtc.mask_local_ips;
+  return record_ && record_->mask_local_ips;
 }
 
-WTF::String BlinkFingerprintManager::GetFakePublicIP() const {
-  if (!ShouldProtectWebRTC()) {
-    return WTF::String();
+const WTF::String& BlinkFingerprintManager::GetFakePublicIP() const {
+  if (!record_) {
+    return NullString();
   }
   
-  IncrementOperationCount("webrtc_fake_ip");
-  return WTF::String::FromUTF8(config_.webrtc.fake_public_ip.c_str());
+  IncrementOperationCount(SpoofedOperation::kWebRTCFakeIP);
+  return record_->fake_public_ip;
 }
 
 bool BlinkFingerprintManager::ShouldHideAutomationFlags() const {
-  return configured_ && config_.anti_detection.enabled && 
-         config_.anti_detection.automation.hide_headless_flags;
+  return record_ && record_->hide_automation_flags;
 }
 
 bool BlinkFingerprintManager::ShouldSpoofChromeRuntime() const {
-  return configured_ && config_.anti_detection.enabled && 
-         config_.anti_detection.webdriver.spoof_chrome_runtime;
+  return record_ && record_->spoof_chrome_runtime;
 }
 
-bool BlinkFingerprintManager::ShouldBlockDetectionScripts() const {
-  return configured_ && config_.anti_detection.enabled && 
-         config_.anti_detection.js_injection.block_detection_scripts;
+bool BlinkFingerprintManager::UsesNativeSpoofing() const {
+  return record_ && record_->native_spoofing;
 }
 
-WTF::Vector<WTF::String> BlinkFingerprintManager::GetBlockedScriptPatterns() const {
-  if (!ShouldBlockDetectionScripts()) {
-    return WTF::Vector<WTF::String>();
-  }
-  
-  WTF::Vector<WTF::String> patterns;
-  for (const auto& pattern : config_.anti_detection.js_injection.blocked_script_patterns) {
-    patterns.push_back(WTF::String::FromUTF8(pattern.c_str()));
-  }
-  
-  return patterns;
+bool BlinkFingerprintManager::ShouldBlockDetectionScripts() const {
+  return record_ && record_->block_detection_scripts;
 }
 
-void BlinkFingerprintManager::IncrementOperationCount(const WTF::String& operation) {
-  std::string op_str = operation.Utf8();
-  operation_counts_[op_str]++;
+scoped_refptr<const ScriptPatternMatcher>
+BlinkFingerprintManager::GetScriptPatternMatcher() const {
+  return record_ && record_->block_detection_scripts ? record_->script_matcher
+                                                     : nullptr;
 }
 
-int BlinkFingerprintManager::GetOperationCount(const WTF::String& operation) const {
-  std::string op_str = operation.Utf8();
-  auto it = operation_counts_.find(op_str);
-  return it != operation_counts_.end() ? it->second : 0;
+int BlinkFingerprintManager::GetOperationCount(SpoofedOperation operation) const {
+  return static_cast<int>(operation_counts_[static_cast<size_t>(operation)].load(
+      std::memory_order_relaxed));
 }
 
 void BlinkFingerprintManager::Trace(blink::Visitor* visitor) const {
   visitor->Trace(frame_);
+  visitor->Trace(bundle_window_);
   Supplement<blink::LocalFrame>::Trace(visitor);
 }
 
-void BlinkFingerprintManager::InitializeDefaultConfig() {
-  // Initialize with basic default configuration
-  config_.enabled = true;
-  config_.profile_name = "default";
-  config_.device_profile = "windows_desktop";
-  config_.behavior_pattern = "normal_user";
-  
-  // Basic navigator config
-  config_.navigator.enabled = true;
-  config_.navigator.user_agent = "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36";
-  config_.navigator.platform = "Win32";
-  config_.navigator.languages = {"en-US", "en"};
-  config_.navigator.hardware_concurrency = 8;
-  config_.navigator.device_memory = 8;
-  config_.navigator.hide_webdriver = true;
-  
-  // Basic canvas config
-  config_.canvas.enabled = true;
-  config_.canvas.add_noise = true;
-  config_.canvas.noise_level = 0.1;
-  config_.canvas.spoof_text_metrics = true;
-  
-  // Basic WebGL config
-  config_.webgl.enabled = true;
-  config_.webgl.vendor = "Google Inc. (Intel)";
-  config_.webgl.renderer = "ANGLE (Intel, Intel(R) UHD Graphics 620 Direct3D11 vs_5_0 ps_5_0, D3D11)";
-  config_.webgl.version = "OpenGL ES 2.0 (ANGLE 2.1.0.0)";
-  
-  // Basic screen config
-  config_.screen.enabled = true;
-  config_.screen.width = 1920;
-  config_.screen.height = 1080;
-  config_.screen.color_depth = 24;
-  config_.screen.pixel_depth = 24;
-  config_.screen.device_pixel_ratio = 1.0;
-  
-  // Basic anti-detection config
-  config_.anti_detection.enabled = true;
-  config_.anti_detection.webdriver.hide_webdriver_property = true;
-  config_.anti_detection.webdriver.hide_automation_flags = true;
-  config_.anti_detection.automation.hide_headless_flags = true;
-  
-  configured_ = false; // Will be set to true when real config is loaded
-}
-
-bool BlinkFingerprintManager::ValidateConfig(const FingerprintConfig& config) const {
+// static
+bool BlinkFingerprintManager::ValidateConfig(const FingerprintConfig& config) {
   // Basic validation
   if (config.profile_name.empty()) {
     return false;
   }
   
+  // Nothing of a disabled config is applied, so its sections need not be
+  // usable; rejecting it would leave the previous profile in effect.
+  if (!config.enabled) {
+    return true;
+  }
+  
   if (config.navigator.enabled && config.navigator.user_agent.empty()) {
     return false;
   }
@@ -449,13 +504,7 @@ bool BlinkFingerprintManager::ValidateConfig(const FingerprintConfig& config) co
 }
 
 uint32_t BlinkFingerprintManager::GenerateSeed() const {
-  if (!frame_) {
-    return 12345;
-  }
-  
-  std::hash<std::string> hasher;
-  std::string frame_id = base::StringPrintf("frame_%p", frame_.Get());
-  return static_cast<uint32_t>(hasher(frame_id));
+  return SeedService::Fold32(GetSeed(SeedSurface::kFrame));
 }
 
 WTF::String BlinkFingerprintManager::GenerateConsistentValue(
@@ -474,15 +523,6 @@ WTF::String BlinkFingerprintManager::GenerateConsistentValue(
   return WTF::String::FromUTF8(result.c_str());
 }
 
-void BlinkFingerprintManager::ClearCache() const {
-  cached_user_agent_ = WTF::String();
-  cached_platform_ = WTF::String();
-  cached_languages_.clear();
-  cached_webgl_extensions_.clear();
-  cached_fonts_.clear();
-  cache_valid_ = false;
-}
-
 // JSInjectionManager implementation
 // static
 void JSInjectionManager::InjectAntiDetectionScripts(blink::LocalFrame* frame) {
@@ -490,6 +530,7 @@ void JSInjectionManager::InjectAntiDetectionScripts(blink::LocalFrame* frame) {
     return;
   }
   
+  InjectCustomScript(frame, WTF::String(kWebDriverOverrideTemplate));
   WTF::String script = GenerateAntiDetectionScript();
   InjectCustomScript(frame, script);
 }
@@ -550,6 +591,10 @@ void JSInjectionManager::InjectCustomScript(blink::LocalFrame* frame,
     return;
   }
   
+  TRACE_EVENT(NOVEBROWSE_TRACE_CATEGORY, "JSInjectionManager::InjectCustomScript",
+              "length", script.length());
+  ScopedProtectionTimer timer(ProtectionSurface::kScriptInjection, window);
+  
   blink::ClassicScript* classic_script = blink::ClassicScript::Create(
       script, blink::ScriptSourceLocationType::kInternal);
   
@@ -558,6 +603,82 @@ void JSInjectionManager::InjectCustomScript(blink::LocalFrame* frame,
   }
 }
 
+// static
+void JSInjectionManager::InjectProtectionBundle(blink::LocalFrame* frame,
+                                                const FingerprintConfig& config) {
+  if (!frame || !config.enabled) {
+    return;
+  }
+  
+  TRACE_EVENT(NOVEBROWSE_TRACE_CATEGORY, "JSInjectionManager::InjectProtectionBundle");
+  ScopedProtectionTimer timer(ProtectionSurface::kScriptInjection,
+                              frame->DomWindow());
+  
+  ProtectionScriptBundle& bundle =
+      ProtectionScriptBundleCache::GetInstance().GetOrCreate(
+          config.GetStructuralHash(), [&config] {
+            WTF::StringBuilder builder;
+            for (const WTF::String& script : GenerateProtectionScripts(config)) {
+              // Each piece gets its own try block, so one that throws (e.g.
+              // touching WebGL2RenderingContext with WebGL2 disabled) skips
+              // only itself, as it did when every piece ran on its own. The
+              // newline ends a trailing line comment before the brace.
+              builder.Append("try{\n");
+              builder.Append(script);
+              builder.Append("\n}catch(e){}\n");
+            }
+            return builder.ToString();
+          });
+  if (bundle.RunInFrame(frame)) {
+    return;
+  }
+  
+  // The combined script failed to compile, most likely because of a broken
+  // custom injection. Fall back to running the pieces one by one so the
+  // built-in protections still apply.
+  if (bundle.compile_failed()) {
+    for (const WTF::String& script : GenerateProtectionScripts(config)) {
+      InjectCustomScript(frame, script);
+    }
+  }
+}
+
+// static
+WTF::Vector<WTF::String> JSInjectionManager::GenerateProtectionScripts(
+    const FingerprintConfig& config) {
+  // In native mode the canvas, WebGL and navigator surfaces (including
+  // navigator.webdriver) are spoofed by the binding hooks in the core patch,
+  // so only what has no native hook is injected.
+  bool native = config.anti_detection.mode == mojom::SpoofingMode::kNative;
+  
+  WTF::Vector<WTF::String> scripts;
+  if (config.anti_detection.enabled) {
+    if (!native) {
+      scripts.push_back(WTF::String(kWebDriverOverrideTemplate));
+    }
+    scripts.push_back(GenerateAntiDetectionScript());
+  }
+  if (!native && config.canvas.enabled) {
+    scripts.push_back(GenerateCanvasProtectionScript(config.canvas));
+  }
+  if (!native && config.webgl.enabled) {
+    scripts.push_back(GenerateWebGLProtectionScript(config.webgl));
+  }
+  if (!native && config.navigator.enabled) {
+    scripts.push_back(GenerateNavigatorSpoofingScript(config.navigator));
+  }
+  if (config.webrtc.enabled) {
+    scripts.push_back(GenerateWebRTCProtectionScript(config.webrtc));
+  }
+  for (const auto& injection : config.custom_js_injections) {
+    if (!injection.empty()) {
+      scripts.push_back(WTF::String::FromUTF8(injection.c_str()));
+    }
+  }
+  
+  return scripts;
+}
+
 // static
 WTF::String JSInjectionManager::GenerateAntiDetectionScript() {
   return WTF::String(kAntiDetectionTemplate);
@@ -596,7 +717,7 @@ WTF::String JSInjectionManager::GenerateWebRTCProtectionScript(const WebRTCConfi
 }
 
 // Script templates
-const char JSInjectionManager::kAntiDetectionTemplate[] = R"(
+const char JSInjectionManager::kWebDriverOverrideTemplate[] = R"(
 (function() {
   'use strict';
   
@@ -605,6 +726,12 @@ const char JSInjectionManager::kAntiDetectionTemplate[] = R"(
     get: () => undefined,
     configurable: true
   });
+})();
+)";
+
+const char JSInjectionManager::kAntiDetectionTemplate[] = R"(
+(function() {
+  'use strict';
   
   // Remove automation indicators
   delete window.cdc_adoQpoasnfa76pfcZLmcfl_Array;
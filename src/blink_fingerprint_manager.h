@@ -1,9 +1,13 @@
 #ifndef NOVEBROWSE_BLINK_FINGERPRINT_MANAGER_H_
 #define NOVEBROWSE_BLINK_FINGERPRINT_MANAGER_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
 #include <memory>
-#include <string>
-#include <unordered_map>
+#include <vector>
 
 #include "third_party/blink/renderer/core/frame/local_frame.h"
 #include "third_party/blink/renderer/platform/heap/garbage_collected.h"
@@ -11,10 +15,48 @@
 #include "third_party/blink/renderer/platform/supplementable.h"
 #include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
 #include "third_party/blink/renderer/platform/wtf/vector.h"
+#include "base/memory/scoped_refptr.h"
 #include "novebrowse/fingerprint_config.h"
+#include "novebrowse/seed_service.h"
+#include "novebrowse/spoof_record.h"
+
+namespace blink {
+class LocalDOMWindow;
+class WebLocalFrame;
+}
 
 namespace novebrowse {
 
+// 被伪造的操作，用作BlinkFingerprintManager操作计数的下标
+enum class SpoofedOperation : uint8_t {
+  kNavigatorUserAgent,
+  kNavigatorPlatform,
+  kNavigatorLanguages,
+  kNavigatorHardwareConcurrency,
+  kNavigatorDeviceMemory,
+  kNavigatorWebDriver,
+  kScreenWidth,
+  kScreenHeight,
+  kScreenColorDepth,
+  kScreenPixelDepth,
+  kScreenDevicePixelRatio,
+  kTimezone,
+  kTimezoneOffset,
+  kGeolocationLatitude,
+  kGeolocationLongitude,
+  kGeolocationAccuracy,
+  kWebGLVendor,
+  kWebGLRenderer,
+  kWebGLVersion,
+  kWebGLExtensions,
+  kAudioSampleRate,
+  kFontEnumeration,
+  kWebRTCFakeIP,
+};
+
+inline constexpr size_t kSpoofedOperationCount =
+    static_cast<size_t>(SpoofedOperation::kWebRTCFakeIP) + 1;
+
 // Blink层指纹管理器 - 负责在渲染器进程中管理指纹伪造
 class BlinkFingerprintManager final 
     : public blink::GarbageCollected<BlinkFingerprintManager>,
@@ -22,9 +64,15 @@ class BlinkFingerprintManager final
  public:
   static const char kSupplementName[];
   
-  // 获取Frame对应的指纹管理器
+  // 获取Frame对应的指纹管理器（不存在时创建）
   static BlinkFingerprintManager* FromFrame(blink::LocalFrame* frame);
   
+  // content层只有WebLocalFrame，经此取得对应LocalFrame的管理器（不存在时创建）
+  static BlinkFingerprintManager* FromWebFrame(blink::WebLocalFrame* web_frame);
+  
+  // 只返回已配置的管理器，不会创建 - 供绑定层的热路径使用
+  static BlinkFingerprintManager* FromFrameIfConfigured(blink::LocalFrame* frame);
+  
   // 创建指纹管理器
   static BlinkFingerprintManager* Create(blink::LocalFrame* frame);
   
@@ -34,10 +82,18 @@ class BlinkFingerprintManager final
   // 更新指纹配置
   void UpdateConfig(const FingerprintConfig& config);
   
+  // 应用浏览器发来的配置更新；只带哈希而本进程已没有该配置，或完整配置未通过
+  // 验证时返回false，浏览器据此不再只发送该哈希
+  bool ApplyConfigUpdate(const mojom::FingerprintConfigUpdate& update);
+  
+  // 预先缓存浏览器推送的配置池配置（进程级），之后切换到这些配置只需哈希
+  static void PrimeConfigs(
+      const std::vector<mojom::FingerprintConfigUpdatePtr>& updates);
+  
   // Navigator属性伪造
-  WTF::String GetSpoofedUserAgent() const;
-  WTF::String GetSpoofedPlatform() const;
-  WTF::Vector<WTF::String> GetSpoofedLanguages() const;
+  const WTF::String& GetSpoofedUserAgent() const;
+  const WTF::String& GetSpoofedPlatform() const;
+  const WTF::Vector<WTF::String>& GetSpoofedLanguages() const;
   int GetSpoofedHardwareConcurrency() const;
   uint64_t GetSpoofedDeviceMemory() const;
   bool ShouldHideWebDriver() const;
@@ -50,7 +106,7 @@ class BlinkFingerprintManager final
   double GetSpoofedDevicePixelRatio() const;
   
   // 时区伪造
-  WTF::String GetSpoofedTimezone() const;
+  const WTF::String& GetSpoofedTimezone() const;
   int GetSpoofedTimezoneOffset() const;
   
   // 地理位置伪造
@@ -66,49 +122,64 @@ class BlinkFingerprintManager final
   
   // WebGL保护
   bool ShouldProtectWebGL() const;
-  WTF::String GetSpoofedWebGLVendor() const;
-  WTF::String GetSpoofedWebGLRenderer() const;
-  WTF::String GetSpoofedWebGLVersion() const;
-  WTF::Vector<WTF::String> GetSpoofedWebGLExtensions() const;
+  const WTF::String& GetSpoofedWebGLVendor() const;
+  const WTF::String& GetSpoofedWebGLRenderer() const;
+  const WTF::String& GetSpoofedWebGLVersion() const;
+  const WTF::Vector<WTF::String>& GetSpoofedWebGLExtensions() const;
   
   // 音频保护
   bool ShouldProtectAudio() const;
   double GetAudioNoiseLevel() const;
+  bool ShouldProtectAnalyserNode() const;
+  bool ShouldProtectOfflineAudio() const;
   int GetSpoofedSampleRate() const;
   
   // 字体保护
   bool ShouldProtectFonts() const;
-  WTF::Vector<WTF::String> GetSpoofedAvailableFonts() const;
-  bool ShouldSpoofFontMetrics() const;
+  const WTF::Vector<WTF::String>& GetSpoofedAvailableFonts() const;
+  // 字体匹配时的白名单检查，一次哈希查找；未限制时总是返回true
+  bool IsFontFamilyAllowed(const WTF::AtomicString& family) const;
   
   // WebRTC保护
   bool ShouldProtectWebRTC() const;
   bool ShouldMaskLocalIPs() const;
-  WTF::String GetFakePublicIP() const;
+  const WTF::String& GetFakePublicIP() const;
   
   // 反检测功能
   bool ShouldHideAutomationFlags() const;
   bool ShouldSpoofChromeRuntime() const;
+  bool UsesNativeSpoofing() const;  // anti_detection.mode == native
   bool ShouldBlockDetectionScripts() const;
-  WTF::Vector<WTF::String> GetBlockedScriptPatterns() const;
-  
-  // 配置状态
-  bool IsConfigured() const { return configured_; }
-  const FingerprintConfig& GetConfig() const { return config_; }
-  
-  // 统计信息
-  void IncrementOperationCount(const WTF::String& operation);
-  int GetOperationCount(const WTF::String& operation) const;
+  // 编译好的检测脚本特征，未启用拦截时返回nullptr
+  scoped_refptr<const ScriptPatternMatcher> GetScriptPatternMatcher() const;
+  
+  // 噪声种子 - 由当前配置和文档源派生，源或配置不变时直接返回缓存值
+  uint64_t GetSeed(SeedSurface surface) const;
+  // 当前配置的配置种子（未配置时取内置默认配置），也交给本文档创建的Worker
+  uint64_t GetProfileSeed() const;
+  
+  // 配置状态 - 未配置时GetConfig()和GetRecord()返回内置默认配置
+  bool IsConfigured() const { return !!record_; }
+  const FingerprintConfig& GetConfig() const;
+  scoped_refptr<const SpoofRecord> GetRecord() const;
+  
+  // 向当前文档注入保护脚本包，每个文档只注入一次 - 由主世界窗口对象清除的
+  // 钩子调用，文档提交后才到达的首个配置也会补注入
+  void InjectProtectionBundleOnce();
+  
+  // 统计信息 - 每种操作一个固定计数槽
+  void IncrementOperationCount(SpoofedOperation operation) const {
+    operation_counts_[static_cast<size_t>(operation)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+  int GetOperationCount(SpoofedOperation operation) const;
   
   // Garbage collection
   void Trace(blink::Visitor* visitor) const override;
   
  private:
-  // 初始化默认配置
-  void InitializeDefaultConfig();
-  
   // 验证配置
-  bool ValidateConfig(const FingerprintConfig& config) const;
+  static bool ValidateConfig(const FingerprintConfig& config);
   
   // 生成确定性值
   uint32_t GenerateSeed() const;
@@ -116,22 +187,19 @@ class BlinkFingerprintManager final
   
   // 成员变量
   blink::Member<blink::LocalFrame> frame_;
-  FingerprintConfig config_;
-  bool configured_ = false;
+  
+  // 当前配置的预计算伪造值，未配置时为空
+  scoped_refptr<const SpoofRecord> record_;
+  
+  // 已注入保护脚本包的文档窗口
+  blink::WeakMember<blink::LocalDOMWindow> bundle_window_;
+  
+  // 按(配置种子, 源)缓存的各表面种子
+  mutable SeedService seeds_;
   
   // 操作统计
-  mutable std::unordered_map<std::string, int> operation_counts_;
-  
-  // 缓存的伪造值
-  mutable WTF::String cached_user_agent_;
-  mutable WTF::String cached_platform_;
-  mutable WTF::Vector<WTF::String> cached_languages_;
-  mutable WTF::Vector<WTF::String> cached_webgl_extensions_;
-  mutable WTF::Vector<WTF::String> cached_fonts_;
-  mutable bool cache_valid_ = false;
-  
-  // 清除缓存
-  void ClearCache() const;
+  mutable std::array<std::atomic<uint32_t>, kSpoofedOperationCount>
+      operation_counts_ = {};
 };
 
 // JavaScript注入管理器
@@ -155,8 +223,15 @@ class JSInjectionManager {
   // 注入自定义脚本
   static void InjectCustomScript(blink::LocalFrame* frame, const WTF::String& script);
   
+  // 注入整份配置的保护脚本包 - 同一配置哈希在进程内只编译一次；
+  // 经BlinkFingerprintManager::InjectProtectionBundleOnce在页面脚本前运行
+  static void InjectProtectionBundle(blink::LocalFrame* frame,
+                                     const FingerprintConfig& config);
+  
  private:
   // 生成脚本内容
+  static WTF::Vector<WTF::String> GenerateProtectionScripts(
+      const FingerprintConfig& config);
   static WTF::String GenerateAntiDetectionScript();
   static WTF::String GenerateCanvasProtectionScript(const CanvasConfig& config);
   static WTF::String GenerateWebGLProtectionScript(const WebGLConfig& config);
@@ -164,6 +239,7 @@ class JSInjectionManager {
   static WTF::String GenerateWebRTCProtectionScript(const WebRTCConfig& config);
   
   // 脚本模板
+  static const char kWebDriverOverrideTemplate[];
   static const char kAntiDetectionTemplate[];
   static const char kCanvasProtectionTemplate[];
   static const char kWebGLProtectionTemplate[];
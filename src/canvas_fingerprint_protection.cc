@@ -1,21 +1,103 @@
 #include "novebrowse/canvas_fingerprint_protection.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
-#include <random>
 
+#include "base/functional/bind.h"
 #include "base/logging.h"
-#include "base/strings/stringprintf.h"
+#include "base/task/post_job.h"
+#include "base/task/task_traits.h"
+#include "base/time/time.h"
+#include "novebrowse/blink_fingerprint_manager.h"
+#include "novebrowse/canvas_host_data.h"
+#include "novebrowse/canvas_noise_kernel.h"
 #include "novebrowse/fingerprint_manager.h"
+#include "novebrowse/fingerprint_telemetry_reporter.h"
+#include "novebrowse/fingerprint_trace.h"
+#include "novebrowse/seed_service.h"
+#include "third_party/blink/renderer/core/frame/local_dom_window.h"
+#include "third_party/blink/renderer/platform/graphics/image_data_buffer.h"
+#include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
 #include "third_party/skia/include/core/SkPixmap.h"
 
 namespace novebrowse {
 
-// Static member definitions
-std::unordered_map<std::string, CanvasFingerprintDetector::CanvasUsageStats> 
-    CanvasFingerprintDetector::canvas_stats_;
-base::Lock CanvasFingerprintDetector::stats_lock_;
+namespace {
+
+void ApplyNoiseToRows(const CanvasPixelRegion& region,
+                      uint32_t seed,
+                      int amplitude,
+                      int first_row,
+                      int end_row) {
+  for (int row = first_row; row < end_row; ++row) {
+    CanvasNoiseKernel::ApplyToRow(region.pixels + row * region.row_bytes,
+                                  region.width, region.origin_x,
+                                  region.origin_y + row, seed, amplitude);
+  }
+}
+
+// Hands out bands of rows to thread pool workers. The job is joined before
+// ProcessPixelData returns, so it may point at the caller's pixels.
+class TiledNoiseJob {
+ public:
+  TiledNoiseJob(const CanvasPixelRegion& region,
+                uint32_t seed,
+                int amplitude,
+                int tile_rows,
+                int max_threads)
+      : region_(region),
+        seed_(seed),
+        amplitude_(amplitude),
+        tile_rows_(tile_rows),
+        tile_count_((region.height + tile_rows - 1) / tile_rows),
+        max_threads_(static_cast<size_t>(max_threads)) {}
+  
+  TiledNoiseJob(const TiledNoiseJob&) = delete;
+  TiledNoiseJob& operator=(const TiledNoiseJob&) = delete;
+  
+  void Run(base::JobDelegate* delegate) {
+    while (!delegate->ShouldYield()) {
+      int tile = next_tile_.fetch_add(1, std::memory_order_relaxed);
+      if (tile >= tile_count_) {
+        return;
+      }
+      
+      int first_row = tile * tile_rows_;
+      int end_row = std::min(first_row + tile_rows_, region_.height);
+      ApplyNoiseToRows(region_, seed_, amplitude_, first_row, end_row);
+    }
+  }
+  
+  size_t GetMaxConcurrency(size_t worker_count) const {
+    int claimed = std::min(next_tile_.load(std::memory_order_relaxed), tile_count_);
+    size_t remaining = static_cast<size_t>(tile_count_ - claimed);
+    return std::min(remaining, max_threads_);
+  }
+  
+ private:
+  const CanvasPixelRegion region_;
+  const uint32_t seed_;
+  const int amplitude_;
+  const int tile_rows_;
+  const int tile_count_;
+  const size_t max_threads_;
+  std::atomic<int> next_tile_{0};
+};
+
+// Counts a spoofed read locally and queues it for the browser's per-site
+// telemetry.
+void RecordSpoofedOperation(blink::CanvasRenderingContextHost* host,
+                            CanvasOperation operation) {
+  INCREMENT_FINGERPRINT_STAT(kCanvasOperationsSpoofed);
+  FingerprintTelemetryReporter::Record(host->GetTopExecutionContext(),
+                                       FingerprintStat::kCanvasOperationsSpoofed,
+                                       static_cast<uint16_t>(operation));
+}
+
+}  // namespace
 
 // static
 bool CanvasFingerprintProtection::IsEnabled() {
@@ -25,18 +107,26 @@ bool CanvasFingerprintProtection::IsEnabled() {
 // static
 blink::ImageData* CanvasFingerprintProtection::ProcessImageData(
     blink::ImageData* original_data,
-    blink::CanvasRenderingContextHost* host) {
+    blink::CanvasRenderingContextHost* host,
+    const gfx::Point& source_origin) {
   if (!IsEnabled() || !original_data || !host) {
     return original_data;
   }
   
-  CanvasConfig config = GetConfigForHost(host);
+  TRACE_EVENT(NOVEBROWSE_TRACE_CATEGORY, "CanvasFingerprintProtection::ProcessImageData",
+              "width", original_data->width(), "height", original_data->height());
+  ScopedProtectionTimer timer(ProtectionSurface::kCanvasImageData,
+                              host->GetTopExecutionContext());
+  
+  scoped_refptr<const FingerprintConfigSnapshot> snapshot = GetConfigForHost(host);
+  const CanvasConfig& config = snapshot->canvas;
   if (!config.enabled || !config.protect_image_data) {
     return original_data;
   }
   
   // Record operation for detection
-  CanvasFingerprintDetector::RecordCanvasOperation(host, "getImageData", "");
+  CanvasFingerprintDetector::RecordCanvasOperation(
+      host, CanvasOperation::kGetImageData);
   
   // Generate noise seed based on host
   uint32_t seed = GenerateNoiseSeed(host);
@@ -44,101 +134,213 @@ blink::ImageData* CanvasFingerprintProtection::ProcessImageData(
   // Apply noise to image data
   blink::DOMUint8ClampedArray* data_array = original_data->data();
   if (data_array && config.add_noise) {
-    uint8_t* pixel_data = data_array->Data();
-    size_t data_length = data_array->length();
+    CanvasPixelRegion region;
+    region.pixels = data_array->Data();
+    region.width = original_data->width();
+    region.height = original_data->height();
+    region.row_bytes = static_cast<size_t>(region.width) * 4;
+    region.origin_x = source_origin.x();
+    region.origin_y = source_origin.y();
     
-    ProcessPixelData(pixel_data, data_length, config);
+    size_t region_bytes = region.row_bytes * region.height;
+    if (region_bytes <= data_array->length()) {
+      CanvasHostData& host_data = host->NoveBrowseData();
+      CanvasNoiseCache& cache = host_data.noise_cache;
+      cache.SetMemoryLimit(static_cast<size_t>(config.cache_memory_limit_kb) * 1024);
+      
+      CanvasNoiseCache::ImageDataKey key;
+      key.generation = host_data.content_generation;
+      key.seed = seed;
+      key.noise_level = config.noise_level;
+      key.canvas_width = host->Size().width();
+      key.canvas_height = host->Size().height();
+      key.x = region.origin_x;
+      key.y = region.origin_y;
+      key.width = region.width;
+      key.height = region.height;
+      key.color_space = static_cast<int>(original_data->GetPredefinedColorSpace());
+      key.storage_format =
+          static_cast<int>(original_data->GetImageDataStorageFormat());
+      
+      // An unchanged canvas reads back the same pixels, so the noised
+      // result of the previous read can be reused as is.
+      base::span<const uint8_t> cached = cache.FindImageData(key);
+      if (cached.size() == region_bytes) {
+        std::copy(cached.begin(), cached.end(), region.pixels);
+      } else {
+        ProcessPixelData(region, seed, config);
+        cache.StoreImageData(key, base::make_span(region.pixels, region_bytes));
+      }
+    }
   }
   
-  INCREMENT_FINGERPRINT_STAT("canvas_operations_spoofed");
+  RecordSpoofedOperation(host, CanvasOperation::kGetImageData);
   return original_data;
 }
 
 // static
 WTF::String CanvasFingerprintProtection::ProcessDataURL(
-    const WTF::String& original_url,
-    blink::CanvasRenderingContextHost* host) {
+    blink::CanvasRenderingContextHost* host,
+    blink::ImageEncodingMimeType mime_type,
+    double quality,
+    base::FunctionRef<scoped_refptr<blink::StaticBitmapImage>()> snapshot) {
   if (!IsEnabled() || !host) {
-    return original_url;
+    return WTF::String();
   }
   
-  CanvasConfig config = GetConfigForHost(host);
+  TRACE_EVENT(NOVEBROWSE_TRACE_CATEGORY, "CanvasFingerprintProtection::ProcessDataURL");
+  ScopedProtectionTimer timer(ProtectionSurface::kCanvasDataURL,
+                              host->GetTopExecutionContext());
+  
+  scoped_refptr<const FingerprintConfigSnapshot> config_snapshot =
+      GetConfigForHost(host);
+  const CanvasConfig& config = config_snapshot->canvas;
   if (!config.enabled || !config.protect_data_url) {
-    return original_url;
+    return WTF::String();
   }
   
   // Record operation for detection
-  CanvasFingerprintDetector::RecordCanvasOperation(host, "toDataURL", "");
+  CanvasFingerprintDetector::RecordCanvasOperation(
+      host, CanvasOperation::kToDataURL);
+  
+  uint32_t seed = GenerateNoiseSeed(host);
+  CanvasHostData& host_data = host->NoveBrowseData();
+  CanvasNoiseCache& cache = host_data.noise_cache;
+  cache.SetMemoryLimit(static_cast<size_t>(config.cache_memory_limit_kb) * 1024);
+  
+  CanvasNoiseCache::DataURLKey key;
+  key.generation = host_data.content_generation;
+  key.seed = seed;
+  key.noise_level = config.add_noise ? config.noise_level : 0.0;
+  key.canvas_width = host->Size().width();
+  key.canvas_height = host->Size().height();
+  key.mime_type = static_cast<int>(mime_type);
+  key.quality = quality;
+  
+  WTF::String cached_url = cache.FindDataURL(key);
+  if (!cached_url.IsNull()) {
+    RecordSpoofedOperation(host, CanvasOperation::kToDataURL);
+    return cached_url;
+  }
+  
+  scoped_refptr<blink::StaticBitmapImage> image = snapshot();
+  if (!image) {
+    return WTF::String();
+  }
+  
+  sk_sp<SkImage> sk_image = image->PaintImageForCurrentFrame().GetSwSkImage();
+  if (!sk_image) {
+    return WTF::String();
+  }
   
-  // For data URLs, we modify the canvas before export
-  // This is handled at the canvas level, so we just record the operation
-  INCREMENT_FINGERPRINT_STAT("canvas_operations_spoofed");
-  return original_url;
+  // Read back unpremultiplied RGBA so noise lands on the exported colors
+  SkBitmap bitmap;
+  SkImageInfo info = SkImageInfo::Make(sk_image->width(), sk_image->height(),
+                                       kRGBA_8888_SkColorType,
+                                       kUnpremul_SkAlphaType);
+  if (!bitmap.tryAllocPixels(info) ||
+      !sk_image->readPixels(bitmap.pixmap(), 0, 0)) {
+    return WTF::String();
+  }
+  
+  if (config.add_noise) {
+    AddCanvasNoise(bitmap, seed, config);
+  }
+  
+  std::unique_ptr<blink::ImageDataBuffer> data_buffer =
+      blink::ImageDataBuffer::Create(bitmap.pixmap());
+  if (!data_buffer) {
+    return WTF::String();
+  }
+  
+  WTF::String data_url = data_buffer->ToDataURL(mime_type, quality);
+  cache.StoreDataURL(key, data_url);
+  
+  RecordSpoofedOperation(host, CanvasOperation::kToDataURL);
+  return data_url;
 }
 
 // static
 blink::TextMetrics* CanvasFingerprintProtection::ProcessTextMetrics(
     blink::TextMetrics* original_metrics,
-    blink::CanvasRenderingContextHost* host) {
+    blink::CanvasRenderingContextHost* host,
+    const WTF::String& text,
+    const WTF::String& font) {
   if (!IsEnabled() || !original_metrics || !host) {
     return original_metrics;
   }
   
-  CanvasConfig config = GetConfigForHost(host);
+  scoped_refptr<const FingerprintConfigSnapshot> snapshot = GetConfigForHost(host);
+  const CanvasConfig& config = snapshot->canvas;
   if (!config.enabled || !config.spoof_text_metrics) {
     return original_metrics;
   }
   
   // Record operation for detection
-  CanvasFingerprintDetector::RecordCanvasOperation(host, "measureText", "");
-  
-  // Apply slight offsets to text metrics
-  ApplyTextMetricsOffset(original_metrics, config);
-  
-  INCREMENT_FINGERPRINT_STAT("canvas_operations_spoofed");
+  CanvasFingerprintDetector::RecordCanvasOperation(
+      host, CanvasOperation::kMeasureText);
+  
+  // Measuring the same string again must give the same metrics, so the
+  // offsets come from the text itself rather than from a random source.
+  const TextMetricsOffsets& offsets =
+      host->NoveBrowseData().text_metrics_offsets.Get(
+          GetSpoofRecordForHost(host, *snapshot), GenerateNoiseSeed(host), font,
+          text);
+  ApplyTextMetricsOffset(original_metrics, offsets);
+  
+  RecordSpoofedOperation(host, CanvasOperation::kMeasureText);
   return original_metrics;
 }
 
 // static
 void CanvasFingerprintProtection::ProcessPixelData(
-    uint8_t* pixel_data,
-    size_t data_length,
+    const CanvasPixelRegion& region,
+    uint32_t seed,
     const CanvasConfig& config) {
-  if (!pixel_data || data_length == 0 || !config.add_noise) {
+  if (!region.pixels || region.width <= 0 || region.height <= 0 ||
+      region.row_bytes < static_cast<size_t>(region.width) * 4 ||
+      !config.add_noise) {
     return;
   }
   
-  // Generate deterministic noise based on pixel data hash
-  std::hash<std::string> hasher;
-  std::string data_str(reinterpret_cast<char*>(pixel_data), 
-                       std::min(data_length, size_t(1024)));
-  uint32_t seed = static_cast<uint32_t>(hasher(data_str));
-  
-  CanvasNoiseGenerator noise_generator(seed);
+  int amplitude = CanvasNoiseKernel::AmplitudeForNoiseLevel(config.noise_level);
+  if (amplitude == 0) {
+    return;
+  }
   
-  // Process pixels in RGBA format
-  for (size_t i = 0; i < data_length; i += 4) {
-    if (i + 3 < data_length) {
-      int x = (i / 4) % 1000; // Assume max width of 1000 for noise calculation
-      int y = (i / 4) / 1000;
-      
-      // Apply noise to RGB channels, leave alpha unchanged
-      pixel_data[i] = noise_generator.GeneratePixelNoise(x, y, 0, pixel_data[i], config.noise_level);
-      pixel_data[i + 1] = noise_generator.GeneratePixelNoise(x, y, 1, pixel_data[i + 1], config.noise_level);
-      pixel_data[i + 2] = noise_generator.GeneratePixelNoise(x, y, 2, pixel_data[i + 2], config.noise_level);
-      // pixel_data[i + 3] is alpha, keep unchanged
-    }
+  // Noise is addressed by absolute canvas coordinates, so a sub-rectangle
+  // read produces exactly the same pixels as the same area of a full read,
+  // and row bands can be processed in any order on any thread.
+  int64_t pixel_count = static_cast<int64_t>(region.width) * region.height;
+  if (config.parallel_max_threads > 1 && config.parallel_tile_rows > 0 &&
+      pixel_count >= config.parallel_min_pixels &&
+      region.height > config.parallel_tile_rows) {
+    TiledNoiseJob job(region, seed, amplitude, config.parallel_tile_rows,
+                      config.parallel_max_threads);
+    base::PostJob(FROM_HERE, {base::TaskPriority::USER_BLOCKING},
+                  base::BindRepeating(&TiledNoiseJob::Run, base::Unretained(&job)),
+                  base::BindRepeating(&TiledNoiseJob::GetMaxConcurrency,
+                                      base::Unretained(&job)))
+        .Join();
+    return;
   }
+  
+  ApplyNoiseToRows(region, seed, amplitude, 0, region.height);
 }
 
 // static
 void CanvasFingerprintProtection::AddCanvasNoise(
     SkBitmap& bitmap,
-    double noise_level) {
-  if (bitmap.empty() || noise_level <= 0.0) {
+    uint32_t seed,
+    const CanvasConfig& config) {
+  if (bitmap.empty() || config.noise_level <= 0.0) {
     return;
   }
   
+  // Timed as part of ProcessDataURL, its only caller on the page path.
+  TRACE_EVENT(NOVEBROWSE_TRACE_CATEGORY, "CanvasFingerprintProtection::AddCanvasNoise",
+              "width", bitmap.width(), "height", bitmap.height());
+  
   SkImageInfo info = bitmap.info();
   if (info.colorType() != kRGBA_8888_SkColorType && 
       info.colorType() != kBGRA_8888_SkColorType) {
@@ -150,32 +352,13 @@ void CanvasFingerprintProtection::AddCanvasNoise(
     return;
   }
   
-  uint8_t* pixels = static_cast<uint8_t*>(pixmap.writable_addr());
-  size_t row_bytes = pixmap.rowBytes();
-  
-  // Generate noise seed from bitmap content
-  uint32_t seed = 0;
-  for (int y = 0; y < info.height() && y < 10; ++y) {
-    for (int x = 0; x < info.width() && x < 10; ++x) {
-      uint8_t* pixel = pixels + y * row_bytes + x * info.bytesPerPixel();
-      seed ^= (pixel[0] << 24) | (pixel[1] << 16) | (pixel[2] << 8) | pixel[3];
-    }
-  }
-  
-  CanvasNoiseGenerator noise_generator(seed);
+  CanvasPixelRegion region;
+  region.pixels = static_cast<uint8_t*>(pixmap.writable_addr());
+  region.width = pixmap.width();
+  region.height = pixmap.height();
+  region.row_bytes = pixmap.rowBytes();
   
-  // Apply noise to each pixel
-  for (int y = 0; y < info.height(); ++y) {
-    for (int x = 0; x < info.width(); ++x) {
-      uint8_t* pixel = pixels + y * row_bytes + x * info.bytesPerPixel();
-      
-      // Apply noise to RGB channels
-      pixel[0] = noise_generator.GeneratePixelNoise(x, y, 0, pixel[0], noise_level);
-      pixel[1] = noise_generator.GeneratePixelNoise(x, y, 1, pixel[1], noise_level);
-      pixel[2] = noise_generator.GeneratePixelNoise(x, y, 2, pixel[2], noise_level);
-      // Keep alpha channel unchanged
-    }
-  }
+  ProcessPixelData(region, seed, config);
 }
 
 // static
@@ -185,87 +368,59 @@ uint32_t CanvasFingerprintProtection::GenerateNoiseSeed(
     return 12345; // Default seed
   }
   
-  // Generate seed based on canvas properties
-  std::string canvas_id = CalculateCanvasHash(host);
-  std::hash<std::string> hasher;
-  return static_cast<uint32_t>(hasher(canvas_id));
-}
-
-// static
-CanvasConfig CanvasFingerprintProtection::GetConfigForHost(
-    blink::CanvasRenderingContextHost* host) {
-  if (!host) {
-    return CanvasConfig{};
-  }
-  
-  // Get config from fingerprint manager
-  FingerprintConfig config = FINGERPRINT_MANAGER()->GetDefaultConfig();
-  return config.canvas;
+  // Per origin, not per canvas: the same drawing reads back the same noised
+  // pixels from every canvas of a site, as it would on real hardware.
+  return SeedService::Fold32(SeedService::ForExecutionContext(
+      host->GetTopExecutionContext(), SeedSurface::kCanvas));
 }
 
 // static
-double CanvasFingerprintProtection::GenerateNoise(uint32_t seed, int x, int y, int channel) {
-  // Simple deterministic noise function
-  uint32_t hash = seed;
-  hash ^= (x * 73856093) ^ (y * 19349663) ^ (channel * 83492791);
-  hash = ((hash >> 16) ^ hash) * 0x45d9f3b;
-  hash = ((hash >> 16) ^ hash) * 0x45d9f3b;
-  hash = (hash >> 16) ^ hash;
-  
-  return (static_cast<double>(hash % 1000) / 1000.0 - 0.5) * 2.0; // Range [-1, 1]
+scoped_refptr<const FingerprintConfigSnapshot>
+CanvasFingerprintProtection::GetConfigForHost(blink::CanvasRenderingContextHost* host) {
+  // Get config from fingerprint manager; the caller keeps the snapshot
+  // alive and reads its canvas section in place.
+  return FINGERPRINT_MANAGER()->GetDefaultConfig();
 }
 
 // static
-void CanvasFingerprintProtection::ApplyPixelNoise(
-    uint8_t* pixel,
-    uint32_t seed,
-    int x,
-    int y,
-    double noise_level) {
-  for (int channel = 0; channel < 3; ++channel) {
-    double noise = GenerateNoise(seed, x, y, channel) * noise_level * 255.0;
-    int new_value = static_cast<int>(pixel[channel]) + static_cast<int>(noise);
-    pixel[channel] = static_cast<uint8_t>(std::max(0, std::min(255, new_value)));
+scoped_refptr<const SpoofRecord> CanvasFingerprintProtection::GetSpoofRecordForHost(
+    blink::CanvasRenderingContextHost* host,
+    const FingerprintConfigSnapshot& snapshot) {
+  blink::ExecutionContext* context = host->GetTopExecutionContext();
+  if (auto* window = blink::DynamicTo<blink::LocalDOMWindow>(context)) {
+    if (blink::LocalFrame* frame = window->GetFrame()) {
+      return BlinkFingerprintManager::FromFrame(frame)->GetRecord();
+    }
+  }
+  
+  // The shared records live on the main thread, so a worker canvas compiles
+  // its own from the config it already reads and keeps it per generation.
+  CanvasHostData& host_data = host->NoveBrowseData();
+  if (!host_data.worker_record ||
+      host_data.worker_record_generation != snapshot.generation()) {
+    host_data.worker_record = base::MakeRefCounted<SpoofRecord>(snapshot);
+    host_data.worker_record_generation = snapshot.generation();
   }
+  return host_data.worker_record;
 }
 
 // static
 void CanvasFingerprintProtection::ApplyTextMetricsOffset(
     blink::TextMetrics* metrics,
-    const CanvasConfig& config) {
-  if (!metrics || !config.spoof_text_metrics) {
+    const TextMetricsOffsets& offsets) {
+  if (!metrics) {
     return;
   }
   
-  // Apply small random offsets to text metrics
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_real_distribution<double> dis(-0.5, 0.5);
-  
-  // Modify width slightly
-  double width_offset = dis(gen) * 0.1; // ±0.05 pixel offset
-  metrics->setWidth(metrics->width() + width_offset);
-  
-  // Modify other metrics with smaller offsets
-  double small_offset = dis(gen) * 0.05;
-  metrics->setActualBoundingBoxLeft(metrics->actualBoundingBoxLeft() + small_offset);
-  metrics->setActualBoundingBoxRight(metrics->actualBoundingBoxRight() + small_offset);
-  metrics->setActualBoundingBoxAscent(metrics->actualBoundingBoxAscent() + small_offset);
-  metrics->setActualBoundingBoxDescent(metrics->actualBoundingBoxDescent() + small_offset);
-}
-
-// static
-std::string CanvasFingerprintProtection::CalculateCanvasHash(
-    blink::CanvasRenderingContextHost* host) {
-  if (!host) {
-    return "null_canvas";
-  }
-  
-  // Generate a hash based on canvas properties
-  std::stringstream ss;
-  ss << "canvas_" << reinterpret_cast<uintptr_t>(host);
-  
-  return ss.str();
+  metrics->setWidth(metrics->width() + offsets.width);
+  metrics->setActualBoundingBoxLeft(metrics->actualBoundingBoxLeft() +
+                                    offsets.bounding_box_left);
+  metrics->setActualBoundingBoxRight(metrics->actualBoundingBoxRight() +
+                                     offsets.bounding_box_right);
+  metrics->setActualBoundingBoxAscent(metrics->actualBoundingBoxAscent() +
+                                      offsets.bounding_box_ascent);
+  metrics->setActualBoundingBoxDescent(metrics->actualBoundingBoxDescent() +
+                                       offsets.bounding_box_descent);
 }
 
 // CanvasNoiseGenerator implementation
@@ -274,12 +429,14 @@ CanvasNoiseGenerator::CanvasNoiseGenerator(uint32_t seed) : seed_(seed) {}
 uint8_t CanvasNoiseGenerator::GeneratePixelNoise(int x, int y, int channel, 
                                                 uint8_t original_value, 
                                                 double noise_level) {
-  if (noise_level <= 0.0) {
+  int amplitude = CanvasNoiseKernel::AmplitudeForNoiseLevel(noise_level);
+  if (amplitude == 0) {
     return original_value;
   }
   
-  double noise = PerlinNoise(x * 0.1, y * 0.1) * noise_level * 10.0;
-  int new_value = static_cast<int>(original_value) + static_cast<int>(noise);
+  uint32_t hash = CanvasNoiseKernel::HashPixel(seed_, x, y);
+  int new_value = static_cast<int>(original_value) +
+                  CanvasNoiseKernel::NoiseDelta(hash, channel, amplitude);
   return static_cast<uint8_t>(std::max(0, std::min(255, new_value)));
 }
 
@@ -288,115 +445,38 @@ double CanvasNoiseGenerator::GenerateFloatNoise(int x, int y, double noise_level
     return 0.0;
   }
   
-  return PerlinNoise(x * 0.1, y * 0.1) * noise_level;
+  uint32_t hash = CanvasNoiseKernel::HashPixel(seed_, x, y);
+  double unit = static_cast<double>(hash) / static_cast<double>(UINT32_MAX);
+  return (unit - 0.5) * 2.0 * noise_level;
 }
 
 void CanvasNoiseGenerator::SetSeed(uint32_t seed) {
   seed_ = seed;
 }
 
-uint32_t CanvasNoiseGenerator::NextRandom() {
-  seed_ = (seed_ * 1103515245 + 12345) & 0x7fffffff;
-  return seed_;
-}
-
-double CanvasNoiseGenerator::NextFloat() {
-  return static_cast<double>(NextRandom()) / static_cast<double>(0x7fffffff);
-}
-
-double CanvasNoiseGenerator::PerlinNoise(double x, double y) {
-  // Simplified Perlin noise implementation
-  int xi = static_cast<int>(x) & 255;
-  int yi = static_cast<int>(y) & 255;
-  
-  double xf = x - static_cast<int>(x);
-  double yf = y - static_cast<int>(y);
-  
-  double u = Fade(xf);
-  double v = Fade(yf);
-  
-  int aa = (xi + yi) & 255;
-  int ab = (xi + yi + 1) & 255;
-  int ba = (xi + 1 + yi) & 255;
-  int bb = (xi + 1 + yi + 1) & 255;
-  
-  double x1 = Lerp(Grad(aa, xf, yf), Grad(ba, xf - 1, yf), u);
-  double x2 = Lerp(Grad(ab, xf, yf - 1), Grad(bb, xf - 1, yf - 1), u);
-  
-  return Lerp(x1, x2, v);
-}
-
-double CanvasNoiseGenerator::Fade(double t) {
-  return t * t * t * (t * (t * 6 - 15) + 10);
-}
-
-double CanvasNoiseGenerator::Lerp(double t, double a, double b) {
-  return a + t * (b - a);
-}
-
-double CanvasNoiseGenerator::Grad(int hash, double x, double y) {
-  int h = hash & 15;
-  double u = h < 8 ? x : y;
-  double v = h < 4 ? y : h == 12 || h == 14 ? x : 0;
-  return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
-}
-
 // CanvasFingerprintDetector implementation
 // static
 bool CanvasFingerprintDetector::DetectFingerprintingAttempt(
     blink::CanvasRenderingContextHost* host,
-    const std::string& operation) {
+    CanvasOperation operation) {
   if (!host) {
     return false;
   }
   
-  RecordCanvasOperation(host, operation, "");
+  RecordCanvasOperation(host, operation);
   return AnalyzeUsagePattern(host);
 }
 
 // static
 void CanvasFingerprintDetector::RecordCanvasOperation(
     blink::CanvasRenderingContextHost* host,
-    const std::string& operation,
-    const std::string& parameters) {
+    CanvasOperation operation) {
   if (!host) {
     return;
   }
   
-  base::AutoLock auto_lock(stats_lock_);
-  
-  std::string canvas_id = base::StringPrintf("canvas_%p", host);
-  CanvasUsageStats& stats = canvas_stats_[canvas_id];
-  
-  int64_t current_time = base::Time::Now().ToInternalValue();
-  if (stats.first_operation_time == 0) {
-    stats.first_operation_time = current_time;
-  }
-  stats.last_operation_time = current_time;
-  
-  stats.operation_sequence.push_back(operation);
-  
-  // Limit sequence length to prevent memory bloat
-  if (stats.operation_sequence.size() > 100) {
-    stats.operation_sequence.erase(stats.operation_sequence.begin());
-  }
-  
-  // Categorize operations
-  if (operation == "fillRect" || operation == "strokeRect" || 
-      operation == "fillText" || operation == "strokeText" ||
-      operation == "drawImage") {
-    stats.draw_operations++;
-  } else if (operation == "getImageData" || operation == "toDataURL") {
-    stats.read_operations++;
-    if (operation == "getImageData") {
-      stats.image_data_reads++;
-    } else {
-      stats.data_url_exports++;
-    }
-  } else if (operation == "fillText" || operation == "strokeText" || 
-             operation == "measureText") {
-    stats.text_operations++;
-  }
+  int64_t now_us = (base::TimeTicks::Now() - base::TimeTicks()).InMicroseconds();
+  host->NoveBrowseData().usage_stats.Record(operation, now_us);
 }
 
 // static
@@ -406,15 +486,11 @@ bool CanvasFingerprintDetector::AnalyzeUsagePattern(
     return false;
   }
   
-  base::AutoLock auto_lock(stats_lock_);
-  
-  std::string canvas_id = base::StringPrintf("canvas_%p", host);
-  auto it = canvas_stats_.find(canvas_id);
-  if (it == canvas_stats_.end()) {
+  const CanvasUsageStats& stats = host->NoveBrowseData().usage_stats;
+  if (stats.first_operation_time() == 0) {
     return false;
   }
   
-  const CanvasUsageStats& stats = it->second;
   return IsLikelyFingerprintingPattern(stats);
 }
 
@@ -426,16 +502,18 @@ bool CanvasFingerprintDetector::IsLikelyFingerprintingPattern(
     return true;
   }
   
-  if (HasSuspiciousOperationSequence(stats.operation_sequence)) {
+  std::array<CanvasOperation, CanvasUsageStats::kSequenceCapacity> sequence;
+  size_t length = stats.CopyRecentOperations(sequence);
+  if (HasSuspiciousOperationSequence(base::span(sequence).first(length))) {
     return true;
   }
   
-  // Check for rapid canvas operations (potential automated fingerprinting)
-  if (stats.first_operation_time != 0 && stats.last_operation_time != 0) {
-    int64_t duration = stats.last_operation_time - stats.first_operation_time;
-    int total_operations = stats.draw_operations + stats.read_operations;
+  // Check for rapid canvas reads (potential automated fingerprinting). Draws
+  // are left out: any animated canvas draws more than this per second.
+  if (stats.first_operation_time() != 0 && stats.last_operation_time() != 0) {
+    int64_t duration = stats.last_operation_time() - stats.first_operation_time();
     
-    if (total_operations > 10 && duration < 1000000) { // Less than 1 second
+    if (stats.read_operations() > 10 && duration < 1000000) { // Less than 1 second
       return true;
     }
   }
@@ -445,7 +523,7 @@ bool CanvasFingerprintDetector::IsLikelyFingerprintingPattern(
 
 // static
 bool CanvasFingerprintDetector::HasSuspiciousOperationSequence(
-    const std::vector<std::string>& sequence) {
+    base::span<const CanvasOperation> sequence) {
   if (sequence.size() < 3) {
     return false;
   }
@@ -454,8 +532,9 @@ bool CanvasFingerprintDetector::HasSuspiciousOperationSequence(
   int consecutive_reads = 0;
   int total_reads = 0;
   
-  for (const auto& op : sequence) {
-    if (op == "getImageData" || op == "toDataURL") {
+  for (CanvasOperation op : sequence) {
+    if (op == CanvasOperation::kGetImageData ||
+        op == CanvasOperation::kToDataURL) {
       consecutive_reads++;
       total_reads++;
     } else {
@@ -476,11 +555,13 @@ bool CanvasFingerprintDetector::HasSuspiciousOperationSequence(
 // static
 bool CanvasFingerprintDetector::HasHighReadToWriteRatio(
     const CanvasUsageStats& stats) {
-  if (stats.draw_operations == 0) {
-    return stats.read_operations > 0; // Only reads, no draws
+  int draw_operations = stats.draw_operations();
+  int read_operations = stats.read_operations();
+  if (draw_operations == 0) {
+    return read_operations > 0; // Only reads, no draws
   }
   
-  double ratio = static_cast<double>(stats.read_operations) / stats.draw_operations;
+  double ratio = static_cast<double>(read_operations) / draw_operations;
   return ratio > 2.0; // More than 2 reads per draw operation
 }
 
@@ -3,14 +3,32 @@
 
 #include <memory>
 #include <string>
+#include "base/functional/function_ref.h"
+#include "base/memory/scoped_refptr.h"
 #include "third_party/blink/renderer/core/html/canvas/image_data.h"
 #include "third_party/blink/renderer/core/html/canvas/text_metrics.h"
 #include "third_party/blink/renderer/core/html/canvas/canvas_rendering_context_host.h"
+#include "third_party/blink/renderer/platform/graphics/static_bitmap_image.h"
+#include "third_party/blink/renderer/platform/image-encoders/image_encoder_utils.h"
 #include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/geometry/point.h"
+#include "novebrowse/canvas_usage_stats.h"
 #include "novebrowse/fingerprint_config.h"
+#include "novebrowse/spoof_record.h"
+#include "novebrowse/text_metrics_offsets.h"
 
 namespace novebrowse {
 
+// Canvas像素区域 - 描述画布中一块按行连续存放的4字节像素
+struct CanvasPixelRegion {
+  uint8_t* pixels = nullptr;  // 区域左上角像素
+  int width = 0;
+  int height = 0;
+  size_t row_bytes = 0;       // 行跨度（字节）
+  int origin_x = 0;           // 区域左上角在画布中的绝对坐标
+  int origin_y = 0;
+};
+
 // Canvas指纹保护实现类
 class CanvasFingerprintProtection {
  public:
@@ -18,62 +36,62 @@ class CanvasFingerprintProtection {
   static bool IsEnabled();
   
   // 处理ImageData - 添加噪声保护
+  // source_origin为getImageData源矩形在画布中的左上角
   static blink::ImageData* ProcessImageData(
       blink::ImageData* original_data,
-      blink::CanvasRenderingContextHost* host);
+      blink::CanvasRenderingContextHost* host,
+      const gfx::Point& source_origin);
   
-  // 处理Canvas数据URL - 添加噪声保护
+  // 处理Canvas数据URL - 对导出图像加噪后编码，结果按画布缓存
+  // snapshot仅在缓存未命中时调用；返回空字符串表示未处理，调用方应走原始路径
   static WTF::String ProcessDataURL(
-      const WTF::String& original_url,
-      blink::CanvasRenderingContextHost* host);
+      blink::CanvasRenderingContextHost* host,
+      blink::ImageEncodingMimeType mime_type,
+      double quality,
+      base::FunctionRef<scoped_refptr<blink::StaticBitmapImage>()> snapshot);
   
-  // 处理文本度量 - 添加轻微偏移
+  // 处理文本度量 - 添加由(种子, 字体, 文本)确定的轻微偏移，结果按画布缓存
   static blink::TextMetrics* ProcessTextMetrics(
       blink::TextMetrics* original_metrics,
-      blink::CanvasRenderingContextHost* host);
+      blink::CanvasRenderingContextHost* host,
+      const WTF::String& text,
+      const WTF::String& font);
   
-  // 处理Canvas像素数据
+  // 处理Canvas像素数据 - 噪声只取决于画布绝对坐标
   static void ProcessPixelData(
-      uint8_t* pixel_data,
-      size_t data_length,
+      const CanvasPixelRegion& region,
+      uint32_t seed,
       const CanvasConfig& config);
   
   // 添加Canvas噪声
   static void AddCanvasNoise(
       SkBitmap& bitmap,
-      double noise_level);
+      uint32_t seed,
+      const CanvasConfig& config);
   
-  // 生成确定性噪声种子
+  // 生成确定性噪声种子（按画布所在源，由SeedService派生）
   static uint32_t GenerateNoiseSeed(
       blink::CanvasRenderingContextHost* host);
   
-  // 获取Canvas配置
-  static CanvasConfig GetConfigForHost(
+  // 获取Canvas配置所在的快照 - 调用方持有快照并直接引用其canvas，不复制
+  static scoped_refptr<const FingerprintConfigSnapshot> GetConfigForHost(
       blink::CanvasRenderingContextHost* host);
   
- private:
-  // 内部噪声生成函数
-  static double GenerateNoise(uint32_t seed, int x, int y, int channel);
-  
-  // 应用像素级噪声
-  static void ApplyPixelNoise(
-      uint8_t* pixel,
-      uint32_t seed,
-      int x,
-      int y,
-      double noise_level);
+  // 获取画布所在文档Frame的预计算记录（未配置时为内置默认记录）；
+  // Worker中的画布按默认配置快照自建一份，快照代数变化时重建
+  static scoped_refptr<const SpoofRecord> GetSpoofRecordForHost(
+      blink::CanvasRenderingContextHost* host,
+      const FingerprintConfigSnapshot& snapshot);
   
+ private:
   // 文本度量偏移
   static void ApplyTextMetricsOffset(
       blink::TextMetrics* metrics,
-      const CanvasConfig& config);
-  
-  // 计算Canvas指纹哈希
-  static std::string CalculateCanvasHash(
-      blink::CanvasRenderingContextHost* host);
+      const TextMetricsOffsets& offsets);
 };
 
-// Canvas噪声生成器
+// Canvas噪声生成器 - 单像素接口，与CanvasNoiseKernel输出一致
+// 无内部状态推进，任意坐标、任意调用顺序得到相同结果
 class CanvasNoiseGenerator {
  public:
   explicit CanvasNoiseGenerator(uint32_t seed);
@@ -89,16 +107,6 @@ class CanvasNoiseGenerator {
   
  private:
   uint32_t seed_;
-  
-  // 伪随机数生成
-  uint32_t NextRandom();
-  double NextFloat();
-  
-  // 噪声函数
-  double PerlinNoise(double x, double y);
-  double Fade(double t);
-  double Lerp(double t, double a, double b);
-  double Grad(int hash, double x, double y);
 };
 
 // Canvas指纹检测器
@@ -107,36 +115,23 @@ class CanvasFingerprintDetector {
   // 检测Canvas指纹提取尝试
   static bool DetectFingerprintingAttempt(
       blink::CanvasRenderingContextHost* host,
-      const std::string& operation);
+      CanvasOperation operation);
   
-  // 记录Canvas操作
+  // 记录Canvas操作 - 统计保存在画布自身的CanvasHostData中。读取由保护路径记录，
+  // 绘制由补丁中宿主的DidDraw钩子（WebGL为MarkContextChanged）以kDraw记录
   static void RecordCanvasOperation(
       blink::CanvasRenderingContextHost* host,
-      const std::string& operation,
-      const std::string& parameters);
+      CanvasOperation operation);
   
   // 分析Canvas使用模式
   static bool AnalyzeUsagePattern(
       blink::CanvasRenderingContextHost* host);
   
  private:
-  struct CanvasUsageStats {
-    int draw_operations = 0;
-    int read_operations = 0;
-    int text_operations = 0;
-    int image_data_reads = 0;
-    int data_url_exports = 0;
-    std::vector<std::string> operation_sequence;
-    int64_t first_operation_time = 0;
-    int64_t last_operation_time = 0;
-  };
-  
-  static std::unordered_map<std::string, CanvasUsageStats> canvas_stats_;
-  static base::Lock stats_lock_;
-  
   // 指纹识别模式
   static bool IsLikelyFingerprintingPattern(const CanvasUsageStats& stats);
-  static bool HasSuspiciousOperationSequence(const std::vector<std::string>& sequence);
+  static bool HasSuspiciousOperationSequence(
+      base::span<const CanvasOperation> sequence);
   static bool HasHighReadToWriteRatio(const CanvasUsageStats& stats);
 };
 
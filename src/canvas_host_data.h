@@ -0,0 +1,47 @@
+#ifndef NOVEBROWSE_CANVAS_HOST_DATA_H_
+#define NOVEBROWSE_CANVAS_HOST_DATA_H_
+
+#include <stdint.h>
+
+#include "novebrowse/canvas_noise_cache.h"
+#include "novebrowse/canvas_usage_stats.h"
+#include "novebrowse/spoof_record.h"
+#include "novebrowse/text_metrics_offsets.h"
+
+namespace novebrowse {
+
+// 每个CanvasRenderingContextHost持有的指纹保护状态
+//
+// 由补丁嵌入blink::CanvasRenderingContextHost，随画布一起销毁。
+struct CanvasHostData {
+  CanvasHostData() = default;
+  CanvasHostData(const CanvasHostData&) = delete;
+  CanvasHostData& operator=(const CanvasHostData&) = delete;
+
+  // 画布内容发生变化（任何绘制调用、重置或改变尺寸）时由宿主调用；
+  // 旧的导出结果立即释放，不占用进程内共享的缓存上限
+  void DidDraw() {
+    ++content_generation;
+    noise_cache.Clear();
+  }
+
+  // 内容代数 - 每次绘制、重置或改变尺寸时递增
+  uint64_t content_generation = 0;
+
+  // 已加噪的导出结果
+  CanvasNoiseCache noise_cache;
+  
+  // 指纹检测用的使用统计
+  CanvasUsageStats usage_stats;
+  
+  // measureText的偏移，与内容代数无关
+  TextMetricsOffsetCache text_metrics_offsets;
+  
+  // Worker中的画布自建的预计算记录及其所属的默认配置代数；文档中的画布不使用
+  scoped_refptr<const SpoofRecord> worker_record;
+  uint64_t worker_record_generation = 0;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_CANVAS_HOST_DATA_H_
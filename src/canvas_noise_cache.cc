@@ -0,0 +1,204 @@
+#include "novebrowse/canvas_noise_cache.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace novebrowse {
+
+namespace {
+
+// Matches the CanvasConfig default so a cache that was never configured
+// behaves like one that was. Large enough for a 4K getImageData result.
+constexpr size_t kDefaultMemoryLimitBytes = 64 * 1024 * 1024;
+
+// Bytes held by every cache in the process. Caches on the main thread and
+// on workers check it before storing; two concurrent stores may overshoot
+// the limit by at most one entry each.
+std::atomic<size_t> g_process_memory_usage{0};
+
+}  // namespace
+
+bool CanvasNoiseCache::ImageDataKey::operator==(const ImageDataKey& other) const {
+  return generation == other.generation && seed == other.seed &&
+         noise_level == other.noise_level && canvas_width == other.canvas_width &&
+         canvas_height == other.canvas_height && x == other.x && y == other.y &&
+         width == other.width && height == other.height &&
+         color_space == other.color_space &&
+         storage_format == other.storage_format;
+}
+
+bool CanvasNoiseCache::DataURLKey::operator==(const DataURLKey& other) const {
+  return generation == other.generation && seed == other.seed &&
+         noise_level == other.noise_level && canvas_width == other.canvas_width &&
+         canvas_height == other.canvas_height && mime_type == other.mime_type &&
+         quality == other.quality;
+}
+
+CanvasNoiseCache::CanvasNoiseCache() : memory_limit_(kDefaultMemoryLimitBytes) {}
+
+CanvasNoiseCache::~CanvasNoiseCache() {
+  Clear();
+}
+
+// static
+size_t CanvasNoiseCache::process_memory_usage() {
+  return g_process_memory_usage.load(std::memory_order_relaxed);
+}
+
+void CanvasNoiseCache::SetMemoryLimit(size_t limit_bytes) {
+  if (limit_bytes == memory_limit_) {
+    return;
+  }
+
+  memory_limit_ = limit_bytes;
+  MakeRoom(0);
+}
+
+base::span<const uint8_t> CanvasNoiseCache::FindImageData(const ImageDataKey& key) {
+  DropStaleEntries(key.generation);
+
+  for (auto& entry : image_data_entries_) {
+    if (entry.key == key) {
+      entry.last_use = ++use_counter_;
+      return entry.pixels;
+    }
+  }
+
+  return {};
+}
+
+void CanvasNoiseCache::StoreImageData(const ImageDataKey& key,
+                                      base::span<const uint8_t> pixels) {
+  if (pixels.empty()) {
+    return;
+  }
+
+  DropStaleEntries(key.generation);
+  if (!MakeRoom(pixels.size())) {
+    return;
+  }
+
+  ImageDataEntry entry;
+  entry.key = key;
+  entry.pixels.assign(pixels.begin(), pixels.end());
+  entry.last_use = ++use_counter_;
+  AddUsage(entry.pixels.size());
+  image_data_entries_.push_back(std::move(entry));
+}
+
+WTF::String CanvasNoiseCache::FindDataURL(const DataURLKey& key) {
+  DropStaleEntries(key.generation);
+
+  for (auto& entry : data_url_entries_) {
+    if (entry.key == key) {
+      entry.last_use = ++use_counter_;
+      return entry.data_url;
+    }
+  }
+
+  return WTF::String();
+}
+
+void CanvasNoiseCache::StoreDataURL(const DataURLKey& key,
+                                    const WTF::String& data_url) {
+  if (data_url.IsEmpty()) {
+    return;
+  }
+
+  DropStaleEntries(key.generation);
+  size_t bytes = DataURLBytes(data_url);
+  if (!MakeRoom(bytes)) {
+    return;
+  }
+
+  DataURLEntry entry;
+  entry.key = key;
+  entry.data_url = data_url;
+  entry.last_use = ++use_counter_;
+  AddUsage(bytes);
+  data_url_entries_.push_back(std::move(entry));
+}
+
+void CanvasNoiseCache::Clear() {
+  image_data_entries_.clear();
+  data_url_entries_.clear();
+  RemoveUsage(memory_usage_);
+}
+
+void CanvasNoiseCache::DropStaleEntries(uint64_t generation) {
+  // All entries share one generation: any draw invalidates everything.
+  if (!image_data_entries_.empty() &&
+      image_data_entries_.front().key.generation != generation) {
+    Clear();
+    return;
+  }
+
+  if (!data_url_entries_.empty() &&
+      data_url_entries_.front().key.generation != generation) {
+    Clear();
+  }
+}
+
+bool CanvasNoiseCache::MakeRoom(size_t incoming_bytes) {
+  if (incoming_bytes > memory_limit_) {
+    return false;
+  }
+
+  // Only this cache's own entries can be evicted; the others belong to
+  // canvases that may live on other threads.
+  while (process_memory_usage() + incoming_bytes > memory_limit_) {
+    if (!EvictOldest()) {
+      break;
+    }
+  }
+
+  return process_memory_usage() + incoming_bytes <= memory_limit_;
+}
+
+bool CanvasNoiseCache::EvictOldest() {
+  auto oldest_image = std::min_element(
+      image_data_entries_.begin(), image_data_entries_.end(),
+      [](const ImageDataEntry& a, const ImageDataEntry& b) {
+        return a.last_use < b.last_use;
+      });
+  auto oldest_url = std::min_element(
+      data_url_entries_.begin(), data_url_entries_.end(),
+      [](const DataURLEntry& a, const DataURLEntry& b) {
+        return a.last_use < b.last_use;
+      });
+
+  bool has_image = oldest_image != image_data_entries_.end();
+  bool has_url = oldest_url != data_url_entries_.end();
+  if (!has_image && !has_url) {
+    return false;
+  }
+
+  if (has_image && (!has_url || oldest_image->last_use < oldest_url->last_use)) {
+    RemoveUsage(oldest_image->pixels.size());
+    image_data_entries_.erase(oldest_image);
+  } else {
+    RemoveUsage(DataURLBytes(oldest_url->data_url));
+    data_url_entries_.erase(oldest_url);
+  }
+  return true;
+}
+
+void CanvasNoiseCache::AddUsage(size_t bytes) {
+  memory_usage_ += bytes;
+  g_process_memory_usage.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void CanvasNoiseCache::RemoveUsage(size_t bytes) {
+  if (bytes == 0) {
+    return;
+  }
+  memory_usage_ -= bytes;
+  g_process_memory_usage.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+// static
+size_t CanvasNoiseCache::DataURLBytes(const WTF::String& data_url) {
+  return data_url.CharactersSizeInBytes();
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,116 @@
+#ifndef NOVEBROWSE_CANVAS_NOISE_CACHE_H_
+#define NOVEBROWSE_CANVAS_NOISE_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/containers/span.h"
+#include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
+
+namespace novebrowse {
+
+// Canvas噪声结果缓存 - 每个画布一份，保存已加噪的像素和已编码的数据URL
+//
+// 缓存项以内容代数、画布尺寸和噪声种子为键，画布任何绘制、重置或改变尺寸
+// 都会使内容代数递增，从而使旧的缓存项失效。只在画布所属线程上访问，
+// 不需要加锁；内存上限由进程内所有画布共享，用原子计数汇总。
+class CanvasNoiseCache {
+ public:
+  // getImageData结果的缓存键
+  struct ImageDataKey {
+    uint64_t generation = 0;
+    uint32_t seed = 0;
+    double noise_level = 0.0;
+    int canvas_width = 0;
+    int canvas_height = 0;
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    // getImageData的ImageDataSettings：同一区域按不同色彩空间或存储格式
+    // 读回的像素不同
+    int color_space = 0;
+    int storage_format = 0;
+
+    bool operator==(const ImageDataKey& other) const;
+  };
+
+  // toDataURL结果的缓存键
+  struct DataURLKey {
+    uint64_t generation = 0;
+    uint32_t seed = 0;
+    double noise_level = 0.0;
+    int canvas_width = 0;
+    int canvas_height = 0;
+    int mime_type = 0;
+    double quality = 0.0;
+
+    bool operator==(const DataURLKey& other) const;
+  };
+
+  CanvasNoiseCache();
+  ~CanvasNoiseCache();
+
+  CanvasNoiseCache(const CanvasNoiseCache&) = delete;
+  CanvasNoiseCache& operator=(const CanvasNoiseCache&) = delete;
+
+  // 设置进程内共享的内存上限（字节），超出时淘汰本缓存最近最少使用的项；
+  // 其余画布占满上限时新结果不缓存
+  void SetMemoryLimit(size_t limit_bytes);
+  size_t memory_limit() const { return memory_limit_; }
+  size_t memory_usage() const { return memory_usage_; }
+
+  // 进程内全部画布缓存占用的字节数
+  static size_t process_memory_usage();
+
+  // 查找已加噪的像素，未命中返回空span
+  base::span<const uint8_t> FindImageData(const ImageDataKey& key);
+  void StoreImageData(const ImageDataKey& key, base::span<const uint8_t> pixels);
+
+  // 查找已编码的数据URL，未命中返回空字符串
+  WTF::String FindDataURL(const DataURLKey& key);
+  void StoreDataURL(const DataURLKey& key, const WTF::String& data_url);
+
+  // 清空缓存
+  void Clear();
+
+ private:
+  struct ImageDataEntry {
+    ImageDataKey key;
+    std::vector<uint8_t> pixels;
+    uint64_t last_use = 0;
+  };
+
+  struct DataURLEntry {
+    DataURLKey key;
+    WTF::String data_url;
+    uint64_t last_use = 0;
+  };
+
+  // 丢弃不属于当前内容代数的缓存项
+  void DropStaleEntries(uint64_t generation);
+
+  // 淘汰缓存项直到新增incoming_bytes后进程总占用不超过上限
+  bool MakeRoom(size_t incoming_bytes);
+
+  // 淘汰本缓存中最近最少使用的一项，缓存为空时返回false
+  bool EvictOldest();
+
+  // 同时更新本缓存和进程内的占用
+  void AddUsage(size_t bytes);
+  void RemoveUsage(size_t bytes);
+
+  static size_t DataURLBytes(const WTF::String& data_url);
+
+  std::vector<ImageDataEntry> image_data_entries_;
+  std::vector<DataURLEntry> data_url_entries_;
+  size_t memory_limit_;
+  size_t memory_usage_ = 0;
+  uint64_t use_counter_ = 0;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_CANVAS_NOISE_CACHE_H_
@@ -0,0 +1,374 @@
+#include "novebrowse/canvas_noise_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/cpu.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+#elif defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace novebrowse {
+
+namespace {
+
+// Hash constants shared by every kernel. Changing any of them changes the
+// noise pattern for every site, so treat them as part of the output format.
+constexpr uint32_t kXMultiplier = 0x9E3779B1u;
+constexpr uint32_t kYMultiplier = 0x85EBCA77u;
+constexpr uint32_t kMix1 = 0x7FEB352Du;
+constexpr uint32_t kMix2 = 0x846CA68Bu;
+
+// Each channel consumes 10 bits of the pixel hash.
+constexpr int kChannelBits = 10;
+constexpr uint32_t kChannelMask = (1u << kChannelBits) - 1;
+
+inline uint32_t RowKey(uint32_t seed, int y) {
+  return seed ^ (static_cast<uint32_t>(y) * kYMultiplier);
+}
+
+inline uint32_t MixHash(uint32_t h) {
+  h ^= h >> 16;
+  h *= kMix1;
+  h ^= h >> 15;
+  h *= kMix2;
+  h ^= h >> 16;
+  return h;
+}
+
+using RowKernel = void (*)(uint8_t* row,
+                           int width,
+                           int x_origin,
+                           uint32_t row_key,
+                           int amplitude);
+
+void ApplyRowScalar(uint8_t* row,
+                    int width,
+                    int x_origin,
+                    uint32_t row_key,
+                    int amplitude) {
+  const uint32_t span = static_cast<uint32_t>(2 * amplitude + 1);
+  for (int i = 0; i < width; ++i) {
+    uint32_t h = MixHash(row_key ^ (static_cast<uint32_t>(x_origin + i) * kXMultiplier));
+    uint8_t* pixel = row + static_cast<size_t>(i) * 4;
+
+    // Apply noise to the three color channels, leave alpha unchanged
+    for (int channel = 0; channel < 3; ++channel) {
+      uint32_t bits = (h >> (channel * kChannelBits)) & kChannelMask;
+      int delta = static_cast<int>((bits * span) >> kChannelBits) - amplitude;
+      int value = static_cast<int>(pixel[channel]) + delta;
+      pixel[channel] = static_cast<uint8_t>(std::clamp(value, 0, 255));
+    }
+  }
+}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+#define NOVEBROWSE_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define NOVEBROWSE_TARGET_AVX2 __attribute__((target("avx2")))
+
+NOVEBROWSE_TARGET_SSE41 inline __m128i MixHashSSE41(__m128i h) {
+  h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+  h = _mm_mullo_epi32(h, _mm_set1_epi32(static_cast<int>(kMix1)));
+  h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+  h = _mm_mullo_epi32(h, _mm_set1_epi32(static_cast<int>(kMix2)));
+  h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+  return h;
+}
+
+// Splits one channel's signed delta into the positive and negative byte lanes
+// so that adds_epu8/subs_epu8 reproduce the scalar clamp exactly.
+NOVEBROWSE_TARGET_SSE41 inline void AccumulateChannelSSE41(__m128i channel_bits,
+                                                           __m128i span,
+                                                           __m128i amplitude,
+                                                           int byte_shift,
+                                                           __m128i* positive,
+                                                           __m128i* negative) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i bits = _mm_and_si128(channel_bits, _mm_set1_epi32(kChannelMask));
+  __m128i scaled = _mm_srli_epi32(_mm_mullo_epi32(bits, span), kChannelBits);
+  __m128i delta = _mm_sub_epi32(scaled, amplitude);
+  __m128i pos = _mm_max_epi32(delta, zero);
+  __m128i neg = _mm_max_epi32(_mm_sub_epi32(zero, delta), zero);
+  switch (byte_shift) {
+    case 0:
+      break;
+    case 1:
+      pos = _mm_slli_epi32(pos, 8);
+      neg = _mm_slli_epi32(neg, 8);
+      break;
+    default:
+      pos = _mm_slli_epi32(pos, 16);
+      neg = _mm_slli_epi32(neg, 16);
+      break;
+  }
+  *positive = _mm_or_si128(*positive, pos);
+  *negative = _mm_or_si128(*negative, neg);
+}
+
+NOVEBROWSE_TARGET_SSE41 void ApplyRowSSE41(uint8_t* row,
+                                           int width,
+                                           int x_origin,
+                                           uint32_t row_key,
+                                           int amplitude) {
+  const __m128i key = _mm_set1_epi32(static_cast<int>(row_key));
+  const __m128i x_multiplier = _mm_set1_epi32(static_cast<int>(kXMultiplier));
+  const __m128i span = _mm_set1_epi32(2 * amplitude + 1);
+  const __m128i amp = _mm_set1_epi32(amplitude);
+  const __m128i step = _mm_set1_epi32(4);
+  __m128i xs = _mm_setr_epi32(x_origin, x_origin + 1, x_origin + 2, x_origin + 3);
+
+  int i = 0;
+  for (; i + 4 <= width; i += 4) {
+    __m128i h = MixHashSSE41(_mm_xor_si128(key, _mm_mullo_epi32(xs, x_multiplier)));
+    __m128i positive = _mm_setzero_si128();
+    __m128i negative = _mm_setzero_si128();
+    AccumulateChannelSSE41(h, span, amp, 0, &positive, &negative);
+    AccumulateChannelSSE41(_mm_srli_epi32(h, kChannelBits), span, amp, 1,
+                           &positive, &negative);
+    AccumulateChannelSSE41(_mm_srli_epi32(h, 2 * kChannelBits), span, amp, 2,
+                           &positive, &negative);
+
+    __m128i* ptr = reinterpret_cast<__m128i*>(row + static_cast<size_t>(i) * 4);
+    __m128i pixels = _mm_loadu_si128(ptr);
+    pixels = _mm_subs_epu8(_mm_adds_epu8(pixels, positive), negative);
+    _mm_storeu_si128(ptr, pixels);
+    xs = _mm_add_epi32(xs, step);
+  }
+
+  ApplyRowScalar(row + static_cast<size_t>(i) * 4, width - i, x_origin + i,
+                 row_key, amplitude);
+}
+
+NOVEBROWSE_TARGET_AVX2 inline __m256i MixHashAVX2(__m256i h) {
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+  h = _mm256_mullo_epi32(h, _mm256_set1_epi32(static_cast<int>(kMix1)));
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+  h = _mm256_mullo_epi32(h, _mm256_set1_epi32(static_cast<int>(kMix2)));
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+  return h;
+}
+
+NOVEBROWSE_TARGET_AVX2 inline void AccumulateChannelAVX2(__m256i channel_bits,
+                                                         __m256i span,
+                                                         __m256i amplitude,
+                                                         int byte_shift,
+                                                         __m256i* positive,
+                                                         __m256i* negative) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i bits = _mm256_and_si256(channel_bits, _mm256_set1_epi32(kChannelMask));
+  __m256i scaled = _mm256_srli_epi32(_mm256_mullo_epi32(bits, span), kChannelBits);
+  __m256i delta = _mm256_sub_epi32(scaled, amplitude);
+  __m256i pos = _mm256_max_epi32(delta, zero);
+  __m256i neg = _mm256_max_epi32(_mm256_sub_epi32(zero, delta), zero);
+  switch (byte_shift) {
+    case 0:
+      break;
+    case 1:
+      pos = _mm256_slli_epi32(pos, 8);
+      neg = _mm256_slli_epi32(neg, 8);
+      break;
+    default:
+      pos = _mm256_slli_epi32(pos, 16);
+      neg = _mm256_slli_epi32(neg, 16);
+      break;
+  }
+  *positive = _mm256_or_si256(*positive, pos);
+  *negative = _mm256_or_si256(*negative, neg);
+}
+
+NOVEBROWSE_TARGET_AVX2 void ApplyRowAVX2(uint8_t* row,
+                                         int width,
+                                         int x_origin,
+                                         uint32_t row_key,
+                                         int amplitude) {
+  const __m256i key = _mm256_set1_epi32(static_cast<int>(row_key));
+  const __m256i x_multiplier = _mm256_set1_epi32(static_cast<int>(kXMultiplier));
+  const __m256i span = _mm256_set1_epi32(2 * amplitude + 1);
+  const __m256i amp = _mm256_set1_epi32(amplitude);
+  const __m256i step = _mm256_set1_epi32(8);
+  __m256i xs = _mm256_setr_epi32(x_origin, x_origin + 1, x_origin + 2, x_origin + 3,
+                                 x_origin + 4, x_origin + 5, x_origin + 6, x_origin + 7);
+
+  int i = 0;
+  for (; i + 8 <= width; i += 8) {
+    __m256i h = MixHashAVX2(_mm256_xor_si256(key, _mm256_mullo_epi32(xs, x_multiplier)));
+    __m256i positive = _mm256_setzero_si256();
+    __m256i negative = _mm256_setzero_si256();
+    AccumulateChannelAVX2(h, span, amp, 0, &positive, &negative);
+    AccumulateChannelAVX2(_mm256_srli_epi32(h, kChannelBits), span, amp, 1,
+                          &positive, &negative);
+    AccumulateChannelAVX2(_mm256_srli_epi32(h, 2 * kChannelBits), span, amp, 2,
+                          &positive, &negative);
+
+    __m256i* ptr = reinterpret_cast<__m256i*>(row + static_cast<size_t>(i) * 4);
+    __m256i pixels = _mm256_loadu_si256(ptr);
+    pixels = _mm256_subs_epu8(_mm256_adds_epu8(pixels, positive), negative);
+    _mm256_storeu_si256(ptr, pixels);
+    xs = _mm256_add_epi32(xs, step);
+  }
+
+  // The SSE4.1 kernel picks up the remaining 0-7 pixels.
+  ApplyRowSSE41(row + static_cast<size_t>(i) * 4, width - i, x_origin + i,
+                row_key, amplitude);
+}
+
+#elif defined(ARCH_CPU_ARM64)
+
+inline uint32x4_t MixHashNEON(uint32x4_t h) {
+  h = veorq_u32(h, vshrq_n_u32(h, 16));
+  h = vmulq_u32(h, vdupq_n_u32(kMix1));
+  h = veorq_u32(h, vshrq_n_u32(h, 15));
+  h = vmulq_u32(h, vdupq_n_u32(kMix2));
+  h = veorq_u32(h, vshrq_n_u32(h, 16));
+  return h;
+}
+
+inline void AccumulateChannelNEON(uint32x4_t channel_bits,
+                                  uint32x4_t span,
+                                  int32x4_t amplitude,
+                                  int byte_shift,
+                                  uint32x4_t* positive,
+                                  uint32x4_t* negative) {
+  const int32x4_t zero = vdupq_n_s32(0);
+  uint32x4_t bits = vandq_u32(channel_bits, vdupq_n_u32(kChannelMask));
+  uint32x4_t scaled = vshrq_n_u32(vmulq_u32(bits, span), kChannelBits);
+  int32x4_t delta = vsubq_s32(vreinterpretq_s32_u32(scaled), amplitude);
+  uint32x4_t pos = vreinterpretq_u32_s32(vmaxq_s32(delta, zero));
+  uint32x4_t neg = vreinterpretq_u32_s32(vmaxq_s32(vnegq_s32(delta), zero));
+  switch (byte_shift) {
+    case 0:
+      break;
+    case 1:
+      pos = vshlq_n_u32(pos, 8);
+      neg = vshlq_n_u32(neg, 8);
+      break;
+    default:
+      pos = vshlq_n_u32(pos, 16);
+      neg = vshlq_n_u32(neg, 16);
+      break;
+  }
+  *positive = vorrq_u32(*positive, pos);
+  *negative = vorrq_u32(*negative, neg);
+}
+
+void ApplyRowNEON(uint8_t* row,
+                  int width,
+                  int x_origin,
+                  uint32_t row_key,
+                  int amplitude) {
+  const uint32x4_t key = vdupq_n_u32(row_key);
+  const uint32x4_t x_multiplier = vdupq_n_u32(kXMultiplier);
+  const uint32x4_t span = vdupq_n_u32(static_cast<uint32_t>(2 * amplitude + 1));
+  const int32x4_t amp = vdupq_n_s32(amplitude);
+  const uint32x4_t step = vdupq_n_u32(4);
+  const uint32_t initial_xs[4] = {
+      static_cast<uint32_t>(x_origin), static_cast<uint32_t>(x_origin + 1),
+      static_cast<uint32_t>(x_origin + 2), static_cast<uint32_t>(x_origin + 3)};
+  uint32x4_t xs = vld1q_u32(initial_xs);
+
+  int i = 0;
+  for (; i + 4 <= width; i += 4) {
+    uint32x4_t h = MixHashNEON(veorq_u32(key, vmulq_u32(xs, x_multiplier)));
+    uint32x4_t positive = vdupq_n_u32(0);
+    uint32x4_t negative = vdupq_n_u32(0);
+    AccumulateChannelNEON(h, span, amp, 0, &positive, &negative);
+    AccumulateChannelNEON(vshrq_n_u32(h, kChannelBits), span, amp, 1,
+                          &positive, &negative);
+    AccumulateChannelNEON(vshrq_n_u32(h, 2 * kChannelBits), span, amp, 2,
+                          &positive, &negative);
+
+    uint8_t* ptr = row + static_cast<size_t>(i) * 4;
+    uint8x16_t pixels = vld1q_u8(ptr);
+    pixels = vqaddq_u8(pixels, vreinterpretq_u8_u32(positive));
+    pixels = vqsubq_u8(pixels, vreinterpretq_u8_u32(negative));
+    vst1q_u8(ptr, pixels);
+    xs = vaddq_u32(xs, step);
+  }
+
+  ApplyRowScalar(row + static_cast<size_t>(i) * 4, width - i, x_origin + i,
+                 row_key, amplitude);
+}
+
+#endif
+
+RowKernel SelectRowKernel() {
+#if defined(ARCH_CPU_X86_FAMILY)
+  base::CPU cpu;
+  if (cpu.has_avx2()) {
+    return &ApplyRowAVX2;
+  }
+  if (cpu.has_sse41()) {
+    return &ApplyRowSSE41;
+  }
+  return &ApplyRowScalar;
+#elif defined(ARCH_CPU_ARM64)
+  return &ApplyRowNEON;
+#else
+  return &ApplyRowScalar;
+#endif
+}
+
+}  // namespace
+
+// static
+int CanvasNoiseKernel::AmplitudeForNoiseLevel(double noise_level) {
+  if (!(noise_level > 0.0)) {
+    return 0;
+  }
+
+  double amplitude = std::ceil(noise_level * kAmplitudePerNoiseLevel);
+  return static_cast<int>(std::min(amplitude, 255.0));
+}
+
+// static
+void CanvasNoiseKernel::ApplyToRow(uint8_t* row,
+                                   int width,
+                                   int x_origin,
+                                   int y,
+                                   uint32_t seed,
+                                   int amplitude) {
+  if (!row || width <= 0 || amplitude <= 0) {
+    return;
+  }
+
+  static const RowKernel kernel = SelectRowKernel();
+  kernel(row, width, x_origin, RowKey(seed, y), std::min(amplitude, 255));
+}
+
+// static
+void CanvasNoiseKernel::ApplyToRowScalar(uint8_t* row,
+                                         int width,
+                                         int x_origin,
+                                         int y,
+                                         uint32_t seed,
+                                         int amplitude) {
+  if (!row || width <= 0 || amplitude <= 0) {
+    return;
+  }
+
+  ApplyRowScalar(row, width, x_origin, RowKey(seed, y), std::min(amplitude, 255));
+}
+
+// static
+uint32_t CanvasNoiseKernel::HashPixel(uint32_t seed, int x, int y) {
+  return MixHash(RowKey(seed, y) ^ (static_cast<uint32_t>(x) * kXMultiplier));
+}
+
+// static
+int CanvasNoiseKernel::NoiseDelta(uint32_t pixel_hash, int channel, int amplitude) {
+  if (amplitude <= 0 || channel < 0 || channel > 2) {
+    return 0;
+  }
+
+  amplitude = std::min(amplitude, 255);
+  const uint32_t span = static_cast<uint32_t>(2 * amplitude + 1);
+  uint32_t bits = (pixel_hash >> (channel * kChannelBits)) & kChannelMask;
+  return static_cast<int>((bits * span) >> kChannelBits) - amplitude;
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,46 @@
+#ifndef NOVEBROWSE_CANVAS_NOISE_KERNEL_H_
+#define NOVEBROWSE_CANVAS_NOISE_KERNEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace novebrowse {
+
+// Canvas行噪声内核 - 无状态的整数哈希噪声，按整行处理4字节像素
+//
+// 每个像素的RGB偏移只由(seed, x, y)决定，alpha通道不做修改。
+// SSE4.1/AVX2/NEON路径与标量路径的输出逐位一致。
+class CanvasNoiseKernel {
+ public:
+  // noise_level对应的最大偏移，与CanvasNoiseGenerator的缩放保持一致
+  static constexpr int kAmplitudePerNoiseLevel = 10;
+
+  // 由noise_level换算噪声幅度，返回0表示不扰动
+  static int AmplitudeForNoiseLevel(double noise_level);
+
+  // 对一行像素添加噪声（自动选择SIMD实现）
+  static void ApplyToRow(uint8_t* row,
+                         int width,
+                         int x_origin,
+                         int y,
+                         uint32_t seed,
+                         int amplitude);
+
+  // 标量参考实现
+  static void ApplyToRowScalar(uint8_t* row,
+                               int width,
+                               int x_origin,
+                               int y,
+                               uint32_t seed,
+                               int amplitude);
+
+  // 单个像素的哈希值
+  static uint32_t HashPixel(uint32_t seed, int x, int y);
+
+  // 单通道噪声偏移，范围[-amplitude, amplitude]
+  static int NoiseDelta(uint32_t pixel_hash, int channel, int amplitude);
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_CANVAS_NOISE_KERNEL_H_
@@ -0,0 +1,70 @@
+#include "novebrowse/canvas_usage_stats.h"
+
+#include <algorithm>
+
+namespace novebrowse {
+
+CanvasUsageStats::CanvasUsageStats() {
+  for (auto& slot : sequence_) {
+    slot.store(static_cast<uint8_t>(CanvasOperation::kOther),
+               std::memory_order_relaxed);
+  }
+}
+
+CanvasUsageStats::~CanvasUsageStats() = default;
+
+void CanvasUsageStats::Record(CanvasOperation operation, int64_t now_us) {
+  int64_t expected = 0;
+  first_operation_time_.compare_exchange_strong(expected, now_us,
+                                                std::memory_order_relaxed);
+  last_operation_time_.store(now_us, std::memory_order_relaxed);
+  
+  uint64_t index = operation_count_.load(std::memory_order_relaxed);
+  sequence_[index % kSequenceCapacity].store(static_cast<uint8_t>(operation),
+                                             std::memory_order_relaxed);
+  // Publish the slot before the count so readers never see an unwritten slot.
+  operation_count_.store(index + 1, std::memory_order_release);
+  
+  // fillText/strokeText count as draws, matching the original categorization.
+  switch (operation) {
+    case CanvasOperation::kFillRect:
+    case CanvasOperation::kStrokeRect:
+    case CanvasOperation::kFillText:
+    case CanvasOperation::kStrokeText:
+    case CanvasOperation::kDrawImage:
+    case CanvasOperation::kDraw:
+      draw_operations_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case CanvasOperation::kGetImageData:
+      read_operations_.fetch_add(1, std::memory_order_relaxed);
+      image_data_reads_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case CanvasOperation::kToDataURL:
+      read_operations_.fetch_add(1, std::memory_order_relaxed);
+      data_url_exports_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case CanvasOperation::kMeasureText:
+      text_operations_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case CanvasOperation::kOther:
+      break;
+  }
+}
+
+size_t CanvasUsageStats::CopyRecentOperations(
+    base::span<CanvasOperation, kSequenceCapacity> out) const {
+  uint64_t count = operation_count_.load(std::memory_order_acquire);
+  size_t length = static_cast<size_t>(
+      std::min<uint64_t>(count, kSequenceCapacity));
+  uint64_t start = count - length;
+  
+  for (size_t i = 0; i < length; ++i) {
+    out[i] = static_cast<CanvasOperation>(
+        sequence_[(start + i) % kSequenceCapacity].load(
+            std::memory_order_relaxed));
+  }
+  
+  return length;
+}
+
+}  // namespace novebrowse
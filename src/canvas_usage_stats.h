@@ -0,0 +1,81 @@
+#ifndef NOVEBROWSE_CANVAS_USAGE_STATS_H_
+#define NOVEBROWSE_CANVAS_USAGE_STATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+
+#include "base/containers/span.h"
+
+namespace novebrowse {
+
+// Canvas操作类型 - 检测器记录的操作
+enum class CanvasOperation : uint8_t {
+  kFillRect,
+  kStrokeRect,
+  kFillText,
+  kStrokeText,
+  kDrawImage,
+  kGetImageData,
+  kToDataURL,
+  kMeasureText,
+  kDraw,  // 宿主的DidDraw钩子记录的任意绘制调用，不区分具体类型
+  kOther,
+};
+
+// Canvas使用统计 - 每个画布一份，由CanvasHostData持有
+//
+// 记录路径只做原子操作，不分配内存、不加锁；画布销毁时统计随之释放。
+class CanvasUsageStats {
+ public:
+  // 操作序列的保留长度
+  static constexpr size_t kSequenceCapacity = 100;
+  
+  CanvasUsageStats();
+  ~CanvasUsageStats();
+  
+  CanvasUsageStats(const CanvasUsageStats&) = delete;
+  CanvasUsageStats& operator=(const CanvasUsageStats&) = delete;
+  
+  // 记录一次操作，now_us为单调时钟微秒数
+  void Record(CanvasOperation operation, int64_t now_us);
+  
+  int draw_operations() const { return Load(draw_operations_); }
+  int read_operations() const { return Load(read_operations_); }
+  int text_operations() const { return Load(text_operations_); }
+  int image_data_reads() const { return Load(image_data_reads_); }
+  int data_url_exports() const { return Load(data_url_exports_); }
+  int64_t first_operation_time() const {
+    return first_operation_time_.load(std::memory_order_relaxed);
+  }
+  int64_t last_operation_time() const {
+    return last_operation_time_.load(std::memory_order_relaxed);
+  }
+  
+  // 按时间顺序复制最近的操作序列到out，返回复制的数量
+  size_t CopyRecentOperations(
+      base::span<CanvasOperation, kSequenceCapacity> out) const;
+  
+ private:
+  static int Load(const std::atomic<int>& counter) {
+    return counter.load(std::memory_order_relaxed);
+  }
+  
+  std::atomic<int> draw_operations_{0};
+  std::atomic<int> read_operations_{0};
+  std::atomic<int> text_operations_{0};
+  std::atomic<int> image_data_reads_{0};
+  std::atomic<int> data_url_exports_{0};
+  std::atomic<int64_t> first_operation_time_{0};
+  std::atomic<int64_t> last_operation_time_{0};
+  
+  // 环形缓冲区，operation_count_为累计写入次数
+  std::array<std::atomic<uint8_t>, kSequenceCapacity> sequence_;
+  std::atomic<uint64_t> operation_count_{0};
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_CANVAS_USAGE_STATS_H_
@@ -0,0 +1,507 @@
+#include "novebrowse/compiled_profile_store.h"
+
+#include <string.h>
+
+#include <utility>
+
+#include "base/logging.h"
+#include "build/build_config.h"
+
+#if !defined(ARCH_CPU_LITTLE_ENDIAN)
+#error "Compiled profile stores are little-endian"
+#endif
+
+namespace novebrowse {
+
+namespace {
+
+constexpr char kMagic[8] = {'N', 'V', 'B', 'S', 'T', 'O', 'R', 'E'};
+
+// Indexes a string in the pool: [strings_offset + offset, +length).
+struct StringRef {
+  uint32_t offset;
+  uint32_t length;
+};
+
+// Indexes consecutive entries of the string reference table.
+struct ListRef {
+  uint32_t first;
+  uint32_t count;
+};
+
+// Presence bits, in the order of DEVICE_FIELDS in compile_profiles.py.
+enum DeviceProfileField : uint32_t {
+  kUserAgentField = 1u << 0,
+  kPlatformField = 1u << 1,
+  kLanguagesField = 1u << 2,
+  kHardwareConcurrencyField = 1u << 3,
+  kDeviceMemoryField = 1u << 4,
+  kScreenWidthField = 1u << 5,
+  kScreenHeightField = 1u << 6,
+  kColorDepthField = 1u << 7,
+  kPixelDepthField = 1u << 8,
+  kDevicePixelRatioField = 1u << 9,
+  kWebGLVendorField = 1u << 10,
+  kWebGLRendererField = 1u << 11,
+};
+
+// Presence bits: the eleven doubles, pause_duration_ms, then the bools.
+enum BehaviorPatternField : uint32_t {
+  kMovementSpeedField = 1u << 0,
+  kClickDelayField = 1u << 1,
+  kRandomMovementProbabilityField = 1u << 2,
+  kTypingSpeedField = 1u << 3,
+  kKeyPressDelayField = 1u << 4,
+  kErrorProbabilityField = 1u << 5,
+  kScrollSpeedField = 1u << 6,
+  kPauseProbabilityField = 1u << 7,
+  kPageDwellTimeField = 1u << 8,
+  kLinkClickProbabilityField = 1u << 9,
+  kFormFillSpeedField = 1u << 10,
+  kPauseDurationField = 1u << 11,
+  kAddRandomMovementsField = 1u << 12,
+  kAddTypingErrorsField = 1u << 13,
+  kSmoothScrollingField = 1u << 14,
+  kSimulateReadingField = 1u << 15,
+};
+
+// Values of the boolean fields, indexed like PATTERN_BOOL_FIELDS.
+enum BehaviorPatternBool : uint32_t {
+  kAddRandomMovementsValue = 1u << 0,
+  kAddTypingErrorsValue = 1u << 1,
+  kSmoothScrollingValue = 1u << 2,
+  kSimulateReadingValue = 1u << 3,
+};
+
+// Must match fnv1a32() in compile_profiles.py.
+uint32_t HashName(std::string_view name) {
+  uint32_t hash = 0x811C9DC5u;
+  for (char c : name) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x01000193u;
+  }
+  return hash;
+}
+
+bool RangeFits(uint64_t offset, uint64_t size, uint64_t limit) {
+  return offset <= limit && size <= limit - offset;
+}
+
+}  // namespace
+
+struct CompiledProfileStore::Header {
+  char magic[8];
+  uint32_t format_version;
+  uint32_t kind;
+  uint32_t record_count;
+  uint32_t record_size;
+  uint32_t bucket_count;
+  uint32_t buckets_offset;
+  uint32_t records_offset;
+  uint32_t string_refs_offset;
+  uint32_t string_refs_count;
+  uint32_t strings_offset;
+  uint32_t strings_size;
+  uint32_t file_size;
+  uint32_t reserved[2];
+};
+static_assert(sizeof(CompiledProfileStore::Header) == 64);
+
+// Every record starts with its name so NameAt() works for either kind.
+struct CompiledProfileStore::DeviceProfileRecord {
+  StringRef name;
+  StringRef description;
+  StringRef user_agent;
+  StringRef platform;
+  StringRef webgl_vendor;
+  StringRef webgl_renderer;
+  ListRef languages;
+  uint64_t device_memory;
+  double device_pixel_ratio;
+  int32_t hardware_concurrency;
+  int32_t screen_width;
+  int32_t screen_height;
+  int32_t color_depth;
+  int32_t pixel_depth;
+  uint32_t fields;
+};
+static_assert(sizeof(CompiledProfileStore::DeviceProfileRecord) == 96);
+
+struct CompiledProfileStore::BehaviorPatternRecord {
+  StringRef name;
+  StringRef description;
+  double movement_speed;
+  double click_delay_ms;
+  double random_movement_probability;
+  double typing_speed_wpm;
+  double key_press_delay_ms;
+  double error_probability;
+  double scroll_speed;
+  double pause_probability;
+  double page_dwell_time_ms;
+  double link_click_probability;
+  double form_fill_speed;
+  int32_t pause_duration_ms;
+  uint32_t fields;
+  uint32_t bool_values;
+  uint32_t reserved;
+};
+static_assert(sizeof(CompiledProfileStore::BehaviorPatternRecord) == 120);
+
+CompiledProfileStore::DeviceProfileView::DeviceProfileView(
+    scoped_refptr<const CompiledProfileStore> store,
+    const DeviceProfileRecord* record)
+    : store_(std::move(store)), record_(record) {}
+
+CompiledProfileStore::DeviceProfileView::DeviceProfileView(
+    const DeviceProfileView&) = default;
+
+CompiledProfileStore::DeviceProfileView&
+CompiledProfileStore::DeviceProfileView::operator=(const DeviceProfileView&) =
+    default;
+
+CompiledProfileStore::DeviceProfileView::~DeviceProfileView() = default;
+
+std::string_view CompiledProfileStore::DeviceProfileView::name() const {
+  return store_->StringAt(record_->name.offset, record_->name.length);
+}
+
+std::string_view CompiledProfileStore::DeviceProfileView::description() const {
+  return store_->StringAt(record_->description.offset,
+                          record_->description.length);
+}
+
+std::string_view CompiledProfileStore::DeviceProfileView::user_agent() const {
+  return store_->StringAt(record_->user_agent.offset, record_->user_agent.length);
+}
+
+std::string_view CompiledProfileStore::DeviceProfileView::platform() const {
+  return store_->StringAt(record_->platform.offset, record_->platform.length);
+}
+
+std::string_view CompiledProfileStore::DeviceProfileView::webgl_vendor() const {
+  return store_->StringAt(record_->webgl_vendor.offset,
+                          record_->webgl_vendor.length);
+}
+
+std::string_view CompiledProfileStore::DeviceProfileView::webgl_renderer() const {
+  return store_->StringAt(record_->webgl_renderer.offset,
+                          record_->webgl_renderer.length);
+}
+
+size_t CompiledProfileStore::DeviceProfileView::language_count() const {
+  return record_->languages.count;
+}
+
+std::string_view CompiledProfileStore::DeviceProfileView::language(
+    size_t index) const {
+  DCHECK_LT(index, language_count());
+  const auto* refs = reinterpret_cast<const StringRef*>(
+      store_->file_.data() + store_->header_->string_refs_offset);
+  const StringRef& ref = refs[record_->languages.first + index];
+  return store_->StringAt(ref.offset, ref.length);
+}
+
+DeviceProfile CompiledProfileStore::DeviceProfileView::ToDeviceProfile() const {
+  DeviceProfile profile;
+  profile.name = std::string(name());
+  profile.description = std::string(description());
+  
+  const uint32_t fields = record_->fields;
+  if (fields & kUserAgentField) {
+    profile.navigator.user_agent = std::string(user_agent());
+  }
+  if (fields & kPlatformField) {
+    profile.navigator.platform = std::string(platform());
+  }
+  if (fields & kLanguagesField) {
+    profile.navigator.languages.clear();
+    profile.navigator.languages.reserve(language_count());
+    for (size_t i = 0; i < language_count(); ++i) {
+      profile.navigator.languages.emplace_back(language(i));
+    }
+  }
+  if (fields & kHardwareConcurrencyField) {
+    profile.navigator.hardware_concurrency = record_->hardware_concurrency;
+  }
+  if (fields & kDeviceMemoryField) {
+    profile.navigator.device_memory = record_->device_memory;
+  }
+  
+  if (fields & kScreenWidthField) profile.screen.width = record_->screen_width;
+  if (fields & kScreenHeightField) profile.screen.height = record_->screen_height;
+  if (fields & kColorDepthField) profile.screen.color_depth = record_->color_depth;
+  if (fields & kPixelDepthField) profile.screen.pixel_depth = record_->pixel_depth;
+  if (fields & kDevicePixelRatioField) {
+    profile.screen.device_pixel_ratio = record_->device_pixel_ratio;
+  }
+  
+  if (fields & kWebGLVendorField) {
+    profile.webgl.vendor = std::string(webgl_vendor());
+  }
+  if (fields & kWebGLRendererField) {
+    profile.webgl.renderer = std::string(webgl_renderer());
+  }
+  
+  return profile;
+}
+
+CompiledProfileStore::BehaviorPatternView::BehaviorPatternView(
+    scoped_refptr<const CompiledProfileStore> store,
+    const BehaviorPatternRecord* record)
+    : store_(std::move(store)), record_(record) {}
+
+CompiledProfileStore::BehaviorPatternView::BehaviorPatternView(
+    const BehaviorPatternView&) = default;
+
+CompiledProfileStore::BehaviorPatternView&
+CompiledProfileStore::BehaviorPatternView::operator=(const BehaviorPatternView&) =
+    default;
+
+CompiledProfileStore::BehaviorPatternView::~BehaviorPatternView() = default;
+
+std::string_view CompiledProfileStore::BehaviorPatternView::name() const {
+  return store_->StringAt(record_->name.offset, record_->name.length);
+}
+
+std::string_view CompiledProfileStore::BehaviorPatternView::description() const {
+  return store_->StringAt(record_->description.offset,
+                          record_->description.length);
+}
+
+BehaviorPattern CompiledProfileStore::BehaviorPatternView::ToBehaviorPattern()
+    const {
+  BehaviorPattern pattern;
+  pattern.name = std::string(name());
+  pattern.description = std::string(description());
+  
+  const BehaviorPatternRecord& r = *record_;
+  const uint32_t fields = r.fields;
+  if (fields & kMovementSpeedField) pattern.mouse.movement_speed = r.movement_speed;
+  if (fields & kClickDelayField) pattern.mouse.click_delay_ms = r.click_delay_ms;
+  if (fields & kRandomMovementProbabilityField) {
+    pattern.mouse.random_movement_probability = r.random_movement_probability;
+  }
+  if (fields & kAddRandomMovementsField) {
+    pattern.mouse.add_random_movements = r.bool_values & kAddRandomMovementsValue;
+  }
+  
+  if (fields & kTypingSpeedField) pattern.keyboard.typing_speed_wpm = r.typing_speed_wpm;
+  if (fields & kKeyPressDelayField) {
+    pattern.keyboard.key_press_delay_ms = r.key_press_delay_ms;
+  }
+  if (fields & kErrorProbabilityField) {
+    pattern.keyboard.error_probability = r.error_probability;
+  }
+  if (fields & kAddTypingErrorsField) {
+    pattern.keyboard.add_typing_errors = r.bool_values & kAddTypingErrorsValue;
+  }
+  
+  if (fields & kScrollSpeedField) pattern.scroll.scroll_speed = r.scroll_speed;
+  if (fields & kPauseProbabilityField) {
+    pattern.scroll.pause_probability = r.pause_probability;
+  }
+  if (fields & kPauseDurationField) {
+    pattern.scroll.pause_duration_ms = r.pause_duration_ms;
+  }
+  if (fields & kSmoothScrollingField) {
+    pattern.scroll.smooth_scrolling = r.bool_values & kSmoothScrollingValue;
+  }
+  
+  if (fields & kPageDwellTimeField) {
+    pattern.interaction.page_dwell_time_ms = r.page_dwell_time_ms;
+  }
+  if (fields & kLinkClickProbabilityField) {
+    pattern.interaction.link_click_probability = r.link_click_probability;
+  }
+  if (fields & kFormFillSpeedField) {
+    pattern.interaction.form_fill_speed = r.form_fill_speed;
+  }
+  if (fields & kSimulateReadingField) {
+    pattern.interaction.simulate_reading = r.bool_values & kSimulateReadingValue;
+  }
+  
+  return pattern;
+}
+
+// static
+scoped_refptr<const CompiledProfileStore> CompiledProfileStore::Open(
+    const base::FilePath& path,
+    Kind kind) {
+  auto store = base::WrapRefCounted(new CompiledProfileStore());
+  if (!store->file_.Initialize(path)) {
+    LOG(ERROR) << "Failed to map compiled profile store: " << path;
+    return nullptr;
+  }
+  
+  if (!store->Validate(kind)) {
+    LOG(ERROR) << "Invalid compiled profile store: " << path;
+    return nullptr;
+  }
+  
+  return store;
+}
+
+CompiledProfileStore::CompiledProfileStore() = default;
+
+CompiledProfileStore::~CompiledProfileStore() = default;
+
+CompiledProfileStore::Kind CompiledProfileStore::kind() const {
+  return static_cast<Kind>(header_->kind);
+}
+
+size_t CompiledProfileStore::size() const {
+  return header_->record_count;
+}
+
+std::string_view CompiledProfileStore::NameAt(size_t index) const {
+  DCHECK_LT(index, size());
+  StringRef name;
+  memcpy(&name, RecordAt(index), sizeof(name));
+  return StringAt(name.offset, name.length);
+}
+
+std::optional<CompiledProfileStore::DeviceProfileView>
+CompiledProfileStore::FindDeviceProfile(std::string_view name) const {
+  DCHECK_EQ(kind(), Kind::kDeviceProfiles);
+  std::optional<size_t> index = FindIndex(name);
+  if (!index) {
+    return std::nullopt;
+  }
+  
+  return DeviceProfileView(
+      base::WrapRefCounted(this),
+      reinterpret_cast<const DeviceProfileRecord*>(RecordAt(*index)));
+}
+
+std::optional<CompiledProfileStore::BehaviorPatternView>
+CompiledProfileStore::FindBehaviorPattern(std::string_view name) const {
+  DCHECK_EQ(kind(), Kind::kBehaviorPatterns);
+  std::optional<size_t> index = FindIndex(name);
+  if (!index) {
+    return std::nullopt;
+  }
+  
+  return BehaviorPatternView(
+      base::WrapRefCounted(this),
+      reinterpret_cast<const BehaviorPatternRecord*>(RecordAt(*index)));
+}
+
+bool CompiledProfileStore::Validate(Kind kind) {
+  const uint64_t length = file_.length();
+  if (length < sizeof(Header)) {
+    return false;
+  }
+  
+  // The mapping is page aligned, so the header and every 8-aligned section
+  // can be read in place.
+  const auto* header = reinterpret_cast<const Header*>(file_.data());
+  if (memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+      header->format_version != kFormatVersion ||
+      header->kind != static_cast<uint32_t>(kind) || header->file_size != length) {
+    return false;
+  }
+  
+  const size_t expected_record_size = kind == Kind::kDeviceProfiles
+                                          ? sizeof(DeviceProfileRecord)
+                                          : sizeof(BehaviorPatternRecord);
+  if (header->record_size != expected_record_size) {
+    return false;
+  }
+  
+  // Keep the table sparse; FindIndex() also bounds its probe count so a
+  // corrupt table cannot make it spin.
+  const uint32_t bucket_count = header->bucket_count;
+  if (bucket_count == 0 || (bucket_count & (bucket_count - 1)) != 0 ||
+      bucket_count <= header->record_count) {
+    return false;
+  }
+  
+  if (header->buckets_offset % 8 != 0 || header->records_offset % 8 != 0 ||
+      header->string_refs_offset % 8 != 0 ||
+      !RangeFits(header->buckets_offset, uint64_t{bucket_count} * 4, length) ||
+      !RangeFits(header->records_offset,
+                 uint64_t{header->record_count} * header->record_size, length) ||
+      !RangeFits(header->string_refs_offset,
+                 uint64_t{header->string_refs_count} * sizeof(StringRef), length) ||
+      !RangeFits(header->strings_offset, header->strings_size, length)) {
+    return false;
+  }
+  
+  const uint32_t strings_size = header->strings_size;
+  auto string_fits = [strings_size](const StringRef& ref) {
+    return RangeFits(ref.offset, ref.length, strings_size);
+  };
+  
+  const auto* buckets =
+      reinterpret_cast<const uint32_t*>(file_.data() + header->buckets_offset);
+  for (uint32_t i = 0; i < bucket_count; ++i) {
+    if (buckets[i] > header->record_count) {
+      return false;
+    }
+  }
+  
+  const auto* string_refs =
+      reinterpret_cast<const StringRef*>(file_.data() + header->string_refs_offset);
+  for (uint32_t i = 0; i < header->string_refs_count; ++i) {
+    if (!string_fits(string_refs[i])) {
+      return false;
+    }
+  }
+  
+  const uint8_t* records = file_.data() + header->records_offset;
+  for (uint32_t i = 0; i < header->record_count; ++i) {
+    const uint8_t* record = records + size_t{i} * header->record_size;
+    if (kind == Kind::kDeviceProfiles) {
+      const auto* profile = reinterpret_cast<const DeviceProfileRecord*>(record);
+      if (!string_fits(profile->name) || !string_fits(profile->description) ||
+          !string_fits(profile->user_agent) || !string_fits(profile->platform) ||
+          !string_fits(profile->webgl_vendor) ||
+          !string_fits(profile->webgl_renderer) ||
+          !RangeFits(profile->languages.first, profile->languages.count,
+                     header->string_refs_count)) {
+        return false;
+      }
+    } else {
+      const auto* pattern = reinterpret_cast<const BehaviorPatternRecord*>(record);
+      if (!string_fits(pattern->name) || !string_fits(pattern->description)) {
+        return false;
+      }
+    }
+  }
+  
+  header_ = header;
+  return true;
+}
+
+std::optional<size_t> CompiledProfileStore::FindIndex(std::string_view name) const {
+  const auto* buckets =
+      reinterpret_cast<const uint32_t*>(file_.data() + header_->buckets_offset);
+  const uint32_t mask = header_->bucket_count - 1;
+  
+  uint32_t slot = HashName(name) & mask;
+  for (uint32_t probe = 0; probe <= mask; ++probe, slot = (slot + 1) & mask) {
+    const uint32_t entry = buckets[slot];
+    if (entry == 0) {
+      return std::nullopt;
+    }
+    if (NameAt(entry - 1) == name) {
+      return entry - 1;
+    }
+  }
+  
+  return std::nullopt;
+}
+
+const uint8_t* CompiledProfileStore::RecordAt(size_t index) const {
+  return file_.data() + header_->records_offset + index * header_->record_size;
+}
+
+std::string_view CompiledProfileStore::StringAt(uint32_t offset,
+                                                uint32_t length) const {
+  return std::string_view(
+      reinterpret_cast<const char*>(file_.data() + header_->strings_offset + offset),
+      length);
+}
+
+}  // namespace novebrowse
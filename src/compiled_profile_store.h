@@ -0,0 +1,125 @@
+#ifndef NOVEBROWSE_COMPILED_PROFILE_STORE_H_
+#define NOVEBROWSE_COMPILED_PROFILE_STORE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string_view>
+
+#include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_refptr.h"
+#include "novebrowse/fingerprint_config.h"
+
+namespace novebrowse {
+
+// 编译后的配置文件库 - scripts/compile_profiles.py生成的二进制文件
+//
+// 文件整体内存映射，打开时校验一次边界，之后按名称O(1)查找，
+// 视图直接指向映射内存，不复制字符串。创建后不可变，可在线程间共享。
+class CompiledProfileStore
+    : public base::RefCountedThreadSafe<CompiledProfileStore> {
+ public:
+  // 与compile_profiles.py的FORMAT_VERSION一致，版本不符时拒绝打开
+  static constexpr uint32_t kFormatVersion = 1;
+  
+  // 编译文件的扩展名
+  static constexpr base::FilePath::CharType kFileExtension[] =
+      FILE_PATH_LITERAL(".bin");
+  
+  enum class Kind : uint32_t {
+    kDeviceProfiles = 1,
+    kBehaviorPatterns = 2,
+  };
+  
+  struct Header;
+  struct DeviceProfileRecord;
+  struct BehaviorPatternRecord;
+  
+  // 设备配置文件视图，持有库的引用
+  class DeviceProfileView {
+   public:
+    DeviceProfileView(scoped_refptr<const CompiledProfileStore> store,
+                      const DeviceProfileRecord* record);
+    DeviceProfileView(const DeviceProfileView&);
+    DeviceProfileView& operator=(const DeviceProfileView&);
+    ~DeviceProfileView();
+    
+    std::string_view name() const;
+    std::string_view description() const;
+    std::string_view user_agent() const;
+    std::string_view platform() const;
+    std::string_view webgl_vendor() const;
+    std::string_view webgl_renderer() const;
+    size_t language_count() const;
+    std::string_view language(size_t index) const;
+    
+    // 生成完整的DeviceProfile（文件中缺失的字段保持默认值）
+    DeviceProfile ToDeviceProfile() const;
+   
+   private:
+    scoped_refptr<const CompiledProfileStore> store_;
+    const DeviceProfileRecord* record_;
+  };
+  
+  // 行为模式视图，持有库的引用
+  class BehaviorPatternView {
+   public:
+    BehaviorPatternView(scoped_refptr<const CompiledProfileStore> store,
+                        const BehaviorPatternRecord* record);
+    BehaviorPatternView(const BehaviorPatternView&);
+    BehaviorPatternView& operator=(const BehaviorPatternView&);
+    ~BehaviorPatternView();
+    
+    std::string_view name() const;
+    std::string_view description() const;
+    
+    // 生成完整的BehaviorPattern（文件中缺失的字段保持默认值）
+    BehaviorPattern ToBehaviorPattern() const;
+   
+   private:
+    scoped_refptr<const CompiledProfileStore> store_;
+    const BehaviorPatternRecord* record_;
+  };
+  
+  // 映射并校验文件，格式、版本或类型不符时返回nullptr
+  static scoped_refptr<const CompiledProfileStore> Open(const base::FilePath& path,
+                                                        Kind kind);
+  
+  CompiledProfileStore(const CompiledProfileStore&) = delete;
+  CompiledProfileStore& operator=(const CompiledProfileStore&) = delete;
+  
+  Kind kind() const;
+  size_t size() const;
+  
+  // 第index条记录的名称
+  std::string_view NameAt(size_t index) const;
+  
+  // 按名称查找
+  std::optional<DeviceProfileView> FindDeviceProfile(std::string_view name) const;
+  std::optional<BehaviorPatternView> FindBehaviorPattern(std::string_view name) const;
+  
+ private:
+  friend class base::RefCountedThreadSafe<CompiledProfileStore>;
+  
+  CompiledProfileStore();
+  ~CompiledProfileStore();
+  
+  // 校验头部、哈希桶和全部记录中的引用都在文件范围内
+  bool Validate(Kind kind);
+  
+  // 按名称查找记录下标
+  std::optional<size_t> FindIndex(std::string_view name) const;
+  
+  const uint8_t* RecordAt(size_t index) const;
+  std::string_view StringAt(uint32_t offset, uint32_t length) const;
+  
+  base::MemoryMappedFile file_;
+  const Header* header_ = nullptr;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_COMPILED_PROFILE_STORE_H_
@@ -0,0 +1,105 @@
+#include "novebrowse/config_directory_watcher.h"
+
+#include <utility>
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/task/sequenced_task_runner.h"
+
+namespace novebrowse {
+
+bool ConfigDirectoryWatcher::FileState::operator==(const FileState& other) const {
+  return exists == other.exists && last_modified == other.last_modified &&
+         size == other.size;
+}
+
+ConfigDirectoryWatcher::ConfigDirectoryWatcher(
+    base::FilePath directory,
+    std::vector<base::FilePath> file_names,
+    ReloadCallback reload_callback)
+    : directory_(std::move(directory)),
+      file_names_(std::move(file_names)),
+      reload_callback_(std::move(reload_callback)) {
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+ConfigDirectoryWatcher::~ConfigDirectoryWatcher() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+bool ConfigDirectoryWatcher::Start() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  
+  for (const base::FilePath& file_name : file_names_) {
+    file_states_[file_name] = ReadFileState(file_name);
+  }
+  
+  if (!watcher_.Watch(directory_, base::FilePathWatcher::Type::kNonRecursive,
+                      base::BindRepeating(&ConfigDirectoryWatcher::OnDirectoryChanged,
+                                          weak_factory_.GetWeakPtr()))) {
+    LOG(ERROR) << "Failed to watch config directory: " << directory_;
+    return false;
+  }
+  
+  LOG(INFO) << "Watching config directory for changes: " << directory_;
+  return true;
+}
+
+void ConfigDirectoryWatcher::OnDirectoryChanged(const base::FilePath& path,
+                                                bool error) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  
+  if (error) {
+    LOG(WARNING) << "Config directory watch error: " << directory_;
+    return;
+  }
+  
+  // Collapse a burst of notifications into one pass once writes settle.
+  if (reload_pending_) {
+    return;
+  }
+  
+  reload_pending_ = true;
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&ConfigDirectoryWatcher::ReloadChangedFiles,
+                     weak_factory_.GetWeakPtr()),
+      kSettleDelay);
+}
+
+void ConfigDirectoryWatcher::ReloadChangedFiles() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  reload_pending_ = false;
+  
+  for (const base::FilePath& file_name : file_names_) {
+    FileState state = ReadFileState(file_name);
+    FileState& previous = file_states_[file_name];
+    if (state == previous) {
+      continue;
+    }
+    
+    previous = state;
+    // A deleted file keeps whatever was loaded from it last.
+    if (state.exists) {
+      DVLOG(1) << "Reloading changed config file: " << file_name;
+      reload_callback_.Run(directory_.Append(file_name));
+    }
+  }
+}
+
+ConfigDirectoryWatcher::FileState ConfigDirectoryWatcher::ReadFileState(
+    const base::FilePath& file_name) const {
+  FileState state;
+  base::File::Info info;
+  if (base::GetFileInfo(directory_.Append(file_name), &info) &&
+      !info.is_directory) {
+    state.exists = true;
+    state.last_modified = info.last_modified;
+    state.size = info.size;
+  }
+  return state;
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,71 @@
+#ifndef NOVEBROWSE_CONFIG_DIRECTORY_WATCHER_H_
+#define NOVEBROWSE_CONFIG_DIRECTORY_WATCHER_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/file_path_watcher.h"
+#include "base/functional/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/time/time.h"
+
+namespace novebrowse {
+
+// 配置目录监视器 - 目录变化时只重新加载内容确实改变的配置文件
+//
+// 目录级通知在不同平台上不一定带具体文件名，因此每次通知后比较各文件的
+// 修改时间和大小，并合并短时间内的连续通知（编辑器保存时通常写多次）。
+// 必须在允许阻塞的序列上创建、使用和销毁（通常经base::SequenceBound持有）。
+class ConfigDirectoryWatcher {
+ public:
+  // 在监视器所在序列上调用，参数为发生变化的文件完整路径
+  using ReloadCallback = base::RepeatingCallback<void(const base::FilePath&)>;
+  
+  // 通知后等待文件写完的时间
+  static constexpr base::TimeDelta kSettleDelay = base::Milliseconds(500);
+  
+  // file_names为directory下需要跟踪的文件名
+  ConfigDirectoryWatcher(base::FilePath directory,
+                         std::vector<base::FilePath> file_names,
+                         ReloadCallback reload_callback);
+  ~ConfigDirectoryWatcher();
+  
+  ConfigDirectoryWatcher(const ConfigDirectoryWatcher&) = delete;
+  ConfigDirectoryWatcher& operator=(const ConfigDirectoryWatcher&) = delete;
+  
+  // 开始监视，记录各文件当前状态（不触发加载）
+  bool Start();
+  
+ private:
+  struct FileState {
+    bool exists = false;
+    base::Time last_modified;
+    int64_t size = 0;
+    
+    bool operator==(const FileState& other) const;
+  };
+  
+  void OnDirectoryChanged(const base::FilePath& path, bool error);
+  void ReloadChangedFiles();
+  
+  FileState ReadFileState(const base::FilePath& file_name) const;
+  
+  const base::FilePath directory_;
+  const std::vector<base::FilePath> file_names_;
+  const ReloadCallback reload_callback_;
+  
+  base::FilePathWatcher watcher_;
+  std::map<base::FilePath, FileState> file_states_;
+  bool reload_pending_ = false;
+  
+  SEQUENCE_CHECKER(sequence_checker_);
+  base::WeakPtrFactory<ConfigDirectoryWatcher> weak_factory_{this};
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_CONFIG_DIRECTORY_WATCHER_H_
@@ -1,6 +1,10 @@
 #include "novebrowse/fingerprint_config.h"
 
+#include <string.h>
+
+#include <bit>
 #include <sstream>
+#include <utility>
 
 #include "base/json/json_writer.h"
 #include "base/logging.h"
@@ -10,6 +14,135 @@
 
 namespace novebrowse {
 
+namespace {
+
+// Streaming 64-bit hasher for GetStructuralHash(). Fields are folded in one
+// machine word at a time, so hashing a config costs a walk over its members
+// instead of building a base::Value, writing JSON and running SHA-256.
+class StructuralHasher {
+ public:
+  void AddBool(bool value) { AddWord(value ? 1 : 0); }
+  void AddInt(int64_t value) { AddWord(static_cast<uint64_t>(value)); }
+  void AddUint(uint64_t value) { AddWord(value); }
+  
+  void AddDouble(double value) {
+    // Fold -0.0 into 0.0 so equal values hash equally.
+    AddWord(value == 0.0 ? 0 : std::bit_cast<uint64_t>(value));
+  }
+  
+  void AddString(std::string_view value) {
+    // The length prefix keeps ("ab", "c") and ("a", "bc") apart.
+    AddWord(value.size());
+    size_t offset = 0;
+    for (; offset + sizeof(uint64_t) <= value.size(); offset += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, value.data() + offset, sizeof(word));
+      AddWord(word);
+    }
+    if (offset < value.size()) {
+      uint64_t word = 0;
+      memcpy(&word, value.data() + offset, value.size() - offset);
+      AddWord(word);
+    }
+  }
+  
+  void AddStrings(const std::vector<std::string>& values) {
+    AddWord(values.size());
+    for (const std::string& value : values) {
+      AddString(value);
+    }
+  }
+  
+  // unordered_map iteration order is unspecified, so entries are hashed
+  // independently and combined with an order-insensitive sum.
+  void AddStringMap(const std::unordered_map<std::string, std::string>& values) {
+    uint64_t combined = 0;
+    for (const auto& [key, value] : values) {
+      StructuralHasher entry;
+      entry.AddString(key);
+      entry.AddString(value);
+      combined += entry.Finish();
+    }
+    AddWord(values.size());
+    AddWord(combined);
+  }
+  
+  void AddDoubleMap(const std::unordered_map<std::string, double>& values) {
+    uint64_t combined = 0;
+    for (const auto& [key, value] : values) {
+      StructuralHasher entry;
+      entry.AddString(key);
+      entry.AddDouble(value);
+      combined += entry.Finish();
+    }
+    AddWord(values.size());
+    AddWord(combined);
+  }
+  
+  uint64_t Finish() const { return Mix(state_ ^ word_count_); }
+  
+ private:
+  // MurmurHash3 fmix64 finalizer.
+  static uint64_t Mix(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+  }
+  
+  void AddWord(uint64_t word) {
+    state_ = std::rotl(state_ ^ Mix(word), 27) * 0x9e3779b97f4a7c15ULL;
+    ++word_count_;
+  }
+  
+  uint64_t state_ = 0x6a09e667f3bcc909ULL;
+  uint64_t word_count_ = 0;
+};
+
+}  // namespace
+
+const char* SpoofingModeToString(mojom::SpoofingMode mode) {
+  switch (mode) {
+    case mojom::SpoofingMode::kJavaScript:
+      return "js";
+    case mojom::SpoofingMode::kNative:
+      return "native";
+  }
+  return "js";
+}
+
+std::optional<mojom::SpoofingMode> SpoofingModeFromString(std::string_view value) {
+  if (value == "js") {
+    return mojom::SpoofingMode::kJavaScript;
+  }
+  if (value == "native") {
+    return mojom::SpoofingMode::kNative;
+  }
+  return std::nullopt;
+}
+
+const char* WebGLNoiseModeToString(mojom::WebGLNoiseMode mode) {
+  switch (mode) {
+    case mojom::WebGLNoiseMode::kUpload:
+      return "upload";
+    case mojom::WebGLNoiseMode::kReadback:
+      return "readback";
+  }
+  return "readback";
+}
+
+std::optional<mojom::WebGLNoiseMode> WebGLNoiseModeFromString(std::string_view value) {
+  if (value == "upload") {
+    return mojom::WebGLNoiseMode::kUpload;
+  }
+  if (value == "readback") {
+    return mojom::WebGLNoiseMode::kReadback;
+  }
+  return std::nullopt;
+}
+
 // FingerprintConfig implementation
 mojom::FingerprintConfigPtr FingerprintConfig::ToMojoStruct() const {
   auto mojo_config = mojom::FingerprintConfig::New();
@@ -18,6 +151,7 @@ mojom::FingerprintConfigPtr FingerprintConfig::ToMojoStruct() const {
   mojo_config->profile_name = profile_name;
   mojo_config->device_profile = device_profile;
   mojo_config->behavior_pattern = behavior_pattern;
+  mojo_config->noise_seed = noise_seed;
   mojo_config->created_at = created_at;
   mojo_config->updated_at = updated_at;
   mojo_config->version = version;
@@ -30,6 +164,10 @@ mojom::FingerprintConfigPtr FingerprintConfig::ToMojoStruct() const {
   mojo_config->canvas->spoof_text_metrics = canvas.spoof_text_metrics;
   mojo_config->canvas->protect_data_url = canvas.protect_data_url;
   mojo_config->canvas->protect_image_data = canvas.protect_image_data;
+  mojo_config->canvas->cache_memory_limit_kb = canvas.cache_memory_limit_kb;
+  mojo_config->canvas->parallel_min_pixels = canvas.parallel_min_pixels;
+  mojo_config->canvas->parallel_tile_rows = canvas.parallel_tile_rows;
+  mojo_config->canvas->parallel_max_threads = canvas.parallel_max_threads;
   
   // WebGL config
   mojo_config->webgl = mojom::WebGLConfig::New();
@@ -42,6 +180,10 @@ mojom::FingerprintConfigPtr FingerprintConfig::ToMojoStruct() const {
   mojo_config->webgl->parameters = webgl.parameters;
   mojo_config->webgl->add_noise_to_buffers = webgl.add_noise_to_buffers;
   mojo_config->webgl->buffer_noise_level = webgl.buffer_noise_level;
+  mojo_config->webgl->buffer_parallel_min_bytes = webgl.buffer_parallel_min_bytes;
+  mojo_config->webgl->buffer_parallel_chunk_bytes = webgl.buffer_parallel_chunk_bytes;
+  mojo_config->webgl->buffer_parallel_max_threads = webgl.buffer_parallel_max_threads;
+  mojo_config->webgl->noise_mode = webgl.noise_mode;
   
   // Navigator config
   mojo_config->navigator = mojom::NavigatorConfig::New();
@@ -111,6 +253,7 @@ mojom::FingerprintConfigPtr FingerprintConfig::ToMojoStruct() const {
   // Anti-detection config
   mojo_config->anti_detection = mojom::AntiDetectionConfig::New();
   mojo_config->anti_detection->enabled = anti_detection.enabled;
+  mojo_config->anti_detection->mode = anti_detection.mode;
   
   mojo_config->anti_detection->webdriver = mojom::WebDriverProtection::New();
   mojo_config->anti_detection->webdriver->hide_webdriver_property = anti_detection.webdriver.hide_webdriver_property;
@@ -150,6 +293,7 @@ FingerprintConfig FingerprintConfig::FromMojoStruct(const mojom::FingerprintConf
   config.profile_name = mojo_config->profile_name;
   config.device_profile = mojo_config->device_profile;
   config.behavior_pattern = mojo_config->behavior_pattern;
+  config.noise_seed = mojo_config->noise_seed;
   config.created_at = mojo_config->created_at;
   config.updated_at = mojo_config->updated_at;
   config.version = mojo_config->version;
@@ -162,6 +306,10 @@ FingerprintConfig FingerprintConfig::FromMojoStruct(const mojom::FingerprintConf
     config.canvas.spoof_text_metrics = mojo_config->canvas->spoof_text_metrics;
     config.canvas.protect_data_url = mojo_config->canvas->protect_data_url;
     config.canvas.protect_image_data = mojo_config->canvas->protect_image_data;
+    config.canvas.cache_memory_limit_kb = mojo_config->canvas->cache_memory_limit_kb;
+    config.canvas.parallel_min_pixels = mojo_config->canvas->parallel_min_pixels;
+    config.canvas.parallel_tile_rows = mojo_config->canvas->parallel_tile_rows;
+    config.canvas.parallel_max_threads = mojo_config->canvas->parallel_max_threads;
   }
   
   // WebGL config
@@ -175,6 +323,10 @@ FingerprintConfig FingerprintConfig::FromMojoStruct(const mojom::FingerprintConf
     config.webgl.parameters = mojo_config->webgl->parameters;
     config.webgl.add_noise_to_buffers = mojo_config->webgl->add_noise_to_buffers;
     config.webgl.buffer_noise_level = mojo_config->webgl->buffer_noise_level;
+    config.webgl.buffer_parallel_min_bytes = mojo_config->webgl->buffer_parallel_min_bytes;
+    config.webgl.buffer_parallel_chunk_bytes = mojo_config->webgl->buffer_parallel_chunk_bytes;
+    config.webgl.buffer_parallel_max_threads = mojo_config->webgl->buffer_parallel_max_threads;
+    config.webgl.noise_mode = mojo_config->webgl->noise_mode;
   }
   
   // Navigator config
@@ -252,6 +404,7 @@ FingerprintConfig FingerprintConfig::FromMojoStruct(const mojom::FingerprintConf
   // Anti-detection config
   if (mojo_config->anti_detection) {
     config.anti_detection.enabled = mojo_config->anti_detection->enabled;
+    config.anti_detection.mode = mojo_config->anti_detection->mode;
     
     if (mojo_config->anti_detection->webdriver) {
       config.anti_detection.webdriver.hide_webdriver_property = mojo_config->anti_detection->webdriver->hide_webdriver_property;
@@ -291,6 +444,8 @@ base::Value FingerprintConfig::ToValue() const {
   config_dict.Set("profile_name", profile_name);
   config_dict.Set("device_profile", device_profile);
   config_dict.Set("behavior_pattern", behavior_pattern);
+  // As a string: a double cannot hold every 64-bit value.
+  config_dict.Set("noise_seed", base::NumberToString(noise_seed));
   config_dict.Set("created_at", created_at);
   config_dict.Set("updated_at", updated_at);
   config_dict.Set("version", version);
@@ -303,6 +458,10 @@ base::Value FingerprintConfig::ToValue() const {
   canvas_dict.Set("spoof_text_metrics", canvas.spoof_text_metrics);
   canvas_dict.Set("protect_data_url", canvas.protect_data_url);
   canvas_dict.Set("protect_image_data", canvas.protect_image_data);
+  canvas_dict.Set("cache_memory_limit_kb", canvas.cache_memory_limit_kb);
+  canvas_dict.Set("parallel_min_pixels", canvas.parallel_min_pixels);
+  canvas_dict.Set("parallel_tile_rows", canvas.parallel_tile_rows);
+  canvas_dict.Set("parallel_max_threads", canvas.parallel_max_threads);
   config_dict.Set("canvas", std::move(canvas_dict));
   
   // WebGL config
@@ -327,6 +486,10 @@ base::Value FingerprintConfig::ToValue() const {
   
   webgl_dict.Set("add_noise_to_buffers", webgl.add_noise_to_buffers);
   webgl_dict.Set("buffer_noise_level", webgl.buffer_noise_level);
+  webgl_dict.Set("buffer_parallel_min_bytes", webgl.buffer_parallel_min_bytes);
+  webgl_dict.Set("buffer_parallel_chunk_bytes", webgl.buffer_parallel_chunk_bytes);
+  webgl_dict.Set("buffer_parallel_max_threads", webgl.buffer_parallel_max_threads);
+  webgl_dict.Set("noise_mode", WebGLNoiseModeToString(webgl.noise_mode));
   config_dict.Set("webgl", std::move(webgl_dict));
   
   // Navigator config
@@ -353,6 +516,12 @@ base::Value FingerprintConfig::ToValue() const {
   navigator_dict.Set("mime_types", std::move(mime_types_list));
   config_dict.Set("navigator", std::move(navigator_dict));
   
+  // Anti-detection config
+  base::Value::Dict anti_detection_dict;
+  anti_detection_dict.Set("enabled", anti_detection.enabled);
+  anti_detection_dict.Set("mode", SpoofingModeToString(anti_detection.mode));
+  config_dict.Set("anti_detection", std::move(anti_detection_dict));
+  
   // Custom JS injections
   base::Value::List js_injections_list;
   for (const auto& injection : custom_js_injections) {
@@ -384,6 +553,9 @@ FingerprintConfig FingerprintConfig::FromValue(const base::Value& value) {
   const std::string* behavior_pattern = dict.FindString("behavior_pattern");
   if (behavior_pattern) config.behavior_pattern = *behavior_pattern;
   
+  const std::string* noise_seed = dict.FindString("noise_seed");
+  if (noise_seed) base::StringToUint64(*noise_seed, &config.noise_seed);
+  
   const std::string* created_at = dict.FindString("created_at");
   if (created_at) config.created_at = *created_at;
   
@@ -413,6 +585,65 @@ FingerprintConfig FingerprintConfig::FromValue(const base::Value& value) {
     
     const std::optional<bool> protect_image_data = canvas_dict->FindBool("protect_image_data");
     if (protect_image_data) config.canvas.protect_image_data = *protect_image_data;
+    
+    const std::optional<int> cache_memory_limit_kb = canvas_dict->FindInt("cache_memory_limit_kb");
+    if (cache_memory_limit_kb) config.canvas.cache_memory_limit_kb = *cache_memory_limit_kb;
+    
+    const std::optional<int> parallel_min_pixels = canvas_dict->FindInt("parallel_min_pixels");
+    if (parallel_min_pixels) config.canvas.parallel_min_pixels = *parallel_min_pixels;
+    
+    const std::optional<int> parallel_tile_rows = canvas_dict->FindInt("parallel_tile_rows");
+    if (parallel_tile_rows) config.canvas.parallel_tile_rows = *parallel_tile_rows;
+    
+    const std::optional<int> parallel_max_threads = canvas_dict->FindInt("parallel_max_threads");
+    if (parallel_max_threads) config.canvas.parallel_max_threads = *parallel_max_threads;
+  }
+  
+  // Parse WebGL buffer noise config
+  const base::Value::Dict* webgl_dict = dict.FindDict("webgl");
+  if (webgl_dict) {
+    const std::optional<bool> add_noise_to_buffers = webgl_dict->FindBool("add_noise_to_buffers");
+    if (add_noise_to_buffers) config.webgl.add_noise_to_buffers = *add_noise_to_buffers;
+    
+    const std::optional<double> buffer_noise_level = webgl_dict->FindDouble("buffer_noise_level");
+    if (buffer_noise_level) config.webgl.buffer_noise_level = *buffer_noise_level;
+    
+    const std::optional<int> buffer_parallel_min_bytes = webgl_dict->FindInt("buffer_parallel_min_bytes");
+    if (buffer_parallel_min_bytes) config.webgl.buffer_parallel_min_bytes = *buffer_parallel_min_bytes;
+    
+    const std::optional<int> buffer_parallel_chunk_bytes = webgl_dict->FindInt("buffer_parallel_chunk_bytes");
+    if (buffer_parallel_chunk_bytes) config.webgl.buffer_parallel_chunk_bytes = *buffer_parallel_chunk_bytes;
+    
+    const std::optional<int> buffer_parallel_max_threads = webgl_dict->FindInt("buffer_parallel_max_threads");
+    if (buffer_parallel_max_threads) config.webgl.buffer_parallel_max_threads = *buffer_parallel_max_threads;
+    
+    const std::string* noise_mode = webgl_dict->FindString("noise_mode");
+    if (noise_mode) {
+      std::optional<mojom::WebGLNoiseMode> parsed_noise_mode =
+          WebGLNoiseModeFromString(*noise_mode);
+      if (parsed_noise_mode) {
+        config.webgl.noise_mode = *parsed_noise_mode;
+      } else {
+        LOG(WARNING) << "Unknown webgl.noise_mode: " << *noise_mode;
+      }
+    }
+  }
+  
+  // Parse anti-detection config
+  const base::Value::Dict* anti_detection_dict = dict.FindDict("anti_detection");
+  if (anti_detection_dict) {
+    const std::optional<bool> anti_detection_enabled = anti_detection_dict->FindBool("enabled");
+    if (anti_detection_enabled) config.anti_detection.enabled = *anti_detection_enabled;
+    
+    const std::string* mode = anti_detection_dict->FindString("mode");
+    if (mode) {
+      std::optional<mojom::SpoofingMode> parsed_mode = SpoofingModeFromString(*mode);
+      if (parsed_mode) {
+        config.anti_detection.mode = *parsed_mode;
+      } else {
+        LOG(WARNING) << "Unknown anti_detection.mode: " << *mode;
+      }
+    }
   }
   
   return config;
@@ -439,6 +670,18 @@ bool FingerprintConfig::IsValid() const {
     return false;
   }
   
+  if (canvas.cache_memory_limit_kb < 0) {
+    return false;
+  }
+  
+  if (canvas.parallel_tile_rows <= 0 || canvas.parallel_max_threads <= 0) {
+    return false;
+  }
+  
+  if (webgl.buffer_parallel_chunk_bytes <= 0 || webgl.buffer_parallel_max_threads <= 0) {
+    return false;
+  }
+  
   return true;
 }
 
@@ -469,6 +712,18 @@ std::vector<std::string> FingerprintConfig::GetValidationErrors() const {
     errors.push_back("Audio noise level must be between 0.0 and 1.0");
   }
   
+  if (canvas.cache_memory_limit_kb < 0) {
+    errors.push_back("Canvas cache memory limit cannot be negative");
+  }
+  
+  if (canvas.parallel_tile_rows <= 0 || canvas.parallel_max_threads <= 0) {
+    errors.push_back("Canvas parallel tile rows and thread cap must be positive");
+  }
+  
+  if (webgl.buffer_parallel_chunk_bytes <= 0 || webgl.buffer_parallel_max_threads <= 0) {
+    errors.push_back("WebGL buffer parallel chunk size and thread cap must be positive");
+  }
+  
   return errors;
 }
 
@@ -485,6 +740,10 @@ void FingerprintConfig::MergeWith(const FingerprintConfig& other) {
     behavior_pattern = other.behavior_pattern;
   }
   
+  if (other.noise_seed != 0) {
+    noise_seed = other.noise_seed;
+  }
+  
   // Merge canvas config
   if (other.canvas.enabled) {
     canvas = other.canvas;
@@ -547,3 +806,135 @@ std::string FingerprintConfig::GetConfigHash() const {
   std::string hash = crypto::SHA256HashString(config_json);
   return base::HexEncode(hash.data(), hash.size());
 }
+
+uint64_t FingerprintConfig::GetStructuralHash() const {
+  // Covers every field except created_at/updated_at, so re-saving an
+  // unchanged profile keeps its hash. Unlike GetConfigHash() this includes
+  // the sections ToValue() does not serialize (audio, fonts, screen, ...),
+  // which matters for caches that share state between equal configs.
+  // Keep in sync with the struct when adding fields.
+  StructuralHasher hasher;
+  hasher.AddBool(enabled);
+  hasher.AddString(profile_name);
+  hasher.AddString(device_profile);
+  hasher.AddString(behavior_pattern);
+  hasher.AddUint(noise_seed);
+  hasher.AddString(version);
+  
+  hasher.AddBool(canvas.enabled);
+  hasher.AddBool(canvas.add_noise);
+  hasher.AddDouble(canvas.noise_level);
+  hasher.AddBool(canvas.spoof_text_metrics);
+  hasher.AddBool(canvas.protect_data_url);
+  hasher.AddBool(canvas.protect_image_data);
+  hasher.AddInt(canvas.cache_memory_limit_kb);
+  hasher.AddInt(canvas.parallel_min_pixels);
+  hasher.AddInt(canvas.parallel_tile_rows);
+  hasher.AddInt(canvas.parallel_max_threads);
+  
+  hasher.AddBool(webgl.enabled);
+  hasher.AddString(webgl.vendor);
+  hasher.AddString(webgl.renderer);
+  hasher.AddString(webgl.version);
+  hasher.AddString(webgl.shading_language_version);
+  hasher.AddStrings(webgl.extensions);
+  hasher.AddStringMap(webgl.parameters);
+  hasher.AddBool(webgl.add_noise_to_buffers);
+  hasher.AddDouble(webgl.buffer_noise_level);
+  hasher.AddInt(webgl.buffer_parallel_min_bytes);
+  hasher.AddInt(webgl.buffer_parallel_chunk_bytes);
+  hasher.AddInt(webgl.buffer_parallel_max_threads);
+  hasher.AddInt(static_cast<int>(webgl.noise_mode));
+  
+  hasher.AddBool(navigator.enabled);
+  hasher.AddString(navigator.user_agent);
+  hasher.AddString(navigator.platform);
+  hasher.AddStrings(navigator.languages);
+  hasher.AddInt(navigator.hardware_concurrency);
+  hasher.AddUint(navigator.device_memory);
+  hasher.AddBool(navigator.hide_webdriver);
+  hasher.AddBool(navigator.spoof_plugins);
+  hasher.AddStrings(navigator.mime_types);
+  
+  hasher.AddBool(audio.enabled);
+  hasher.AddBool(audio.add_noise);
+  hasher.AddDouble(audio.noise_level);
+  hasher.AddBool(audio.protect_analyser_node);
+  hasher.AddBool(audio.protect_offline_context);
+  hasher.AddInt(audio.sample_rate);
+  hasher.AddInt(audio.buffer_size);
+  
+  hasher.AddBool(font.enabled);
+  hasher.AddBool(font.spoof_enumeration);
+  hasher.AddBool(font.spoof_metrics);
+  hasher.AddStrings(font.available_fonts);
+  hasher.AddDoubleMap(font.font_metrics_offsets);
+  
+  hasher.AddBool(webrtc.enabled);
+  hasher.AddBool(webrtc.mask_local_ips);
+  hasher.AddBool(webrtc.disable_webrtc);
+  hasher.AddString(webrtc.fake_public_ip);
+  hasher.AddStrings(webrtc.allowed_ice_servers);
+  hasher.AddBool(webrtc.block_device_enumeration);
+  
+  hasher.AddBool(geolocation.enabled);
+  hasher.AddBool(geolocation.spoof_location);
+  hasher.AddDouble(geolocation.latitude);
+  hasher.AddDouble(geolocation.longitude);
+  hasher.AddDouble(geolocation.accuracy);
+  hasher.AddBool(geolocation.block_high_accuracy);
+  
+  hasher.AddBool(screen.enabled);
+  hasher.AddInt(screen.width);
+  hasher.AddInt(screen.height);
+  hasher.AddInt(screen.color_depth);
+  hasher.AddInt(screen.pixel_depth);
+  hasher.AddDouble(screen.device_pixel_ratio);
+  hasher.AddString(screen.orientation);
+  
+  hasher.AddBool(timezone.enabled);
+  hasher.AddString(timezone.timezone);
+  hasher.AddInt(timezone.timezone_offset);
+  hasher.AddBool(timezone.spoof_date_methods);
+  
+  hasher.AddBool(anti_detection.enabled);
+  hasher.AddInt(static_cast<int>(anti_detection.mode));
+  hasher.AddBool(anti_detection.webdriver.hide_webdriver_property);
+  hasher.AddBool(anti_detection.webdriver.hide_automation_flags);
+  hasher.AddBool(anti_detection.webdriver.spoof_chrome_runtime);
+  hasher.AddBool(anti_detection.webdriver.hide_selenium_variables);
+  hasher.AddStrings(anti_detection.webdriver.blocked_properties);
+  hasher.AddBool(anti_detection.automation.hide_headless_flags);
+  hasher.AddBool(anti_detection.automation.spoof_user_interaction);
+  hasher.AddBool(anti_detection.automation.add_human_delays);
+  hasher.AddBool(anti_detection.automation.randomize_request_timing);
+  hasher.AddInt(anti_detection.automation.min_delay_ms);
+  hasher.AddInt(anti_detection.automation.max_delay_ms);
+  hasher.AddBool(anti_detection.js_injection.detect_puppeteer);
+  hasher.AddBool(anti_detection.js_injection.detect_playwright);
+  hasher.AddBool(anti_detection.js_injection.detect_selenium);
+  hasher.AddBool(anti_detection.js_injection.block_detection_scripts);
+  hasher.AddStrings(anti_detection.js_injection.blocked_script_patterns);
+  
+  hasher.AddStrings(custom_js_injections);
+  
+  return hasher.Finish();
+}
+
+// static
+scoped_refptr<const FingerprintConfigSnapshot> FingerprintConfigSnapshot::Create(
+    FingerprintConfig config,
+    uint64_t generation) {
+  return base::WrapRefCounted(
+      new FingerprintConfigSnapshot(std::move(config), generation));
+}
+
+FingerprintConfigSnapshot::FingerprintConfigSnapshot(FingerprintConfig config,
+                                                     uint64_t generation)
+    : FingerprintConfig(std::move(config)),
+      generation_(generation),
+      structural_hash_(GetStructuralHash()) {}
+
+FingerprintConfigSnapshot::~FingerprintConfigSnapshot() = default;
+
+}  // namespace novebrowse
@@ -1,9 +1,13 @@
 #ifndef NOVEBROWSE_FINGERPRINT_CONFIG_H_
 #define NOVEBROWSE_FINGERPRINT_CONFIG_H_
 
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/values.h"
 #include "novebrowse/mojom/fingerprint.mojom.h"
 
@@ -17,6 +21,10 @@ struct CanvasConfig {
   bool spoof_text_metrics = true;
   bool protect_data_url = true;
   bool protect_image_data = true;
+  int cache_memory_limit_kb = 65536;  // 进程内全部画布共享的导出结果缓存上限
+  int parallel_min_pixels = 1048576;  // 超过该像素数时分带并行加噪
+  int parallel_tile_rows = 64;        // 每个并行任务处理的行数
+  int parallel_max_threads = 8;       // 并行加噪的最大线程数（1表示禁用）
 };
 
 // WebGL指纹保护配置
@@ -30,6 +38,10 @@ struct WebGLConfig {
   std::unordered_map<std::string, std::string> parameters;
   bool add_noise_to_buffers = true;
   double buffer_noise_level = 0.01;
+  int buffer_parallel_min_bytes = 4194304;    // 超过该字节数时分块并行加噪
+  int buffer_parallel_chunk_bytes = 1048576;  // 每个并行任务处理的字节数
+  int buffer_parallel_max_threads = 8;        // 并行加噪的最大线程数（1表示禁用）
+  mojom::WebGLNoiseMode noise_mode = mojom::WebGLNoiseMode::kReadback;
 };
 
 // Navigator对象保护配置
@@ -159,6 +171,9 @@ struct BehaviorPattern {
 struct AntiDetectionConfig {
   bool enabled = true;
   
+  // 伪造实现方式，对应JSON中的"js"/"native"
+  mojom::SpoofingMode mode = mojom::SpoofingMode::kJavaScript;
+  
   // WebDriver检测阻止
   struct WebDriverProtection {
     bool hide_webdriver_property = true;
@@ -188,6 +203,14 @@ struct AntiDetectionConfig {
   } js_injection;
 };
 
+// SpoofingMode与JSON字符串（"js"/"native"）互转
+const char* SpoofingModeToString(mojom::SpoofingMode mode);
+std::optional<mojom::SpoofingMode> SpoofingModeFromString(std::string_view value);
+
+// WebGLNoiseMode与JSON字符串（"upload"/"readback"）互转
+const char* WebGLNoiseModeToString(mojom::WebGLNoiseMode mode);
+std::optional<mojom::WebGLNoiseMode> WebGLNoiseModeFromString(std::string_view value);
+
 // 主指纹配置结构
 struct FingerprintConfig {
   bool enabled = true;
@@ -195,6 +218,10 @@ struct FingerprintConfig {
   std::string device_profile = "windows_chrome";
   std::string behavior_pattern = "normal_user";
   
+  // 噪声密钥 - 与profile_name一起派生各表面的噪声种子；为0时使用持久化的
+  // 安装密钥（FingerprintManager::LoadStartupConfig）
+  uint64_t noise_seed = 0;
+  
   CanvasConfig canvas;
   WebGLConfig webgl;
   NavigatorConfig navigator;
@@ -231,8 +258,39 @@ struct FingerprintConfig {
   // 合并配置
   void MergeWith(const FingerprintConfig& other);
   
-  // 生成配置哈希
+  // 生成配置哈希（SHA-256十六进制，稳定，用于持久化）
   std::string GetConfigHash() const;
+  
+  // 结构哈希 - 直接遍历字段计算的64位哈希，不含时间戳，仅用于进程内缓存键
+  uint64_t GetStructuralHash() const;
+};
+
+// 不可变配置快照 - 发布后只读，可在线程间共享，替换配置时整体换新
+class FingerprintConfigSnapshot
+    : public FingerprintConfig,
+      public base::RefCountedThreadSafe<FingerprintConfigSnapshot> {
+ public:
+  static scoped_refptr<const FingerprintConfigSnapshot> Create(
+      FingerprintConfig config,
+      uint64_t generation);
+  
+  FingerprintConfigSnapshot(const FingerprintConfigSnapshot&) = delete;
+  FingerprintConfigSnapshot& operator=(const FingerprintConfigSnapshot&) = delete;
+  
+  // 快照代数 - 每次发布递增，用于判断缓存是否过期
+  uint64_t generation() const { return generation_; }
+  
+  // 创建时计算的结构哈希，快照不可变因此无需失效
+  uint64_t structural_hash() const { return structural_hash_; }
+  
+ private:
+  friend class base::RefCountedThreadSafe<FingerprintConfigSnapshot>;
+  
+  FingerprintConfigSnapshot(FingerprintConfig config, uint64_t generation);
+  ~FingerprintConfigSnapshot();
+  
+  const uint64_t generation_;
+  const uint64_t structural_hash_;
 };
 
 }  // namespace novebrowse
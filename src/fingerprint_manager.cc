@@ -3,31 +3,105 @@
 #include <algorithm>
 #include <fstream>
 #include <random>
+#include <string_view>
+#include <utility>
 
+#include "base/base_paths.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/logging.h"
+#include "base/path_service.h"
+#include "base/rand_util.h"
 #include "base/strings/string_number_conversions.h"
-#include "base/strings/stringprintf.h"
+#include "base/strings/string_util.h"
+#include "base/task/task_traits.h"
+#include "base/task/thread_pool.h"
 #include "base/time/time.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/web_contents.h"
+#include "net/base/schemeful_site.h"
+#include "novebrowse/fingerprint_telemetry.h"
+#include "novebrowse/fingerprint_trace.h"
+#include "novebrowse/frame_config_registry.h"
 
 namespace novebrowse {
 
+namespace {
+
+// Bounds per-site telemetry memory; sites beyond the cap share one bucket.
+constexpr size_t kMaxTrackedSites = 1024;
+constexpr std::string_view kOverflowSiteKey = "(other)";
+constexpr std::string_view kOpaqueSiteKey = "(opaque)";
+
+// Directory next to the executable that the config_files target copies
+// the config into.
+constexpr base::FilePath::CharType kConfigDirectoryName[] =
+    FILE_PATH_LITERAL("novebrowse_config");
+
+// Per-install noise key, kept in the user data dir because the config
+// directory next to the executable may be read-only.
+constexpr base::FilePath::CharType kInstallNoiseKeyFileName[] =
+    FILE_PATH_LITERAL("novebrowse_noise_key");
+
+// Files under the config directory that hot reload tracks. A compiled store
+// and its JSON source are tracked separately; whichever was written last
+// is what gets loaded.
+constexpr base::FilePath::CharType kConfigFileName[] =
+    FILE_PATH_LITERAL("fingerprint_config.json");
+constexpr base::FilePath::CharType kDeviceProfilesBaseName[] =
+    FILE_PATH_LITERAL("device_profiles");
+constexpr base::FilePath::CharType kBehaviorPatternsBaseName[] =
+    FILE_PATH_LITERAL("behavior_patterns");
+constexpr base::FilePath::CharType kJsonExtension[] = FILE_PATH_LITERAL(".json");
+
+// Device profile the default config is built from, e.g. one per fleet
+// instance.
+constexpr char kDeviceProfileSwitch[] = "novebrowse-device-profile";
+
+// The browser's install noise key, passed to renderers so their defaults
+// seed like the browser's.
+constexpr char kNoiseKeySwitch[] = "novebrowse-noise-key";
+
+uint64_t NoiseKeyFromCommandLine() {
+  uint64_t key = 0;
+  if (base::CommandLine::InitializedForCurrentProcess()) {
+    base::StringToUint64(
+        base::CommandLine::ForCurrentProcess()->GetSwitchValueASCII(kNoiseKeySwitch),
+        &key);
+  }
+  return key;
+}
+
+}  // namespace
+
 // Static member initialization
 bool FingerprintManager::enabled_ = true;
 
 FingerprintManager::FingerprintManager() {
   InitializeDefaultConfig();
+  {
+    base::AutoLock auto_lock(lock_);
+    PublishFrameConfigs(base::MakeRefCounted<FrameConfigRegistry>());
+  }
+  if (base::CommandLine::InitializedForCurrentProcess()) {
+    startup_device_profile_ =
+        base::CommandLine::ForCurrentProcess()->GetSwitchValueASCII(
+            kDeviceProfileSwitch);
+  }
 }
 
 FingerprintManager::~FingerprintManager() = default;
 
 // static
 FingerprintManager* FingerprintManager::GetInstance() {
-  return base::Singleton<FingerprintManager>::get();
+  return base::Singleton<FingerprintManager,
+                         base::LeakySingletonTraits<FingerprintManager>>::get();
 }
 
 // static
@@ -46,8 +120,11 @@ void FingerprintManager::SetEnabled(bool enabled) {
 }
 
 bool FingerprintManager::LoadConfig(const std::string& config_path) {
-  base::AutoLock auto_lock(lock_);
+  TRACE_EVENT(NOVEBROWSE_TRACE_CATEGORY, "FingerprintManager::LoadConfig");
+  ScopedProtectionTimer timer(ProtectionSurface::kConfigLoad);
   
+  // Read, parse and validate without lock_ so readers on the navigation
+  // path never wait on file I/O; only the publish below takes the lock.
   std::string config_content;
   if (!base::ReadFileToString(base::FilePath::FromUTF8Unsafe(config_path), 
                               &config_content)) {
@@ -67,24 +144,33 @@ bool FingerprintManager::LoadConfig(const std::string& config_path) {
     return false;
   }
   
-  default_config_ = FingerprintConfig::FromValue(*parsed_json);
-  if (!default_config_.IsValid()) {
+  FingerprintConfig config = FingerprintConfig::FromValue(*parsed_json);
+  if (!config.IsValid()) {
     LOG(ERROR) << "Invalid fingerprint configuration";
-    auto errors = default_config_.GetValidationErrors();
+    auto errors = config.GetValidationErrors();
     for (const auto& error : errors) {
       LOG(ERROR) << "Config validation error: " << error;
     }
     return false;
   }
   
+  {
+    base::AutoLock auto_lock(lock_);
+    // A file without its own key (such as the shipped template) uses this
+    // install's persisted one, so installs do not share noise and one
+    // install keeps its noise across runs.
+    if (config.noise_seed == 0) {
+      config.noise_seed = install_noise_key_;
+    }
+    PublishDefaultConfig(std::move(config));
+  }
   LOG(INFO) << "Loaded fingerprint configuration from: " << config_path;
+  ApplyStartupDeviceProfile();
   return true;
 }
 
 bool FingerprintManager::SaveConfig(const std::string& config_path) {
-  base::AutoLock auto_lock(lock_);
-  
-  base::Value config_value = default_config_.ToValue();
+  base::Value config_value = GetDefaultConfig()->ToValue();
   std::string config_json;
   if (!base::JSONWriter::WriteWithOptions(
           config_value, base::JSONWriter::OPTIONS_PRETTY_PRINT, &config_json)) {
@@ -101,6 +187,360 @@ bool FingerprintManager::SaveConfig(const std::string& config_path) {
   return true;
 }
 
+void FingerprintManager::LoadConfigAsync(const std::string& config_path,
+                                         LoadCallback callback) {
+  PostLoad(base::BindOnce(&FingerprintManager::LoadConfig, base::Unretained(this),
+                          config_path),
+           std::move(callback));
+}
+
+void FingerprintManager::LoadStartupConfig(const base::FilePath& config_dir,
+                                           const base::FilePath& user_data_dir) {
+  // The key comes first so a config without its own noise_seed picks it
+  // up, and the patterns before the profiles so the startup device profile
+  // gets its paired pattern. Compiled stores fall back to their JSON.
+  LoadInstallNoiseKey(user_data_dir.Append(kInstallNoiseKeyFileName));
+  LoadBehaviorPatterns(config_dir.Append(kBehaviorPatternsBaseName)
+                           .AddExtension(CompiledProfileStore::kFileExtension)
+                           .AsUTF8Unsafe());
+  LoadConfig(config_dir.Append(kConfigFileName).AsUTF8Unsafe());
+  LoadDeviceProfiles(config_dir.Append(kDeviceProfilesBaseName)
+                         .AddExtension(CompiledProfileStore::kFileExtension)
+                         .AsUTF8Unsafe());
+  profile_pool_.set_capacity(ProfilePool::kDefaultCapacity);
+  RebuildProfilePool();
+}
+
+void FingerprintManager::LoadDeviceProfilesAsync(const std::string& profiles_path,
+                                                 LoadCallback callback) {
+  PostLoad(base::BindOnce(&FingerprintManager::LoadDeviceProfiles,
+                          base::Unretained(this), profiles_path),
+           std::move(callback));
+}
+
+void FingerprintManager::LoadBehaviorPatternsAsync(const std::string& patterns_path,
+                                                   LoadCallback callback) {
+  PostLoad(base::BindOnce(&FingerprintManager::LoadBehaviorPatterns,
+                          base::Unretained(this), patterns_path),
+           std::move(callback));
+}
+
+void FingerprintManager::StartWatchingConfigDirectory(
+    const base::FilePath& config_dir) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  
+  std::vector<base::FilePath> file_names = {
+      base::FilePath(kConfigFileName),
+      base::FilePath(kDeviceProfilesBaseName)
+          .AddExtension(CompiledProfileStore::kFileExtension),
+      base::FilePath(kDeviceProfilesBaseName).AddExtension(kJsonExtension),
+      base::FilePath(kBehaviorPatternsBaseName)
+          .AddExtension(CompiledProfileStore::kFileExtension),
+      base::FilePath(kBehaviorPatternsBaseName).AddExtension(kJsonExtension),
+  };
+  
+  // The watcher lives on the load sequence, so a reload it triggers is
+  // ordered with any explicit Load*Async call. The manager is a
+  // process-lifetime singleton, hence Unretained.
+  config_watcher_ = base::SequenceBound<ConfigDirectoryWatcher>(
+      GetLoadTaskRunner(), config_dir, std::move(file_names),
+      base::BindRepeating(&FingerprintManager::ReloadConfigFile,
+                          base::Unretained(this)));
+  config_watcher_.AsyncCall(&ConfigDirectoryWatcher::Start);
+}
+
+void FingerprintManager::StopWatchingConfigDirectory() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  config_watcher_.Reset();
+}
+
+// static
+base::FilePath FingerprintManager::GetDefaultConfigDirectory() {
+  return base::PathService::CheckedGet(base::DIR_EXE)
+      .Append(kConfigDirectoryName);
+}
+
+scoped_refptr<base::SequencedTaskRunner> FingerprintManager::GetLoadTaskRunner() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (!load_task_runner_) {
+    load_task_runner_ = base::ThreadPool::CreateSequencedTaskRunner(
+        {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+         base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN});
+  }
+  return load_task_runner_;
+}
+
+void FingerprintManager::PostLoad(base::OnceCallback<bool()> load,
+                                  LoadCallback callback) {
+  if (!callback) {
+    callback = base::DoNothing();
+  }
+  GetLoadTaskRunner()->PostTaskAndReplyWithResult(FROM_HERE, std::move(load),
+                                                  std::move(callback));
+}
+
+void FingerprintManager::ReloadConfigFile(const base::FilePath& path) {
+  // A failed reload leaves the previously published data in place.
+  bool reloaded = false;
+  base::FilePath base_name = path.BaseName();
+  if (base_name == base::FilePath(kConfigFileName)) {
+    reloaded = LoadConfig(path.AsUTF8Unsafe());
+  } else if (base_name.RemoveFinalExtension() ==
+             base::FilePath(kDeviceProfilesBaseName)) {
+    reloaded = LoadDeviceProfiles(path.AsUTF8Unsafe());
+  } else if (base_name.RemoveFinalExtension() ==
+             base::FilePath(kBehaviorPatternsBaseName)) {
+    reloaded = LoadBehaviorPatterns(path.AsUTF8Unsafe());
+  }
+  
+  // Pooled configs are built from all three files.
+  if (reloaded) {
+    RebuildProfilePool();
+  }
+}
+
+void FingerprintManager::WarmProfilePool(size_t count) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  profile_pool_.set_capacity(std::min(count, ProfilePool::kMaxCapacity));
+  GetLoadTaskRunner()->PostTask(
+      FROM_HERE, base::BindOnce(&FingerprintManager::RebuildProfilePool,
+                                base::Unretained(this)));
+}
+
+void FingerprintManager::RebuildProfilePool() {
+  size_t capacity = profile_pool_.capacity();
+  std::vector<ProfilePool::Entry> entries;
+  if (capacity == 0) {
+    profile_pool_.Replace(std::move(entries));
+    return;
+  }
+  
+  // Sorted so the same files always produce the same pool.
+  std::vector<std::string> profile_names = GetAvailableProfiles();
+  std::vector<std::string> pattern_names = GetAvailablePatterns();
+  std::sort(profile_names.begin(), profile_names.end());
+  std::sort(pattern_names.begin(), pattern_names.end());
+  
+  scoped_refptr<const FingerprintConfigSnapshot> base_config = GetDefaultConfig();
+  entries.reserve(std::min(capacity, profile_names.size()));
+  for (size_t i = 0; i < profile_names.size() && entries.size() < capacity; ++i) {
+    const std::string& pattern = ProfilePool::PickBehaviorPattern(
+        profile_names[i], pattern_names, base_config->behavior_pattern);
+    FingerprintConfig config = ProfilePool::BuildConfig(
+        *base_config, GetDeviceProfile(profile_names[i]), pattern);
+    if (!config.IsValid()) {
+      LOG(WARNING) << "Skipping invalid pooled profile: " << profile_names[i];
+      continue;
+    }
+    
+    scoped_refptr<const FingerprintConfigSnapshot> snapshot;
+    {
+      base::AutoLock auto_lock(lock_);
+      snapshot = CreateSnapshot(std::move(config));
+    }
+    entries.emplace_back(profile_names[i], std::move(snapshot));
+  }
+  
+  LOG(INFO) << "Profile pool rebuilt with " << entries.size() << " configs";
+  profile_pool_.Replace(std::move(entries));
+}
+
+bool FingerprintManager::SwitchProfile(content::RenderFrameHost* frame,
+                                       const std::string& profile_name) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (!frame) {
+    return false;
+  }
+  
+  base::TimeTicks start = base::TimeTicks::Now();
+  scoped_refptr<const FingerprintConfigSnapshot> config =
+      GetProfileConfig(profile_name);
+  if (!config) {
+    return false;
+  }
+  
+  ApplySnapshotToFrame(frame, std::move(config));
+  INCREMENT_FINGERPRINT_STAT(kProfileSwitches);
+  FingerprintStatCounters::Add(FingerprintStat::kProfileSwitchMicroseconds,
+                               (base::TimeTicks::Now() - start).InMicroseconds());
+  return true;
+}
+
+bool FingerprintManager::SwitchProfile(content::WebContents* contents,
+                                       const std::string& profile_name) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (!contents) {
+    return false;
+  }
+  
+  base::TimeTicks start = base::TimeTicks::Now();
+  scoped_refptr<const FingerprintConfigSnapshot> config =
+      GetProfileConfig(profile_name);
+  if (!config) {
+    return false;
+  }
+  
+  // Every frame of the page shares the one snapshot.
+  contents->GetPrimaryMainFrame()->ForEachRenderFrameHost(
+      [this, &config](content::RenderFrameHost* frame) {
+        ApplySnapshotToFrame(frame, config);
+      });
+  INCREMENT_FINGERPRINT_STAT(kProfileSwitches);
+  FingerprintStatCounters::Add(FingerprintStat::kProfileSwitchMicroseconds,
+                               (base::TimeTicks::Now() - start).InMicroseconds());
+  return true;
+}
+
+void FingerprintManager::PrimeRendererWithProfilePool(
+    content::RenderFrameHost* frame) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (!frame || !frame->IsRenderFrameLive()) {
+    return;
+  }
+  
+  std::vector<scoped_refptr<const FingerprintConfigSnapshot>> configs =
+      profile_pool_.GetAll();
+  if (!configs.empty()) {
+    frame->PrimeFingerprintConfigs(std::move(configs));
+  }
+}
+
+uint64_t FingerprintManager::install_noise_key() const {
+  base::AutoLock auto_lock(lock_);
+  return install_noise_key_;
+}
+
+void FingerprintManager::AppendRendererSwitches(
+    base::CommandLine* command_line) const {
+  command_line->AppendSwitchASCII(kNoiseKeySwitch,
+                                  base::NumberToString(install_noise_key()));
+}
+
+bool FingerprintManager::LoadInstallNoiseKey(const base::FilePath& key_path) {
+  uint64_t key = 0;
+  std::string contents;
+  if (base::ReadFileToString(key_path, &contents)) {
+    base::StringToUint64(base::TrimWhitespaceASCII(contents, base::TRIM_ALL),
+                         &key);
+  }
+  
+  if (key == 0) {
+    // First run, or the file is gone: persist the random key this run
+    // started with.
+    {
+      base::AutoLock auto_lock(lock_);
+      key = install_noise_key_;
+    }
+    if (!base::CreateDirectory(key_path.DirName()) ||
+        !base::WriteFile(key_path, base::NumberToString(key))) {
+      LOG(ERROR) << "Failed to write install noise key: " << key_path;
+      return false;
+    }
+    return true;
+  }
+  
+  {
+    base::AutoLock auto_lock(lock_);
+    // A config that carries its own noise_seed keeps it.
+    bool default_uses_key = default_config_->noise_seed == install_noise_key_;
+    install_noise_key_ = key;
+    if (default_uses_key) {
+      FingerprintConfig config = *default_config_;
+      config.noise_seed = key;
+      PublishDefaultConfig(std::move(config));
+    }
+  }
+  
+  // Pooled configs were built from the previous key.
+  RebuildProfilePool();
+  return true;
+}
+
+void FingerprintManager::ApplyStartupDeviceProfile() {
+  if (startup_device_profile_.empty()) {
+    return;
+  }
+  
+  // Profiles may load before or after the config; whichever comes second
+  // publishes the combined default.
+  DeviceProfile profile = GetDeviceProfile(startup_device_profile_);
+  if (profile.name.empty()) {
+    LOG(WARNING) << "Startup device profile not found: " << startup_device_profile_;
+    return;
+  }
+  
+  std::vector<std::string> pattern_names = GetAvailablePatterns();
+  std::sort(pattern_names.begin(), pattern_names.end());
+  scoped_refptr<const FingerprintConfigSnapshot> base_config = GetDefaultConfig();
+  FingerprintConfig config = ProfilePool::BuildConfig(
+      *base_config, profile,
+      ProfilePool::PickBehaviorPattern(startup_device_profile_, pattern_names,
+                                       base_config->behavior_pattern));
+  if (!config.IsValid()) {
+    LOG(ERROR) << "Device profile produces an invalid config: "
+               << startup_device_profile_;
+    return;
+  }
+  
+  base::AutoLock auto_lock(lock_);
+  PublishDefaultConfig(std::move(config));
+}
+
+scoped_refptr<const FingerprintConfigSnapshot> FingerprintManager::GetProfileConfig(
+    const std::string& profile_name) {
+  scoped_refptr<const FingerprintConfigSnapshot> config =
+      profile_pool_.Find(profile_name);
+  if (config) {
+    return config;
+  }
+  
+  INCREMENT_FINGERPRINT_STAT(kProfilePoolMisses);
+  DeviceProfile profile = GetDeviceProfile(profile_name);
+  if (profile.name.empty()) {
+    return nullptr;
+  }
+  
+  // Same pairing as RebuildProfilePool, so a miss builds what the pool
+  // would have held.
+  std::vector<std::string> pattern_names = GetAvailablePatterns();
+  std::sort(pattern_names.begin(), pattern_names.end());
+  scoped_refptr<const FingerprintConfigSnapshot> base_config = GetDefaultConfig();
+  FingerprintConfig profile_config = ProfilePool::BuildConfig(
+      *base_config, profile,
+      ProfilePool::PickBehaviorPattern(profile_name, pattern_names,
+                                       base_config->behavior_pattern));
+  if (!profile_config.IsValid()) {
+    LOG(ERROR) << "Device profile produces an invalid config: " << profile_name;
+    return nullptr;
+  }
+  
+  {
+    base::AutoLock auto_lock(lock_);
+    config = CreateSnapshot(std::move(profile_config));
+  }
+  profile_pool_.Add(profile_name, config);
+  return config;
+}
+
+void FingerprintManager::ApplySnapshotToFrame(
+    content::RenderFrameHost* frame,
+    scoped_refptr<const FingerprintConfigSnapshot> config) {
+  content::WebContents* web_contents = content::WebContents::FromRenderFrameHost(frame);
+  if (web_contents) {
+    FrameConfigObserver::CreateForWebContents(web_contents);
+  }
+  
+  {
+    base::AutoLock auto_lock(lock_);
+    PublishFrameConfigs(frame_configs_->Set(frame->GetGlobalId(), config));
+  }
+  
+  // Frames that are not live yet pick the config up at commit.
+  if (frame->IsRenderFrameLive()) {
+    frame->ApplyFingerprintConfig(std::move(config));
+  }
+}
+
 void FingerprintManager::UpdateConfig(const FingerprintConfig& config) {
   base::AutoLock auto_lock(lock_);
   
@@ -109,33 +549,30 @@ void FingerprintManager::UpdateConfig(const FingerprintConfig& config) {
     return;
   }
   
-  default_config_ = config;
-  default_config_.updated_at = base::Time::Now().ToJsTimeIgnoringNull();
+  FingerprintConfig updated_config = config;
+  updated_config.updated_at = base::Time::Now().ToJsTimeIgnoringNull();
+  PublishDefaultConfig(std::move(updated_config));
   
-  LOG(INFO) << "Updated fingerprint configuration";
+  DVLOG(1) << "Updated fingerprint configuration";
 }
 
-FingerprintConfig FingerprintManager::GetConfigForFrame(
+scoped_refptr<const FingerprintConfigSnapshot> FingerprintManager::GetConfigForFrame(
     content::RenderFrameHost* frame) {
-  base::AutoLock auto_lock(lock_);
-  
   if (!frame) {
-    return default_config_;
+    return GetDefaultConfig();
   }
   
-  std::string frame_id = GenerateFrameId(frame);
-  auto it = frame_configs_.find(frame_id);
-  if (it != frame_configs_.end()) {
-    return it->second;
+  scoped_refptr<const FingerprintConfigSnapshot> frame_config =
+      GetFrameConfigs()->Find(frame->GetGlobalId());
+  if (frame_config) {
+    return frame_config;
   }
   
-  return default_config_;
+  return GetDefaultConfig();
 }
 
 void FingerprintManager::SetConfigForFrame(content::RenderFrameHost* frame,
                                           const FingerprintConfig& config) {
-  base::AutoLock auto_lock(lock_);
-  
   if (!frame) {
     LOG(ERROR) << "Cannot set config for null frame";
     return;
@@ -146,24 +583,29 @@ void FingerprintManager::SetConfigForFrame(content::RenderFrameHost* frame,
     return;
   }
   
-  std::string frame_id = GenerateFrameId(frame);
-  frame_configs_[frame_id] = config;
+  // The observer drops the entry when the frame goes away.
+  content::WebContents* web_contents = content::WebContents::FromRenderFrameHost(frame);
+  if (web_contents) {
+    FrameConfigObserver::CreateForWebContents(web_contents);
+  }
+  
+  base::AutoLock auto_lock(lock_);
+  PublishFrameConfigs(
+      frame_configs_->Set(frame->GetGlobalId(), CreateSnapshot(config)));
   
-  LOG(INFO) << "Set fingerprint config for frame: " << frame_id;
+  DVLOG(1) << "Set fingerprint config for frame: " << frame->GetGlobalId();
 }
 
 void FingerprintManager::RemoveFrameConfig(content::RenderFrameHost* frame) {
-  base::AutoLock auto_lock(lock_);
-  
   if (!frame) {
     return;
   }
   
-  std::string frame_id = GenerateFrameId(frame);
-  auto it = frame_configs_.find(frame_id);
-  if (it != frame_configs_.end()) {
-    frame_configs_.erase(it);
-    LOG(INFO) << "Removed fingerprint config for frame: " << frame_id;
+  base::AutoLock auto_lock(lock_);
+  if (scoped_refptr<const FrameConfigRegistry> remaining =
+          frame_configs_->Remove(frame->GetGlobalId())) {
+    PublishFrameConfigs(std::move(remaining));
+    DVLOG(1) << "Removed fingerprint config for frame: " << frame->GetGlobalId();
   }
 }
 
@@ -175,12 +617,97 @@ void FingerprintManager::SetDefaultConfig(const FingerprintConfig& config) {
     return;
   }
   
-  default_config_ = config;
+  PublishDefaultConfig(config);
   LOG(INFO) << "Updated default fingerprint configuration";
 }
 
-bool FingerprintManager::LoadDeviceProfiles(const std::string& profiles_path) {
+scoped_refptr<const FingerprintConfigSnapshot> FingerprintManager::GetDefaultConfig()
+    const {
+  // Fast path: the thread already holds the current snapshot. Only a
+  // generation mismatch, i.e. the first read after a publish, takes lock_.
+  uint64_t generation = default_config_generation_.load(std::memory_order_acquire);
+  CachedDefaultConfig* cached = cached_default_config_.Get();
+  if (cached && cached->generation == generation) {
+    return cached->snapshot;
+  }
+  
   base::AutoLock auto_lock(lock_);
+  if (!cached) {
+    cached_default_config_.Set(std::make_unique<CachedDefaultConfig>());
+    cached = cached_default_config_.Get();
+  }
+  cached->snapshot = default_config_;
+  cached->generation = default_config_->generation();
+  return cached->snapshot;
+}
+
+void FingerprintManager::PublishDefaultConfig(FingerprintConfig config) {
+  lock_.AssertAcquired();
+  
+  // Readers still holding the previous snapshot keep it alive until they
+  // drop their reference.
+  default_config_ = CreateSnapshot(std::move(config));
+  default_config_generation_.store(default_config_->generation(),
+                                   std::memory_order_release);
+}
+
+scoped_refptr<const FrameConfigRegistry> FingerprintManager::GetFrameConfigs()
+    const {
+  // Same scheme as GetDefaultConfig: lock_ only on the first lookup after
+  // a frame config was set or removed.
+  uint64_t generation = frame_configs_generation_.load(std::memory_order_acquire);
+  CachedFrameConfigs* cached = cached_frame_configs_.Get();
+  if (cached && cached->generation == generation) {
+    return cached->registry;
+  }
+  
+  base::AutoLock auto_lock(lock_);
+  if (!cached) {
+    cached_frame_configs_.Set(std::make_unique<CachedFrameConfigs>());
+    cached = cached_frame_configs_.Get();
+  }
+  cached->registry = frame_configs_;
+  cached->generation = frame_configs_->generation();
+  return cached->registry;
+}
+
+void FingerprintManager::PublishFrameConfigs(
+    scoped_refptr<const FrameConfigRegistry> registry) {
+  lock_.AssertAcquired();
+  
+  frame_configs_ = std::move(registry);
+  frame_configs_generation_.store(frame_configs_->generation(),
+                                  std::memory_order_release);
+}
+
+scoped_refptr<const FingerprintConfigSnapshot> FingerprintManager::CreateSnapshot(
+    FingerprintConfig config) {
+  lock_.AssertAcquired();
+  return FingerprintConfigSnapshot::Create(std::move(config),
+                                           next_snapshot_generation_++);
+}
+
+bool FingerprintManager::LoadDeviceProfiles(const std::string& profiles_path) {
+  base::FilePath path = base::FilePath::FromUTF8Unsafe(profiles_path);
+  if (path.MatchesExtension(CompiledProfileStore::kFileExtension)) {
+    scoped_refptr<const CompiledProfileStore> store = CompiledProfileStore::Open(
+        path, CompiledProfileStore::Kind::kDeviceProfiles);
+    if (store) {
+      {
+        base::AutoLock auto_lock(lock_);
+        compiled_device_profiles_ = std::move(store);
+        device_profiles_.clear();
+        LOG(INFO) << "Mapped " << compiled_device_profiles_->size()
+                  << " compiled device profiles from: " << profiles_path;
+      }
+      ApplyStartupDeviceProfile();
+      return true;
+    }
+    
+    // JSON stays the fallback for a missing or stale compiled store.
+    return LoadDeviceProfiles(
+        path.ReplaceExtension(FILE_PATH_LITERAL(".json")).AsUTF8Unsafe());
+  }
   
   std::string profiles_content;
   if (!base::ReadFileToString(base::FilePath::FromUTF8Unsafe(profiles_path), 
@@ -208,7 +735,7 @@ bool FingerprintManager::LoadDeviceProfiles(const std::string& profiles_path) {
     return false;
   }
   
-  device_profiles_.clear();
+  std::unordered_map<std::string, DeviceProfile> loaded_profiles;
   for (const auto& [profile_name, profile_value] : *profiles) {
     if (!profile_value.is_dict()) {
       LOG(WARNING) << "Skipping invalid device profile: " << profile_name;
@@ -283,11 +810,19 @@ bool FingerprintManager::LoadDeviceProfiles(const std::string& profiles_path) {
       if (renderer) profile.webgl.renderer = *renderer;
     }
     
-    device_profiles_[profile_name] = std::move(profile);
+    loaded_profiles[profile_name] = std::move(profile);
   }
   
-  LOG(INFO) << "Loaded " << device_profiles_.size() << " device profiles from: " 
+  size_t profile_count = loaded_profiles.size();
+  {
+    base::AutoLock auto_lock(lock_);
+    compiled_device_profiles_ = nullptr;
+    device_profiles_ = std::move(loaded_profiles);
+  }
+  
+  LOG(INFO) << "Loaded " << profile_count << " device profiles from: " 
             << profiles_path;
+  ApplyStartupDeviceProfile();
   return true;
 }
 
@@ -295,6 +830,14 @@ std::vector<std::string> FingerprintManager::GetAvailableProfiles() const {
   base::AutoLock auto_lock(lock_);
   
   std::vector<std::string> profile_names;
+  if (compiled_device_profiles_) {
+    profile_names.reserve(compiled_device_profiles_->size());
+    for (size_t i = 0; i < compiled_device_profiles_->size(); ++i) {
+      profile_names.emplace_back(compiled_device_profiles_->NameAt(i));
+    }
+    return profile_names;
+  }
+  
   profile_names.reserve(device_profiles_.size());
   
   for (const auto& [name, profile] : device_profiles_) {
@@ -305,6 +848,11 @@ std::vector<std::string> FingerprintManager::GetAvailableProfiles() const {
 }
 
 DeviceProfile FingerprintManager::GetDeviceProfile(const std::string& profile_name) const {
+  if (std::optional<CompiledProfileStore::DeviceProfileView> view =
+          FindDeviceProfileView(profile_name)) {
+    return view->ToDeviceProfile();
+  }
+  
   base::AutoLock auto_lock(lock_);
   
   auto it = device_profiles_.find(profile_name);
@@ -316,8 +864,35 @@ DeviceProfile FingerprintManager::GetDeviceProfile(const std::string& profile_na
   return DeviceProfile{};
 }
 
+std::optional<CompiledProfileStore::DeviceProfileView>
+FingerprintManager::FindDeviceProfileView(std::string_view profile_name) const {
+  scoped_refptr<const CompiledProfileStore> store;
+  {
+    base::AutoLock auto_lock(lock_);
+    store = compiled_device_profiles_;
+  }
+  
+  // The view keeps the store mapped even if a reload replaces it.
+  return store ? store->FindDeviceProfile(profile_name) : std::nullopt;
+}
+
 bool FingerprintManager::LoadBehaviorPatterns(const std::string& patterns_path) {
-  base::AutoLock auto_lock(lock_);
+  base::FilePath path = base::FilePath::FromUTF8Unsafe(patterns_path);
+  if (path.MatchesExtension(CompiledProfileStore::kFileExtension)) {
+    scoped_refptr<const CompiledProfileStore> store = CompiledProfileStore::Open(
+        path, CompiledProfileStore::Kind::kBehaviorPatterns);
+    if (store) {
+      base::AutoLock auto_lock(lock_);
+      compiled_behavior_patterns_ = std::move(store);
+      behavior_patterns_.clear();
+      LOG(INFO) << "Mapped " << compiled_behavior_patterns_->size()
+                << " compiled behavior patterns from: " << patterns_path;
+      return true;
+    }
+    
+    return LoadBehaviorPatterns(
+        path.ReplaceExtension(FILE_PATH_LITERAL(".json")).AsUTF8Unsafe());
+  }
   
   std::string patterns_content;
   if (!base::ReadFileToString(base::FilePath::FromUTF8Unsafe(patterns_path), 
@@ -345,7 +920,7 @@ bool FingerprintManager::LoadBehaviorPatterns(const std::string& patterns_path)
     return false;
   }
   
-  behavior_patterns_.clear();
+  std::unordered_map<std::string, BehaviorPattern> loaded_patterns;
   for (const auto& [pattern_name, pattern_value] : *patterns) {
     if (!pattern_value.is_dict()) {
       LOG(WARNING) << "Skipping invalid behavior pattern: " << pattern_name;
@@ -425,10 +1000,17 @@ bool FingerprintManager::LoadBehaviorPatterns(const std::string& patterns_path)
       if (form_speed) pattern.interaction.form_fill_speed = *form_speed;
     }
     
-    behavior_patterns_[pattern_name] = std::move(pattern);
+    loaded_patterns[pattern_name] = std::move(pattern);
   }
   
-  LOG(INFO) << "Loaded " << behavior_patterns_.size() << " behavior patterns from: " 
+  size_t pattern_count = loaded_patterns.size();
+  {
+    base::AutoLock auto_lock(lock_);
+    compiled_behavior_patterns_ = nullptr;
+    behavior_patterns_ = std::move(loaded_patterns);
+  }
+  
+  LOG(INFO) << "Loaded " << pattern_count << " behavior patterns from: " 
             << patterns_path;
   return true;
 }
@@ -437,6 +1019,14 @@ std::vector<std::string> FingerprintManager::GetAvailablePatterns() const {
   base::AutoLock auto_lock(lock_);
   
   std::vector<std::string> pattern_names;
+  if (compiled_behavior_patterns_) {
+    pattern_names.reserve(compiled_behavior_patterns_->size());
+    for (size_t i = 0; i < compiled_behavior_patterns_->size(); ++i) {
+      pattern_names.emplace_back(compiled_behavior_patterns_->NameAt(i));
+    }
+    return pattern_names;
+  }
+  
   pattern_names.reserve(behavior_patterns_.size());
   
   for (const auto& [name, pattern] : behavior_patterns_) {
@@ -447,6 +1037,11 @@ std::vector<std::string> FingerprintManager::GetAvailablePatterns() const {
 }
 
 BehaviorPattern FingerprintManager::GetBehaviorPattern(const std::string& pattern_name) const {
+  if (std::optional<CompiledProfileStore::BehaviorPatternView> view =
+          FindBehaviorPatternView(pattern_name)) {
+    return view->ToBehaviorPattern();
+  }
+  
   base::AutoLock auto_lock(lock_);
   
   auto it = behavior_patterns_.find(pattern_name);
@@ -458,91 +1053,164 @@ BehaviorPattern FingerprintManager::GetBehaviorPattern(const std::string& patter
   return BehaviorPattern{};
 }
 
+std::optional<CompiledProfileStore::BehaviorPatternView>
+FingerprintManager::FindBehaviorPatternView(std::string_view pattern_name) const {
+  scoped_refptr<const CompiledProfileStore> store;
+  {
+    base::AutoLock auto_lock(lock_);
+    store = compiled_behavior_patterns_;
+  }
+  
+  return store ? store->FindBehaviorPattern(pattern_name) : std::nullopt;
+}
+
 FingerprintManager::Statistics FingerprintManager::GetStatistics() const {
-  base::AutoLock auto_lock(lock_);
-  return statistics_;
+  return FingerprintStatCounters::Aggregate();
 }
 
 void FingerprintManager::ResetStatistics() {
-  base::AutoLock auto_lock(lock_);
-  statistics_ = Statistics{};
+  FingerprintStatCounters::Reset();
+  {
+    base::AutoLock auto_lock(telemetry_lock_);
+    site_statistics_.clear();
+  }
   LOG(INFO) << "Reset fingerprint protection statistics";
 }
 
-void FingerprintManager::IncrementStat(const std::string& stat_name) {
-  base::AutoLock auto_lock(lock_);
+void FingerprintManager::IncrementStat(FingerprintStat stat) {
+  FingerprintStatCounters::Increment(stat);
+}
+
+void FingerprintManager::RecordTelemetryBatch(const url::Origin& origin,
+                                              base::span<const uint8_t> batch) {
+  Statistics batch_counts;
+  int count = ForEachTelemetryRecord(
+      batch, [&](FingerprintStat stat, const TelemetryRecord& record) {
+        if (stat == FingerprintStat::kLatencySamples) {
+          if (record.detail >= kProtectionSurfaceCount) {
+            return;
+          }
+          // The payload saturates at 65535us; longer calls land in that
+          // bucket and undercount the time sum.
+          batch_counts.counts[static_cast<size_t>(
+              FingerprintStat::kSampledProtectionMicroseconds)] += record.payload;
+          batch_counts.latency[record.detail].Add(record.payload);
+        }
+        ++batch_counts.counts[static_cast<size_t>(stat)];
+      });
+  if (count <= 0) {
+    return;
+  }
+  
+  for (size_t i = 0; i < kFingerprintStatCount; ++i) {
+    if (batch_counts.counts[i]) {
+      FingerprintStatCounters::Add(static_cast<FingerprintStat>(i),
+                                   batch_counts.counts[i]);
+    }
+  }
+  for (size_t i = 0; i < kProtectionSurfaceCount; ++i) {
+    FingerprintStatCounters::AddLatency(static_cast<ProtectionSurface>(i),
+                                        batch_counts.latency[i]);
+  }
+  
+  // The origin is renderer-supplied; it only labels telemetry and is never
+  // used for any security decision.
+  std::string site = origin.opaque()
+                         ? std::string(kOpaqueSiteKey)
+                         : net::SchemefulSite(origin).Serialize();
+  
+  base::AutoLock auto_lock(telemetry_lock_);
+  auto it = site_statistics_.find(site);
+  if (it == site_statistics_.end()) {
+    if (site_statistics_.size() >= kMaxTrackedSites) {
+      site = std::string(kOverflowSiteKey);
+    }
+    it = site_statistics_.try_emplace(std::move(site)).first;
+  }
   
-  if (stat_name == "total_frames_protected") {
-    statistics_.total_frames_protected++;
-  } else if (stat_name == "canvas_operations_spoofed") {
-    statistics_.canvas_operations_spoofed++;
-  } else if (stat_name == "webgl_parameters_spoofed") {
-    statistics_.webgl_parameters_spoofed++;
-  } else if (stat_name == "navigator_properties_spoofed") {
-    statistics_.navigator_properties_spoofed++;
-  } else if (stat_name == "webdriver_detections_blocked") {
-    statistics_.webdriver_detections_blocked++;
-  } else if (stat_name == "audio_contexts_protected") {
-    statistics_.audio_contexts_protected++;
-  } else if (stat_name == "font_enumerations_spoofed") {
-    statistics_.font_enumerations_spoofed++;
-  } else if (stat_name == "geolocation_requests_spoofed") {
-    statistics_.geolocation_requests_spoofed++;
-  } else if (stat_name == "webrtc_connections_protected") {
-    statistics_.webrtc_connections_protected++;
+  for (size_t i = 0; i < kFingerprintStatCount; ++i) {
+    it->second.counts[i] += batch_counts.counts[i];
   }
+  for (size_t i = 0; i < kProtectionSurfaceCount; ++i) {
+    for (size_t b = 0; b < LatencyHistogram::kBucketCount; ++b) {
+      it->second.latency[i].buckets[b] += batch_counts.latency[i].buckets[b];
+    }
+  }
+}
+
+std::map<std::string, FingerprintManager::Statistics>
+FingerprintManager::GetSiteStatistics() const {
+  base::AutoLock auto_lock(telemetry_lock_);
+  return std::map<std::string, Statistics>(site_statistics_.begin(),
+                                           site_statistics_.end());
 }
 
 void FingerprintManager::InitializeDefaultConfig() {
-  default_config_.enabled = true;
-  default_config_.profile_name = "default";
-  default_config_.device_profile = "windows_desktop";
-  default_config_.behavior_pattern = "normal_user";
-  default_config_.version = "1.0.0";
-  default_config_.created_at = base::Time::Now().ToJsTimeIgnoringNull();
-  default_config_.updated_at = default_config_.created_at;
+  FingerprintConfig config;
+  config.enabled = true;
+  config.profile_name = "default";
+  config.device_profile = "windows_desktop";
+  config.behavior_pattern = "normal_user";
+  // Renderers start with the browser's key; the browser replaces its random
+  // one with the persisted key in LoadStartupConfig.
+  install_noise_key_ = NoiseKeyFromCommandLine();
+  if (install_noise_key_ == 0) {
+    install_noise_key_ = base::RandUint64();
+  }
+  config.noise_seed = install_noise_key_;
+  config.version = "1.0.0";
+  config.created_at = base::Time::Now().ToJsTimeIgnoringNull();
+  config.updated_at = config.created_at;
   
   // Initialize Canvas config
-  default_config_.canvas.enabled = true;
-  default_config_.canvas.add_noise = true;
-  default_config_.canvas.noise_level = 0.1;
-  default_config_.canvas.spoof_text_metrics = true;
-  default_config_.canvas.protect_data_url = true;
-  default_config_.canvas.protect_image_data = true;
+  config.canvas.enabled = true;
+  config.canvas.add_noise = true;
+  config.canvas.noise_level = 0.1;
+  config.canvas.spoof_text_metrics = true;
+  config.canvas.protect_data_url = true;
+  config.canvas.protect_image_data = true;
+  config.canvas.cache_memory_limit_kb = 65536;
+  config.canvas.parallel_min_pixels = 1048576;
+  config.canvas.parallel_tile_rows = 64;
+  config.canvas.parallel_max_threads = 8;
   
   // Initialize WebGL config
-  default_config_.webgl.enabled = true;
-  default_config_.webgl.vendor = "Google Inc. (Intel)";
-  default_config_.webgl.renderer = "ANGLE (Intel, Intel(R) UHD Graphics 620 Direct3D11 vs_5_0 ps_5_0, D3D11)";
-  default_config_.webgl.version = "OpenGL ES 2.0 (ANGLE 2.1.0.0)";
-  default_config_.webgl.shading_language_version = "OpenGL ES GLSL ES 1.00 (ANGLE 2.1.0.0)";
-  default_config_.webgl.add_noise_to_buffers = true;
-  default_config_.webgl.buffer_noise_level = 0.01;
+  config.webgl.enabled = true;
+  config.webgl.vendor = "Google Inc. (Intel)";
+  config.webgl.renderer = "ANGLE (Intel, Intel(R) UHD Graphics 620 Direct3D11 vs_5_0 ps_5_0, D3D11)";
+  config.webgl.version = "OpenGL ES 2.0 (ANGLE 2.1.0.0)";
+  config.webgl.shading_language_version = "OpenGL ES GLSL ES 1.00 (ANGLE 2.1.0.0)";
+  config.webgl.add_noise_to_buffers = true;
+  config.webgl.buffer_noise_level = 0.01;
+  config.webgl.buffer_parallel_min_bytes = 4194304;
+  config.webgl.buffer_parallel_chunk_bytes = 1048576;
+  config.webgl.buffer_parallel_max_threads = 8;
+  config.webgl.noise_mode = mojom::WebGLNoiseMode::kReadback;
   
   // Initialize Navigator config
-  default_config_.navigator.enabled = true;
-  default_config_.navigator.user_agent = "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36";
-  default_config_.navigator.platform = "Win32";
-  default_config_.navigator.languages = {"en-US", "en"};
-  default_config_.navigator.hardware_concurrency = 8;
-  default_config_.navigator.device_memory = 8;
-  default_config_.navigator.hide_webdriver = true;
-  default_config_.navigator.spoof_plugins = true;
+  config.navigator.enabled = true;
+  config.navigator.user_agent = "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36";
+  config.navigator.platform = "Win32";
+  config.navigator.languages = {"en-US", "en"};
+  config.navigator.hardware_concurrency = 8;
+  config.navigator.device_memory = 8;
+  config.navigator.hide_webdriver = true;
+  config.navigator.spoof_plugins = true;
   
   // Initialize Audio config
-  default_config_.audio.enabled = true;
-  default_config_.audio.add_noise = true;
-  default_config_.audio.noise_level = 0.001;
-  default_config_.audio.protect_analyser_node = true;
-  default_config_.audio.protect_offline_context = true;
-  default_config_.audio.sample_rate = 44100;
-  default_config_.audio.buffer_size = 4096;
+  config.audio.enabled = true;
+  config.audio.add_noise = true;
+  config.audio.noise_level = 0.001;
+  config.audio.protect_analyser_node = true;
+  config.audio.protect_offline_context = true;
+  config.audio.sample_rate = 44100;
+  config.audio.buffer_size = 4096;
   
   // Initialize Font config
-  default_config_.font.enabled = true;
-  default_config_.font.spoof_enumeration = true;
-  default_config_.font.spoof_metrics = true;
-  default_config_.font.available_fonts = {
+  config.font.enabled = true;
+  config.font.spoof_enumeration = true;
+  config.font.spoof_metrics = true;
+  config.font.available_fonts = {
     "Arial", "Arial Black", "Calibri", "Cambria", "Comic Sans MS",
     "Consolas", "Courier New", "Georgia", "Impact", "Lucida Console",
     "Lucida Sans Unicode", "Microsoft Sans Serif", "Palatino Linotype",
@@ -550,89 +1218,75 @@ void FingerprintManager::InitializeDefaultConfig() {
   };
   
   // Initialize WebRTC config
-  default_config_.webrtc.enabled = true;
-  default_config_.webrtc.mask_local_ips = true;
-  default_config_.webrtc.disable_webrtc = false;
-  default_config_.webrtc.fake_public_ip = "203.0.113.1";
-  default_config_.webrtc.block_device_enumeration = true;
+  config.webrtc.enabled = true;
+  config.webrtc.mask_local_ips = true;
+  config.webrtc.disable_webrtc = false;
+  config.webrtc.fake_public_ip = "203.0.113.1";
+  config.webrtc.block_device_enumeration = true;
   
   // Initialize Geolocation config
-  default_config_.geolocation.enabled = true;
-  default_config_.geolocation.spoof_location = true;
-  default_config_.geolocation.latitude = 40.7128;
-  default_config_.geolocation.longitude = -74.0060;
-  default_config_.geolocation.accuracy = 10.0;
-  default_config_.geolocation.block_high_accuracy = true;
+  config.geolocation.enabled = true;
+  config.geolocation.spoof_location = true;
+  config.geolocation.latitude = 40.7128;
+  config.geolocation.longitude = -74.0060;
+  config.geolocation.accuracy = 10.0;
+  config.geolocation.block_high_accuracy = true;
   
   // Initialize Screen config
-  default_config_.screen.enabled = true;
-  default_config_.screen.width = 1920;
-  default_config_.screen.height = 1080;
-  default_config_.screen.color_depth = 24;
-  default_config_.screen.pixel_depth = 24;
-  default_config_.screen.device_pixel_ratio = 1.0;
-  default_config_.screen.orientation = "landscape-primary";
+  config.screen.enabled = true;
+  config.screen.width = 1920;
+  config.screen.height = 1080;
+  config.screen.color_depth = 24;
+  config.screen.pixel_depth = 24;
+  config.screen.device_pixel_ratio = 1.0;
+  config.screen.orientation = "landscape-primary";
   
   // Initialize Timezone config
-  default_config_.timezone.enabled = true;
-  default_config_.timezone.timezone = "America/New_York";
-  default_config_.timezone.timezone_offset = -300;
-  default_config_.timezone.spoof_date_methods = true;
+  config.timezone.enabled = true;
+  config.timezone.timezone = "America/New_York";
+  config.timezone.timezone_offset = -300;
+  config.timezone.spoof_date_methods = true;
   
   // Initialize Anti-detection config
-  default_config_.anti_detection.enabled = true;
-  default_config_.anti_detection.webdriver.hide_webdriver_property = true;
-  default_config_.anti_detection.webdriver.hide_automation_flags = true;
-  default_config_.anti_detection.webdriver.spoof_chrome_runtime = true;
-  default_config_.anti_detection.webdriver.hide_selenium_variables = true;
-  default_config_.anti_detection.webdriver.blocked_properties = {
+  config.anti_detection.enabled = true;
+  config.anti_detection.mode = mojom::SpoofingMode::kJavaScript;
+  config.anti_detection.webdriver.hide_webdriver_property = true;
+  config.anti_detection.webdriver.hide_automation_flags = true;
+  config.anti_detection.webdriver.spoof_chrome_runtime = true;
+  config.anti_detection.webdriver.hide_selenium_variables = true;
+  config.anti_detection.webdriver.blocked_properties = {
     "webdriver", "__webdriver_evaluate", "__selenium_evaluate",
     "__webdriver_script_function", "__webdriver_script_func",
     "__webdriver_script_fn", "__fxdriver_evaluate", "__driver_unwrapped",
     "webdriver_id", "$chrome_asyncScriptInfo", "$cdc_asdjflasutopfhvcZLmcfl_"
   };
   
-  default_config_.anti_detection.automation.hide_headless_flags = true;
-  default_config_.anti_detection.automation.spoof_user_interaction = true;
-  default_config_.anti_detection.automation.add_human_delays = true;
-  default_config_.anti_detection.automation.randomize_request_timing = true;
-  default_config_.anti_detection.automation.min_delay_ms = 100;
-  default_config_.anti_detection.automation.max_delay_ms = 2000;
-  
-  default_config_.anti_detection.js_injection.detect_puppeteer = true;
-  default_config_.anti_detection.js_injection.detect_playwright = true;
-  default_config_.anti_detection.js_injection.detect_selenium = true;
-  default_config_.anti_detection.js_injection.block_detection_scripts = true;
-  default_config_.anti_detection.js_injection.blocked_script_patterns = {
+  config.anti_detection.automation.hide_headless_flags = true;
+  config.anti_detection.automation.spoof_user_interaction = true;
+  config.anti_detection.automation.add_human_delays = true;
+  config.anti_detection.automation.randomize_request_timing = true;
+  config.anti_detection.automation.min_delay_ms = 100;
+  config.anti_detection.automation.max_delay_ms = 2000;
+  
+  config.anti_detection.js_injection.detect_puppeteer = true;
+  config.anti_detection.js_injection.detect_playwright = true;
+  config.anti_detection.js_injection.detect_selenium = true;
+  config.anti_detection.js_injection.block_detection_scripts = true;
+  config.anti_detection.js_injection.blocked_script_patterns = {
     "puppeteer", "playwright", "selenium", "webdriver", "automation",
     "headless", "__nightmare", "_phantom", "callPhantom"
   };
   
   // Initialize custom JS injections
-  default_config_.custom_js_injections = {
+  config.custom_js_injections = {
     "Object.defineProperty(navigator, 'webdriver', {get: () => undefined});",
     "delete window.cdc_adoQpoasnfa76pfcZLmcfl_Array;",
     "delete window.cdc_adoQpoasnfa76pfcZLmcfl_Promise;",
     "delete window.cdc_adoQpoasnfa76pfcZLmcfl_Symbol;"
   };
-}
-
-std::string FingerprintManager::GenerateFrameId(content::RenderFrameHost* frame) {
-  if (!frame) {
-    return "null_frame";
-  }
   
-  content::WebContents* web_contents = content::WebContents::FromRenderFrameHost(frame);
-  if (!web_contents) {
-    return base::StringPrintf("frame_%d_%d", 
-                             frame->GetProcess()->GetID(),
-                             frame->GetRoutingID());
-  }
-  
-  return base::StringPrintf("frame_%d_%d_%d",
-                           web_contents->GetBrowserContext()->GetPath().BaseName().MaybeAsASCII().c_str()[0],
-                           frame->GetProcess()->GetID(),
-                           frame->GetRoutingID());
+  base::AutoLock auto_lock(lock_);
+  PublishDefaultConfig(std::move(config));
 }
 
 }  // namespace novebrowse
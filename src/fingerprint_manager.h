@@ -1,15 +1,38 @@
 #ifndef NOVEBROWSE_FINGERPRINT_MANAGER_H_
 #define NOVEBROWSE_FINGERPRINT_MANAGER_H_
 
+#include <atomic>
+#include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+#include "base/containers/span.h"
+#include "base/files/file_path.h"
+#include "base/functional/callback.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/singleton.h"
 #include "base/synchronization/lock.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/threading/sequence_bound.h"
+#include "base/threading/thread_local.h"
 #include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/web_contents.h"
+#include "novebrowse/compiled_profile_store.h"
+#include "novebrowse/config_directory_watcher.h"
 #include "novebrowse/fingerprint_config.h"
+#include "novebrowse/fingerprint_stats.h"
+#include "novebrowse/frame_config_registry.h"
+#include "novebrowse/profile_pool.h"
+#include "third_party/abseil-cpp/absl/container/flat_hash_map.h"
+#include "url/origin.h"
+
+namespace base {
+class CommandLine;
+}
 
 namespace novebrowse {
 
@@ -22,53 +45,113 @@ class FingerprintManager {
   static bool IsEnabled();
   static void SetEnabled(bool enabled);
   
-  // 配置管理
+  // 加载结果回调，在发起加载的序列上运行
+  using LoadCallback = base::OnceCallback<void(bool success)>;
+  
+  // 配置管理 - Load*/SaveConfig做阻塞文件IO，只能在允许阻塞的线程调用；
+  // 解析在锁外完成，只有发布结果时持有锁
   bool LoadConfig(const std::string& config_path);
   bool SaveConfig(const std::string& config_path);
   void UpdateConfig(const FingerprintConfig& config);
   
-  // 获取指定Frame的指纹配置
-  FingerprintConfig GetConfigForFrame(content::RenderFrameHost* frame);
+  // 异步加载 - 在后台MayBlock序列上读取、解析、验证后原子发布，可在UI线程调用
+  void LoadConfigAsync(const std::string& config_path, LoadCallback callback);
+  void LoadDeviceProfilesAsync(const std::string& profiles_path,
+                               LoadCallback callback);
+  void LoadBehaviorPatternsAsync(const std::string& patterns_path,
+                                 LoadCallback callback);
+  
+  // 启动加载 - 依次读取安装噪声密钥（用户数据目录）、行为模式、配置文件和
+  // 设备配置文件（编译库优先，缺失或过期时回退到JSON），再重建配置池。
+  // 做阻塞IO，由ChromeBrowserMainParts在创建线程之前调用，
+  // 使--novebrowse-device-profile从第一个页面起生效
+  void LoadStartupConfig(const base::FilePath& config_dir,
+                         const base::FilePath& user_data_dir);
+  
+  // 监视配置目录（novebrowse_config/），文件变化时在后台序列上热重载。
+  // 浏览器启动时开始（ChromeBrowserMainParts），主消息循环结束后停止
+  void StartWatchingConfigDirectory(const base::FilePath& config_dir);
+  void StopWatchingConfigDirectory();
+  
+  // 可执行文件旁的novebrowse_config/，构建时由config_files目标复制
+  static base::FilePath GetDefaultConfigDirectory();
+  
+  // 安装噪声密钥 - 渲染器中取自启动命令行，否则为本进程的随机值
+  uint64_t install_noise_key() const;
+  
+  // 渲染器启动时由ChromeContentBrowserClient调用，把安装噪声密钥写入其命令行，
+  // 使渲染器的默认配置（未配置的Frame、共享和Service Worker）跨进程、跨运行
+  // 派生相同的种子
+  void AppendRendererSwitches(base::CommandLine* command_line) const;
+  
+  // 获取指定Frame的指纹配置 - 返回共享的只读快照，与GetDefaultConfig一样无锁读取
+  scoped_refptr<const FingerprintConfigSnapshot> GetConfigForFrame(
+      content::RenderFrameHost* frame);
   
   // 设置指定Frame的指纹配置
   void SetConfigForFrame(content::RenderFrameHost* frame, 
                         const FingerprintConfig& config);
   
-  // 移除Frame配置
+  // 移除Frame配置（Frame删除时由FrameConfigObserver调用）
   void RemoveFrameConfig(content::RenderFrameHost* frame);
   
-  // 获取默认配置
-  const FingerprintConfig& GetDefaultConfig() const { return default_config_; }
+  // 获取默认配置 - 无锁读取当前发布的快照
+  scoped_refptr<const FingerprintConfigSnapshot> GetDefaultConfig() const;
   void SetDefaultConfig(const FingerprintConfig& config);
   
-  // 设备配置文件管理
+  // 默认配置代数 - 即当前默认快照的generation()，供缓存判断是否需要重建
+  uint64_t default_config_generation() const {
+    return default_config_generation_.load(std::memory_order_acquire);
+  }
+  
+  // 设备配置文件管理 - 路径为.bin时映射编译后的库，无法打开时回退到同名.json
   bool LoadDeviceProfiles(const std::string& profiles_path);
   std::vector<std::string> GetAvailableProfiles() const;
   DeviceProfile GetDeviceProfile(const std::string& profile_name) const;
   
-  // 行为模式管理
+  // 编译库中的设备配置文件视图，不复制；从JSON加载时返回nullopt
+  std::optional<CompiledProfileStore::DeviceProfileView> FindDeviceProfileView(
+      std::string_view profile_name) const;
+  
+  // 行为模式管理 - 路径规则同LoadDeviceProfiles
   bool LoadBehaviorPatterns(const std::string& patterns_path);
   std::vector<std::string> GetAvailablePatterns() const;
   BehaviorPattern GetBehaviorPattern(const std::string& pattern_name) const;
   
-  // 统计信息
-  struct Statistics {
-    int total_frames_protected = 0;
-    int canvas_operations_spoofed = 0;
-    int webgl_parameters_spoofed = 0;
-    int navigator_properties_spoofed = 0;
-    int webdriver_detections_blocked = 0;
-    int audio_contexts_protected = 0;
-    int font_enumerations_spoofed = 0;
-    int geolocation_requests_spoofed = 0;
-    int webrtc_connections_protected = 0;
-  };
+  // 编译库中的行为模式视图，不复制；从JSON加载时返回nullopt
+  std::optional<CompiledProfileStore::BehaviorPatternView> FindBehaviorPatternView(
+      std::string_view pattern_name) const;
+  
+  // 配置池 - 在后台预构建count个设备配置文件的配置（行为模式按配置文件名分配），
+  // 配置文件热重载后自动重建。count超过ProfilePool::kMaxCapacity时按其截断。
+  // 只在UI线程调用
+  void WarmProfilePool(size_t count);
+  
+  // 切换Frame（或页面的全部Frame）到指定设备配置文件并立即下发给渲染器。
+  // 配置池命中时为O(1)，未命中时同步构建并计入profile_pool_misses。只在UI线程调用
+  bool SwitchProfile(content::RenderFrameHost* frame, const std::string& profile_name);
+  bool SwitchProfile(content::WebContents* contents, const std::string& profile_name);
+  
+  // 向frame所在渲染器进程预推送配置池中的配置，之后切换只需发送哈希
+  void PrimeRendererWithProfilePool(content::RenderFrameHost* frame);
+  
+  // 统计信息 - 计数保存在FingerprintStatCounters中，这里只做汇总
+  using Statistics = FingerprintStatistics;
   
   Statistics GetStatistics() const;
   void ResetStatistics();
-  void IncrementStat(const std::string& stat_name);
+  void IncrementStat(FingerprintStat stat);
+  
+  // 渲染器遥测批次 - 计入全局统计并按站点汇总
+  void RecordTelemetryBatch(const url::Origin& origin,
+                            base::span<const uint8_t> batch);
+  
+  // 按站点（scheme + eTLD+1）汇总的统计
+  std::map<std::string, Statistics> GetSiteStatistics() const;
   
  private:
+  // 泄漏单例：ThreadLocalOwnedPointer成员销毁时要求其他线程已不再持有缓存，
+  // 而AtExit时线程池线程的缓存仍在，因此进程退出时不析构
   friend struct base::DefaultSingletonTraits<FingerprintManager>;
   
   FingerprintManager();
@@ -78,27 +161,106 @@ class FingerprintManager {
   FingerprintManager(const FingerprintManager&) = delete;
   FingerprintManager& operator=(const FingerprintManager&) = delete;
   
+  // 每个线程缓存的默认快照
+  struct CachedDefaultConfig {
+    uint64_t generation = 0;
+    scoped_refptr<const FingerprintConfigSnapshot> snapshot;
+  };
+  
+  // 每个线程缓存的Frame配置表
+  struct CachedFrameConfigs {
+    uint64_t generation = 0;
+    scoped_refptr<const FrameConfigRegistry> registry;
+  };
+  
   // 内部方法
   void InitializeDefaultConfig();
-  std::string GenerateFrameId(content::RenderFrameHost* frame);
+  
+  // 发布新的默认快照，调用方需持有lock_
+  void PublishDefaultConfig(FingerprintConfig config);
+  
+  // 无锁读取当前Frame配置表
+  scoped_refptr<const FrameConfigRegistry> GetFrameConfigs() const;
+  
+  // 替换当前Frame配置表，调用方需持有lock_
+  void PublishFrameConfigs(scoped_refptr<const FrameConfigRegistry> registry);
+  
+  // 为配置分配快照代数
+  scoped_refptr<const FingerprintConfigSnapshot> CreateSnapshot(
+      FingerprintConfig config);
+  
+  // 后台加载序列，首次使用时创建；所有加载和热重载在其上串行执行
+  scoped_refptr<base::SequencedTaskRunner> GetLoadTaskRunner();
+  void PostLoad(base::OnceCallback<bool()> load, LoadCallback callback);
+  
+  // 配置目录监视器在后台序列上调用，按文件名分派到对应的Load*
+  void ReloadConfigFile(const base::FilePath& path);
+  
+  // 按当前默认配置和配置文件重建配置池，在后台加载序列上运行
+  void RebuildProfilePool();
+  
+  // 安装噪声密钥 - 配置文件的noise_seed为0时使用。首次启动随机生成并写入，
+  // 之后每次启动读回，使同一安装的噪声跨运行保持一致；读到已有密钥时替换
+  // 仍在使用旧密钥的默认配置
+  bool LoadInstallNoiseKey(const base::FilePath& key_path);
+  
+  // 启动参数指定了设备配置文件时，以其组合出的配置替换默认配置；
+  // 配置或设备配置文件加载后调用，使默认配置始终对应该设备
+  void ApplyStartupDeviceProfile();
+  
+  // 取得配置文件对应的快照，配置池未命中时同步构建
+  scoped_refptr<const FingerprintConfigSnapshot> GetProfileConfig(
+      const std::string& profile_name);
+  
+  // 记录Frame配置并下发给渲染器
+  void ApplySnapshotToFrame(content::RenderFrameHost* frame,
+                            scoped_refptr<const FingerprintConfigSnapshot> config);
   
   // 成员变量
   mutable base::Lock lock_;
   static bool enabled_;
   
-  FingerprintConfig default_config_;
-  std::unordered_map<std::string, FingerprintConfig> frame_configs_;
+  // 默认快照只在lock_下替换；读者通过代数比较命中线程缓存，无需加锁
+  scoped_refptr<const FingerprintConfigSnapshot> default_config_;
+  std::atomic<uint64_t> default_config_generation_{0};
+  uint64_t next_snapshot_generation_ = 1;
+  mutable base::ThreadLocalOwnedPointer<CachedDefaultConfig> cached_default_config_;
+  
+  // 只在UI线程上创建和替换
+  scoped_refptr<base::SequencedTaskRunner> load_task_runner_;
+  base::SequenceBound<ConfigDirectoryWatcher> config_watcher_;
+  
+  // Frame配置表同默认快照：只在lock_下替换，读者按代数命中线程缓存
+  scoped_refptr<const FrameConfigRegistry> frame_configs_;
+  std::atomic<uint64_t> frame_configs_generation_{0};
+  mutable base::ThreadLocalOwnedPointer<CachedFrameConfigs> cached_frame_configs_;
+  
+  ProfilePool profile_pool_;
   std::unordered_map<std::string, DeviceProfile> device_profiles_;
   std::unordered_map<std::string, BehaviorPattern> behavior_patterns_;
   
-  mutable Statistics statistics_;
+  // 安装噪声密钥，lock_下读写；读回持久化的密钥之前是本次运行的随机值
+  uint64_t install_noise_key_ = 0;
+  
+  // --novebrowse-device-profile的值（由启动器的fleet模式传入），构造后不变
+  std::string startup_device_profile_;
+  
+  // 从编译库加载时非空，此时上面对应的JSON表为空
+  scoped_refptr<const CompiledProfileStore> compiled_device_profiles_;
+  scoped_refptr<const CompiledProfileStore> compiled_behavior_patterns_;
+  
+  // 站点统计使用独立的锁，遥测批次不与配置读写竞争
+  mutable base::Lock telemetry_lock_;
+  absl::flat_hash_map<std::string, Statistics> site_statistics_;
 };
 
 // 便捷宏定义
 #define FINGERPRINT_MANAGER() FingerprintManager::GetInstance()
 #define IS_FINGERPRINT_ENABLED() FingerprintManager::IsEnabled()
+// stat为FingerprintStat枚举名，例如INCREMENT_FINGERPRINT_STAT(kCanvasOperationsSpoofed)
 #define INCREMENT_FINGERPRINT_STAT(stat) \
-  if (IS_FINGERPRINT_ENABLED()) FINGERPRINT_MANAGER()->IncrementStat(stat)
+  if (IS_FINGERPRINT_ENABLED()) \
+    ::novebrowse::FingerprintStatCounters::Increment(::novebrowse::FingerprintStat::stat)
 
 }  // namespace novebrowse
 
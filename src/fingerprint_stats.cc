@@ -0,0 +1,193 @@
+#include "novebrowse/fingerprint_stats.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "third_party/abseil-cpp/absl/base/attributes.h"
+
+namespace novebrowse {
+
+namespace {
+
+constexpr size_t kUnassignedShard = std::numeric_limits<size_t>::max();
+
+ABSL_CONST_INIT thread_local size_t g_current_shard = kUnassignedShard;
+
+std::atomic<size_t> g_next_shard{0};
+
+constexpr double kLatencyPercentiles[] = {0.50, 0.95, 0.99};
+constexpr const char* kLatencyPercentileSuffixes[] = {".p50_us", ".p95_us",
+                                                      ".p99_us"};
+
+// Calls |add| with each latency key and value for surfaces with samples.
+template <typename Add>
+void ForEachLatencyEntry(
+    const std::array<LatencyHistogram, kProtectionSurfaceCount>& latency,
+    Add add) {
+  for (size_t i = 0; i < kProtectionSurfaceCount; ++i) {
+    uint64_t samples = latency[i].SampleCount();
+    if (!samples) {
+      continue;
+    }
+    
+    std::string prefix = "latency." + std::string(kProtectionSurfaceNames[i]);
+    add(prefix + ".samples", samples);
+    for (size_t p = 0; p < std::size(kLatencyPercentiles); ++p) {
+      add(prefix + kLatencyPercentileSuffixes[p],
+          latency[i].PercentileMicroseconds(kLatencyPercentiles[p]));
+    }
+  }
+}
+
+}  // namespace
+
+// static
+std::array<FingerprintStatCounters::Shard, FingerprintStatCounters::kShardCount>
+    FingerprintStatCounters::shards_;
+
+// static
+std::array<std::array<std::atomic<uint64_t>, LatencyHistogram::kBucketCount>,
+           kProtectionSurfaceCount>
+    FingerprintStatCounters::latency_;
+
+// static
+size_t LatencyHistogram::BucketFor(int64_t microseconds) {
+  if (microseconds <= 0) {
+    return 0;
+  }
+  
+  // bit_width(1) == 1, so [1, 2) lands in bucket 1, [2, 4) in bucket 2...
+  size_t bucket = std::bit_width(static_cast<uint64_t>(microseconds));
+  return std::min(bucket, kBucketCount - 1);
+}
+
+uint64_t LatencyHistogram::SampleCount() const {
+  uint64_t total = 0;
+  for (uint64_t count : buckets) {
+    total += count;
+  }
+  
+  return total;
+}
+
+uint64_t LatencyHistogram::PercentileMicroseconds(double fraction) const {
+  uint64_t total = SampleCount();
+  if (!total) {
+    return 0;
+  }
+  
+  uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(total))));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      // Upper bound of bucket i; the open-ended last bucket reports its
+      // lower bound.
+      return i + 1 < kBucketCount ? uint64_t{1} << i : uint64_t{1} << (i - 1);
+    }
+  }
+  
+  return uint64_t{1} << (kBucketCount - 2);
+}
+
+base::flat_map<std::string, int32_t> FingerprintStatistics::ToInt32Map() const {
+  std::vector<std::pair<std::string, int32_t>> entries;
+  entries.reserve(kFingerprintStatCount);
+  for (size_t i = 0; i < kFingerprintStatCount; ++i) {
+    uint64_t clamped = std::min<uint64_t>(
+        counts[i], std::numeric_limits<int32_t>::max());
+    entries.emplace_back(std::string(kFingerprintStatNames[i]),
+                         static_cast<int32_t>(clamped));
+  }
+  ForEachLatencyEntry(latency, [&](std::string key, uint64_t value) {
+    uint64_t clamped =
+        std::min<uint64_t>(value, std::numeric_limits<int32_t>::max());
+    entries.emplace_back(std::move(key), static_cast<int32_t>(clamped));
+  });
+  
+  return base::flat_map<std::string, int32_t>(std::move(entries));
+}
+
+base::flat_map<std::string, uint64_t> FingerprintStatistics::ToUint64Map() const {
+  std::vector<std::pair<std::string, uint64_t>> entries;
+  entries.reserve(kFingerprintStatCount);
+  for (size_t i = 0; i < kFingerprintStatCount; ++i) {
+    entries.emplace_back(std::string(kFingerprintStatNames[i]), counts[i]);
+  }
+  ForEachLatencyEntry(latency, [&](std::string key, uint64_t value) {
+    entries.emplace_back(std::move(key), value);
+  });
+  
+  return base::flat_map<std::string, uint64_t>(std::move(entries));
+}
+
+// static
+void FingerprintStatCounters::RecordLatency(ProtectionSurface surface,
+                                            int64_t microseconds) {
+  Increment(FingerprintStat::kLatencySamples);
+  Add(FingerprintStat::kSampledProtectionMicroseconds,
+      static_cast<uint64_t>(std::max<int64_t>(microseconds, 0)));
+  latency_[static_cast<size_t>(surface)][LatencyHistogram::BucketFor(microseconds)]
+      .fetch_add(1, std::memory_order_relaxed);
+}
+
+// static
+void FingerprintStatCounters::AddLatency(ProtectionSurface surface,
+                                         const LatencyHistogram& histogram) {
+  auto& buckets = latency_[static_cast<size_t>(surface)];
+  for (size_t b = 0; b < LatencyHistogram::kBucketCount; ++b) {
+    if (histogram.buckets[b]) {
+      buckets[b].fetch_add(histogram.buckets[b], std::memory_order_relaxed);
+    }
+  }
+}
+
+// static
+FingerprintStatistics FingerprintStatCounters::Aggregate() {
+  FingerprintStatistics statistics;
+  for (const Shard& shard : shards_) {
+    for (size_t i = 0; i < kFingerprintStatCount; ++i) {
+      statistics.counts[i] += shard.counts[i].load(std::memory_order_relaxed);
+    }
+  }
+  for (size_t i = 0; i < kProtectionSurfaceCount; ++i) {
+    for (size_t b = 0; b < LatencyHistogram::kBucketCount; ++b) {
+      statistics.latency[i].buckets[b] =
+          latency_[i][b].load(std::memory_order_relaxed);
+    }
+  }
+  
+  return statistics;
+}
+
+// static
+void FingerprintStatCounters::Reset() {
+  // Increments racing with a reset may land on either side of it.
+  for (Shard& shard : shards_) {
+    for (auto& counter : shard.counts) {
+      counter.store(0, std::memory_order_relaxed);
+    }
+  }
+  for (auto& histogram : latency_) {
+    for (auto& bucket : histogram) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+// static
+size_t FingerprintStatCounters::CurrentShard() {
+  if (g_current_shard == kUnassignedShard) {
+    g_current_shard =
+        g_next_shard.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+  }
+  
+  return g_current_shard;
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,172 @@
+#ifndef NOVEBROWSE_FINGERPRINT_STATS_H_
+#define NOVEBROWSE_FINGERPRINT_STATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <string_view>
+
+#include "base/containers/flat_map.h"
+
+namespace novebrowse {
+
+// 统计项 - 顺序与kFingerprintStatNames一致
+enum class FingerprintStat : uint8_t {
+  kTotalFramesProtected,
+  kCanvasOperationsSpoofed,
+  kWebGLParametersSpoofed,
+  kNavigatorPropertiesSpoofed,
+  kWebDriverDetectionsBlocked,
+  kAudioContextsProtected,
+  kFontEnumerationsSpoofed,
+  kGeolocationRequestsSpoofed,
+  kWebRTCConnectionsProtected,
+  kProfileSwitches,
+  kProfileSwitchMicroseconds,  // 切换耗时累计，除以kProfileSwitches为平均值
+  kProfilePoolMisses,
+  kLatencySamples,                // 延迟采样数，分布见FingerprintStatistics::latency
+  kSampledProtectionMicroseconds,  // 采样调用的耗时累计，乘以采样间隔为估计总耗时
+};
+
+inline constexpr size_t kFingerprintStatCount =
+    static_cast<size_t>(FingerprintStat::kSampledProtectionMicroseconds) + 1;
+
+// 统计项名称，用于mojom统计映射的键
+inline constexpr std::array<std::string_view, kFingerprintStatCount>
+    kFingerprintStatNames = {
+        "total_frames_protected",
+        "canvas_operations_spoofed",
+        "webgl_parameters_spoofed",
+        "navigator_properties_spoofed",
+        "webdriver_detections_blocked",
+        "audio_contexts_protected",
+        "font_enumerations_spoofed",
+        "geolocation_requests_spoofed",
+        "webrtc_connections_protected",
+        "profile_switches",
+        "profile_switch_time_us",
+        "profile_pool_misses",
+        "latency_samples",
+        "sampled_protection_time_us",
+};
+
+constexpr std::string_view FingerprintStatName(FingerprintStat stat) {
+  return kFingerprintStatNames[static_cast<size_t>(stat)];
+}
+
+// 计时的保护热路径 - 顺序与kProtectionSurfaceNames一致
+enum class ProtectionSurface : uint8_t {
+  kCanvasImageData,
+  kCanvasDataURL,
+  kWebGLParameter,
+  kWebGLBufferData,
+  kScriptInjection,
+  kConfigLoad,
+  kConfigCommit,
+};
+
+inline constexpr size_t kProtectionSurfaceCount =
+    static_cast<size_t>(ProtectionSurface::kConfigCommit) + 1;
+
+// 热路径名称，用于mojom统计映射中延迟项的键
+inline constexpr std::array<std::string_view, kProtectionSurfaceCount>
+    kProtectionSurfaceNames = {
+        "canvas_image_data",
+        "canvas_data_url",
+        "webgl_parameter",
+        "webgl_buffer_data",
+        "script_injection",
+        "config_load",
+        "config_commit",
+};
+
+constexpr std::string_view ProtectionSurfaceName(ProtectionSurface surface) {
+  return kProtectionSurfaceNames[static_cast<size_t>(surface)];
+}
+
+// 延迟直方图 - 桶0为不足1微秒，桶i（i>0）为[2^(i-1), 2^i)微秒，最后一桶不设上界
+struct LatencyHistogram {
+  static constexpr size_t kBucketCount = 24;
+  
+  std::array<uint64_t, kBucketCount> buckets = {};
+  
+  static size_t BucketFor(int64_t microseconds);
+  
+  void Add(int64_t microseconds) { ++buckets[BucketFor(microseconds)]; }
+  
+  uint64_t SampleCount() const;
+  
+  // 估计分位数（fraction取0到1），返回所在桶的上界（微秒）；无采样时返回0
+  uint64_t PercentileMicroseconds(double fraction) const;
+};
+
+// 统计快照 - 各分片汇总后的计数
+struct FingerprintStatistics {
+  std::array<uint64_t, kFingerprintStatCount> counts = {};
+  std::array<LatencyHistogram, kProtectionSurfaceCount> latency = {};
+  
+  uint64_t operator[](FingerprintStat stat) const {
+    return counts[static_cast<size_t>(stat)];
+  }
+  
+  const LatencyHistogram& operator[](ProtectionSurface surface) const {
+    return latency[static_cast<size_t>(surface)];
+  }
+  
+  // 转换为mojom统计映射；32位版本超出范围时截断到INT32_MAX。
+  // 有采样的热路径另加"latency.<名称>.samples/p50_us/p95_us/p99_us"项
+  base::flat_map<std::string, int32_t> ToInt32Map() const;
+  base::flat_map<std::string, uint64_t> ToUint64Map() const;
+};
+
+// 统计计数器 - 按线程分片的原子计数，递增路径只有一次relaxed原子加
+//
+// 计数器为常量初始化的静态存储，不经过FingerprintManager单例。
+class FingerprintStatCounters {
+ public:
+  // 分片数量，线程按首次使用顺序轮流分配到各分片
+  static constexpr size_t kShardCount = 16;
+  
+  FingerprintStatCounters() = delete;
+  
+  static void Increment(FingerprintStat stat) { Add(stat, 1); }
+  
+  // 一次累加多个计数（用于合并遥测批次）
+  static void Add(FingerprintStat stat, uint64_t count) {
+    shards_[CurrentShard()].counts[static_cast<size_t>(stat)].fetch_add(
+        count, std::memory_order_relaxed);
+  }
+  
+  // 记录一次延迟采样，同时累加latency_samples和sampled_protection_time_us；
+  // 调用方已完成采样，直方图不分片
+  static void RecordLatency(ProtectionSurface surface, int64_t microseconds);
+  
+  // 合并一个直方图的各桶（用于合并遥测批次，计数项另行累加）
+  static void AddLatency(ProtectionSurface surface,
+                         const LatencyHistogram& histogram);
+  
+  // 汇总所有分片和延迟直方图
+  static FingerprintStatistics Aggregate();
+  
+  // 清零所有分片和延迟直方图
+  static void Reset();
+  
+ private:
+  struct alignas(64) Shard {
+    std::array<std::atomic<uint64_t>, kFingerprintStatCount> counts = {};
+  };
+  
+  static size_t CurrentShard();
+  
+  static std::array<Shard, kShardCount> shards_;
+  static std::array<std::array<std::atomic<uint64_t>, LatencyHistogram::kBucketCount>,
+                    kProtectionSurfaceCount>
+      latency_;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_FINGERPRINT_STATS_H_
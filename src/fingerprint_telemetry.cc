@@ -0,0 +1,72 @@
+#include "novebrowse/fingerprint_telemetry.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace novebrowse {
+
+int ForEachTelemetryRecord(
+    base::span<const uint8_t> batch,
+    base::FunctionRef<void(FingerprintStat, const TelemetryRecord&)> callback) {
+  if (batch.size() % sizeof(TelemetryRecord) != 0) {
+    return -1;
+  }
+  
+  int valid_records = 0;
+  for (size_t offset = 0; offset < batch.size(); offset += sizeof(TelemetryRecord)) {
+    TelemetryRecord record;
+    memcpy(&record, batch.data() + offset, sizeof(record));
+    
+    // The batch comes from a renderer; ignore stats it should not know about.
+    if (record.stat >= kFingerprintStatCount) {
+      continue;
+    }
+    
+    callback(static_cast<FingerprintStat>(record.stat), record);
+    valid_records++;
+  }
+  
+  return valid_records;
+}
+
+TelemetryBuffer::TelemetryBuffer() {
+  records_.reserve(kFlushRecordCount);
+}
+
+TelemetryBuffer::~TelemetryBuffer() = default;
+
+bool TelemetryBuffer::Append(FingerprintStat stat,
+                             uint16_t payload,
+                             base::TimeTicks now,
+                             uint8_t detail) {
+  if (records_.empty()) {
+    batch_start_ = now;
+  }
+  
+  int64_t delta_ms = std::clamp<int64_t>(
+      (now - batch_start_).InMilliseconds(), 0,
+      std::numeric_limits<uint32_t>::max());
+  
+  TelemetryRecord record;
+  record.stat = static_cast<uint8_t>(stat);
+  record.detail = detail;
+  record.payload = payload;
+  record.time_delta_ms = static_cast<uint32_t>(delta_ms);
+  records_.push_back(record);
+  
+  return records_.size() >= kFlushRecordCount;
+}
+
+std::vector<uint8_t> TelemetryBuffer::TakeBatch() {
+  std::vector<uint8_t> batch(records_.size() * sizeof(TelemetryRecord));
+  if (!batch.empty()) {
+    memcpy(batch.data(), records_.data(), batch.size());
+  }
+  
+  records_.clear();
+  return batch;
+}
+
+}  // namespace novebrowse
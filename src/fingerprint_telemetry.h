@@ -0,0 +1,67 @@
+#ifndef NOVEBROWSE_FINGERPRINT_TELEMETRY_H_
+#define NOVEBROWSE_FINGERPRINT_TELEMETRY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/functional/function_ref.h"
+#include "base/time/time.h"
+#include "novebrowse/fingerprint_stats.h"
+
+namespace novebrowse {
+
+// 遥测记录 - 渲染器与浏览器之间的8字节二进制格式
+//
+// 批次按Frame发送，因此记录中不含Frame标识；时间为相对批次开始的毫秒数。
+struct TelemetryRecord {
+  uint8_t stat = 0;            // FingerprintStat
+  uint8_t detail = 0;          // 与统计项相关的分类，例如延迟采样的ProtectionSurface
+  uint16_t payload = 0;        // 与统计项相关的小数据，例如WebGL pname或采样耗时（微秒）
+  uint32_t time_delta_ms = 0;  // 相对批次开始的时间
+};
+
+static_assert(sizeof(TelemetryRecord) == 8, "TelemetryRecord must stay packed");
+
+// 遍历批次中的记录，跳过无法识别的统计项；返回有效记录数，格式错误返回-1
+int ForEachTelemetryRecord(
+    base::span<const uint8_t> batch,
+    base::FunctionRef<void(FingerprintStat, const TelemetryRecord&)> callback);
+
+// 遥测缓冲区 - 每个Frame一份，只在渲染器主线程上使用
+class TelemetryBuffer {
+ public:
+  // 攒够该数量的记录后应立即发送
+  static constexpr size_t kFlushRecordCount = 128;
+  
+  // 定时发送的间隔
+  static constexpr base::TimeDelta kFlushInterval = base::Seconds(5);
+  
+  TelemetryBuffer();
+  ~TelemetryBuffer();
+  
+  TelemetryBuffer(const TelemetryBuffer&) = delete;
+  TelemetryBuffer& operator=(const TelemetryBuffer&) = delete;
+  
+  // 追加一条记录，返回true表示已达到发送阈值
+  bool Append(FingerprintStat stat,
+              uint16_t payload,
+              base::TimeTicks now,
+              uint8_t detail = 0);
+  
+  // 取出当前批次并清空
+  std::vector<uint8_t> TakeBatch();
+  
+  bool empty() const { return records_.empty(); }
+  size_t size() const { return records_.size(); }
+  
+ private:
+  std::vector<TelemetryRecord> records_;
+  base::TimeTicks batch_start_;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_FINGERPRINT_TELEMETRY_H_
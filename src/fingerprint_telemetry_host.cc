@@ -0,0 +1,54 @@
+#include "novebrowse/fingerprint_telemetry_host.h"
+
+#include <memory>
+
+#include "base/logging.h"
+#include "content/public/browser/render_frame_host.h"
+#include "mojo/public/cpp/bindings/message.h"
+#include "mojo/public/cpp/bindings/self_owned_receiver.h"
+#include "novebrowse/fingerprint_manager.h"
+#include "novebrowse/fingerprint_telemetry.h"
+
+namespace novebrowse {
+
+// static
+void FingerprintTelemetryHost::Create(
+    content::RenderFrameHost* frame,
+    mojo::PendingReceiver<mojom::FingerprintTelemetry> receiver) {
+  if (!frame) {
+    return;
+  }
+  
+  mojo::MakeSelfOwnedReceiver(
+      std::make_unique<FingerprintTelemetryHost>(frame->GetGlobalId()),
+      std::move(receiver));
+}
+
+FingerprintTelemetryHost::FingerprintTelemetryHost(
+    content::GlobalRenderFrameHostId frame_id)
+    : frame_id_(frame_id) {}
+
+FingerprintTelemetryHost::~FingerprintTelemetryHost() = default;
+
+void FingerprintTelemetryHost::RecordOperationBatch(
+    const std::vector<uint8_t>& records) {
+  if (records.size() % sizeof(TelemetryRecord) != 0 ||
+      records.size() > kMaxRecordsPerBatch * sizeof(TelemetryRecord)) {
+    mojo::ReportBadMessage("Malformed fingerprint telemetry batch");
+    return;
+  }
+  
+  // The site comes from the browser's view of the frame, so a compromised
+  // renderer cannot charge its operations to another site.
+  content::RenderFrameHost* frame = content::RenderFrameHost::FromID(frame_id_);
+  if (!frame) {
+    return;
+  }
+  
+  DVLOG(2) << "Telemetry batch from frame " << frame_id_ << ": "
+           << records.size() / sizeof(TelemetryRecord) << " records";
+  FINGERPRINT_MANAGER()->RecordTelemetryBatch(frame->GetLastCommittedOrigin(),
+                                              records);
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,44 @@
+#ifndef NOVEBROWSE_FINGERPRINT_TELEMETRY_HOST_H_
+#define NOVEBROWSE_FINGERPRINT_TELEMETRY_HOST_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "content/public/browser/global_routing_id.h"
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+#include "novebrowse/mojom/fingerprint.mojom.h"
+
+namespace content {
+class RenderFrameHost;
+}
+
+namespace novebrowse {
+
+// 浏览器侧遥测接收端 - 每个Frame一个，把批次交给FingerprintManager汇总
+// 批次计入Frame最近一次提交的来源所属站点；Frame已销毁时丢弃
+class FingerprintTelemetryHost : public mojom::FingerprintTelemetry {
+ public:
+  // 单批次最多接受的记录数，超出视为异常消息
+  static constexpr size_t kMaxRecordsPerBatch = 4096;
+  
+  // 绑定到指定Frame（在Frame的BrowserInterfaceBroker中注册）
+  static void Create(content::RenderFrameHost* frame,
+                     mojo::PendingReceiver<mojom::FingerprintTelemetry> receiver);
+  
+  explicit FingerprintTelemetryHost(content::GlobalRenderFrameHostId frame_id);
+  ~FingerprintTelemetryHost() override;
+  
+  FingerprintTelemetryHost(const FingerprintTelemetryHost&) = delete;
+  FingerprintTelemetryHost& operator=(const FingerprintTelemetryHost&) = delete;
+  
+  // mojom::FingerprintTelemetry:
+  void RecordOperationBatch(const std::vector<uint8_t>& records) override;
+  
+ private:
+  const content::GlobalRenderFrameHostId frame_id_;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_FINGERPRINT_TELEMETRY_HOST_H_
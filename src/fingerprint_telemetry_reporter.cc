@@ -0,0 +1,177 @@
+#include "novebrowse/fingerprint_telemetry_reporter.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "novebrowse/fingerprint_manager.h"
+#include "novebrowse/fingerprint_trace.h"
+#include "third_party/blink/public/common/browser_interface_broker_proxy.h"
+#include "third_party/blink/public/platform/task_type.h"
+
+namespace novebrowse {
+
+const char FingerprintTelemetryReporter::kSupplementName[] =
+    "FingerprintTelemetryReporter";
+
+// static
+void FingerprintTelemetryReporter::Record(blink::ExecutionContext* context,
+                                          FingerprintStat stat,
+                                          uint16_t payload) {
+  if (!IS_FINGERPRINT_ENABLED()) {
+    return;
+  }
+  
+  // Workers have no frame to batch against; their operations only reach the
+  // renderer-local counters.
+  auto* window = blink::DynamicTo<blink::LocalDOMWindow>(context);
+  if (!window || window->IsContextDestroyed()) {
+    return;
+  }
+  
+  From(*window)->Record(stat, payload);
+}
+
+// static
+void FingerprintTelemetryReporter::RecordLatency(blink::ExecutionContext* context,
+                                                 ProtectionSurface surface,
+                                                 base::TimeDelta elapsed) {
+  if (!IS_FINGERPRINT_ENABLED()) {
+    return;
+  }
+  
+  auto* window = blink::DynamicTo<blink::LocalDOMWindow>(context);
+  if (!window || window->IsContextDestroyed()) {
+    return;
+  }
+  
+  From(*window)->RecordLatency(surface, elapsed);
+}
+
+// static
+FingerprintTelemetryReporter* FingerprintTelemetryReporter::From(
+    blink::LocalDOMWindow& window) {
+  auto* reporter =
+      Supplement<blink::LocalDOMWindow>::From<FingerprintTelemetryReporter>(window);
+  if (!reporter) {
+    reporter = blink::MakeGarbageCollected<FingerprintTelemetryReporter>(window);
+    ProvideTo(window, reporter);
+  }
+  
+  return reporter;
+}
+
+FingerprintTelemetryReporter::FingerprintTelemetryReporter(
+    blink::LocalDOMWindow& window)
+    : Supplement<blink::LocalDOMWindow>(window),
+      ExecutionContextLifecycleObserver(&window),
+      flush_timer_(window.GetTaskRunner(blink::TaskType::kInternalDefault),
+                   this,
+                   &FingerprintTelemetryReporter::OnFlushTimer),
+      telemetry_(&window) {}
+
+void FingerprintTelemetryReporter::Record(FingerprintStat stat,
+                                          uint16_t payload) {
+  if (buffer_.Append(stat, payload, base::TimeTicks::Now())) {
+    Flush();
+    return;
+  }
+  
+  if (!flush_timer_.IsActive()) {
+    flush_timer_.StartOneShot(TelemetryBuffer::kFlushInterval, FROM_HERE);
+  }
+}
+
+void FingerprintTelemetryReporter::RecordLatency(ProtectionSurface surface,
+                                                 base::TimeDelta elapsed) {
+  size_t index = static_cast<size_t>(surface);
+  sampled_time_[index] += elapsed;
+  ++sampled_calls_[index];
+  
+  // The record carries the surface in |detail| and the saturated time in
+  // microseconds as its payload.
+  uint16_t payload = static_cast<uint16_t>(std::clamp<int64_t>(
+      elapsed.InMicroseconds(), 0, std::numeric_limits<uint16_t>::max()));
+  if (buffer_.Append(FingerprintStat::kLatencySamples, payload,
+                     base::TimeTicks::Now(), static_cast<uint8_t>(surface))) {
+    Flush();
+    return;
+  }
+  
+  if (!flush_timer_.IsActive()) {
+    flush_timer_.StartOneShot(TelemetryBuffer::kFlushInterval, FROM_HERE);
+  }
+}
+
+void FingerprintTelemetryReporter::Flush() {
+  flush_timer_.Stop();
+  if (buffer_.empty()) {
+    return;
+  }
+  
+  std::vector<uint8_t> batch = buffer_.TakeBatch();
+  mojom::FingerprintTelemetry* telemetry = GetTelemetry();
+  if (!telemetry) {
+    return;
+  }
+  
+  telemetry->RecordOperationBatch(batch);
+}
+
+void FingerprintTelemetryReporter::ContextDestroyed() {
+  // Unload: send whatever is left before the pipe goes away.
+  ReportProtectionBudget();
+  Flush();
+  telemetry_.reset();
+}
+
+void FingerprintTelemetryReporter::OnFlushTimer(blink::TimerBase*) {
+  Flush();
+}
+
+void FingerprintTelemetryReporter::ReportProtectionBudget() {
+  TRACE_EVENT_INSTANT(
+      NOVEBROWSE_TRACE_CATEGORY, "FrameProtectionBudget",
+      [&](perfetto::EventContext ctx) {
+        // Each sample stands for kSampleInterval calls on average.
+        int64_t estimated_total_us = 0;
+        for (size_t i = 0; i < kProtectionSurfaceCount; ++i) {
+          if (!sampled_calls_[i]) {
+            continue;
+          }
+          
+          int64_t estimated_us = sampled_time_[i].InMicroseconds() *
+                                 ScopedProtectionTimer::kSampleInterval;
+          estimated_total_us += estimated_us;
+          ctx.AddDebugAnnotation(
+              perfetto::StaticString(kProtectionSurfaceNames[i].data()),
+              estimated_us);
+        }
+        ctx.AddDebugAnnotation("estimated_total_us", estimated_total_us);
+      });
+}
+
+mojom::FingerprintTelemetry* FingerprintTelemetryReporter::GetTelemetry() {
+  if (!telemetry_.is_bound()) {
+    blink::LocalDOMWindow* window = GetSupplementable();
+    if (!window->GetFrame()) {
+      return nullptr;
+    }
+    
+    window->GetFrame()->GetBrowserInterfaceBroker().GetInterface(
+        telemetry_.BindNewPipeAndPassReceiver(
+            window->GetTaskRunner(blink::TaskType::kInternalDefault)));
+  }
+  
+  return telemetry_.get();
+}
+
+void FingerprintTelemetryReporter::Trace(blink::Visitor* visitor) const {
+  visitor->Trace(flush_timer_);
+  visitor->Trace(telemetry_);
+  Supplement<blink::LocalDOMWindow>::Trace(visitor);
+  ExecutionContextLifecycleObserver::Trace(visitor);
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,83 @@
+#ifndef NOVEBROWSE_FINGERPRINT_TELEMETRY_REPORTER_H_
+#define NOVEBROWSE_FINGERPRINT_TELEMETRY_REPORTER_H_
+
+#include <stdint.h>
+
+#include <array>
+
+#include "base/time/time.h"
+#include "novebrowse/fingerprint_stats.h"
+#include "novebrowse/fingerprint_telemetry.h"
+#include "novebrowse/mojom/fingerprint.mojom.h"
+#include "third_party/blink/renderer/core/execution_context/execution_context_lifecycle_observer.h"
+#include "third_party/blink/renderer/core/frame/local_dom_window.h"
+#include "third_party/blink/renderer/platform/heap/garbage_collected.h"
+#include "third_party/blink/renderer/platform/mojo/heap_mojo_remote.h"
+#include "third_party/blink/renderer/platform/supplementable.h"
+#include "third_party/blink/renderer/platform/timer.h"
+
+namespace novebrowse {
+
+// 渲染器侧遥测上报 - 每个文档一份，攒批后通过一次mojo调用发送到浏览器
+//
+// 记录数达到阈值、定时器到期或文档销毁时发送；Worker中的操作不上报。
+// 文档销毁时另发出一个FrameProtectionBudget跟踪事件，汇总本文档各热路径的估计耗时。
+class FingerprintTelemetryReporter final
+    : public blink::GarbageCollected<FingerprintTelemetryReporter>,
+      public blink::Supplement<blink::LocalDOMWindow>,
+      public blink::ExecutionContextLifecycleObserver {
+ public:
+  static const char kSupplementName[];
+  
+  // 记录一次受保护的操作，context不是文档时忽略
+  static void Record(blink::ExecutionContext* context,
+                     FingerprintStat stat,
+                     uint16_t payload = 0);
+  
+  // 记录一次延迟采样（由ScopedProtectionTimer调用），context不是文档时忽略
+  static void RecordLatency(blink::ExecutionContext* context,
+                            ProtectionSurface surface,
+                            base::TimeDelta elapsed);
+  
+  // 获取文档对应的上报器（不存在时创建）
+  static FingerprintTelemetryReporter* From(blink::LocalDOMWindow& window);
+  
+  explicit FingerprintTelemetryReporter(blink::LocalDOMWindow& window);
+  
+  void Record(FingerprintStat stat, uint16_t payload);
+  void RecordLatency(ProtectionSurface surface, base::TimeDelta elapsed);
+  
+  // 立即发送当前批次
+  void Flush();
+  
+  // blink::ExecutionContextLifecycleObserver:
+  void ContextDestroyed() override;
+  
+  void Trace(blink::Visitor* visitor) const override;
+  
+ private:
+  void OnFlushTimer(blink::TimerBase* timer);
+  
+  // 发出本文档的FrameProtectionBudget跟踪事件
+  void ReportProtectionBudget();
+  
+  // 按需连接浏览器侧的FingerprintTelemetry
+  mojom::FingerprintTelemetry* GetTelemetry();
+  
+  TelemetryBuffer buffer_;
+  
+  // 本文档各热路径的采样耗时和采样数
+  std::array<base::TimeDelta, kProtectionSurfaceCount> sampled_time_ = {};
+  std::array<uint32_t, kProtectionSurfaceCount> sampled_calls_ = {};
+  
+  blink::HeapTaskRunnerTimer<FingerprintTelemetryReporter> flush_timer_;
+  
+  // 不随上下文自动断开，ContextDestroyed中发送完剩余记录后再断开
+  blink::HeapMojoRemote<mojom::FingerprintTelemetry,
+                        blink::HeapMojoWrapperMode::kForceWithoutContextObserver>
+      telemetry_;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_FINGERPRINT_TELEMETRY_REPORTER_H_
@@ -0,0 +1,42 @@
+#include "novebrowse/fingerprint_trace.h"
+
+#include "novebrowse/fingerprint_telemetry_reporter.h"
+#include "third_party/abseil-cpp/absl/base/attributes.h"
+
+namespace novebrowse {
+
+namespace {
+
+ABSL_CONST_INIT thread_local uint32_t g_calls_since_sample = 0;
+
+// The first call on each thread is sampled, then every kSampleInterval-th.
+bool ShouldSample() {
+  return g_calls_since_sample++ % ScopedProtectionTimer::kSampleInterval == 0;
+}
+
+}  // namespace
+
+ScopedProtectionTimer::ScopedProtectionTimer(ProtectionSurface surface,
+                                             blink::ExecutionContext* context)
+    : surface_(surface), context_(context) {
+  if (ShouldSample()) {
+    start_ = base::TimeTicks::Now();
+  }
+}
+
+ScopedProtectionTimer::ScopedProtectionTimer(ProtectionSurface surface)
+    : surface_(surface), context_(nullptr), start_(base::TimeTicks::Now()) {}
+
+ScopedProtectionTimer::~ScopedProtectionTimer() {
+  if (start_.is_null()) {
+    return;
+  }
+  
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start_;
+  FingerprintStatCounters::RecordLatency(surface_, elapsed.InMicroseconds());
+  if (context_) {
+    FingerprintTelemetryReporter::RecordLatency(context_, surface_, elapsed);
+  }
+}
+
+}  // namespace novebrowse
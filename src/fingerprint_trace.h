@@ -0,0 +1,49 @@
+#ifndef NOVEBROWSE_FINGERPRINT_TRACE_H_
+#define NOVEBROWSE_FINGERPRINT_TRACE_H_
+
+#include <stdint.h>
+
+#include "base/time/time.h"
+#include "base/trace_event/trace_event.h"
+#include "novebrowse/fingerprint_stats.h"
+
+namespace blink {
+class ExecutionContext;
+}  // namespace blink
+
+// 跟踪类别 - 在base/trace_event/builtin_categories.h中注册
+#define NOVEBROWSE_TRACE_CATEGORY "novebrowse"
+
+namespace novebrowse {
+
+// 热路径采样计时 - 作用域结束时把耗时计入延迟直方图
+//
+// 渲染器侧每个线程每kSampleInterval次调用只计时一次，未采样时只有一次
+// 线程局部计数；采样同时随文档的遥测批次上报，浏览器据此按站点汇总。
+// 浏览器侧的配置加载和提交频率低，每次都计时。
+class ScopedProtectionTimer {
+ public:
+  // 渲染器侧的采样间隔
+  static constexpr uint32_t kSampleInterval = 16;
+  
+  // 渲染器热路径；context为空或不是文档时只计入本进程直方图
+  ScopedProtectionTimer(ProtectionSurface surface,
+                        blink::ExecutionContext* context);
+  
+  // 浏览器侧低频路径
+  explicit ScopedProtectionTimer(ProtectionSurface surface);
+  
+  ~ScopedProtectionTimer();
+  
+  ScopedProtectionTimer(const ScopedProtectionTimer&) = delete;
+  ScopedProtectionTimer& operator=(const ScopedProtectionTimer&) = delete;
+  
+ private:
+  const ProtectionSurface surface_;
+  blink::ExecutionContext* const context_;
+  base::TimeTicks start_;  // 未采样时为空
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_FINGERPRINT_TRACE_H_
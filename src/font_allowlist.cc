@@ -0,0 +1,46 @@
+#include "novebrowse/font_allowlist.h"
+
+namespace novebrowse {
+
+FontAllowlist::FontAllowlist() = default;
+
+FontAllowlist::FontAllowlist(const FontConfig& config) {
+  ordered_families_.reserve(static_cast<wtf_size_t>(config.available_fonts.size()));
+  for (const std::string& family : config.available_fonts) {
+    WTF::AtomicString name = WTF::AtomicString::FromUTF8(family);
+    if (name.empty()) {
+      continue;
+    }
+    
+    // Enumeration keeps the configured spelling and order, minus repeats
+    // that differ only in case.
+    if (families_.insert(name).is_new_entry) {
+      ordered_families_.push_back(name.GetString());
+    }
+  }
+}
+
+FontAllowlist::~FontAllowlist() = default;
+
+bool FontAllowlist::Contains(const WTF::AtomicString& family) const {
+  return !family.empty() && families_.Contains(family);
+}
+
+// static
+std::optional<FontMetric> FontAllowlist::MetricFromName(std::string_view name) {
+  if (name == "width") {
+    return FontMetric::kWidth;
+  }
+  if (name == "height") {
+    return FontMetric::kHeight;
+  }
+  if (name == "ascent") {
+    return FontMetric::kAscent;
+  }
+  if (name == "descent") {
+    return FontMetric::kDescent;
+  }
+  return std::nullopt;
+}
+
+}  // namespace novebrowse
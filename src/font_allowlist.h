@@ -0,0 +1,64 @@
+#ifndef NOVEBROWSE_FONT_ALLOWLIST_H_
+#define NOVEBROWSE_FONT_ALLOWLIST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string_view>
+
+#include "novebrowse/fingerprint_config.h"
+#include "third_party/blink/renderer/platform/wtf/hash_set.h"
+#include "third_party/blink/renderer/platform/wtf/text/atomic_string.h"
+#include "third_party/blink/renderer/platform/wtf/text/case_folding_hash.h"
+#include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
+#include "third_party/blink/renderer/platform/wtf/vector.h"
+
+namespace novebrowse {
+
+// 字体度量项 - 与font_metrics_offsets的键一一对应
+enum class FontMetric : uint8_t {
+  kWidth,
+  kHeight,
+  kAscent,
+  kDescent,
+};
+
+inline constexpr size_t kFontMetricCount =
+    static_cast<size_t>(FontMetric::kDescent) + 1;
+
+// 字体白名单索引 - 应用配置时由FontConfig编译一次
+//
+// 族名存放在大小写无关的AtomicString集合中，查询是一次哈希查找，
+// 不分配内存也不生成折叠后的字符串。
+// AtomicString按线程驻留，因此只在渲染器主线程上构建和使用。
+class FontAllowlist {
+ public:
+  FontAllowlist();
+  explicit FontAllowlist(const FontConfig& config);
+  ~FontAllowlist();
+  
+  FontAllowlist(const FontAllowlist&) = delete;
+  FontAllowlist& operator=(const FontAllowlist&) = delete;
+  
+  // 名单为空表示不限制
+  bool empty() const { return families_.empty(); }
+  
+  // 族名是否在名单中（大小写无关）
+  bool Contains(const WTF::AtomicString& family) const;
+  
+  // 按配置顺序排列的族名，供字体枚举直接返回，不再逐次复制
+  const WTF::Vector<WTF::String>& families() const { return ordered_families_; }
+  
+  // font_metrics_offsets的键转换为度量项，未知键返回nullopt
+  static std::optional<FontMetric> MetricFromName(std::string_view name);
+  
+ private:
+  WTF::HashSet<WTF::AtomicString, WTF::CaseFoldingHashTraits<WTF::AtomicString>>
+      families_;
+  WTF::Vector<WTF::String> ordered_families_;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_FONT_ALLOWLIST_H_
@@ -0,0 +1,45 @@
+#include "novebrowse/font_fingerprint_protection.h"
+
+#include "novebrowse/blink_fingerprint_manager.h"
+#include "novebrowse/fingerprint_manager.h"
+#include "novebrowse/fingerprint_stats.h"
+#include "novebrowse/fingerprint_telemetry_reporter.h"
+#include "third_party/blink/renderer/core/execution_context/execution_context.h"
+#include "third_party/blink/renderer/core/frame/local_dom_window.h"
+#include "third_party/blink/renderer/core/frame/local_frame.h"
+#include "third_party/blink/renderer/platform/wtf/casting.h"
+
+namespace novebrowse {
+
+// static
+bool FontFingerprintProtection::IsEnabled() {
+  return FingerprintManager::IsEnabled();
+}
+
+// static
+bool FontFingerprintProtection::ShouldRejectFamily(
+    blink::ExecutionContext* context,
+    const WTF::AtomicString& family) {
+  if (!IsEnabled() || family.empty()) {
+    return false;
+  }
+  
+  // Workers have no frame record and are left unfiltered.
+  auto* window = blink::DynamicTo<blink::LocalDOMWindow>(context);
+  if (!window || !window->GetFrame()) {
+    return false;
+  }
+  
+  BlinkFingerprintManager* manager =
+      BlinkFingerprintManager::FromFrameIfConfigured(window->GetFrame());
+  if (!manager || manager->IsFontFamilyAllowed(family)) {
+    return false;
+  }
+  
+  INCREMENT_FINGERPRINT_STAT(kFontEnumerationsSpoofed);
+  FingerprintTelemetryReporter::Record(context,
+                                       FingerprintStat::kFontEnumerationsSpoofed);
+  return true;
+}
+
+}  // namespace novebrowse
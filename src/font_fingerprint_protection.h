@@ -0,0 +1,29 @@
+#ifndef NOVEBROWSE_FONT_FINGERPRINT_PROTECTION_H_
+#define NOVEBROWSE_FONT_FINGERPRINT_PROTECTION_H_
+
+#include "third_party/blink/renderer/platform/wtf/text/atomic_string.h"
+
+namespace blink {
+class ExecutionContext;
+}
+
+namespace novebrowse {
+
+// 字体指纹保护实现类
+//
+// 在CSSFontSelector查询平台字体之前按Frame的字体白名单拒绝名单外的族名，
+// 探测脚本测量的未列出字体因此不会触发平台字体查找，也不会产生FontCache未命中。
+// @font-face声明的网页字体和通用族名不受影响。
+class FontFingerprintProtection {
+ public:
+  // 检查是否启用字体保护
+  static bool IsEnabled();
+  
+  // 非通用族名是否应当在平台查找前拒绝 - 一次大小写无关的哈希查找
+  static bool ShouldRejectFamily(blink::ExecutionContext* context,
+                                 const WTF::AtomicString& family);
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_FONT_FINGERPRINT_PROTECTION_H_
@@ -0,0 +1,63 @@
+#include "novebrowse/frame_config_registry.h"
+
+#include <utility>
+
+#include "content/public/browser/render_frame_host.h"
+#include "novebrowse/fingerprint_manager.h"
+
+namespace novebrowse {
+
+FrameConfigRegistry::FrameConfigRegistry() : generation_(1) {}
+
+FrameConfigRegistry::FrameConfigRegistry(ConfigMap configs, uint64_t generation)
+    : configs_(std::move(configs)), generation_(generation) {}
+
+FrameConfigRegistry::~FrameConfigRegistry() = default;
+
+scoped_refptr<const FingerprintConfigSnapshot> FrameConfigRegistry::Find(
+    const content::GlobalRenderFrameHostId& id) const {
+  auto it = configs_.find(id);
+  if (it == configs_.end()) {
+    return nullptr;
+  }
+  
+  return it->second;
+}
+
+scoped_refptr<const FrameConfigRegistry> FrameConfigRegistry::Set(
+    const content::GlobalRenderFrameHostId& id,
+    scoped_refptr<const FingerprintConfigSnapshot> config) const {
+  // Frame configs change on navigation and profile switches, far less
+  // often than they are read, so copying the table is the cheap side.
+  ConfigMap configs = configs_;
+  configs.insert_or_assign(id, std::move(config));
+  return base::WrapRefCounted(
+      new FrameConfigRegistry(std::move(configs), generation_ + 1));
+}
+
+scoped_refptr<const FrameConfigRegistry> FrameConfigRegistry::Remove(
+    const content::GlobalRenderFrameHostId& id) const {
+  if (!configs_.contains(id)) {
+    return nullptr;
+  }
+  
+  ConfigMap configs = configs_;
+  configs.erase(id);
+  return base::WrapRefCounted(
+      new FrameConfigRegistry(std::move(configs), generation_ + 1));
+}
+
+FrameConfigObserver::FrameConfigObserver(content::WebContents* web_contents)
+    : content::WebContentsObserver(web_contents),
+      content::WebContentsUserData<FrameConfigObserver>(*web_contents) {}
+
+FrameConfigObserver::~FrameConfigObserver() = default;
+
+void FrameConfigObserver::RenderFrameDeleted(
+    content::RenderFrameHost* render_frame_host) {
+  FINGERPRINT_MANAGER()->RemoveFrameConfig(render_frame_host);
+}
+
+WEB_CONTENTS_USER_DATA_KEY_IMPL(FrameConfigObserver);
+
+}  // namespace novebrowse
@@ -0,0 +1,84 @@
+#ifndef NOVEBROWSE_FRAME_CONFIG_REGISTRY_H_
+#define NOVEBROWSE_FRAME_CONFIG_REGISTRY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_refptr.h"
+#include "content/public/browser/global_routing_id.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "content/public/browser/web_contents_user_data.h"
+#include "novebrowse/fingerprint_config.h"
+#include "third_party/abseil-cpp/absl/container/flat_hash_map.h"
+
+namespace novebrowse {
+
+// Frame配置表 - 以GlobalRenderFrameHostId为键保存每个Frame的配置快照
+//
+// 不做字符串格式化，查找为一次哈希。表本身不可变：修改时复制出带新代数的表，
+// 仍持有旧表的读者不受影响。FingerprintManager在锁下替换当前表，
+// 读者按代数命中线程缓存，查找不加锁。
+class FrameConfigRegistry
+    : public base::RefCountedThreadSafe<FrameConfigRegistry> {
+ public:
+  FrameConfigRegistry();
+  
+  FrameConfigRegistry(const FrameConfigRegistry&) = delete;
+  FrameConfigRegistry& operator=(const FrameConfigRegistry&) = delete;
+  
+  // 查找Frame配置，未设置时返回nullptr
+  scoped_refptr<const FingerprintConfigSnapshot> Find(
+      const content::GlobalRenderFrameHostId& id) const;
+  
+  // 返回设置/移除一项后的新表；要移除的项不存在时Remove返回nullptr
+  scoped_refptr<const FrameConfigRegistry> Set(
+      const content::GlobalRenderFrameHostId& id,
+      scoped_refptr<const FingerprintConfigSnapshot> config) const;
+  scoped_refptr<const FrameConfigRegistry> Remove(
+      const content::GlobalRenderFrameHostId& id) const;
+  
+  // 每次修改递增，从1开始
+  uint64_t generation() const { return generation_; }
+  size_t size() const { return configs_.size(); }
+  
+ private:
+  friend class base::RefCountedThreadSafe<FrameConfigRegistry>;
+  
+  using ConfigMap = absl::flat_hash_map<content::GlobalRenderFrameHostId,
+                                        scoped_refptr<const FingerprintConfigSnapshot>,
+                                        content::GlobalRenderFrameHostIdHasher>;
+  
+  FrameConfigRegistry(ConfigMap configs, uint64_t generation);
+  ~FrameConfigRegistry();
+  
+  const ConfigMap configs_;
+  const uint64_t generation_;
+};
+
+// Frame配置清理观察者 - 挂在设置过Frame配置的WebContents上
+//
+// Frame删除时移除对应配置，避免配置表无限增长。
+class FrameConfigObserver
+    : public content::WebContentsObserver,
+      public content::WebContentsUserData<FrameConfigObserver> {
+ public:
+  ~FrameConfigObserver() override;
+  
+  FrameConfigObserver(const FrameConfigObserver&) = delete;
+  FrameConfigObserver& operator=(const FrameConfigObserver&) = delete;
+  
+  // content::WebContentsObserver:
+  void RenderFrameDeleted(content::RenderFrameHost* render_frame_host) override;
+  
+ private:
+  friend class content::WebContentsUserData<FrameConfigObserver>;
+  
+  explicit FrameConfigObserver(content::WebContents* web_contents);
+  
+  WEB_CONTENTS_USER_DATA_KEY_DECL();
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_FRAME_CONFIG_REGISTRY_H_
@@ -0,0 +1,118 @@
+#include "novebrowse/profile_pool.h"
+
+#include "base/hash/hash.h"
+
+namespace novebrowse {
+
+ProfilePool::ProfilePool() = default;
+
+ProfilePool::~ProfilePool() = default;
+
+// static
+FingerprintConfig ProfilePool::BuildConfig(const FingerprintConfig& base,
+                                           const DeviceProfile& profile,
+                                           const std::string& behavior_pattern) {
+  FingerprintConfig config = base;
+  config.device_profile = profile.name;
+  config.profile_name = profile.name;
+  if (!behavior_pattern.empty()) {
+    config.behavior_pattern = behavior_pattern;
+  }
+  
+  // Only the fields a device profile actually carries; the rest, including
+  // the per-section enabled switches, come from |base|.
+  if (!profile.navigator.user_agent.empty()) {
+    config.navigator.user_agent = profile.navigator.user_agent;
+  }
+  if (!profile.navigator.platform.empty()) {
+    config.navigator.platform = profile.navigator.platform;
+  }
+  if (!profile.navigator.languages.empty()) {
+    config.navigator.languages = profile.navigator.languages;
+  }
+  config.navigator.hardware_concurrency = profile.navigator.hardware_concurrency;
+  config.navigator.device_memory = profile.navigator.device_memory;
+  
+  config.screen.width = profile.screen.width;
+  config.screen.height = profile.screen.height;
+  config.screen.color_depth = profile.screen.color_depth;
+  config.screen.pixel_depth = profile.screen.pixel_depth;
+  config.screen.device_pixel_ratio = profile.screen.device_pixel_ratio;
+  
+  config.webgl.vendor = profile.webgl.vendor;
+  config.webgl.renderer = profile.webgl.renderer;
+  
+  return config;
+}
+
+// static
+const std::string& ProfilePool::PickBehaviorPattern(
+    std::string_view profile_name,
+    const std::vector<std::string>& sorted_pattern_names,
+    const std::string& fallback) {
+  if (sorted_pattern_names.empty()) {
+    return fallback;
+  }
+  
+  // PersistentHash is stable across runs and platforms, so a profile keeps
+  // its pattern whether it was pooled or built on a miss.
+  return sorted_pattern_names[base::PersistentHash(profile_name) %
+                              sorted_pattern_names.size()];
+}
+
+scoped_refptr<const FingerprintConfigSnapshot> ProfilePool::Find(
+    std::string_view name) const {
+  base::AutoLock auto_lock(lock_);
+  auto it = entries_.find(name);
+  return it != entries_.end() ? it->second : nullptr;
+}
+
+void ProfilePool::Replace(std::vector<Entry> entries) {
+  absl::flat_hash_map<std::string, scoped_refptr<const FingerprintConfigSnapshot>>
+      new_entries;
+  new_entries.reserve(entries.size());
+  for (auto& [name, config] : entries) {
+    new_entries.insert_or_assign(std::move(name), std::move(config));
+  }
+  
+  // Release the old snapshots outside the lock.
+  base::AutoLock auto_lock(lock_);
+  entries_.swap(new_entries);
+}
+
+void ProfilePool::Add(std::string name,
+                      scoped_refptr<const FingerprintConfigSnapshot> config) {
+  base::AutoLock auto_lock(lock_);
+  if (entries_.size() >= capacity_ && !entries_.contains(name)) {
+    return;
+  }
+  entries_.insert_or_assign(std::move(name), std::move(config));
+}
+
+std::vector<scoped_refptr<const FingerprintConfigSnapshot>> ProfilePool::GetAll()
+    const {
+  std::vector<scoped_refptr<const FingerprintConfigSnapshot>> configs;
+  base::AutoLock auto_lock(lock_);
+  configs.reserve(entries_.size());
+  for (const auto& [name, config] : entries_) {
+    configs.push_back(config);
+  }
+  return configs;
+}
+
+size_t ProfilePool::capacity() const {
+  base::AutoLock auto_lock(lock_);
+  return capacity_;
+}
+
+void ProfilePool::set_capacity(size_t capacity) {
+  base::AutoLock auto_lock(lock_);
+  capacity_ = capacity;
+}
+
+size_t ProfilePool::size() const {
+  base::AutoLock auto_lock(lock_);
+  return entries_.size();
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,78 @@
+#ifndef NOVEBROWSE_PROFILE_POOL_H_
+#define NOVEBROWSE_PROFILE_POOL_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "base/memory/scoped_refptr.h"
+#include "base/synchronization/lock.h"
+#include "novebrowse/fingerprint_config.h"
+#include "third_party/abseil-cpp/absl/container/flat_hash_map.h"
+
+namespace novebrowse {
+
+// 配置池 - 以设备配置文件名为键，保存预先构建并验证好的配置快照
+//
+// 构建在后台加载序列上完成，切换配置时只需一次哈希查找。可在任意线程使用。
+class ProfilePool {
+ public:
+  // 默认预构建的配置数（启动加载后即按此预热）
+  static constexpr size_t kDefaultCapacity = 8;
+  
+  // 预热允许的最大配置数；渲染器侧的记录缓存不小于它，预推送的配置不会被挤掉
+  static constexpr size_t kMaxCapacity = 64;
+  
+  // 渲染器进程保留的配置记录数（SpoofRecord缓存），浏览器侧按同一数量跟踪
+  // 已发送的配置；超出最大池容量的部分留给各Frame自己的配置
+  static constexpr size_t kRendererCachedConfigs = kMaxCapacity + 16;
+  
+  using Entry = std::pair<std::string, scoped_refptr<const FingerprintConfigSnapshot>>;
+  
+  ProfilePool();
+  ~ProfilePool();
+  
+  ProfilePool(const ProfilePool&) = delete;
+  ProfilePool& operator=(const ProfilePool&) = delete;
+  
+  // 由设备配置文件和行为模式组合出完整配置，base提供其余字段
+  static FingerprintConfig BuildConfig(const FingerprintConfig& base,
+                                       const DeviceProfile& profile,
+                                       const std::string& behavior_pattern);
+  
+  // 为配置文件选定行为模式：按配置文件名的稳定哈希在已排序的模式名中取一个，
+  // 与加载顺序和池容量无关。预热和未命中构建共用此规则；没有模式时返回fallback
+  static const std::string& PickBehaviorPattern(
+      std::string_view profile_name,
+      const std::vector<std::string>& sorted_pattern_names,
+      const std::string& fallback);
+  
+  // 查找预构建的配置，未命中返回nullptr
+  scoped_refptr<const FingerprintConfigSnapshot> Find(std::string_view name) const;
+  
+  // 整体替换池内容（重新预热或配置文件重载后）
+  void Replace(std::vector<Entry> entries);
+  
+  // 加入单个配置（未命中时同步构建的结果），超出容量时不保留
+  void Add(std::string name, scoped_refptr<const FingerprintConfigSnapshot> config);
+  
+  // 当前池中的全部配置，用于向渲染器预推送
+  std::vector<scoped_refptr<const FingerprintConfigSnapshot>> GetAll() const;
+  
+  size_t capacity() const;
+  void set_capacity(size_t capacity);
+  size_t size() const;
+  
+ private:
+  mutable base::Lock lock_;
+  size_t capacity_ = 0;
+  absl::flat_hash_map<std::string, scoped_refptr<const FingerprintConfigSnapshot>>
+      entries_;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_PROFILE_POOL_H_
@@ -0,0 +1,57 @@
+#include "novebrowse/profile_switcher_host.h"
+
+#include <memory>
+#include <utility>
+
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/web_contents.h"
+#include "mojo/public/cpp/bindings/message.h"
+#include "mojo/public/cpp/bindings/self_owned_receiver.h"
+#include "novebrowse/fingerprint_manager.h"
+#include "novebrowse/profile_pool.h"
+
+namespace novebrowse {
+
+// static
+void ProfileSwitcherHost::Create(
+    mojo::PendingReceiver<mojom::FingerprintProfileSwitcher> receiver) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  mojo::MakeSelfOwnedReceiver(std::make_unique<ProfileSwitcherHost>(),
+                              std::move(receiver));
+}
+
+ProfileSwitcherHost::ProfileSwitcherHost() = default;
+
+ProfileSwitcherHost::~ProfileSwitcherHost() = default;
+
+void ProfileSwitcherHost::WarmProfilePool(uint32_t count) {
+  if (count > ProfilePool::kMaxCapacity) {
+    mojo::ReportBadMessage("WarmProfilePool count out of range");
+    return;
+  }
+  FINGERPRINT_MANAGER()->WarmProfilePool(count);
+}
+
+void ProfileSwitcherHost::SwitchProfile(int32_t render_process_id,
+                                        int32_t render_frame_id,
+                                        bool whole_page,
+                                        const std::string& profile_name,
+                                        SwitchProfileCallback callback) {
+  content::RenderFrameHost* frame =
+      content::RenderFrameHost::FromID(render_process_id, render_frame_id);
+  if (!frame) {
+    std::move(callback).Run(false);
+    return;
+  }
+  
+  if (whole_page) {
+    std::move(callback).Run(FINGERPRINT_MANAGER()->SwitchProfile(
+        content::WebContents::FromRenderFrameHost(frame), profile_name));
+    return;
+  }
+  
+  std::move(callback).Run(FINGERPRINT_MANAGER()->SwitchProfile(frame, profile_name));
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,39 @@
+#ifndef NOVEBROWSE_PROFILE_SWITCHER_HOST_H_
+#define NOVEBROWSE_PROFILE_SWITCHER_HOST_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+#include "novebrowse/mojom/fingerprint.mojom.h"
+
+namespace novebrowse {
+
+// 配置切换接收端 - 把自动化控制端的请求转给FingerprintManager，只在UI线程上运行
+class ProfileSwitcherHost : public mojom::FingerprintProfileSwitcher {
+ public:
+  // 绑定一个自持有的接收端 - 由浏览器控制通道（启动本进程的控制端经Mojo邀请
+  // 传入的管道，见ChromeContentBrowserClient::BindBrowserControlInterface）
+  // 调用，不注册到Frame，渲染器无法获取
+  static void Create(
+      mojo::PendingReceiver<mojom::FingerprintProfileSwitcher> receiver);
+  
+  ProfileSwitcherHost();
+  ~ProfileSwitcherHost() override;
+  
+  ProfileSwitcherHost(const ProfileSwitcherHost&) = delete;
+  ProfileSwitcherHost& operator=(const ProfileSwitcherHost&) = delete;
+  
+  // mojom::FingerprintProfileSwitcher:
+  void WarmProfilePool(uint32_t count) override;
+  void SwitchProfile(int32_t render_process_id,
+                     int32_t render_frame_id,
+                     bool whole_page,
+                     const std::string& profile_name,
+                     SwitchProfileCallback callback) override;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_PROFILE_SWITCHER_HOST_H_
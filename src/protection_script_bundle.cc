@@ -0,0 +1,157 @@
+#include "novebrowse/protection_script_bundle.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check.h"
+#include "base/logging.h"
+#include "base/no_destructor.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_binding_for_core.h"
+#include "third_party/blink/renderer/core/frame/local_frame.h"
+#include "third_party/blink/renderer/platform/bindings/script_state.h"
+#include "third_party/blink/renderer/platform/bindings/v8_binding.h"
+#include "third_party/blink/renderer/platform/wtf/wtf.h"
+
+namespace novebrowse {
+
+namespace {
+
+// Shows up in DevTools and stack traces instead of an anonymous script.
+constexpr char kBundleResourceName[] = "novebrowse://protection-bundle.js";
+
+}  // namespace
+
+ProtectionScriptBundle::ProtectionScriptBundle(uint64_t config_hash,
+                                               WTF::String source)
+    : config_hash_(config_hash), source_(std::move(source)) {}
+
+ProtectionScriptBundle::~ProtectionScriptBundle() = default;
+
+bool ProtectionScriptBundle::RunInFrame(blink::LocalFrame* frame) {
+  if (!frame || compile_failed_ || source_.IsEmpty()) {
+    return false;
+  }
+  
+  blink::ScriptState* script_state = blink::ToScriptStateForMainWorld(frame);
+  if (!script_state) {
+    return false;
+  }
+  
+  blink::ScriptState::Scope scope(script_state);
+  v8::Isolate* isolate = script_state->GetIsolate();
+  v8::Local<v8::Context> context = script_state->GetContext();
+  
+  v8::Local<v8::UnboundScript> unbound_script;
+  if (!GetOrCompile(isolate).ToLocal(&unbound_script)) {
+    return false;
+  }
+  
+  v8::MicrotasksScope microtasks_scope(context,
+                                       v8::MicrotasksScope::kDoNotRunMicrotasks);
+  v8::TryCatch try_catch(isolate);
+  v8::Local<v8::Value> result;
+  if (!unbound_script->BindToCurrentContext()->Run(context).ToLocal(&result)) {
+    // A throwing page-facing hook must not break the frame; the bundle
+    // itself compiled fine, so it stays usable for the next frame.
+    DVLOG(1) << "Protection bundle threw in frame";
+  }
+  
+  return true;
+}
+
+void ProtectionScriptBundle::ReleaseCompiledScript() {
+  unbound_script_.Reset();
+}
+
+v8::MaybeLocal<v8::UnboundScript> ProtectionScriptBundle::GetOrCompile(
+    v8::Isolate* isolate) {
+  if (!unbound_script_.IsEmpty()) {
+    return unbound_script_.Get(isolate);
+  }
+  
+  v8::ScriptCompiler::CompileOptions options =
+      v8::ScriptCompiler::kNoCompileOptions;
+  v8::ScriptCompiler::CachedData* cached_data = nullptr;
+  if (!code_cache_.empty()) {
+    cached_data = new v8::ScriptCompiler::CachedData(
+        code_cache_.data(), static_cast<int>(code_cache_.size()),
+        v8::ScriptCompiler::CachedData::BufferNotOwned);
+    options = v8::ScriptCompiler::kConsumeCodeCache;
+  }
+  
+  // Source takes ownership of |cached_data|.
+  v8::ScriptOrigin origin(blink::V8String(isolate, kBundleResourceName));
+  v8::ScriptCompiler::Source script_source(blink::V8String(isolate, source_),
+                                           origin, cached_data);
+  
+  v8::TryCatch try_catch(isolate);
+  v8::Local<v8::UnboundScript> unbound_script;
+  if (!v8::ScriptCompiler::CompileUnboundScript(isolate, &script_source, options)
+           .ToLocal(&unbound_script)) {
+    LOG(ERROR) << "Failed to compile protection bundle " << config_hash_;
+    compile_failed_ = true;
+    return v8::MaybeLocal<v8::UnboundScript>();
+  }
+  
+  // V8 rejects caches built by a different version or with other flags.
+  if (cached_data && script_source.GetCachedData()->rejected) {
+    code_cache_.clear();
+  }
+  
+  if (code_cache_.empty()) {
+    std::unique_ptr<v8::ScriptCompiler::CachedData> new_cache(
+        v8::ScriptCompiler::CreateCodeCache(unbound_script));
+    if (new_cache && new_cache->length > 0) {
+      code_cache_.assign(new_cache->data, new_cache->data + new_cache->length);
+    }
+  }
+  
+  unbound_script_.Reset(isolate, unbound_script);
+  return unbound_script;
+}
+
+// static
+ProtectionScriptBundleCache& ProtectionScriptBundleCache::GetInstance() {
+  DCHECK(WTF::IsMainThread());
+  static base::NoDestructor<ProtectionScriptBundleCache> instance;
+  return *instance;
+}
+
+ProtectionScriptBundleCache::ProtectionScriptBundleCache() = default;
+
+ProtectionScriptBundleCache::~ProtectionScriptBundleCache() = default;
+
+ProtectionScriptBundle& ProtectionScriptBundleCache::GetOrCreate(
+    uint64_t config_hash,
+    base::FunctionRef<WTF::String()> build_source) {
+  auto it = std::find_if(bundles_.begin(), bundles_.end(),
+                         [&](const std::unique_ptr<ProtectionScriptBundle>& bundle) {
+                           return bundle->config_hash() == config_hash;
+                         });
+  if (it != bundles_.end()) {
+    // Move to the back so the most recently used bundle is last.
+    std::rotate(it, it + 1, bundles_.end());
+  } else {
+    bundles_.push_back(
+        std::make_unique<ProtectionScriptBundle>(config_hash, build_source()));
+  }
+  
+  Trim();
+  return *bundles_.back();
+}
+
+void ProtectionScriptBundleCache::Trim() {
+  if (bundles_.size() > kMaxBundles) {
+    bundles_.erase(bundles_.begin(),
+                   bundles_.begin() + (bundles_.size() - kMaxBundles));
+  }
+  
+  size_t compiled = 0;
+  for (auto it = bundles_.rbegin(); it != bundles_.rend(); ++it) {
+    if ((*it)->is_compiled() && ++compiled > kMaxCompiledBundles) {
+      (*it)->ReleaseCompiledScript();
+    }
+  }
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,90 @@
+#ifndef NOVEBROWSE_PROTECTION_SCRIPT_BUNDLE_H_
+#define NOVEBROWSE_PROTECTION_SCRIPT_BUNDLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/functional/function_ref.h"
+#include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
+#include "v8/include/v8.h"
+
+namespace blink {
+class LocalFrame;
+}
+
+namespace novebrowse {
+
+// 保护脚本包 - 同一配置哈希的全部注入脚本合并成一个脚本，
+// 每段包在各自的try块中，一段抛出异常不影响其余各段
+//
+// 每个进程只编译一次（UnboundScript），之后绑定到各Frame的主世界运行；
+// 编译产出的V8代码缓存保留下来，脚本被释放后再次编译时直接消费缓存。
+class ProtectionScriptBundle {
+ public:
+  ProtectionScriptBundle(uint64_t config_hash, WTF::String source);
+  ~ProtectionScriptBundle();
+  
+  ProtectionScriptBundle(const ProtectionScriptBundle&) = delete;
+  ProtectionScriptBundle& operator=(const ProtectionScriptBundle&) = delete;
+  
+  // 在Frame主世界中运行，编译失败返回false
+  bool RunInFrame(blink::LocalFrame* frame);
+  
+  // 释放已编译的脚本，保留源码和代码缓存
+  void ReleaseCompiledScript();
+  
+  uint64_t config_hash() const { return config_hash_; }
+  const WTF::String& source() const { return source_; }
+  bool is_compiled() const { return !unbound_script_.IsEmpty(); }
+  bool compile_failed() const { return compile_failed_; }
+  size_t code_cache_size() const { return code_cache_.size(); }
+  
+ private:
+  // 返回已编译的脚本，必要时编译（有代码缓存时消费缓存）
+  v8::MaybeLocal<v8::UnboundScript> GetOrCompile(v8::Isolate* isolate);
+  
+  const uint64_t config_hash_;
+  const WTF::String source_;
+  
+  v8::Global<v8::UnboundScript> unbound_script_;
+  std::vector<uint8_t> code_cache_;
+  bool compile_failed_ = false;
+};
+
+// 保护脚本包缓存 - 按配置哈希索引，只在渲染器主线程上使用
+class ProtectionScriptBundleCache {
+ public:
+  // 最多保留的脚本包数量（源码和代码缓存）
+  static constexpr size_t kMaxBundles = 32;
+  
+  // 最多同时保持编译状态的脚本包数量
+  static constexpr size_t kMaxCompiledBundles = 8;
+  
+  static ProtectionScriptBundleCache& GetInstance();
+  
+  ProtectionScriptBundleCache();
+  ~ProtectionScriptBundleCache();
+  
+  ProtectionScriptBundleCache(const ProtectionScriptBundleCache&) = delete;
+  ProtectionScriptBundleCache& operator=(const ProtectionScriptBundleCache&) = delete;
+  
+  // 获取配置哈希对应的脚本包，不存在时调用build_source生成源码
+  ProtectionScriptBundle& GetOrCreate(uint64_t config_hash,
+                                      base::FunctionRef<WTF::String()> build_source);
+  
+  size_t size() const { return bundles_.size(); }
+  
+ private:
+  // 超出上限时释放最久未用的编译结果和脚本包
+  void Trim();
+  
+  // 按最近使用排序，最后一个最新
+  std::vector<std::unique_ptr<ProtectionScriptBundle>> bundles_;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_PROTECTION_SCRIPT_BUNDLE_H_
@@ -0,0 +1,121 @@
+#include "novebrowse/renderer_config_tracker.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "content/public/browser/browser_thread.h"
+
+namespace novebrowse {
+
+namespace {
+
+const char kRendererConfigTrackerKey[] = "novebrowse_renderer_config_tracker";
+
+}  // namespace
+
+// static
+mojom::FingerprintConfigUpdatePtr RendererConfigTracker::CreateUpdate(
+    content::RenderProcessHost* process,
+    const FingerprintConfigSnapshot& config) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  
+  auto update = mojom::FingerprintConfigUpdate::New();
+  update->config_hash = config.structural_hash();
+  
+  bool already_sent = GetOrCreate(process)->MarkSent(update->config_hash);
+  if (!already_sent) {
+    update->config = config.ToMojoStruct();
+  }
+  
+  return update;
+}
+
+// static
+std::vector<mojom::FingerprintConfigUpdatePtr>
+RendererConfigTracker::CreatePrimeUpdates(
+    content::RenderProcessHost* process,
+    const std::vector<scoped_refptr<const FingerprintConfigSnapshot>>& configs) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  
+  RendererConfigTracker* tracker = GetOrCreate(process);
+  std::vector<mojom::FingerprintConfigUpdatePtr> updates;
+  for (const auto& config : configs) {
+    // Checked without MarkSent() so configs the process already has keep
+    // their place in the recency order.
+    if (tracker->Contains(config->structural_hash())) {
+      continue;
+    }
+    
+    tracker->MarkSent(config->structural_hash());
+    auto update = mojom::FingerprintConfigUpdate::New();
+    update->config_hash = config->structural_hash();
+    update->config = config->ToMojoStruct();
+    updates.push_back(std::move(update));
+  }
+  
+  return updates;
+}
+
+// static
+void RendererConfigTracker::OnUpdateRejected(content::RenderProcessHost* process,
+                                             uint64_t config_hash) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  GetOrCreate(process)->Forget(config_hash);
+}
+
+// static
+RendererConfigTracker* RendererConfigTracker::GetOrCreate(
+    content::RenderProcessHost* process) {
+  auto* tracker = static_cast<RendererConfigTracker*>(
+      process->GetUserData(kRendererConfigTrackerKey));
+  if (!tracker) {
+    auto new_tracker = std::make_unique<RendererConfigTracker>(process);
+    tracker = new_tracker.get();
+    process->SetUserData(kRendererConfigTrackerKey, std::move(new_tracker));
+  }
+  
+  return tracker;
+}
+
+RendererConfigTracker::RendererConfigTracker(content::RenderProcessHost* process) {
+  process_observation_.Observe(process);
+}
+
+RendererConfigTracker::~RendererConfigTracker() = default;
+
+void RendererConfigTracker::RenderProcessExited(
+    content::RenderProcessHost* host,
+    const content::ChildProcessTerminationInfo& info) {
+  // A relaunched renderer on the same host starts with an empty cache.
+  sent_hashes_.clear();
+}
+
+void RendererConfigTracker::RenderProcessHostDestroyed(
+    content::RenderProcessHost* host) {
+  process_observation_.Reset();
+}
+
+bool RendererConfigTracker::MarkSent(uint64_t config_hash) {
+  auto it = std::find(sent_hashes_.begin(), sent_hashes_.end(), config_hash);
+  if (it != sent_hashes_.end()) {
+    std::rotate(it, it + 1, sent_hashes_.end());
+    return true;
+  }
+  
+  if (sent_hashes_.size() >= kMaxTrackedConfigs) {
+    sent_hashes_.erase(sent_hashes_.begin());
+  }
+  sent_hashes_.push_back(config_hash);
+  return false;
+}
+
+void RendererConfigTracker::Forget(uint64_t config_hash) {
+  std::erase(sent_hashes_, config_hash);
+}
+
+bool RendererConfigTracker::Contains(uint64_t config_hash) const {
+  return std::find(sent_hashes_.begin(), sent_hashes_.end(), config_hash) !=
+         sent_hashes_.end();
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,72 @@
+#ifndef NOVEBROWSE_RENDERER_CONFIG_TRACKER_H_
+#define NOVEBROWSE_RENDERER_CONFIG_TRACKER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/scoped_observation.h"
+#include "base/supports_user_data.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_process_host_observer.h"
+#include "novebrowse/fingerprint_config.h"
+#include "novebrowse/profile_pool.h"
+
+namespace novebrowse {
+
+// 渲染器配置跟踪 - 记录每个渲染器进程已收到过的配置哈希
+//
+// 进程已有该配置时只发送哈希；进程退出时清空（同一RenderProcessHost
+// 可能在崩溃后复用，新进程没有任何缓存）。只在UI线程上使用。
+class RendererConfigTracker : public base::SupportsUserData::Data,
+                              public content::RenderProcessHostObserver {
+ public:
+  // 单个进程最多记录的哈希数，与渲染器侧保留的配置数相同
+  static constexpr size_t kMaxTrackedConfigs = ProfilePool::kRendererCachedConfigs;
+  
+  // 构造发往process的配置更新：已发送过时只带哈希，否则带完整配置
+  static mojom::FingerprintConfigUpdatePtr CreateUpdate(
+      content::RenderProcessHost* process,
+      const FingerprintConfigSnapshot& config);
+  
+  // 构造预推送更新：只包含process尚未收到过的配置（均带完整配置），并记为已发送
+  static std::vector<mojom::FingerprintConfigUpdatePtr> CreatePrimeUpdates(
+      content::RenderProcessHost* process,
+      const std::vector<scoped_refptr<const FingerprintConfigSnapshot>>& configs);
+  
+  // 渲染器拒绝了只带哈希的更新（已淘汰该配置），下次发送完整配置
+  static void OnUpdateRejected(content::RenderProcessHost* process,
+                               uint64_t config_hash);
+  
+  explicit RendererConfigTracker(content::RenderProcessHost* process);
+  ~RendererConfigTracker() override;
+  
+  RendererConfigTracker(const RendererConfigTracker&) = delete;
+  RendererConfigTracker& operator=(const RendererConfigTracker&) = delete;
+  
+  // content::RenderProcessHostObserver:
+  void RenderProcessExited(
+      content::RenderProcessHost* host,
+      const content::ChildProcessTerminationInfo& info) override;
+  void RenderProcessHostDestroyed(content::RenderProcessHost* host) override;
+  
+ private:
+  static RendererConfigTracker* GetOrCreate(content::RenderProcessHost* process);
+  
+  // 记录哈希，返回此前是否已存在
+  bool MarkSent(uint64_t config_hash);
+  void Forget(uint64_t config_hash);
+  bool Contains(uint64_t config_hash) const;
+  
+  // 按最近发送排序，最后一个最新
+  std::vector<uint64_t> sent_hashes_;
+  
+  base::ScopedObservation<content::RenderProcessHost,
+                          content::RenderProcessHostObserver>
+      process_observation_{this};
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_RENDERER_CONFIG_TRACKER_H_
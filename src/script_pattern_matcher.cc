@@ -0,0 +1,402 @@
+#include "novebrowse/script_pattern_matcher.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/memory/ptr_util.h"
+#include "base/no_destructor.h"
+#include "base/strings/string_util.h"
+#include "novebrowse/fingerprint_manager.h"
+#include "novebrowse/fingerprint_stats.h"
+#include "novebrowse/fingerprint_telemetry_reporter.h"
+#include "novebrowse/seed_service.h"
+
+namespace novebrowse {
+
+namespace {
+
+// Distinct pattern lists kept for sharing. Records hold their own
+// reference, so this only has to cover configs that come and go.
+constexpr size_t kMaxSharedMatchers = 4;
+
+// Fixed key for the pattern list fingerprint; it only has to be stable
+// within the process.
+constexpr uint64_t kFingerprintKey = 0x73637269707470ull;  // "scriptp"
+
+constexpr uint32_t kNoState = 0xFFFFFFFFu;
+
+// Decoded UTF-16 text is re-encoded this many bytes at a time.
+constexpr size_t kEncodeChunkSize = 1024;
+
+// Writes |code_point| as UTF-8 and returns its length; |out| needs 4 bytes.
+size_t EncodeUTF8(uint32_t code_point, uint8_t* out) {
+  if (code_point < 0x80) {
+    out[0] = static_cast<uint8_t>(code_point);
+    return 1;
+  }
+  if (code_point < 0x800) {
+    out[0] = static_cast<uint8_t>(0xC0 | (code_point >> 6));
+    out[1] = static_cast<uint8_t>(0x80 | (code_point & 0x3F));
+    return 2;
+  }
+  if (code_point < 0x10000) {
+    out[0] = static_cast<uint8_t>(0xE0 | (code_point >> 12));
+    out[1] = static_cast<uint8_t>(0x80 | ((code_point >> 6) & 0x3F));
+    out[2] = static_cast<uint8_t>(0x80 | (code_point & 0x3F));
+    return 3;
+  }
+  out[0] = static_cast<uint8_t>(0xF0 | (code_point >> 18));
+  out[1] = static_cast<uint8_t>(0x80 | ((code_point >> 12) & 0x3F));
+  out[2] = static_cast<uint8_t>(0x80 | ((code_point >> 6) & 0x3F));
+  out[3] = static_cast<uint8_t>(0x80 | (code_point & 0x3F));
+  return 4;
+}
+
+struct SharedMatchers {
+  base::Lock lock;
+  std::vector<scoped_refptr<const ScriptPatternMatcher>> entries GUARDED_BY(lock);
+};
+
+SharedMatchers& GetSharedMatchers() {
+  static base::NoDestructor<SharedMatchers> matchers;
+  return *matchers;
+}
+
+// Lowercases, drops empty entries and repeats, and sorts, so lists that
+// differ only in order or case compile to the same matcher.
+std::vector<std::string> NormalizePatterns(const std::vector<std::string>& patterns) {
+  std::vector<std::string> normalized;
+  normalized.reserve(patterns.size());
+  for (const std::string& pattern : patterns) {
+    if (!pattern.empty()) {
+      normalized.push_back(base::ToLowerASCII(pattern));
+    }
+  }
+  std::sort(normalized.begin(), normalized.end());
+  normalized.erase(std::unique(normalized.begin(), normalized.end()),
+                   normalized.end());
+  return normalized;
+}
+
+uint64_t PatternFingerprint(const std::vector<std::string>& patterns) {
+  std::string joined;
+  for (const std::string& pattern : patterns) {
+    joined.append(pattern);
+    joined.push_back('\0');
+  }
+  return SeedService::KeyedHash(kFingerprintKey, joined);
+}
+
+}  // namespace
+
+// static
+scoped_refptr<const ScriptPatternMatcher> ScriptPatternMatcher::GetOrCompile(
+    const std::vector<std::string>& patterns) {
+  std::vector<std::string> normalized = NormalizePatterns(patterns);
+  if (normalized.empty()) {
+    return nullptr;
+  }
+  
+  uint64_t fingerprint = PatternFingerprint(normalized);
+  SharedMatchers& shared = GetSharedMatchers();
+  {
+    base::AutoLock lock(shared.lock);
+    for (const auto& entry : shared.entries) {
+      if (entry->fingerprint() == fingerprint) {
+        return entry;
+      }
+    }
+  }
+  
+  // Compile outside the lock; a list with hundreds of patterns takes long
+  // enough that other threads should not queue behind it.
+  scoped_refptr<const ScriptPatternMatcher> matcher = base::WrapRefCounted(
+      new ScriptPatternMatcher(std::move(normalized), fingerprint));
+  
+  base::AutoLock lock(shared.lock);
+  for (const auto& entry : shared.entries) {
+    if (entry->fingerprint() == fingerprint) {
+      return entry;
+    }
+  }
+  if (shared.entries.size() >= kMaxSharedMatchers) {
+    shared.entries.erase(shared.entries.begin());
+  }
+  shared.entries.push_back(matcher);
+  return matcher;
+}
+
+// static
+scoped_refptr<const ScriptPatternMatcher> ScriptPatternMatcher::Compile(
+    const std::vector<std::string>& patterns) {
+  std::vector<std::string> normalized = NormalizePatterns(patterns);
+  if (normalized.empty()) {
+    return nullptr;
+  }
+  uint64_t fingerprint = PatternFingerprint(normalized);
+  return base::WrapRefCounted(
+      new ScriptPatternMatcher(std::move(normalized), fingerprint));
+}
+
+ScriptPatternMatcher::ScriptPatternMatcher(std::vector<std::string> patterns,
+                                           uint64_t fingerprint)
+    : patterns_(std::move(patterns)),
+      fingerprint_(fingerprint),
+      results_(kMaxCachedResults) {
+  Build();
+}
+
+ScriptPatternMatcher::~ScriptPatternMatcher() = default;
+
+void ScriptPatternMatcher::Build() {
+  // Every byte that occurs in a pattern gets a class; an uppercase ASCII
+  // letter shares the class of its lowercase form. Patterns are lowercase,
+  // so at most 230 distinct bytes occur and the classes fit in a byte.
+  for (const std::string& pattern : patterns_) {
+    for (char c : pattern) {
+      uint8_t byte = static_cast<uint8_t>(c);
+      if (byte_classes_[byte] != 0) {
+        continue;
+      }
+      byte_classes_[byte] = static_cast<uint8_t>(class_count_++);
+      if (base::IsAsciiLower(c)) {
+        byte_classes_[static_cast<uint8_t>(base::ToUpperASCII(c))] =
+            byte_classes_[byte];
+      }
+    }
+  }
+  DCHECK_LE(class_count_, 256u);
+  
+  // Trie.
+  transitions_.assign(class_count_, kNoState);
+  match_pattern_.assign(1, -1);
+  for (size_t index = 0; index < patterns_.size(); ++index) {
+    uint32_t state = kInitialState;
+    for (char c : patterns_[index]) {
+      size_t slot = state * class_count_ + byte_classes_[static_cast<uint8_t>(c)];
+      if (transitions_[slot] == kNoState) {
+        transitions_[slot] = static_cast<uint32_t>(match_pattern_.size());
+        transitions_.resize(transitions_.size() + class_count_, kNoState);
+        match_pattern_.push_back(-1);
+      }
+      state = transitions_[slot];
+    }
+    if (match_pattern_[state] < 0) {
+      match_pattern_[state] = static_cast<int32_t>(index);
+    }
+  }
+  
+  // Breadth-first over the trie: missing edges take the edge of the fail
+  // state, whose row is already complete because it is shallower. A state
+  // whose fail chain ends in a match is a match itself, so the scan loop
+  // never follows fail links.
+  std::vector<uint32_t> fail(match_pattern_.size(), kInitialState);
+  std::vector<uint32_t> queue;
+  queue.reserve(match_pattern_.size());
+  for (size_t cls = 0; cls < class_count_; ++cls) {
+    uint32_t& next = transitions_[cls];
+    if (next == kNoState) {
+      next = kInitialState;
+    } else {
+      queue.push_back(next);
+    }
+  }
+  for (size_t head = 0; head < queue.size(); ++head) {
+    uint32_t state = queue[head];
+    uint32_t fallback = fail[state];
+    if (match_pattern_[state] < 0) {
+      match_pattern_[state] = match_pattern_[fallback];
+    }
+    for (size_t cls = 0; cls < class_count_; ++cls) {
+      uint32_t& next = transitions_[state * class_count_ + cls];
+      uint32_t fallback_next = transitions_[fallback * class_count_ + cls];
+      if (next == kNoState) {
+        next = fallback_next;
+      } else {
+        fail[next] = fallback_next;
+        queue.push_back(next);
+      }
+    }
+  }
+}
+
+uint32_t ScriptPatternMatcher::Scan(uint32_t state,
+                                    base::span<const uint8_t> data,
+                                    int* matched_pattern) const {
+  DCHECK_LT(state, match_pattern_.size());
+  const uint32_t* transitions = transitions_.data();
+  const int32_t* match_pattern = match_pattern_.data();
+  for (uint8_t byte : data) {
+    state = transitions[state * class_count_ + byte_classes_[byte]];
+    if (match_pattern[state] >= 0) {
+      *matched_pattern = match_pattern[state];
+      return state;
+    }
+  }
+  return state;
+}
+
+std::optional<size_t> ScriptPatternMatcher::Find(std::string_view text) const {
+  int matched = -1;
+  Scan(kInitialState, base::as_byte_span(text), &matched);
+  if (matched < 0) {
+    return std::nullopt;
+  }
+  return static_cast<size_t>(matched);
+}
+
+std::optional<int> ScriptPatternMatcher::FindResult(uint64_t resource_key) const {
+  base::AutoLock lock(results_lock_);
+  auto it = results_.Get(resource_key);
+  if (it == results_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+void ScriptPatternMatcher::StoreResult(uint64_t resource_key,
+                                       int matched_pattern) const {
+  base::AutoLock lock(results_lock_);
+  results_.Put(resource_key, matched_pattern);
+}
+
+std::optional<uint64_t> ScriptPatternMatcher::ResourceKey(
+    std::string_view url,
+    std::string_view etag,
+    std::string_view last_modified) const {
+  if (etag.empty() && last_modified.empty()) {
+    return std::nullopt;
+  }
+  
+  std::string key;
+  key.reserve(url.size() + etag.size() + last_modified.size() + 2);
+  key.append(url);
+  key.push_back('\n');
+  key.append(etag);
+  key.push_back('\n');
+  key.append(last_modified);
+  return SeedService::KeyedHash(fingerprint_, key);
+}
+
+// static
+std::unique_ptr<ScriptPatternScan> ScriptPatternScan::Start(
+    scoped_refptr<const ScriptPatternMatcher> matcher,
+    std::string_view url) {
+  if (!matcher) {
+    return nullptr;
+  }
+  return base::WrapUnique(new ScriptPatternScan(std::move(matcher), url));
+}
+
+ScriptPatternScan::ScriptPatternScan(
+    scoped_refptr<const ScriptPatternMatcher> matcher,
+    std::string_view url)
+    : matcher_(std::move(matcher)), url_(url) {
+  // The URL is scanned on its own; a pattern spanning the end of the URL
+  // and the start of the body is not a match.
+  std::optional<size_t> url_match = matcher_->Find(url_);
+  if (url_match) {
+    matched_pattern_ = static_cast<int>(*url_match);
+    decided_ = true;
+  }
+}
+
+ScriptPatternScan::~ScriptPatternScan() = default;
+
+void ScriptPatternScan::OnResponse(std::string_view etag,
+                                   std::string_view last_modified) {
+  if (decided_) {
+    return;
+  }
+  
+  resource_key_ = matcher_->ResourceKey(url_, etag, last_modified);
+  if (!resource_key_) {
+    return;
+  }
+  
+  std::optional<int> cached = matcher_->FindResult(*resource_key_);
+  if (!cached) {
+    return;
+  }
+  
+  // The verdict is known, so the body is not scanned at all.
+  matched_pattern_ = *cached;
+  decided_ = true;
+  resource_key_.reset();
+}
+
+void ScriptPatternScan::Feed(base::span<const uint8_t> data) {
+  if (decided_ || data.empty()) {
+    return;
+  }
+  
+  state_ = matcher_->Scan(state_, data, &matched_pattern_);
+  if (matched_pattern_ >= 0) {
+    decided_ = true;
+  }
+}
+
+void ScriptPatternScan::FeedLatin1(base::span<const uint8_t> text) {
+  // ASCII runs are already UTF-8 and are scanned in place.
+  size_t run_start = 0;
+  for (size_t i = 0; i < text.size() && !decided_; ++i) {
+    if (text[i] < 0x80) {
+      continue;
+    }
+    Feed(text.subspan(run_start, i - run_start));
+    uint8_t encoded[4];
+    Feed(base::span<const uint8_t>(encoded, EncodeUTF8(text[i], encoded)));
+    run_start = i + 1;
+  }
+  Feed(text.subspan(std::min(run_start, text.size())));
+}
+
+void ScriptPatternScan::FeedUTF16(base::span<const char16_t> text) {
+  std::array<uint8_t, kEncodeChunkSize + 4> buffer;
+  size_t used = 0;
+  for (size_t i = 0; i < text.size() && !decided_; ++i) {
+    uint32_t code_point = text[i];
+    if (code_point >= 0xD800 && code_point <= 0xDFFF) {
+      // Unpaired surrogates become U+FFFD, as String::Utf8() does.
+      if (code_point <= 0xDBFF && i + 1 < text.size() &&
+          text[i + 1] >= 0xDC00 && text[i + 1] <= 0xDFFF) {
+        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (text[i + 1] - 0xDC00);
+        ++i;
+      } else {
+        code_point = 0xFFFD;
+      }
+    }
+    used += EncodeUTF8(code_point, buffer.data() + used);
+    if (used >= kEncodeChunkSize) {
+      Feed(base::span<const uint8_t>(buffer.data(), used));
+      used = 0;
+    }
+  }
+  Feed(base::span<const uint8_t>(buffer.data(), used));
+}
+
+bool ScriptPatternScan::Finish() {
+  if (resource_key_) {
+    matcher_->StoreResult(*resource_key_, matched_pattern_);
+    resource_key_.reset();
+  }
+  decided_ = true;
+  return matched();
+}
+
+std::string_view ScriptPatternScan::matched_pattern() const {
+  if (!matched()) {
+    return std::string_view();
+  }
+  return matcher_->pattern(static_cast<size_t>(matched_pattern_));
+}
+
+// static
+void ScriptPatternScan::RecordBlocked(blink::ExecutionContext* context) {
+  INCREMENT_FINGERPRINT_STAT(kWebDriverDetectionsBlocked);
+  FingerprintTelemetryReporter::Record(context,
+                                       FingerprintStat::kWebDriverDetectionsBlocked);
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,160 @@
+#ifndef NOVEBROWSE_SCRIPT_PATTERN_MATCHER_H_
+#define NOVEBROWSE_SCRIPT_PATTERN_MATCHER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/containers/lru_cache.h"
+#include "base/containers/span.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+
+namespace blink {
+class ExecutionContext;
+}
+
+namespace novebrowse {
+
+// 检测脚本特征匹配器 - blocked_script_patterns编译成的Aho-Corasick自动机
+//
+// 特征按ASCII大小写无关、去重后编译为完整的DFA：出现在特征中的字节各占一个
+// 字节类，其余字节共用类0，转移表按状态×字节类展开，失败链接在编译时全部
+// 折叠进转移表，扫描时每个字节只查一次表，与特征数量无关。
+// 相同的特征列表在进程内共享一份实例；实例不可变，可在任意线程使用。
+// 实例还带有按脚本资源索引的扫描结果缓存，配置更换后随旧实例一起丢弃。
+class ScriptPatternMatcher
+    : public base::RefCountedThreadSafe<ScriptPatternMatcher> {
+ public:
+  // 扫描结果缓存的容量
+  static constexpr size_t kMaxCachedResults = 512;
+  
+  // 起始状态
+  static constexpr uint32_t kInitialState = 0;
+  
+  // 获取特征列表对应的共享匹配器，列表为空（或只有空串）时返回nullptr
+  static scoped_refptr<const ScriptPatternMatcher> GetOrCompile(
+      const std::vector<std::string>& patterns);
+  
+  // 直接编译，不经过进程内共享
+  static scoped_refptr<const ScriptPatternMatcher> Compile(
+      const std::vector<std::string>& patterns);
+  
+  ScriptPatternMatcher(const ScriptPatternMatcher&) = delete;
+  ScriptPatternMatcher& operator=(const ScriptPatternMatcher&) = delete;
+  
+  // 从state继续扫描data，返回扫描后的状态；命中时立即停止并写入*matched_pattern
+  uint32_t Scan(uint32_t state,
+                base::span<const uint8_t> data,
+                int* matched_pattern) const;
+  
+  // 一次性扫描整段文本，返回命中的特征下标
+  std::optional<size_t> Find(std::string_view text) const;
+  
+  // 归一化后的特征（小写）
+  const std::string& pattern(size_t index) const { return patterns_[index]; }
+  size_t pattern_count() const { return patterns_.size(); }
+  size_t state_count() const { return match_pattern_.size(); }
+  
+  // 特征列表指纹，用于进程内共享和结果缓存键
+  uint64_t fingerprint() const { return fingerprint_; }
+  
+  // 扫描结果缓存 - 键由ResourceKey()生成，可在任意线程调用
+  // 结果为命中的特征下标，-1为未命中
+  std::optional<int> FindResult(uint64_t resource_key) const;
+  void StoreResult(uint64_t resource_key, int matched_pattern) const;
+  
+  // 脚本资源键 - 由URL和HTTP校验器生成；两个校验器都为空时无法判断内容
+  // 是否变化，返回nullopt，此时不缓存
+  std::optional<uint64_t> ResourceKey(std::string_view url,
+                                      std::string_view etag,
+                                      std::string_view last_modified) const;
+  
+ private:
+  friend class base::RefCountedThreadSafe<ScriptPatternMatcher>;
+  
+  ScriptPatternMatcher(std::vector<std::string> patterns, uint64_t fingerprint);
+  ~ScriptPatternMatcher();
+  
+  // 构建字节类表和转移表
+  void Build();
+  
+  const std::vector<std::string> patterns_;
+  const uint64_t fingerprint_;
+  
+  std::array<uint8_t, 256> byte_classes_ = {};
+  size_t class_count_ = 1;
+  std::vector<uint32_t> transitions_;  // 状态×字节类
+  std::vector<int32_t> match_pattern_;  // 每个状态命中的特征下标，-1为未命中
+  
+  mutable base::Lock results_lock_;
+  mutable base::LRUCache<uint64_t, int32_t> results_ GUARDED_BY(results_lock_);
+};
+
+// 单个脚本资源的流式扫描 - 先扫URL，再随响应体逐块扫描，不缓冲正文
+//
+// 已有定论（URL命中、缓存命中或正文命中）后Feed不再做任何工作。
+// 只由发起加载的线程使用。
+class ScriptPatternScan {
+ public:
+  // 开始扫描，matcher为nullptr（未启用拦截）时返回nullptr
+  static std::unique_ptr<ScriptPatternScan> Start(
+      scoped_refptr<const ScriptPatternMatcher> matcher,
+      std::string_view url);
+  
+  ~ScriptPatternScan();
+  
+  ScriptPatternScan(const ScriptPatternScan&) = delete;
+  ScriptPatternScan& operator=(const ScriptPatternScan&) = delete;
+  
+  // 收到响应头 - 304重验证或命中HTTP缓存的资源在此直接取得结果
+  void OnResponse(std::string_view etag, std::string_view last_modified);
+  
+  // 正文数据块
+  void Feed(base::span<const uint8_t> data);
+  
+  // 已解码的正文（内存缓存中已加载的资源）- 按UTF-8扫描，与流式扫描原始
+  // 字节结果一致；Latin-1只对非ASCII字符转码，UTF-16按小块转码，都不复制整段正文
+  void FeedLatin1(base::span<const uint8_t> text);
+  void FeedUTF16(base::span<const char16_t> text);
+  
+  // 正文接收完毕，记录结果并返回是否应拦截
+  bool Finish();
+  
+  bool matched() const { return matched_pattern_ >= 0; }
+  
+  // 所用匹配器的特征列表指纹，结果按它区分不同配置
+  uint64_t matcher_fingerprint() const { return matcher_->fingerprint(); }
+  
+  // 是否已无需继续扫描
+  bool decided() const { return decided_; }
+  
+  // 命中的特征，未命中时为空串
+  std::string_view matched_pattern() const;
+  
+  // 统计一次被拦截的脚本
+  static void RecordBlocked(blink::ExecutionContext* context);
+  
+ private:
+  ScriptPatternScan(scoped_refptr<const ScriptPatternMatcher> matcher,
+                    std::string_view url);
+  
+  const scoped_refptr<const ScriptPatternMatcher> matcher_;
+  const std::string url_;
+  std::optional<uint64_t> resource_key_;
+  uint32_t state_ = ScriptPatternMatcher::kInitialState;
+  int matched_pattern_ = -1;
+  bool decided_ = false;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_SCRIPT_PATTERN_MATCHER_H_
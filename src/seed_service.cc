@@ -0,0 +1,156 @@
+#include "novebrowse/seed_service.h"
+
+#include <string.h>
+
+#include <bit>
+#include <string>
+
+#include "novebrowse/blink_fingerprint_manager.h"
+#include "novebrowse/fingerprint_manager.h"
+#include "novebrowse/worker_seed_client.h"
+#include "third_party/blink/renderer/core/execution_context/execution_context.h"
+#include "third_party/blink/renderer/core/frame/local_dom_window.h"
+#include "third_party/blink/renderer/core/frame/local_frame.h"
+#include "third_party/blink/renderer/core/workers/worker_global_scope.h"
+#include "third_party/blink/renderer/platform/wtf/casting.h"
+
+namespace novebrowse {
+
+namespace {
+
+// Key used for origins without a usable security origin, e.g. a detached
+// window. Any fixed string works; it only has to differ from real origins.
+constexpr std::string_view kNoOrigin = "novebrowse:no-origin";
+
+// MurmurHash3 fmix64 finalizer.
+uint64_t Mix(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  value ^= value >> 33;
+  return value;
+}
+
+uint64_t SurfaceSeed(uint64_t origin_key, SeedSurface surface) {
+  uint64_t tag = static_cast<uint64_t>(surface) + 1;
+  return Mix(origin_key ^ (tag * 0x9e3779b97f4a7c15ULL));
+}
+
+std::string OriginString(const blink::SecurityOrigin* origin) {
+  return origin ? origin->ToString().Utf8() : std::string(kNoOrigin);
+}
+
+}  // namespace
+
+SeedService::SeedService() = default;
+
+SeedService::~SeedService() = default;
+
+// static
+uint64_t SeedService::ProfileSeed(const FingerprintConfig& config) {
+  // noise_seed distinguishes installs, profile_name the profiles of one
+  // install, so pooled profiles built from one base config still differ.
+  return KeyedHash(config.noise_seed, config.profile_name);
+}
+
+// static
+uint64_t SeedService::KeyedHash(uint64_t key, std::string_view data) {
+  // SipHash-1-3 with (key, ~key) as the 128-bit key.
+  uint64_t v0 = key ^ 0x736f6d6570736575ULL;
+  uint64_t v1 = ~key ^ 0x646f72616e646f6dULL;
+  uint64_t v2 = key ^ 0x6c7967656e657261ULL;
+  uint64_t v3 = ~key ^ 0x7465646279746573ULL;
+  
+  auto round = [&] {
+    v0 += v1;
+    v1 = std::rotl(v1, 13) ^ v0;
+    v0 = std::rotl(v0, 32);
+    v2 += v3;
+    v3 = std::rotl(v3, 16) ^ v2;
+    v0 += v3;
+    v3 = std::rotl(v3, 21) ^ v0;
+    v2 += v1;
+    v1 = std::rotl(v1, 17) ^ v2;
+    v2 = std::rotl(v2, 32);
+  };
+  
+  size_t offset = 0;
+  for (; offset + sizeof(uint64_t) <= data.size(); offset += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data.data() + offset, sizeof(word));
+    v3 ^= word;
+    round();
+    v0 ^= word;
+  }
+  
+  uint64_t last = static_cast<uint64_t>(data.size()) << 56;
+  for (size_t i = 0; offset + i < data.size(); ++i) {
+    last |= static_cast<uint64_t>(static_cast<uint8_t>(data[offset + i])) << (8 * i);
+  }
+  v3 ^= last;
+  round();
+  v0 ^= last;
+  
+  v2 ^= 0xff;
+  round();
+  round();
+  round();
+  return v0 ^ v1 ^ v2 ^ v3;
+}
+
+// static
+uint64_t SeedService::DeriveSeed(uint64_t profile_seed,
+                                 std::string_view origin,
+                                 SeedSurface surface) {
+  return SurfaceSeed(KeyedHash(profile_seed, origin), surface);
+}
+
+// static
+uint64_t SeedService::ForExecutionContext(blink::ExecutionContext* context,
+                                          SeedSurface surface) {
+  if (auto* window = blink::DynamicTo<blink::LocalDOMWindow>(context)) {
+    if (blink::LocalFrame* frame = window->GetFrame()) {
+      return BlinkFingerprintManager::FromFrame(frame)->GetSeed(surface);
+    }
+  }
+  
+  // Workers have no frame supplement to cache on; deriving costs one short
+  // keyed hash, which is still far below the noise pass it seeds. The seed
+  // is the one the starting document handed over, so a page and its
+  // workers noise alike.
+  uint64_t profile_seed = 0;
+  auto* scope = blink::DynamicTo<blink::WorkerGlobalScope>(context);
+  if (WorkerSeedClient* client =
+          scope ? WorkerSeedClient::From(scope->Clients()) : nullptr) {
+    profile_seed = client->profile_seed();
+  } else {
+    profile_seed = ProfileSeed(*FINGERPRINT_MANAGER()->GetDefaultConfig());
+  }
+  const blink::SecurityOrigin* origin =
+      context ? context->GetSecurityOrigin() : nullptr;
+  return DeriveSeed(profile_seed, OriginString(origin), surface);
+}
+
+uint64_t SeedService::GetSeed(uint64_t profile_seed,
+                              const blink::SecurityOrigin* origin,
+                              SeedSurface surface) {
+  if (!derived_ || profile_seed != profile_seed_ || origin != origin_.get()) {
+    Derive(profile_seed, origin);
+  }
+  return seeds_[static_cast<size_t>(surface)];
+}
+
+void SeedService::Derive(uint64_t profile_seed,
+                         const blink::SecurityOrigin* origin) {
+  uint64_t origin_key = KeyedHash(profile_seed, OriginString(origin));
+  for (size_t i = 0; i < kSeedSurfaceCount; ++i) {
+    seeds_[i] = SurfaceSeed(origin_key, static_cast<SeedSurface>(i));
+  }
+  
+  derived_ = true;
+  profile_seed_ = profile_seed;
+  origin_ = origin;
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,85 @@
+#ifndef NOVEBROWSE_SEED_SERVICE_H_
+#define NOVEBROWSE_SEED_SERVICE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <string_view>
+
+#include "base/memory/scoped_refptr.h"
+#include "novebrowse/fingerprint_config.h"
+#include "third_party/blink/renderer/platform/weborigin/security_origin.h"
+
+namespace blink {
+class ExecutionContext;
+}
+
+namespace novebrowse {
+
+// 需要噪声种子的表面，同一源下各表面的种子互不相关
+enum class SeedSurface : uint8_t {
+  kCanvas,
+  kWebGL,
+  kWebGLBuffer,
+  kAudio,
+  kFrame,
+  kWebGLTexture,
+};
+
+inline constexpr size_t kSeedSurfaceCount =
+    static_cast<size_t>(SeedSurface::kWebGLTexture) + 1;
+
+// 种子派生服务 - 由(配置种子, 源, 表面)派生稳定的64位噪声种子
+//
+// 每个源只做一次带密钥哈希，之后按表面取种子不再分配或哈希。配置种子由
+// noise_seed和profile_name得到，noise_seed为0时取持久化的安装密钥，因此同一
+// 安装、同一配置和源在任意进程、任意次运行中得到相同的种子。
+// 实例由BlinkFingerprintManager按Frame持有，只在渲染器主线程上使用。
+class SeedService {
+ public:
+  SeedService();
+  ~SeedService();
+  
+  SeedService(const SeedService&) = delete;
+  SeedService& operator=(const SeedService&) = delete;
+  
+  // 配置种子 - 以noise_seed为密钥对profile_name做带密钥哈希
+  static uint64_t ProfileSeed(const FingerprintConfig& config);
+  
+  // 带密钥的64位哈希（SipHash-1-3）
+  static uint64_t KeyedHash(uint64_t key, std::string_view data);
+  
+  // 单次派生，不缓存
+  static uint64_t DeriveSeed(uint64_t profile_seed,
+                             std::string_view origin,
+                             SeedSurface surface);
+  
+  // 折叠为32位，供仍使用32位种子的噪声内核
+  static uint32_t Fold32(uint64_t seed) {
+    return static_cast<uint32_t>(seed ^ (seed >> 32));
+  }
+  
+  // 执行上下文对应的种子：文档取自所在Frame的缓存；Worker按创建它的文档的
+  // 配置种子现算，没有时（共享Worker、Service Worker）用默认配置
+  static uint64_t ForExecutionContext(blink::ExecutionContext* context,
+                                      SeedSurface surface);
+  
+  // 获取种子，配置种子或源变化时重新派生
+  uint64_t GetSeed(uint64_t profile_seed,
+                   const blink::SecurityOrigin* origin,
+                   SeedSurface surface);
+  
+ private:
+  void Derive(uint64_t profile_seed, const blink::SecurityOrigin* origin);
+  
+  bool derived_ = false;
+  uint64_t profile_seed_ = 0;
+  // 持有引用，避免以已释放对象的地址误判为同一源
+  scoped_refptr<const blink::SecurityOrigin> origin_;
+  std::array<uint64_t, kSeedSurfaceCount> seeds_ = {};
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_SEED_SERVICE_H_
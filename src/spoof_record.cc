@@ -0,0 +1,240 @@
+#include "novebrowse/spoof_record.h"
+
+#include "base/check.h"
+#include "base/containers/lru_cache.h"
+#include "base/no_destructor.h"
+#include "novebrowse/fingerprint_manager.h"
+#include "novebrowse/profile_pool.h"
+#include "novebrowse/seed_service.h"
+#include "third_party/blink/renderer/platform/wtf/wtf.h"
+
+namespace novebrowse {
+
+namespace {
+
+// Records no frame references any more are kept until the cache holds
+// this many, so the browser can send only the hash when a config comes
+// back; see RendererConfigTracker. It covers a fully primed profile pool
+// plus the frames' own configs.
+constexpr size_t kMaxCachedRecords = ProfilePool::kRendererCachedConfigs;
+
+// Evicted by hand so records frames still hold are skipped.
+using SpoofRecordCache =
+    base::LRUCache<uint64_t, scoped_refptr<const SpoofRecord>>;
+
+SpoofRecordCache& GetRecordCache() {
+  DCHECK(WTF::IsMainThread());
+  static base::NoDestructor<SpoofRecordCache> records(
+      SpoofRecordCache::NO_AUTO_EVICT);
+  return *records;
+}
+
+// Drops the least recently used record no frame holds. When every record
+// is in use the cache grows past its limit until frames let go.
+void EvictOneRecord(SpoofRecordCache& records) {
+  for (auto it = records.rbegin(); it != records.rend(); ++it) {
+    if (it->second->HasOneRef()) {
+      records.Erase(it);
+      return;
+    }
+  }
+}
+
+WTF::Vector<WTF::String> ToStringVector(const std::vector<std::string>& values) {
+  WTF::Vector<WTF::String> result;
+  result.reserve(static_cast<wtf_size_t>(values.size()));
+  for (const auto& value : values) {
+    result.push_back(WTF::String::FromUTF8(value.c_str()));
+  }
+  return result;
+}
+
+// The allowlist is a const member compiled in the initializer list, so a
+// disabled config or font section compiles an empty one instead.
+const FontConfig& FontConfigIfEnabled(const FingerprintConfig& config) {
+  static const base::NoDestructor<FontConfig> kDisabled;
+  return config.enabled && config.font.enabled ? config.font : *kDisabled;
+}
+
+FingerprintConfig BuildDefaultConfig() {
+  FingerprintConfig config;
+  config.enabled = true;
+  config.profile_name = "default";
+  config.device_profile = "windows_desktop";
+  config.behavior_pattern = "normal_user";
+  // Same key as the process's default config, so a frame without a record
+  // still seeds per install rather than from 0.
+  config.noise_seed = FINGERPRINT_MANAGER()->install_noise_key();
+  
+  // Basic navigator config
+  config.navigator.enabled = true;
+  config.navigator.user_agent = "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36";
+  config.navigator.platform = "Win32";
+  config.navigator.languages = {"en-US", "en"};
+  config.navigator.hardware_concurrency = 8;
+  config.navigator.device_memory = 8;
+  config.navigator.hide_webdriver = true;
+  
+  // Basic canvas config
+  config.canvas.enabled = true;
+  config.canvas.add_noise = true;
+  config.canvas.noise_level = 0.1;
+  config.canvas.spoof_text_metrics = true;
+  
+  // Basic WebGL config
+  config.webgl.enabled = true;
+  config.webgl.vendor = "Google Inc. (Intel)";
+  config.webgl.renderer = "ANGLE (Intel, Intel(R) UHD Graphics 620 Direct3D11 vs_5_0 ps_5_0, D3D11)";
+  config.webgl.version = "OpenGL ES 2.0 (ANGLE 2.1.0.0)";
+  
+  // Basic screen config
+  config.screen.enabled = true;
+  config.screen.width = 1920;
+  config.screen.height = 1080;
+  config.screen.color_depth = 24;
+  config.screen.pixel_depth = 24;
+  config.screen.device_pixel_ratio = 1.0;
+  
+  // Basic anti-detection config
+  config.anti_detection.enabled = true;
+  config.anti_detection.webdriver.hide_webdriver_property = true;
+  config.anti_detection.webdriver.hide_automation_flags = true;
+  config.anti_detection.automation.hide_headless_flags = true;
+  
+  return config;
+}
+
+}  // namespace
+
+// static
+scoped_refptr<const SpoofRecord> SpoofRecord::GetOrCreate(
+    const FingerprintConfig& config) {
+  return GetOrCreate(config, config.GetStructuralHash());
+}
+
+// static
+scoped_refptr<const SpoofRecord> SpoofRecord::GetOrCreate(
+    const FingerprintConfig& config,
+    uint64_t config_hash) {
+  SpoofRecordCache& records = GetRecordCache();
+  auto it = records.Get(config_hash);
+  if (it != records.end()) {
+    return it->second;
+  }
+  
+  if (records.size() >= kMaxCachedRecords) {
+    EvictOneRecord(records);
+  }
+  
+  auto record = base::MakeRefCounted<SpoofRecord>(config);
+  records.Put(config_hash, record);
+  return record;
+}
+
+// static
+scoped_refptr<const SpoofRecord> SpoofRecord::Find(uint64_t config_hash) {
+  // A hit counts as a use, so a primed record a switch just picked up is
+  // not the next one evicted.
+  SpoofRecordCache& records = GetRecordCache();
+  auto it = records.Get(config_hash);
+  return it != records.end() ? it->second : nullptr;
+}
+
+// static
+scoped_refptr<const SpoofRecord> SpoofRecord::GetDefault() {
+  DCHECK(WTF::IsMainThread());
+  static base::NoDestructor<scoped_refptr<const SpoofRecord>> default_record(
+      base::MakeRefCounted<SpoofRecord>(BuildDefaultConfig()));
+  return *default_record;
+}
+
+SpoofRecord::SpoofRecord(const FingerprintConfig& source)
+    : config(source),
+      profile_seed(SeedService::ProfileSeed(source)),
+      font_allowlist(FontConfigIfEnabled(source)),
+      text_metrics_amplitudes(
+          TextMetricsOffsetCache::AmplitudesFromConfig(FontConfigIfEnabled(source))) {
+  // A disabled profile still gets a record, so switching a frame to it
+  // replaces the previous profile's values with "not spoofed".
+  if (!config.enabled) {
+    return;
+  }
+  
+  if (config.navigator.enabled) {
+    user_agent = WTF::String::FromUTF8(config.navigator.user_agent.c_str());
+    platform = WTF::String::FromUTF8(config.navigator.platform.c_str());
+    languages = ToStringVector(config.navigator.languages);
+    hardware_concurrency = config.navigator.hardware_concurrency;
+    device_memory = config.navigator.device_memory;
+    hide_webdriver = config.navigator.hide_webdriver;
+  }
+  
+  if (config.screen.enabled) {
+    screen_width = config.screen.width;
+    screen_height = config.screen.height;
+    screen_color_depth = config.screen.color_depth;
+    screen_pixel_depth = config.screen.pixel_depth;
+    device_pixel_ratio = config.screen.device_pixel_ratio;
+  }
+  
+  if (config.timezone.enabled) {
+    timezone = WTF::String::FromUTF8(config.timezone.timezone.c_str());
+    timezone_offset = config.timezone.timezone_offset;
+  }
+  
+  if (config.geolocation.enabled && config.geolocation.spoof_location) {
+    spoof_geolocation = true;
+    latitude = config.geolocation.latitude;
+    longitude = config.geolocation.longitude;
+    accuracy = config.geolocation.accuracy;
+  }
+  
+  if (config.canvas.enabled) {
+    protect_canvas = true;
+    canvas_noise_level = config.canvas.noise_level;
+    spoof_text_metrics = config.canvas.spoof_text_metrics;
+  }
+  
+  if (config.webgl.enabled) {
+    protect_webgl = true;
+    webgl_vendor = WTF::String::FromUTF8(config.webgl.vendor.c_str());
+    webgl_renderer = WTF::String::FromUTF8(config.webgl.renderer.c_str());
+    webgl_version = WTF::String::FromUTF8(config.webgl.version.c_str());
+    webgl_extensions = ToStringVector(config.webgl.extensions);
+  }
+  
+  if (config.audio.enabled) {
+    protect_audio = true;
+    audio_noise_level = config.audio.noise_level;
+    protect_analyser_node = config.audio.add_noise && config.audio.protect_analyser_node;
+    protect_offline_audio = config.audio.add_noise && config.audio.protect_offline_context;
+    sample_rate = config.audio.sample_rate;
+  }
+  
+  if (config.font.enabled) {
+    protect_fonts = true;
+    block_unlisted_fonts = config.font.spoof_enumeration && !font_allowlist.empty();
+  }
+  
+  if (config.webrtc.enabled) {
+    protect_webrtc = true;
+    mask_local_ips = config.webrtc.mask_local_ips;
+    fake_public_ip = WTF::String::FromUTF8(config.webrtc.fake_public_ip.c_str());
+  }
+  
+  const AntiDetectionConfig& anti_detection = config.anti_detection;
+  native_spoofing = anti_detection.mode == mojom::SpoofingMode::kNative;
+  if (anti_detection.enabled) {
+    hide_automation_flags = anti_detection.automation.hide_headless_flags;
+    spoof_chrome_runtime = anti_detection.webdriver.spoof_chrome_runtime;
+    block_detection_scripts = anti_detection.js_injection.block_detection_scripts;
+    if (block_detection_scripts) {
+      script_matcher = ScriptPatternMatcher::GetOrCompile(
+          anti_detection.js_injection.blocked_script_patterns);
+    }
+  }
+}
+
+SpoofRecord::~SpoofRecord() = default;
+
+}  // namespace novebrowse
@@ -0,0 +1,114 @@
+#ifndef NOVEBROWSE_SPOOF_RECORD_H_
+#define NOVEBROWSE_SPOOF_RECORD_H_
+
+#include <stdint.h>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_refptr.h"
+#include "novebrowse/fingerprint_config.h"
+#include "novebrowse/font_allowlist.h"
+#include "novebrowse/script_pattern_matcher.h"
+#include "novebrowse/text_metrics_offsets.h"
+#include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
+#include "third_party/blink/renderer/platform/wtf/vector.h"
+
+namespace novebrowse {
+
+// 预计算的伪造值 - 由配置一次性生成，进程内同一配置哈希的Frame共享一份
+//
+// 各字段已按总开关和对应子配置的enabled开关处理：未启用时为空字符串/0/false，
+// 因此getter只需判断一次后直接返回。共享记录只在渲染器主线程上创建和释放；
+// Worker中的画布另建只在本线程使用的记录。
+struct SpoofRecord : public base::RefCounted<SpoofRecord> {
+  // 获取配置对应的共享记录，config_hash为config.GetStructuralHash()
+  static scoped_refptr<const SpoofRecord> GetOrCreate(const FingerprintConfig& config);
+  static scoped_refptr<const SpoofRecord> GetOrCreate(const FingerprintConfig& config,
+                                                      uint64_t config_hash);
+  
+  // 按配置哈希查找已缓存的记录，没有时返回nullptr
+  static scoped_refptr<const SpoofRecord> Find(uint64_t config_hash);
+  
+  // 内置默认配置的记录，首次使用时创建
+  static scoped_refptr<const SpoofRecord> GetDefault();
+  
+  explicit SpoofRecord(const FingerprintConfig& config);
+  
+  SpoofRecord(const SpoofRecord&) = delete;
+  SpoofRecord& operator=(const SpoofRecord&) = delete;
+  
+  const FingerprintConfig config;
+  
+  // SeedService::ProfileSeed(config)
+  const uint64_t profile_seed;
+  
+  // Navigator
+  WTF::String user_agent;
+  WTF::String platform;
+  WTF::Vector<WTF::String> languages;
+  int hardware_concurrency = 0;
+  uint64_t device_memory = 0;
+  bool hide_webdriver = false;
+  
+  // Screen
+  int screen_width = 0;
+  int screen_height = 0;
+  int screen_color_depth = 0;
+  int screen_pixel_depth = 0;
+  double device_pixel_ratio = 0.0;
+  
+  // 时区
+  WTF::String timezone;
+  int timezone_offset = 0;
+  
+  // 地理位置
+  bool spoof_geolocation = false;
+  double latitude = 0.0;
+  double longitude = 0.0;
+  double accuracy = 0.0;
+  
+  // Canvas
+  bool protect_canvas = false;
+  double canvas_noise_level = 0.0;
+  bool spoof_text_metrics = false;
+  
+  // WebGL
+  bool protect_webgl = false;
+  WTF::String webgl_vendor;
+  WTF::String webgl_renderer;
+  WTF::String webgl_version;
+  WTF::Vector<WTF::String> webgl_extensions;
+  
+  // 音频
+  bool protect_audio = false;
+  double audio_noise_level = 0.0;
+  bool protect_analyser_node = false;
+  bool protect_offline_audio = false;
+  int sample_rate = 0;
+  
+  // 字体
+  bool protect_fonts = false;
+  bool block_unlisted_fonts = false;  // 名单外的族名在字体匹配时直接拒绝
+  const FontAllowlist font_allowlist;
+  // measureText各度量项的最大偏移，由font_metrics_offsets编译
+  const TextMetricsOffsetCache::Amplitudes text_metrics_amplitudes;
+  
+  // WebRTC
+  bool protect_webrtc = false;
+  bool mask_local_ips = false;
+  WTF::String fake_public_ip;
+  
+  // 反检测
+  bool hide_automation_flags = false;
+  bool spoof_chrome_runtime = false;
+  bool block_detection_scripts = false;
+  bool native_spoofing = false;
+  scoped_refptr<const ScriptPatternMatcher> script_matcher;  // 未拦截时为nullptr
+  
+ private:
+  friend class base::RefCounted<SpoofRecord>;
+  ~SpoofRecord();
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_SPOOF_RECORD_H_
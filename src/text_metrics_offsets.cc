@@ -0,0 +1,123 @@
+#include "novebrowse/text_metrics_offsets.h"
+
+#include <optional>
+#include <utility>
+
+#include "base/logging.h"
+#include "novebrowse/spoof_record.h"
+
+namespace novebrowse {
+
+namespace {
+
+// splitmix64 finalizer.
+uint64_t Mix64(uint64_t value) {
+  value ^= value >> 30;
+  value *= 0xbf58476d1ce4e5b9ull;
+  value ^= value >> 27;
+  value *= 0x94d049bb133111ebull;
+  value ^= value >> 31;
+  return value;
+}
+
+// Uniform in [-1, 1) from the top 53 bits.
+double SignedUnit(uint64_t bits) {
+  return static_cast<double>(bits >> 11) * 0x1.0p-52 - 1.0;
+}
+
+uint64_t StringKey(const WTF::String& string) {
+  if (string.IsNull()) {
+    return 0;
+  }
+
+  // StringImpl caches its hash, and it is the same for 8-bit and 16-bit
+  // copies of a string, so equal strings always get equal offsets.
+  return (static_cast<uint64_t>(string.Impl()->GetHash()) << 32) | string.length();
+}
+
+}  // namespace
+
+TextMetricsOffsetCache::TextMetricsOffsetCache() : entries_(kMaxEntries) {}
+
+TextMetricsOffsetCache::~TextMetricsOffsetCache() = default;
+
+const TextMetricsOffsets& TextMetricsOffsetCache::Get(
+    scoped_refptr<const SpoofRecord> record,
+    uint32_t seed,
+    const WTF::String& font,
+    const WTF::String& text) {
+  if (record != record_) {
+    record_ = std::move(record);
+    entries_.Clear();
+  }
+
+  uint64_t key = KeyFor(seed, font, text);
+  auto it = entries_.Get(key);
+  if (it == entries_.end()) {
+    it = entries_.Put(key, Compute(key, record_->text_metrics_amplitudes));
+  }
+  return it->second;
+}
+
+// static
+TextMetricsOffsetCache::Amplitudes TextMetricsOffsetCache::AmplitudesFromConfig(
+    const FontConfig& config) {
+  Amplitudes amplitudes;
+  amplitudes[static_cast<size_t>(FontMetric::kWidth)] = kDefaultWidthAmplitude;
+  amplitudes[static_cast<size_t>(FontMetric::kHeight)] = kDefaultVerticalAmplitude;
+  amplitudes[static_cast<size_t>(FontMetric::kAscent)] = kDefaultVerticalAmplitude;
+  amplitudes[static_cast<size_t>(FontMetric::kDescent)] = kDefaultVerticalAmplitude;
+
+  if (!config.enabled || !config.spoof_metrics) {
+    return amplitudes;
+  }
+
+  // A configured zero turns that metric's offset off.
+  for (const auto& [name, offset] : config.font_metrics_offsets) {
+    std::optional<FontMetric> metric = FontAllowlist::MetricFromName(name);
+    if (!metric) {
+      LOG(WARNING) << "Unknown font.font_metrics_offsets key: " << name;
+      continue;
+    }
+    amplitudes[static_cast<size_t>(*metric)] = offset < 0.0 ? -offset : offset;
+  }
+  return amplitudes;
+}
+
+// static
+uint64_t TextMetricsOffsetCache::KeyFor(uint32_t seed,
+                                        const WTF::String& font,
+                                        const WTF::String& text) {
+  uint64_t key = Mix64(seed ^ 0x74657874ull);  // "text"
+  key = Mix64(key ^ StringKey(font));
+  return Mix64(key ^ StringKey(text));
+}
+
+// static
+TextMetricsOffsets TextMetricsOffsetCache::Compute(uint64_t key,
+                                                   const Amplitudes& amplitudes) {
+  double width = amplitudes[static_cast<size_t>(FontMetric::kWidth)];
+  double height = amplitudes[static_cast<size_t>(FontMetric::kHeight)];
+  double ascent = amplitudes[static_cast<size_t>(FontMetric::kAscent)];
+  double descent = amplitudes[static_cast<size_t>(FontMetric::kDescent)];
+
+  // Each offset reads its own word of the splitmix64 sequence.
+  uint64_t state = key;
+  auto next = [&state] {
+    state += 0x9e3779b97f4a7c15ull;
+    return SignedUnit(Mix64(state));
+  };
+
+  TextMetricsOffsets offsets;
+  offsets.width = next() * width;
+  // The box edges move by less than the advance; the height share is split
+  // between ascent and descent so it changes the box's total height.
+  offsets.bounding_box_left = next() * width * 0.5;
+  offsets.bounding_box_right = next() * width * 0.5;
+  double height_offset = next() * height * 0.5;
+  offsets.bounding_box_ascent = next() * ascent + height_offset;
+  offsets.bounding_box_descent = next() * descent + height_offset;
+  return offsets;
+}
+
+}  // namespace novebrowse
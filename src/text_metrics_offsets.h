@@ -0,0 +1,77 @@
+#ifndef NOVEBROWSE_TEXT_METRICS_OFFSETS_H_
+#define NOVEBROWSE_TEXT_METRICS_OFFSETS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+
+#include "base/containers/lru_cache.h"
+#include "base/memory/scoped_refptr.h"
+#include "novebrowse/fingerprint_config.h"
+#include "novebrowse/font_allowlist.h"
+#include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
+
+namespace novebrowse {
+
+struct SpoofRecord;
+
+// measureText结果的偏移（CSS像素）
+struct TextMetricsOffsets {
+  double width = 0.0;
+  double bounding_box_left = 0.0;
+  double bounding_box_right = 0.0;
+  double bounding_box_ascent = 0.0;
+  double bounding_box_descent = 0.0;
+};
+
+// 文本度量偏移缓存 - 每个画布一份，由CanvasHostData持有
+//
+// 偏移只由(种子, 字体, 文本)的哈希决定，同一字符串重复测量得到相同结果，
+// 缓存淘汰后重新计算也不变。各度量项的最大偏移是SpoofRecord中编译好的
+// text_metrics_amplitudes，记录变化时清空缓存。只在画布所属线程上访问，不需要加锁。
+class TextMetricsOffsetCache {
+ public:
+  // 缓存的(字体, 文本)组合数上限
+  static constexpr size_t kMaxEntries = 256;
+
+  // 未配置的度量项使用的最大偏移
+  static constexpr double kDefaultWidthAmplitude = 0.05;
+  static constexpr double kDefaultVerticalAmplitude = 0.025;
+
+  // 各FontMetric的最大偏移
+  using Amplitudes = std::array<double, kFontMetricCount>;
+
+  TextMetricsOffsetCache();
+  ~TextMetricsOffsetCache();
+
+  TextMetricsOffsetCache(const TextMetricsOffsetCache&) = delete;
+  TextMetricsOffsetCache& operator=(const TextMetricsOffsetCache&) = delete;
+
+  // 返回text在font下的偏移，未命中时计算并缓存
+  const TextMetricsOffsets& Get(scoped_refptr<const SpoofRecord> record,
+                                uint32_t seed,
+                                const WTF::String& font,
+                                const WTF::String& text);
+
+  size_t size() const { return entries_.size(); }
+
+  // 由font_metrics_offsets编译各度量项的最大偏移，SpoofRecord创建时调用一次。
+  // 未配置的项取默认值，配置为0的项不偏移；字体保护或spoof_metrics关闭时全部取默认值
+  static Amplitudes AmplitudesFromConfig(const FontConfig& config);
+
+  // 偏移的缓存键，与字符串的8位/16位存储方式无关
+  static uint64_t KeyFor(uint32_t seed, const WTF::String& font, const WTF::String& text);
+
+  // 由缓存键计算偏移
+  static TextMetricsOffsets Compute(uint64_t key, const Amplitudes& amplitudes);
+
+ private:
+  base::LRUCache<uint64_t, TextMetricsOffsets> entries_;
+  // 缓存项所用的记录，持有引用使其在比较期间不会被替换为同地址的新记录
+  scoped_refptr<const SpoofRecord> record_;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_TEXT_METRICS_OFFSETS_H_
@@ -0,0 +1,44 @@
+#ifndef NOVEBROWSE_WEBGL_CONTEXT_DATA_H_
+#define NOVEBROWSE_WEBGL_CONTEXT_DATA_H_
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "novebrowse/webgl_spoof_table.h"
+#include "novebrowse/webgl_usage_stats.h"
+
+namespace novebrowse {
+
+// 每个WebGLRenderingContextBase持有的指纹保护状态
+//
+// 由补丁嵌入blink::WebGLRenderingContextBase，随上下文一起销毁，
+// 上下文丢失时调用DidLoseContext清空。
+struct WebGLContextData {
+  WebGLContextData() = default;
+  WebGLContextData(const WebGLContextData&) = delete;
+  WebGLContextData& operator=(const WebGLContextData&) = delete;
+  
+  // 上下文丢失时由上下文调用
+  void DidLoseContext() { usage_stats.Reset(); }
+  
+  // 指纹检测用的使用统计
+  WebGLUsageStats usage_stats;
+  
+  // getParameter伪造表，配置代数变化时整体替换
+  std::unique_ptr<const WebGLSpoofTable> spoof_table;
+  
+  // 读回噪声参数，按配置代数解析一次；从不读回的上下文不会解析
+  struct NoiseFlags {
+    bool resolved = false;
+    uint64_t generation = 0;
+    bool on_readback = false;   // 当前配置为读回模式且启用了噪声
+    double noise_level = 0.0;   // 非RGBA8读回使用的buffer_noise_level
+    int rgba8_amplitude = 0;    // RGBA8读回使用的Canvas噪声幅度
+  };
+  NoiseFlags noise_flags;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_WEBGL_CONTEXT_DATA_H_
@@ -1,17 +1,197 @@
 #include "novebrowse/webgl_fingerprint_protection.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <optional>
 #include <random>
 
+#include "base/functional/bind.h"
 #include "base/logging.h"
-#include "base/strings/stringprintf.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task/post_job.h"
+#include "base/task/task_traits.h"
+#include "base/time/time.h"
+#include "novebrowse/canvas_noise_kernel.h"
 #include "novebrowse/fingerprint_manager.h"
+#include "novebrowse/fingerprint_telemetry_reporter.h"
+#include "novebrowse/fingerprint_trace.h"
+#include "novebrowse/seed_service.h"
+#include "novebrowse/webgl_context_data.h"
+#include "novebrowse/webgl_spoof_table.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_binding_for_core.h"
 #include "v8/include/v8.h"
 
 namespace novebrowse {
 
+namespace {
+
+// Counts a spoofed query locally and queues it, tagged with the queried
+// pname, for the browser's per-site telemetry.
+void RecordSpoofedParameter(blink::WebGLRenderingContextBase* context,
+                            GLenum pname) {
+  INCREMENT_FINGERPRINT_STAT(kWebGLParametersSpoofed);
+  FingerprintTelemetryReporter::Record(context->Host()->GetTopExecutionContext(),
+                                       FingerprintStat::kWebGLParametersSpoofed,
+                                       static_cast<uint16_t>(pname));
+}
+
+// Chunk sizes are kept to a multiple of this many elements so a chunk never
+// starts inside a u8 hash word and the vector kernels stay on their fast path.
+constexpr size_t kChunkElementAlignment = 16;
+
+// Components per pixel of an unpacked format, or 0 if unsupported.
+size_t ComponentsForFormat(GLenum format) {
+  switch (format) {
+    case GL_RGB:
+      return 3;
+    case GL_RGBA:
+      return 4;
+    case GL_LUMINANCE:
+    case GL_ALPHA:
+      return 1;
+    case GL_LUMINANCE_ALPHA:
+      return 2;
+    default:
+      return 0;
+  }
+}
+
+// Packed types (5_6_5, 4_4_4_4, ...) have no per-component element to
+// perturb and are left alone.
+std::optional<WebGLElementType> ElementTypeForType(GLenum type) {
+  switch (type) {
+    case GL_UNSIGNED_BYTE:
+      return WebGLElementType::kUint8;
+    case GL_UNSIGNED_SHORT:
+      return WebGLElementType::kUint16;
+    case GL_HALF_FLOAT_OES:
+      return WebGLElementType::kFloat16;
+    case GL_FLOAT:
+      return WebGLElementType::kFloat32;
+    default:
+      return std::nullopt;
+  }
+}
+
+// Element type of a typed array passed to bufferData; arrays of other
+// element types are uploaded as is.
+std::optional<WebGLElementType> ElementTypeForArrayType(
+    blink::DOMArrayBufferView::ViewType type) {
+  switch (type) {
+    case blink::DOMArrayBufferView::kTypeUint8:
+    case blink::DOMArrayBufferView::kTypeUint8Clamped:
+      return WebGLElementType::kUint8;
+    case blink::DOMArrayBufferView::kTypeUint16:
+      return WebGLElementType::kUint16;
+    case blink::DOMArrayBufferView::kTypeFloat32:
+      return WebGLElementType::kFloat32;
+    default:
+      return std::nullopt;
+  }
+}
+
+// Where GL finds the rows of a client-side image, following the pixel store
+// parameters: each row is ROW_LENGTH pixels (the image width when 0) padded
+// to ALIGNMENT, and the first pixel sits SKIP_ROWS rows and SKIP_PIXELS
+// pixels in. WebGL 1 contexts report 0 for all but the alignment.
+struct PixelRowLayout {
+  size_t first_row_offset = 0;
+  size_t row_stride = 0;
+  size_t row_elements = 0;
+  size_t row_bytes = 0;
+};
+
+// Returns nullopt if the rows do not fit in buffer_size bytes.
+std::optional<PixelRowLayout> ComputePixelRowLayout(
+    GLsizei width,
+    GLsizei height,
+    size_t components_per_pixel,
+    WebGLElementType element_type,
+    const blink::WebGLImageConversion::PixelStoreParams& params,
+    size_t buffer_size) {
+  size_t pixel_bytes = components_per_pixel * WebGLNoiseKernel::ElementSize(element_type);
+  size_t row_length = params.row_length > 0 ? static_cast<size_t>(params.row_length)
+                                            : static_cast<size_t>(width);
+  size_t skip_pixels = static_cast<size_t>(std::max(params.skip_pixels, 0));
+  size_t skip_rows = static_cast<size_t>(std::max(params.skip_rows, 0));
+  size_t alignment = params.alignment > 0 ? static_cast<size_t>(params.alignment) : 1;
+  
+  PixelRowLayout layout;
+  layout.row_elements = static_cast<size_t>(width) * components_per_pixel;
+  layout.row_bytes = static_cast<size_t>(width) * pixel_bytes;
+  layout.row_stride = (row_length * pixel_bytes + alignment - 1) / alignment * alignment;
+  layout.first_row_offset = skip_rows * layout.row_stride + skip_pixels * pixel_bytes;
+  if (skip_pixels + static_cast<size_t>(width) > row_length ||
+      layout.first_row_offset +
+              (static_cast<size_t>(height) - 1) * layout.row_stride +
+              layout.row_bytes >
+          buffer_size) {
+    return std::nullopt;
+  }
+  return layout;
+}
+
+// Hands out fixed-size chunks of elements to thread pool workers. The job is
+// joined before ApplyBufferNoise returns, so it may point at the caller's data.
+class ChunkedBufferNoiseJob {
+ public:
+  ChunkedBufferNoiseJob(uint8_t* data,
+                        size_t element_count,
+                        WebGLElementType element_type,
+                        uint32_t seed,
+                        int amplitude,
+                        size_t chunk_elements,
+                        int max_threads)
+      : data_(data),
+        element_count_(element_count),
+        element_size_(WebGLNoiseKernel::ElementSize(element_type)),
+        element_type_(element_type),
+        seed_(seed),
+        amplitude_(amplitude),
+        chunk_elements_(chunk_elements),
+        chunk_count_((element_count + chunk_elements - 1) / chunk_elements),
+        max_threads_(static_cast<size_t>(max_threads)) {}
+  
+  ChunkedBufferNoiseJob(const ChunkedBufferNoiseJob&) = delete;
+  ChunkedBufferNoiseJob& operator=(const ChunkedBufferNoiseJob&) = delete;
+  
+  void Run(base::JobDelegate* delegate) {
+    while (!delegate->ShouldYield()) {
+      size_t chunk = next_chunk_.fetch_add(1, std::memory_order_relaxed);
+      if (chunk >= chunk_count_) {
+        return;
+      }
+      
+      size_t first = chunk * chunk_elements_;
+      size_t count = std::min(chunk_elements_, element_count_ - first);
+      WebGLNoiseKernel::Apply(data_ + first * element_size_, count, first,
+                              element_type_, seed_, amplitude_);
+    }
+  }
+  
+  size_t GetMaxConcurrency(size_t worker_count) const {
+    size_t claimed =
+        std::min(next_chunk_.load(std::memory_order_relaxed), chunk_count_);
+    return std::min(chunk_count_ - claimed, max_threads_);
+  }
+  
+ private:
+  uint8_t* const data_;
+  const size_t element_count_;
+  const size_t element_size_;
+  const WebGLElementType element_type_;
+  const uint32_t seed_;
+  const int amplitude_;
+  const size_t chunk_elements_;
+  const size_t chunk_count_;
+  const size_t max_threads_;
+  std::atomic<size_t> next_chunk_{0};
+};
+
+}  // namespace
+
 // Static member definitions
 const std::unordered_map<GLenum, std::string> WebGLFingerprintProtection::kParameterNames = {
   {GL_VENDOR, "VENDOR"},
@@ -46,10 +226,6 @@ const std::unordered_map<GLenum, std::vector<GLfloat>> WebGLFingerprintProtectio
   {GL_COLOR_CLEAR_VALUE, {0.0f, 0.0f, 0.0f, 0.0f}}
 };
 
-std::unordered_map<std::string, WebGLFingerprintDetector::WebGLUsageStats> 
-    WebGLFingerprintDetector::webgl_stats_;
-base::Lock WebGLFingerprintDetector::stats_lock_;
-
 // static
 bool WebGLFingerprintProtection::IsEnabled() {
   return FingerprintManager::IsEnabled();
@@ -63,55 +239,28 @@ std::optional<v8::Local<v8::Value>> WebGLFingerprintProtection::GetSpoofedParame
     return std::nullopt;
   }
   
-  WebGLConfig config = GetConfigForContext(context);
-  if (!config.enabled) {
+  TRACE_EVENT(NOVEBROWSE_TRACE_CATEGORY, "WebGLFingerprintProtection::GetSpoofedParameter",
+              "pname", pname);
+  ScopedProtectionTimer timer(ProtectionSurface::kWebGLParameter,
+                              context->Host()->GetTopExecutionContext());
+  
+  const WebGLSpoofTable& table = GetSpoofTable(context);
+  if (!table.enabled()) {
     return std::nullopt;
   }
   
   // Record parameter query for detection
-  WebGLFingerprintDetector::RecordWebGLOperation(context, "getParameter", 
-                                                 base::StringPrintf("0x%x", pname));
-  
-  v8::Isolate* isolate = context->GetScriptState()->GetIsolate();
+  WebGLFingerprintDetector::RecordWebGLOperation(
+      context, WebGLOperation::kGetParameter, pname);
   
-  switch (pname) {
-    case GL_VENDOR:
-      INCREMENT_FINGERPRINT_STAT("webgl_parameters_spoofed");
-      return CreateSpoofedVendor(isolate, config);
-      
-    case GL_RENDERER:
-      INCREMENT_FINGERPRINT_STAT("webgl_parameters_spoofed");
-      return CreateSpoofedRenderer(isolate, config);
-      
-    case GL_VERSION:
-      INCREMENT_FINGERPRINT_STAT("webgl_parameters_spoofed");
-      return CreateSpoofedVersion(isolate, config);
-      
-    case GL_SHADING_LANGUAGE_VERSION:
-      INCREMENT_FINGERPRINT_STAT("webgl_parameters_spoofed");
-      return CreateSpoofedShadingLanguageVersion(isolate, config);
-      
-    case GL_MAX_TEXTURE_SIZE:
-    case GL_MAX_CUBE_MAP_TEXTURE_SIZE:
-    case GL_MAX_RENDERBUFFER_SIZE:
-    case GL_MAX_VERTEX_ATTRIBS:
-    case GL_MAX_VERTEX_UNIFORM_VECTORS:
-    case GL_MAX_FRAGMENT_UNIFORM_VECTORS:
-    case GL_MAX_VARYING_VECTORS:
-      INCREMENT_FINGERPRINT_STAT("webgl_parameters_spoofed");
-      return CreateSpoofedParameter(isolate, pname, config);
-      
-    case GL_MAX_VIEWPORT_DIMS: {
-      INCREMENT_FINGERPRINT_STAT("webgl_parameters_spoofed");
-      v8::Local<v8::Array> array = v8::Array::New(isolate, 2);
-      array->Set(context->GetScriptState()->GetContext(), 0, v8::Integer::New(isolate, 16384)).Check();
-      array->Set(context->GetScriptState()->GetContext(), 1, v8::Integer::New(isolate, 16384)).Check();
-      return array;
-    }
-      
-    default:
-      return std::nullopt;
+  int slot = WebGLSpoofTable::SlotForParameter(pname);
+  if (slot == WebGLSpoofTable::kNoSlot) {
+    return std::nullopt;
   }
+  
+  RecordSpoofedParameter(context, pname);
+  blink::ScriptState* script_state = context->GetScriptState();
+  return table.ToV8(script_state->GetIsolate(), script_state->GetContext(), slot);
 }
 
 // static
@@ -122,53 +271,59 @@ WTF::String WebGLFingerprintProtection::GetSpoofedStringParameter(
     return WTF::String();
   }
   
-  WebGLConfig config = GetConfigForContext(context);
-  if (!config.enabled) {
+  const WebGLSpoofTable& table = GetSpoofTable(context);
+  if (!table.enabled()) {
     return WTF::String();
   }
   
   // Record parameter query for detection
-  WebGLFingerprintDetector::RecordWebGLOperation(context, "getParameter", 
-                                                 base::StringPrintf("0x%x", pname));
+  WebGLFingerprintDetector::RecordWebGLOperation(
+      context, WebGLOperation::kGetParameter, pname);
   
-  switch (pname) {
-    case GL_VENDOR:
-      INCREMENT_FINGERPRINT_STAT("webgl_parameters_spoofed");
-      return WTF::String::FromUTF8(config.vendor.c_str());
-      
-    case GL_RENDERER:
-      INCREMENT_FINGERPRINT_STAT("webgl_parameters_spoofed");
-      return WTF::String::FromUTF8(config.renderer.c_str());
-      
-    case GL_VERSION:
-      INCREMENT_FINGERPRINT_STAT("webgl_parameters_spoofed");
-      return WTF::String::FromUTF8(config.version.c_str());
-      
-    case GL_SHADING_LANGUAGE_VERSION:
-      INCREMENT_FINGERPRINT_STAT("webgl_parameters_spoofed");
-      return WTF::String::FromUTF8(config.shading_language_version.c_str());
-      
-    default:
-      return WTF::String();
+  const WTF::String& spoofed = table.GetString(WebGLSpoofTable::SlotForParameter(pname));
+  if (!spoofed.IsNull()) {
+    RecordSpoofedParameter(context, pname);
   }
+  return spoofed;
 }
 
 // static
-void WebGLFingerprintProtection::ProcessBufferData(
-    void* buffer_data,
-    size_t data_size,
-    const WebGLConfig& config) {
-  if (!buffer_data || data_size == 0 || !config.add_noise_to_buffers) {
-    return;
+std::vector<uint8_t> WebGLFingerprintProtection::ProcessBufferData(
+    blink::WebGLRenderingContextBase* context,
+    GLenum target,
+    const blink::DOMArrayBufferView& data) {
+  // Indices must stay exact, or draw calls read past the vertex data.
+  if (!IsEnabled() || !context || data.byteLength() == 0 ||
+      target == GL_ELEMENT_ARRAY_BUFFER) {
+    return {};
+  }
+  
+  std::optional<WebGLElementType> element_type = ElementTypeForArrayType(data.GetType());
+  if (!element_type) {
+    return {};
+  }
+  
+  // In readback mode uploads go to the driver untouched and uncopied.
+  scoped_refptr<const FingerprintConfigSnapshot> snapshot =
+      FINGERPRINT_MANAGER()->GetDefaultConfig();
+  const WebGLConfig& config = snapshot->webgl;
+  if (!config.enabled || !config.add_noise_to_buffers ||
+      config.noise_mode != mojom::WebGLNoiseMode::kUpload) {
+    return {};
   }
   
-  // Generate seed from buffer content
-  std::hash<std::string> hasher;
-  std::string data_str(reinterpret_cast<char*>(buffer_data), 
-                       std::min(data_size, size_t(256)));
-  uint32_t seed = static_cast<uint32_t>(hasher(data_str));
+  TRACE_EVENT(NOVEBROWSE_TRACE_CATEGORY, "WebGLFingerprintProtection::ProcessBufferData",
+              "bytes", data.byteLength());
+  ScopedProtectionTimer timer(ProtectionSurface::kWebGLBufferData,
+                              context->Host()->GetTopExecutionContext());
   
-  ApplyBufferNoise(buffer_data, data_size, seed, config.buffer_noise_level);
+  // Script may still hold the view, so the noise goes into a copy.
+  const uint8_t* source = static_cast<const uint8_t*>(data.BaseAddressMaybeShared());
+  std::vector<uint8_t> noised(source, source + data.byteLength());
+  uint32_t seed = SeedService::Fold32(SeedService::ForExecutionContext(
+      context->Host()->GetTopExecutionContext(), SeedSurface::kWebGLBuffer));
+  ApplyBufferNoise(noised.data(), noised.size(), *element_type, seed, config);
+  return noised;
 }
 
 // static
@@ -178,16 +333,17 @@ std::vector<std::string> WebGLFingerprintProtection::GetSpoofedExtensions(
     return {};
   }
   
-  WebGLConfig config = GetConfigForContext(context);
-  if (!config.enabled) {
+  const WebGLSpoofTable& table = GetSpoofTable(context);
+  if (!table.enabled()) {
     return {};
   }
   
   // Record extension query for detection
-  WebGLFingerprintDetector::RecordWebGLOperation(context, "getSupportedExtensions", "");
+  WebGLFingerprintDetector::RecordWebGLOperation(
+      context, WebGLOperation::kGetSupportedExtensions);
   
-  INCREMENT_FINGERPRINT_STAT("webgl_parameters_spoofed");
-  return config.extensions;
+  RecordSpoofedParameter(context, GL_EXTENSIONS);
+  return table.extensions();
 }
 
 // static
@@ -239,48 +395,148 @@ void WebGLFingerprintProtection::GetSpoofedShaderPrecisionFormat(
       break;
   }
   
-  INCREMENT_FINGERPRINT_STAT("webgl_parameters_spoofed");
+  INCREMENT_FINGERPRINT_STAT(kWebGLParametersSpoofed);
 }
 
 // static
-void WebGLFingerprintProtection::ProcessTextureData(
+std::vector<uint8_t> WebGLFingerprintProtection::ProcessTextureData(
+    blink::WebGLRenderingContextBase* context,
     const void* pixels,
+    size_t buffer_size,
     GLenum format,
     GLenum type,
     GLsizei width,
     GLsizei height,
-    const WebGLConfig& config) {
-  if (!pixels || !config.add_noise_to_buffers) {
+    const blink::WebGLImageConversion::PixelStoreParams& unpack_params) {
+  if (!IsEnabled() || !context || !pixels || width <= 0 || height <= 0) {
+    return {};
+  }
+  
+  // In readback mode uploads go to the driver untouched and uncopied.
+  scoped_refptr<const FingerprintConfigSnapshot> snapshot =
+      FINGERPRINT_MANAGER()->GetDefaultConfig();
+  const WebGLConfig& config = snapshot->webgl;
+  if (!config.enabled || !config.add_noise_to_buffers ||
+      config.noise_mode != mojom::WebGLNoiseMode::kUpload) {
+    return {};
+  }
+  
+  size_t components_per_pixel = ComponentsForFormat(format);
+  std::optional<WebGLElementType> element_type = ElementTypeForType(type);
+  if (components_per_pixel == 0 || !element_type) {
+    return {};
+  }
+  
+  int amplitude =
+      WebGLNoiseKernel::AmplitudeForNoiseLevel(*element_type, config.buffer_noise_level);
+  std::optional<PixelRowLayout> layout =
+      ComputePixelRowLayout(width, height, components_per_pixel, *element_type,
+                            unpack_params, buffer_size);
+  if (amplitude == 0 || !layout) {
+    return {};
+  }
+  
+  TRACE_EVENT(NOVEBROWSE_TRACE_CATEGORY, "WebGLFingerprintProtection::ProcessTextureData",
+              "width", width, "height", height);
+  
+  // The caller's pixels are const and may be shared with script, so the
+  // noise goes into a copy that is uploaded in their place with the same
+  // unpack parameters. Row padding and skipped pixels are copied as is.
+  const uint8_t* source = static_cast<const uint8_t*>(pixels);
+  size_t copy_size = layout->first_row_offset +
+                     (static_cast<size_t>(height) - 1) * layout->row_stride +
+                     layout->row_bytes;
+  std::vector<uint8_t> noised(source, source + copy_size);
+  
+  uint32_t seed = SeedService::Fold32(SeedService::ForExecutionContext(
+      context->Host()->GetTopExecutionContext(), SeedSurface::kWebGLTexture));
+  uint8_t* rows = noised.data() + layout->first_row_offset;
+  for (GLsizei row = 0; row < height; ++row) {
+    WebGLNoiseKernel::Apply(rows + row * layout->row_stride, layout->row_elements, 0,
+                            *element_type,
+                            WebGLNoiseKernel::HashCounter(seed, static_cast<uint32_t>(row)),
+                            amplitude);
+  }
+  return noised;
+}
+
+// static
+void WebGLFingerprintProtection::ProcessReadPixels(
+    blink::WebGLRenderingContextBase* context,
+    void* pixels,
+    size_t buffer_size,
+    GLint x,
+    GLint y,
+    GLsizei width,
+    GLsizei height,
+    GLenum format,
+    GLenum type,
+    const blink::WebGLImageConversion::PixelStoreParams& pack_params) {
+  if (!IsEnabled() || !context || !pixels || width <= 0 || height <= 0) {
     return;
   }
   
-  // Calculate data size based on format and type
-  size_t bytes_per_pixel = 0;
-  switch (format) {
-    case GL_RGB:
-      bytes_per_pixel = 3;
-      break;
-    case GL_RGBA:
-      bytes_per_pixel = 4;
-      break;
-    case GL_LUMINANCE:
-    case GL_ALPHA:
-      bytes_per_pixel = 1;
-      break;
-    case GL_LUMINANCE_ALPHA:
-      bytes_per_pixel = 2;
-      break;
-    default:
-      return;
+  const WebGLContextData::NoiseFlags& flags = GetNoiseFlags(context);
+  if (!flags.on_readback) {
+    return;
   }
   
-  size_t data_size = width * height * bytes_per_pixel;
+  size_t components_per_pixel = ComponentsForFormat(format);
+  std::optional<WebGLElementType> element_type = ElementTypeForType(type);
+  if (components_per_pixel == 0 || !element_type) {
+    return;
+  }
+  
+  // Lay the rows out the way GL packs them, so only the pixels it wrote
+  // are touched.
+  std::optional<PixelRowLayout> layout =
+      ComputePixelRowLayout(width, height, components_per_pixel, *element_type,
+                            pack_params, buffer_size);
+  if (!layout) {
+    return;
+  }
+  size_t row_stride = layout->row_stride;
+  size_t row_elements = layout->row_elements;
   
-  // Generate seed from texture properties
-  uint32_t seed = (width << 16) | height | (format << 8) | type;
+  uint8_t* rows = static_cast<uint8_t*>(pixels) + layout->first_row_offset;
+  blink::ExecutionContext* execution_context =
+      context->Host()->GetTopExecutionContext();
+  if (format == GL_RGBA && type == GL_UNSIGNED_BYTE) {
+    // Use the 2D canvas kernel, seed and level, so readPixels agrees with
+    // toDataURL on the same drawing buffer. GL rows count from the bottom.
+    if (flags.rgba8_amplitude == 0) {
+      return;
+    }
+    uint32_t seed = SeedService::Fold32(
+        SeedService::ForExecutionContext(execution_context, SeedSurface::kCanvas));
+    int buffer_height = context->drawingBufferHeight();
+    for (GLsizei row = 0; row < height; ++row) {
+      CanvasNoiseKernel::ApplyToRow(rows + row * row_stride, width, x,
+                                    buffer_height - 1 - (y + row), seed,
+                                    flags.rgba8_amplitude);
+    }
+    INCREMENT_FINGERPRINT_STAT(kCanvasOperationsSpoofed);
+    return;
+  }
   
-  // Apply noise to texture data
-  ApplyBufferNoise(const_cast<void*>(pixels), data_size, seed, config.buffer_noise_level);
+  int amplitude =
+      WebGLNoiseKernel::AmplitudeForNoiseLevel(*element_type, flags.noise_level);
+  if (amplitude == 0) {
+    return;
+  }
+  
+  // One counter stream per framebuffer row, indexed from column 0, so a
+  // sub-rectangle read matches the same area of a full read.
+  uint32_t seed = SeedService::Fold32(
+      SeedService::ForExecutionContext(execution_context, SeedSurface::kWebGL));
+  for (GLsizei row = 0; row < height; ++row) {
+    WebGLNoiseKernel::Apply(rows + row * row_stride, row_elements,
+                            static_cast<size_t>(x) * components_per_pixel,
+                            *element_type,
+                            WebGLNoiseKernel::HashCounter(seed, static_cast<uint32_t>(y + row)),
+                            amplitude);
+  }
+  INCREMENT_FINGERPRINT_STAT(kCanvasOperationsSpoofed);
 }
 
 // static
@@ -291,125 +547,165 @@ WebGLConfig WebGLFingerprintProtection::GetConfigForContext(
   }
   
   // Get config from fingerprint manager
-  FingerprintConfig config = FINGERPRINT_MANAGER()->GetDefaultConfig();
-  return config.webgl;
+  return FINGERPRINT_MANAGER()->GetDefaultConfig()->webgl;
 }
 
 // static
-std::string WebGLFingerprintProtection::GetContextId(
+const WebGLSpoofTable& WebGLFingerprintProtection::GetSpoofTable(
     blink::WebGLRenderingContextBase* context) {
-  if (!context) {
-    return "null_context";
+  std::unique_ptr<const WebGLSpoofTable>& table =
+      context->NoveBrowseData().spoof_table;
+  
+  // The table is swapped as a whole, so a reader never sees a half-updated
+  // mix of old and new values.
+  uint64_t generation = FINGERPRINT_MANAGER()->default_config_generation();
+  if (!table || table->generation() != generation) {
+    table = BuildSpoofTable(GetConfigForContext(context), generation);
+  }
+  
+  return *table;
+}
+
+// static
+const WebGLContextData::NoiseFlags& WebGLFingerprintProtection::GetNoiseFlags(
+    blink::WebGLRenderingContextBase* context) {
+  WebGLContextData::NoiseFlags& flags = context->NoveBrowseData().noise_flags;
+  
+  // Resolved once per config generation, so a context pays one comparison
+  // per readback instead of copying WebGLConfig.
+  uint64_t generation = FINGERPRINT_MANAGER()->default_config_generation();
+  if (!flags.resolved || flags.generation != generation) {
+    scoped_refptr<const FingerprintConfigSnapshot> config =
+        FINGERPRINT_MANAGER()->GetDefaultConfig();
+    const WebGLConfig& webgl = config->webgl;
+    flags.on_readback = webgl.enabled && webgl.add_noise_to_buffers &&
+                        webgl.noise_mode == mojom::WebGLNoiseMode::kReadback;
+    flags.noise_level = webgl.buffer_noise_level;
+    flags.rgba8_amplitude =
+        config->canvas.add_noise
+            ? CanvasNoiseKernel::AmplitudeForNoiseLevel(config->canvas.noise_level)
+            : 0;
+    flags.generation = generation;
+    flags.resolved = true;
   }
   
-  return base::StringPrintf("webgl_%p", context);
+  return flags;
 }
 
 // static
 uint32_t WebGLFingerprintProtection::GenerateNoiseSeed(
     blink::WebGLRenderingContextBase* context) {
-  std::string context_id = GetContextId(context);
-  std::hash<std::string> hasher;
-  return static_cast<uint32_t>(hasher(context_id));
+  if (!context) {
+    return 12345;
+  }
+  
+  return SeedService::Fold32(SeedService::ForExecutionContext(
+      context->Host()->GetTopExecutionContext(), SeedSurface::kWebGL));
 }
 
 // static
 void WebGLFingerprintProtection::ApplyBufferNoise(
     void* buffer,
     size_t size,
+    WebGLElementType element_type,
     uint32_t seed,
-    double noise_level) {
-  if (!buffer || size == 0 || noise_level <= 0.0) {
+    const WebGLConfig& config) {
+  int amplitude =
+      WebGLNoiseKernel::AmplitudeForNoiseLevel(element_type, config.buffer_noise_level);
+  if (!buffer || amplitude == 0) {
     return;
   }
   
-  WebGLNoiseGenerator noise_generator(seed);
-  noise_generator.GenerateBufferNoise(buffer, size, noise_level);
-}
-
-// static
-v8::Local<v8::Value> WebGLFingerprintProtection::CreateSpoofedVendor(
-    v8::Isolate* isolate,
-    const WebGLConfig& config) {
-  return v8::String::NewFromUtf8(isolate, config.vendor.c_str()).ToLocalChecked();
-}
-
-// static
-v8::Local<v8::Value> WebGLFingerprintProtection::CreateSpoofedRenderer(
-    v8::Isolate* isolate,
-    const WebGLConfig& config) {
-  return v8::String::NewFromUtf8(isolate, config.renderer.c_str()).ToLocalChecked();
-}
-
-// static
-v8::Local<v8::Value> WebGLFingerprintProtection::CreateSpoofedVersion(
-    v8::Isolate* isolate,
-    const WebGLConfig& config) {
-  return v8::String::NewFromUtf8(isolate, config.version.c_str()).ToLocalChecked();
-}
-
-// static
-v8::Local<v8::Value> WebGLFingerprintProtection::CreateSpoofedShadingLanguageVersion(
-    v8::Isolate* isolate,
-    const WebGLConfig& config) {
-  return v8::String::NewFromUtf8(isolate, config.shading_language_version.c_str()).ToLocalChecked();
-}
-
-// static
-v8::Local<v8::Value> WebGLFingerprintProtection::CreateSpoofedExtensions(
-    v8::Isolate* isolate,
-    const WebGLConfig& config) {
-  v8::Local<v8::Array> extensions_array = v8::Array::New(isolate, config.extensions.size());
+  // A trailing partial element is left as is.
+  size_t element_size = WebGLNoiseKernel::ElementSize(element_type);
+  size_t element_count = size / element_size;
+  if (element_count == 0) {
+    return;
+  }
   
-  for (size_t i = 0; i < config.extensions.size(); ++i) {
-    v8::Local<v8::String> extension = v8::String::NewFromUtf8(
-        isolate, config.extensions[i].c_str()).ToLocalChecked();
-    extensions_array->Set(isolate->GetCurrentContext(), i, extension).Check();
+  // Noise is addressed by element index, so chunks can be processed in any
+  // order on any thread and match a single pass exactly.
+  size_t chunk_elements =
+      static_cast<size_t>(std::max(config.buffer_parallel_chunk_bytes, 0)) / element_size;
+  chunk_elements -= chunk_elements % kChunkElementAlignment;
+  if (config.buffer_parallel_max_threads > 1 && chunk_elements > 0 &&
+      size >= static_cast<size_t>(std::max(config.buffer_parallel_min_bytes, 0)) &&
+      element_count > chunk_elements) {
+    ChunkedBufferNoiseJob job(static_cast<uint8_t*>(buffer), element_count,
+                              element_type, seed, amplitude, chunk_elements,
+                              config.buffer_parallel_max_threads);
+    base::PostJob(FROM_HERE, {base::TaskPriority::USER_BLOCKING},
+                  base::BindRepeating(&ChunkedBufferNoiseJob::Run,
+                                      base::Unretained(&job)),
+                  base::BindRepeating(&ChunkedBufferNoiseJob::GetMaxConcurrency,
+                                      base::Unretained(&job)))
+        .Join();
+    return;
   }
   
-  return extensions_array;
+  WebGLNoiseKernel::Apply(buffer, element_count, 0, element_type, seed, amplitude);
 }
 
 // static
-v8::Local<v8::Value> WebGLFingerprintProtection::CreateSpoofedParameter(
-    v8::Isolate* isolate,
-    GLenum pname,
-    const WebGLConfig& config) {
-  // Check if we have a custom parameter value
-  auto param_name_it = kParameterNames.find(pname);
-  if (param_name_it != kParameterNames.end()) {
+std::unique_ptr<const WebGLSpoofTable> WebGLFingerprintProtection::BuildSpoofTable(
+    const WebGLConfig& config,
+    uint64_t generation) {
+  auto table = std::make_unique<WebGLSpoofTable>(config.enabled, generation);
+  if (!config.enabled) {
+    return table;
+  }
+  
+  table->SetString(WebGLSpoofTable::kVendor,
+                   WTF::String::FromUTF8(config.vendor.c_str()));
+  table->SetString(WebGLSpoofTable::kRenderer,
+                   WTF::String::FromUTF8(config.renderer.c_str()));
+  table->SetString(WebGLSpoofTable::kVersion,
+                   WTF::String::FromUTF8(config.version.c_str()));
+  table->SetString(WebGLSpoofTable::kShadingLanguageVersion,
+                   WTF::String::FromUTF8(config.shading_language_version.c_str()));
+  
+  // Default values for common parameters
+  static constexpr struct {
+    GLenum pname;
+    int value;
+  } kDefaultIntValues[] = {
+    {GL_MAX_TEXTURE_SIZE, 16384},
+    {GL_MAX_CUBE_MAP_TEXTURE_SIZE, 16384},
+    {GL_MAX_RENDERBUFFER_SIZE, 16384},
+    {GL_MAX_VERTEX_ATTRIBS, 16},
+    {GL_MAX_VERTEX_UNIFORM_VECTORS, 1024},
+    {GL_MAX_FRAGMENT_UNIFORM_VECTORS, 1024},
+    {GL_MAX_VARYING_VECTORS, 30},
+  };
+  
+  for (const auto& default_value : kDefaultIntValues) {
+    auto slot = static_cast<WebGLSpoofTable::Slot>(
+        WebGLSpoofTable::SlotForParameter(default_value.pname));
+    table->SetInt(slot, default_value.value);
+    
+    // Check if we have a custom parameter value
+    auto param_name_it = kParameterNames.find(default_value.pname);
+    if (param_name_it == kParameterNames.end()) {
+      continue;
+    }
+    
     auto param_it = config.parameters.find(param_name_it->second);
-    if (param_it != config.parameters.end()) {
-      // Try to parse as integer first
-      int int_value;
-      if (base::StringToInt(param_it->second, &int_value)) {
-        return v8::Integer::New(isolate, int_value);
-      }
-      
-      // Otherwise return as string
-      return v8::String::NewFromUtf8(isolate, param_it->second.c_str()).ToLocalChecked();
+    if (param_it == config.parameters.end()) {
+      continue;
+    }
+    
+    // Try to parse as integer first, otherwise keep it as a string
+    int int_value;
+    if (base::StringToInt(param_it->second, &int_value)) {
+      table->SetInt(slot, int_value);
+    } else {
+      table->SetString(slot, WTF::String::FromUTF8(param_it->second.c_str()));
     }
   }
   
-  // Return default values for common parameters
-  switch (pname) {
-    case GL_MAX_TEXTURE_SIZE:
-      return v8::Integer::New(isolate, 16384);
-    case GL_MAX_CUBE_MAP_TEXTURE_SIZE:
-      return v8::Integer::New(isolate, 16384);
-    case GL_MAX_RENDERBUFFER_SIZE:
-      return v8::Integer::New(isolate, 16384);
-    case GL_MAX_VERTEX_ATTRIBS:
-      return v8::Integer::New(isolate, 16);
-    case GL_MAX_VERTEX_UNIFORM_VECTORS:
-      return v8::Integer::New(isolate, 1024);
-    case GL_MAX_FRAGMENT_UNIFORM_VECTORS:
-      return v8::Integer::New(isolate, 1024);
-    case GL_MAX_VARYING_VECTORS:
-      return v8::Integer::New(isolate, 30);
-    default:
-      return v8::Integer::New(isolate, 0);
-  }
+  table->SetIntPair(WebGLSpoofTable::kMaxViewportDims, 16384, 16384);
+  table->SetExtensions(config.extensions);
+  return table;
 }
 
 // WebGLNoiseGenerator implementation
@@ -420,13 +716,10 @@ void WebGLNoiseGenerator::GenerateBufferNoise(void* buffer, size_t size, double
     return;
   }
   
-  uint8_t* byte_buffer = static_cast<uint8_t*>(buffer);
-  
-  for (size_t i = 0; i < size; ++i) {
-    float noise = GenerateFloatNoise(byte_buffer[i], noise_level);
-    int new_value = static_cast<int>(byte_buffer[i]) + static_cast<int>(noise * 255.0f);
-    byte_buffer[i] = static_cast<uint8_t>(std::max(0, std::min(255, new_value)));
-  }
+  // Raw bytes; callers that know the element type use WebGLNoiseKernel.
+  WebGLNoiseKernel::Apply(
+      buffer, size, 0, WebGLElementType::kUint8, seed_,
+      WebGLNoiseKernel::AmplitudeForNoiseLevel(WebGLElementType::kUint8, noise_level));
 }
 
 float WebGLNoiseGenerator::GenerateFloatNoise(float original_value, double noise_level) {
@@ -481,57 +774,26 @@ double WebGLNoiseGenerator::NextGaussian() {
 // static
 bool WebGLFingerprintDetector::DetectFingerprintingAttempt(
     blink::WebGLRenderingContextBase* context,
-    const std::string& operation) {
+    WebGLOperation operation) {
   if (!context) {
     return false;
   }
   
-  RecordWebGLOperation(context, operation, "");
+  RecordWebGLOperation(context, operation);
   return AnalyzeUsagePattern(context);
 }
 
 // static
 void WebGLFingerprintDetector::RecordWebGLOperation(
     blink::WebGLRenderingContextBase* context,
-    const std::string& operation,
-    const std::string& parameters) {
+    WebGLOperation operation,
+    GLenum pname) {
   if (!context) {
     return;
   }
   
-  base::AutoLock auto_lock(stats_lock_);
-  
-  std::string context_id = base::StringPrintf("webgl_%p", context);
-  WebGLUsageStats& stats = webgl_stats_[context_id];
-  
-  int64_t current_time = base::Time::Now().ToInternalValue();
-  if (stats.first_operation_time == 0) {
-    stats.first_operation_time = current_time;
-  }
-  stats.last_operation_time = current_time;
-  
-  stats.operation_sequence.push_back(operation);
-  
-  // Limit sequence length
-  if (stats.operation_sequence.size() > 100) {
-    stats.operation_sequence.erase(stats.operation_sequence.begin());
-  }
-  
-  // Categorize operations
-  if (operation == "getParameter") {
-    stats.parameter_queries++;
-    stats.queried_parameters.push_back(parameters);
-  } else if (operation == "getSupportedExtensions") {
-    stats.extension_queries++;
-  } else if (operation == "getShaderPrecisionFormat") {
-    stats.shader_queries++;
-  } else if (operation.find("Buffer") != std::string::npos) {
-    stats.buffer_operations++;
-  } else if (operation.find("Texture") != std::string::npos) {
-    stats.texture_operations++;
-  } else if (operation == "drawArrays" || operation == "drawElements") {
-    stats.rendering_operations++;
-  }
+  int64_t now_us = (base::TimeTicks::Now() - base::TimeTicks()).InMicroseconds();
+  context->NoveBrowseData().usage_stats.Record(operation, pname, now_us);
 }
 
 // static
@@ -541,15 +803,11 @@ bool WebGLFingerprintDetector::AnalyzeUsagePattern(
     return false;
   }
   
-  base::AutoLock auto_lock(stats_lock_);
-  
-  std::string context_id = base::StringPrintf("webgl_%p", context);
-  auto it = webgl_stats_.find(context_id);
-  if (it == webgl_stats_.end()) {
+  const WebGLUsageStats& stats = context->NoveBrowseData().usage_stats;
+  if (stats.first_operation_time() == 0) {
     return false;
   }
   
-  const WebGLUsageStats& stats = it->second;
   return IsLikelyFingerprintingPattern(stats);
 }
 
@@ -562,12 +820,14 @@ bool WebGLFingerprintDetector::IsLikelyFingerprintingPattern(
   }
   
   // Check for suspicious parameter queries
-  if (HasSuspiciousParameterQueries(stats.queried_parameters)) {
+  if (HasSuspiciousParameterQueries(stats)) {
     return true;
   }
   
   // Check for fingerprinting operation sequence
-  if (HasFingerprintingSequence(stats.operation_sequence)) {
+  std::array<WebGLOperation, WebGLUsageStats::kSequenceCapacity> sequence;
+  size_t length = stats.CopyRecentOperations(sequence);
+  if (HasFingerprintingSequence(base::span(sequence).first(length))) {
     return true;
   }
   
@@ -576,53 +836,44 @@ bool WebGLFingerprintDetector::IsLikelyFingerprintingPattern(
 
 // static
 bool WebGLFingerprintDetector::HasSuspiciousParameterQueries(
-    const std::vector<std::string>& parameters) {
-  // Common fingerprinting parameters
-  std::vector<std::string> fingerprinting_params = {
-    "0x1F00", // GL_VENDOR
-    "0x1F01", // GL_RENDERER
-    "0x1F02", // GL_VERSION
-    "0x8B8C"  // GL_SHADING_LANGUAGE_VERSION
-  };
-  
-  int fingerprinting_queries = 0;
-  for (const auto& param : parameters) {
-    if (std::find(fingerprinting_params.begin(), fingerprinting_params.end(), param) 
-        != fingerprinting_params.end()) {
-      fingerprinting_queries++;
-    }
-  }
-  
-  return fingerprinting_queries >= 3; // Querying 3+ fingerprinting parameters
+    const WebGLUsageStats& stats) {
+  // Querying 3+ of VENDOR/RENDERER/VERSION/SHADING_LANGUAGE_VERSION.
+  // Maintained incrementally by WebGLUsageStats::Record.
+  return stats.distinct_fingerprinting_queries() >= 3;
 }
 
 // static
 bool WebGLFingerprintDetector::HasHighQueryToRenderRatio(
     const WebGLUsageStats& stats) {
-  if (stats.rendering_operations == 0) {
-    return (stats.parameter_queries + stats.extension_queries) > 5;
+  int parameter_queries = stats.parameter_queries();
+  int extension_queries = stats.extension_queries();
+  int rendering_operations = stats.rendering_operations();
+  if (rendering_operations == 0) {
+    return (parameter_queries + extension_queries) > 5;
   }
   
-  int total_queries = stats.parameter_queries + stats.extension_queries + stats.shader_queries;
-  double ratio = static_cast<double>(total_queries) / stats.rendering_operations;
+  int total_queries = parameter_queries + extension_queries + stats.shader_queries();
+  double ratio = static_cast<double>(total_queries) / rendering_operations;
   
   return ratio > 10.0; // More than 10 queries per render operation
 }
 
 // static
 bool WebGLFingerprintDetector::HasFingerprintingSequence(
-    const std::vector<std::string>& sequence) {
+    base::span<const WebGLOperation> sequence) {
   if (sequence.size() < 5) {
     return false;
   }
   
   // Look for patterns of consecutive parameter queries without rendering
   int consecutive_queries = 0;
-  for (const auto& op : sequence) {
-    if (op == "getParameter" || op == "getSupportedExtensions" || 
-        op == "getShaderPrecisionFormat") {
+  for (WebGLOperation op : sequence) {
+    if (op == WebGLOperation::kGetParameter ||
+        op == WebGLOperation::kGetSupportedExtensions ||
+        op == WebGLOperation::kGetShaderPrecisionFormat) {
       consecutive_queries++;
-    } else if (op == "drawArrays" || op == "drawElements") {
+    } else if (op == WebGLOperation::kDrawArrays ||
+               op == WebGLOperation::kDrawElements) {
       consecutive_queries = 0;
     }
     
@@ -7,12 +7,20 @@
 #include <vector>
 #include <optional>
 
+#include "base/gtest_prod_util.h"
 #include "third_party/blink/renderer/modules/webgl/webgl_rendering_context_base.h"
 #include "third_party/blink/renderer/bindings/core/v8/script_value.h"
+#include "third_party/blink/renderer/core/typed_arrays/dom_array_buffer_view.h"
+#include "third_party/blink/renderer/platform/graphics/gpu/webgl_image_conversion.h"
 #include "novebrowse/fingerprint_config.h"
+#include "novebrowse/webgl_context_data.h"
+#include "novebrowse/webgl_noise_kernel.h"
+#include "novebrowse/webgl_usage_stats.h"
 
 namespace novebrowse {
 
+class WebGLSpoofTable;
+
 // WebGL指纹保护实现类
 class WebGLFingerprintProtection {
  public:
@@ -29,11 +37,13 @@ class WebGLFingerprintProtection {
       GLenum pname,
       blink::WebGLRenderingContextBase* context);
   
-  // 处理WebGL缓冲区数据
-  static void ProcessBufferData(
-      void* buffer_data,
-      size_t data_size,
-      const WebGLConfig& config);
+  // 处理WebGL缓冲区数据 - 仅上传模式，种子按上下文所在源派生，与缓冲区内容无关
+  // 返回加噪后的副本供bufferData/bufferSubData代替原数据上传，返回空表示原样上传；
+  // 元素类型取自ArrayBufferView，索引缓冲区不处理
+  static std::vector<uint8_t> ProcessBufferData(
+      blink::WebGLRenderingContextBase* context,
+      GLenum target,
+      const blink::DOMArrayBufferView& data);
   
   // 获取伪造的扩展列表
   static std::vector<std::string> GetSpoofedExtensions(
@@ -46,20 +56,42 @@ class WebGLFingerprintProtection {
       GLint* range,
       GLint* precision);
   
-  // 处理WebGL纹理数据
-  static void ProcessTextureData(
+  // 处理WebGL纹理数据 - 仅上传模式，返回加噪后的副本供调用方代替原数据上传
+  // 返回空表示原样上传；调用方的像素不会被修改。行距和起始偏移按unpack参数
+  // （ALIGNMENT、ROW_LENGTH、SKIP_ROWS、SKIP_PIXELS）计算，副本按同一参数上传；
+  // 种子按上下文所在源派生。由补丁的texImage2D/texSubImage2D（ArrayBufferView）调用
+  static std::vector<uint8_t> ProcessTextureData(
+      blink::WebGLRenderingContextBase* context,
       const void* pixels,
+      size_t buffer_size,
       GLenum format,
       GLenum type,
       GLsizei width,
       GLsizei height,
-      const WebGLConfig& config);
+      const blink::WebGLImageConversion::PixelStoreParams& unpack_params);
+  
+  // 处理readPixels读回结果 - 仅读回模式，行距和起始偏移按pack参数
+  // （ALIGNMENT、ROW_LENGTH、SKIP_ROWS、SKIP_PIXELS）计算，与GL写入的位置一致
+  // RGBA8与2D Canvas使用同一内核和种子，与toDataURL的结果一致
+  static void ProcessReadPixels(
+      blink::WebGLRenderingContextBase* context,
+      void* pixels,
+      size_t buffer_size,
+      GLint x,
+      GLint y,
+      GLsizei width,
+      GLsizei height,
+      GLenum format,
+      GLenum type,
+      const blink::WebGLImageConversion::PixelStoreParams& pack_params);
   
   // 获取WebGL配置
   static WebGLConfig GetConfigForContext(
       blink::WebGLRenderingContextBase* context);
   
  private:
+  FRIEND_TEST_ALL_PREFIXES(WebGLFingerprintPerfTest, ApplyBufferNoise);
+  
   // WebGL参数映射
   static const std::unordered_map<GLenum, std::string> kParameterNames;
   static const std::unordered_map<GLenum, std::string> kDefaultStringValues;
@@ -67,17 +99,23 @@ class WebGLFingerprintProtection {
   static const std::unordered_map<GLenum, std::vector<GLfloat>> kDefaultFloatArrayValues;
   
   // 内部辅助函数
-  static std::string GetContextId(blink::WebGLRenderingContextBase* context);
   static uint32_t GenerateNoiseSeed(blink::WebGLRenderingContextBase* context);
-  static void ApplyBufferNoise(void* buffer, size_t size, uint32_t seed, double noise_level);
-  
-  // 参数伪造函数
-  static v8::Local<v8::Value> CreateSpoofedVendor(v8::Isolate* isolate, const WebGLConfig& config);
-  static v8::Local<v8::Value> CreateSpoofedRenderer(v8::Isolate* isolate, const WebGLConfig& config);
-  static v8::Local<v8::Value> CreateSpoofedVersion(v8::Isolate* isolate, const WebGLConfig& config);
-  static v8::Local<v8::Value> CreateSpoofedShadingLanguageVersion(v8::Isolate* isolate, const WebGLConfig& config);
-  static v8::Local<v8::Value> CreateSpoofedExtensions(v8::Isolate* isolate, const WebGLConfig& config);
-  static v8::Local<v8::Value> CreateSpoofedParameter(v8::Isolate* isolate, GLenum pname, const WebGLConfig& config);
+  // 按元素类型加噪，超过配置阈值的数据分块并行处理
+  static void ApplyBufferNoise(void* buffer,
+                               size_t size,
+                               WebGLElementType element_type,
+                               uint32_t seed,
+                               const WebGLConfig& config);
+  
+  // 读回噪声参数 - 缓存在上下文的WebGLContextData中，配置变化后重新解析
+  static const WebGLContextData::NoiseFlags& GetNoiseFlags(
+      blink::WebGLRenderingContextBase* context);
+  
+  // 参数伪造表 - 获取上下文当前的伪造表，配置变化后自动重建
+  static const WebGLSpoofTable& GetSpoofTable(blink::WebGLRenderingContextBase* context);
+  static std::unique_ptr<const WebGLSpoofTable> BuildSpoofTable(
+      const WebGLConfig& config,
+      uint64_t generation);
 };
 
 // WebGL噪声生成器
@@ -112,40 +150,25 @@ class WebGLFingerprintDetector {
   // 检测WebGL指纹提取尝试
   static bool DetectFingerprintingAttempt(
       blink::WebGLRenderingContextBase* context,
-      const std::string& operation);
+      WebGLOperation operation);
   
-  // 记录WebGL操作
+  // 记录WebGL操作 - 统计保存在上下文自身的WebGLContextData中
+  // pname仅对getParameter有意义
   static void RecordWebGLOperation(
       blink::WebGLRenderingContextBase* context,
-      const std::string& operation,
-      const std::string& parameters);
+      WebGLOperation operation,
+      GLenum pname = 0);
   
   // 分析WebGL使用模式
   static bool AnalyzeUsagePattern(
       blink::WebGLRenderingContextBase* context);
   
  private:
-  struct WebGLUsageStats {
-    int parameter_queries = 0;
-    int extension_queries = 0;
-    int shader_queries = 0;
-    int buffer_operations = 0;
-    int texture_operations = 0;
-    int rendering_operations = 0;
-    std::vector<std::string> queried_parameters;
-    std::vector<std::string> operation_sequence;
-    int64_t first_operation_time = 0;
-    int64_t last_operation_time = 0;
-  };
-  
-  static std::unordered_map<std::string, WebGLUsageStats> webgl_stats_;
-  static base::Lock stats_lock_;
-  
   // 指纹识别模式检测
   static bool IsLikelyFingerprintingPattern(const WebGLUsageStats& stats);
-  static bool HasSuspiciousParameterQueries(const std::vector<std::string>& parameters);
+  static bool HasSuspiciousParameterQueries(const WebGLUsageStats& stats);
   static bool HasHighQueryToRenderRatio(const WebGLUsageStats& stats);
-  static bool HasFingerprintingSequence(const std::vector<std::string>& sequence);
+  static bool HasFingerprintingSequence(base::span<const WebGLOperation> sequence);
 };
 
 // WebGL扩展管理器
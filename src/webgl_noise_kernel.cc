@@ -0,0 +1,606 @@
+#include "novebrowse/webgl_noise_kernel.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/cpu.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+#elif defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace novebrowse {
+
+namespace {
+
+// Hash constants shared by every kernel. Changing any of them changes the
+// noise pattern for every site, so treat them as part of the output format.
+constexpr uint32_t kCounterMultiplier = 0xC2B2AE3Du;
+constexpr uint32_t kMix1 = 0x7FEB352Du;
+constexpr uint32_t kMix2 = 0x846CA68Bu;
+
+// u8 elements take 8 bits of a hash, so four consecutive bytes share one
+// counter; u16 and f16 elements take 16 bits, two per counter. f32 elements
+// get a counter each and use its low 16 bits.
+constexpr int kUint8Bits = 8;
+constexpr int kHalfWordBits = 16;
+constexpr uint32_t kUint8Mask = (1u << kUint8Bits) - 1;
+constexpr uint32_t kHalfWordMask = (1u << kHalfWordBits) - 1;
+
+constexpr uint32_t kFloat32MagnitudeMask = 0x7FFFFFFFu;
+constexpr int32_t kFloat32MaxFinite = 0x7F7FFFFF;
+constexpr uint16_t kFloat16MagnitudeMask = 0x7FFF;
+constexpr int kFloat16MaxFinite = 0x7BFF;
+
+inline uint32_t MixHash(uint32_t h) {
+  h ^= h >> 16;
+  h *= kMix1;
+  h ^= h >> 15;
+  h *= kMix2;
+  h ^= h >> 16;
+  return h;
+}
+
+inline uint32_t CounterHash(uint32_t seed, uint32_t counter) {
+  return MixHash(seed ^ (counter * kCounterMultiplier));
+}
+
+// Maps a |field_bits| wide slice of a hash onto [-amplitude, amplitude].
+inline int FieldDelta(uint32_t bits, int field_bits, uint32_t span, int amplitude) {
+  return static_cast<int>((static_cast<uint64_t>(bits) * span) >> field_bits) -
+         amplitude;
+}
+
+int MaxAmplitude(WebGLElementType type) {
+  switch (type) {
+    case WebGLElementType::kUint8:
+      return 255;
+    case WebGLElementType::kUint16:
+      return 65535;
+    case WebGLElementType::kFloat16:
+      return WebGLNoiseKernel::kFloat16UlpsPerNoiseLevel;
+    case WebGLElementType::kFloat32:
+      return WebGLNoiseKernel::kFloat32UlpsPerNoiseLevel;
+  }
+  return 0;
+}
+
+using ElementKernel = void (*)(uint8_t* data,
+                               size_t count,
+                               size_t first_element,
+                               uint32_t seed,
+                               int amplitude);
+
+void ApplyUint8Scalar(uint8_t* data,
+                      size_t count,
+                      size_t first_element,
+                      uint32_t seed,
+                      int amplitude) {
+  const uint32_t span = static_cast<uint32_t>(2 * amplitude + 1);
+  for (size_t i = 0; i < count; ++i) {
+    size_t index = first_element + i;
+    uint32_t h = CounterHash(seed, static_cast<uint32_t>(index >> 2));
+    uint32_t bits = (h >> ((index & 3) * kUint8Bits)) & kUint8Mask;
+    int value = static_cast<int>(data[i]) + FieldDelta(bits, kUint8Bits, span, amplitude);
+    data[i] = static_cast<uint8_t>(std::clamp(value, 0, 255));
+  }
+}
+
+void ApplyUint16Scalar(uint8_t* data,
+                       size_t count,
+                       size_t first_element,
+                       uint32_t seed,
+                       int amplitude) {
+  const uint32_t span = static_cast<uint32_t>(2 * amplitude + 1);
+  for (size_t i = 0; i < count; ++i) {
+    size_t index = first_element + i;
+    uint32_t h = CounterHash(seed, static_cast<uint32_t>(index >> 1));
+    uint32_t bits = (h >> ((index & 1) * kHalfWordBits)) & kHalfWordMask;
+
+    uint16_t element;
+    memcpy(&element, data + i * sizeof(element), sizeof(element));
+    int value = static_cast<int>(element) + FieldDelta(bits, kHalfWordBits, span, amplitude);
+    element = static_cast<uint16_t>(std::clamp(value, 0, 65535));
+    memcpy(data + i * sizeof(element), &element, sizeof(element));
+  }
+}
+
+void ApplyFloat16Scalar(uint8_t* data,
+                        size_t count,
+                        size_t first_element,
+                        uint32_t seed,
+                        int amplitude) {
+  const uint32_t span = static_cast<uint32_t>(2 * amplitude + 1);
+  for (size_t i = 0; i < count; ++i) {
+    size_t index = first_element + i;
+    uint32_t h = CounterHash(seed, static_cast<uint32_t>(index >> 1));
+    uint32_t bits = (h >> ((index & 1) * kHalfWordBits)) & kHalfWordMask;
+
+    uint16_t element;
+    memcpy(&element, data + i * sizeof(element), sizeof(element));
+    int magnitude = element & kFloat16MagnitudeMask;
+    if (magnitude == 0 || magnitude > kFloat16MaxFinite) {
+      continue;
+    }
+
+    // Moving the magnitude by a few ULPs keeps the sign and stays finite.
+    magnitude = std::clamp(magnitude + FieldDelta(bits, kHalfWordBits, span, amplitude),
+                           1, kFloat16MaxFinite);
+    element = static_cast<uint16_t>((element & ~kFloat16MagnitudeMask) | magnitude);
+    memcpy(data + i * sizeof(element), &element, sizeof(element));
+  }
+}
+
+void ApplyFloat32Scalar(uint8_t* data,
+                        size_t count,
+                        size_t first_element,
+                        uint32_t seed,
+                        int amplitude) {
+  const uint32_t span = static_cast<uint32_t>(2 * amplitude + 1);
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t h = CounterHash(seed, static_cast<uint32_t>(first_element + i));
+
+    uint32_t element;
+    memcpy(&element, data + i * sizeof(element), sizeof(element));
+    int32_t magnitude = static_cast<int32_t>(element & kFloat32MagnitudeMask);
+    if (magnitude == 0 || magnitude > kFloat32MaxFinite) {
+      continue;
+    }
+
+    magnitude = std::clamp(
+        magnitude + FieldDelta(h & kHalfWordMask, kHalfWordBits, span, amplitude), 1,
+        kFloat32MaxFinite);
+    element = (element & ~kFloat32MagnitudeMask) | static_cast<uint32_t>(magnitude);
+    memcpy(data + i * sizeof(element), &element, sizeof(element));
+  }
+}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+#define NOVEBROWSE_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define NOVEBROWSE_TARGET_AVX2 __attribute__((target("avx2")))
+
+NOVEBROWSE_TARGET_SSE41 inline __m128i MixHashSSE41(__m128i h) {
+  h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+  h = _mm_mullo_epi32(h, _mm_set1_epi32(static_cast<int>(kMix1)));
+  h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+  h = _mm_mullo_epi32(h, _mm_set1_epi32(static_cast<int>(kMix2)));
+  h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+  return h;
+}
+
+// Splits one byte lane's signed delta into positive and negative parts so
+// that adds_epu8/subs_epu8 reproduce the scalar clamp exactly.
+NOVEBROWSE_TARGET_SSE41 inline void AccumulateByteSSE41(__m128i lane_bits,
+                                                        __m128i span,
+                                                        __m128i amplitude,
+                                                        __m128i byte_shift,
+                                                        __m128i* positive,
+                                                        __m128i* negative) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i bits = _mm_and_si128(lane_bits, _mm_set1_epi32(kUint8Mask));
+  __m128i scaled = _mm_srli_epi32(_mm_mullo_epi32(bits, span), kUint8Bits);
+  __m128i delta = _mm_sub_epi32(scaled, amplitude);
+  __m128i pos = _mm_max_epi32(delta, zero);
+  __m128i neg = _mm_max_epi32(_mm_sub_epi32(zero, delta), zero);
+  *positive = _mm_or_si128(*positive, _mm_sll_epi32(pos, byte_shift));
+  *negative = _mm_or_si128(*negative, _mm_sll_epi32(neg, byte_shift));
+}
+
+// |first_element| must be a multiple of 4 so each vector lane is one word.
+NOVEBROWSE_TARGET_SSE41 void ApplyUint8SSE41(uint8_t* data,
+                                             size_t count,
+                                             size_t first_element,
+                                             uint32_t seed,
+                                             int amplitude) {
+  const __m128i key = _mm_set1_epi32(static_cast<int>(seed));
+  const __m128i multiplier = _mm_set1_epi32(static_cast<int>(kCounterMultiplier));
+  const __m128i span = _mm_set1_epi32(2 * amplitude + 1);
+  const __m128i amp = _mm_set1_epi32(amplitude);
+  const __m128i step = _mm_set1_epi32(4);
+  const __m128i shift8 = _mm_cvtsi32_si128(8);
+  const __m128i shift16 = _mm_cvtsi32_si128(16);
+  const __m128i shift24 = _mm_cvtsi32_si128(24);
+  const int c0 = static_cast<int>(first_element >> 2);
+  __m128i counters = _mm_setr_epi32(c0, c0 + 1, c0 + 2, c0 + 3);
+
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m128i h = MixHashSSE41(_mm_xor_si128(key, _mm_mullo_epi32(counters, multiplier)));
+    __m128i positive = _mm_setzero_si128();
+    __m128i negative = _mm_setzero_si128();
+    AccumulateByteSSE41(h, span, amp, _mm_setzero_si128(), &positive, &negative);
+    AccumulateByteSSE41(_mm_srli_epi32(h, 8), span, amp, shift8, &positive, &negative);
+    AccumulateByteSSE41(_mm_srli_epi32(h, 16), span, amp, shift16, &positive, &negative);
+    AccumulateByteSSE41(_mm_srli_epi32(h, 24), span, amp, shift24, &positive, &negative);
+
+    __m128i* ptr = reinterpret_cast<__m128i*>(data + i);
+    __m128i bytes = _mm_loadu_si128(ptr);
+    bytes = _mm_subs_epu8(_mm_adds_epu8(bytes, positive), negative);
+    _mm_storeu_si128(ptr, bytes);
+    counters = _mm_add_epi32(counters, step);
+  }
+
+  ApplyUint8Scalar(data + i, count - i, first_element + i, seed, amplitude);
+}
+
+NOVEBROWSE_TARGET_SSE41 void ApplyFloat32SSE41(uint8_t* data,
+                                               size_t count,
+                                               size_t first_element,
+                                               uint32_t seed,
+                                               int amplitude) {
+  const __m128i key = _mm_set1_epi32(static_cast<int>(seed));
+  const __m128i multiplier = _mm_set1_epi32(static_cast<int>(kCounterMultiplier));
+  const __m128i span = _mm_set1_epi32(2 * amplitude + 1);
+  const __m128i amp = _mm_set1_epi32(amplitude);
+  const __m128i low_bits = _mm_set1_epi32(kHalfWordMask);
+  const __m128i magnitude_mask = _mm_set1_epi32(static_cast<int>(kFloat32MagnitudeMask));
+  const __m128i max_finite = _mm_set1_epi32(kFloat32MaxFinite);
+  const __m128i one = _mm_set1_epi32(1);
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i step = _mm_set1_epi32(4);
+  const int c0 = static_cast<int>(first_element);
+  __m128i counters = _mm_setr_epi32(c0, c0 + 1, c0 + 2, c0 + 3);
+
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128i h = MixHashSSE41(_mm_xor_si128(key, _mm_mullo_epi32(counters, multiplier)));
+    __m128i scaled =
+        _mm_srli_epi32(_mm_mullo_epi32(_mm_and_si128(h, low_bits), span), kHalfWordBits);
+    __m128i delta = _mm_sub_epi32(scaled, amp);
+
+    __m128i* ptr = reinterpret_cast<__m128i*>(data + i * 4);
+    __m128i elements = _mm_loadu_si128(ptr);
+    __m128i magnitude = _mm_and_si128(elements, magnitude_mask);
+    // Zeros, infinities and NaNs pass through unchanged.
+    __m128i keep = _mm_or_si128(_mm_cmpeq_epi32(magnitude, zero),
+                                _mm_cmpgt_epi32(magnitude, max_finite));
+    __m128i noised = _mm_min_epi32(_mm_max_epi32(_mm_add_epi32(magnitude, delta), one),
+                                   max_finite);
+    noised = _mm_or_si128(_mm_andnot_si128(magnitude_mask, elements), noised);
+    _mm_storeu_si128(ptr, _mm_blendv_epi8(noised, elements, keep));
+    counters = _mm_add_epi32(counters, step);
+  }
+
+  ApplyFloat32Scalar(data + i * 4, count - i, first_element + i, seed, amplitude);
+}
+
+NOVEBROWSE_TARGET_AVX2 inline __m256i MixHashAVX2(__m256i h) {
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+  h = _mm256_mullo_epi32(h, _mm256_set1_epi32(static_cast<int>(kMix1)));
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+  h = _mm256_mullo_epi32(h, _mm256_set1_epi32(static_cast<int>(kMix2)));
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+  return h;
+}
+
+NOVEBROWSE_TARGET_AVX2 inline void AccumulateByteAVX2(__m256i lane_bits,
+                                                      __m256i span,
+                                                      __m256i amplitude,
+                                                      __m128i byte_shift,
+                                                      __m256i* positive,
+                                                      __m256i* negative) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i bits = _mm256_and_si256(lane_bits, _mm256_set1_epi32(kUint8Mask));
+  __m256i scaled = _mm256_srli_epi32(_mm256_mullo_epi32(bits, span), kUint8Bits);
+  __m256i delta = _mm256_sub_epi32(scaled, amplitude);
+  __m256i pos = _mm256_max_epi32(delta, zero);
+  __m256i neg = _mm256_max_epi32(_mm256_sub_epi32(zero, delta), zero);
+  *positive = _mm256_or_si256(*positive, _mm256_sll_epi32(pos, byte_shift));
+  *negative = _mm256_or_si256(*negative, _mm256_sll_epi32(neg, byte_shift));
+}
+
+NOVEBROWSE_TARGET_AVX2 void ApplyUint8AVX2(uint8_t* data,
+                                           size_t count,
+                                           size_t first_element,
+                                           uint32_t seed,
+                                           int amplitude) {
+  const __m256i key = _mm256_set1_epi32(static_cast<int>(seed));
+  const __m256i multiplier = _mm256_set1_epi32(static_cast<int>(kCounterMultiplier));
+  const __m256i span = _mm256_set1_epi32(2 * amplitude + 1);
+  const __m256i amp = _mm256_set1_epi32(amplitude);
+  const __m256i step = _mm256_set1_epi32(8);
+  const __m128i shift8 = _mm_cvtsi32_si128(8);
+  const __m128i shift16 = _mm_cvtsi32_si128(16);
+  const __m128i shift24 = _mm_cvtsi32_si128(24);
+  const int c0 = static_cast<int>(first_element >> 2);
+  __m256i counters = _mm256_setr_epi32(c0, c0 + 1, c0 + 2, c0 + 3,
+                                       c0 + 4, c0 + 5, c0 + 6, c0 + 7);
+
+  size_t i = 0;
+  for (; i + 32 <= count; i += 32) {
+    __m256i h = MixHashAVX2(_mm256_xor_si256(key, _mm256_mullo_epi32(counters, multiplier)));
+    __m256i positive = _mm256_setzero_si256();
+    __m256i negative = _mm256_setzero_si256();
+    AccumulateByteAVX2(h, span, amp, _mm_setzero_si128(), &positive, &negative);
+    AccumulateByteAVX2(_mm256_srli_epi32(h, 8), span, amp, shift8, &positive, &negative);
+    AccumulateByteAVX2(_mm256_srli_epi32(h, 16), span, amp, shift16, &positive, &negative);
+    AccumulateByteAVX2(_mm256_srli_epi32(h, 24), span, amp, shift24, &positive, &negative);
+
+    __m256i* ptr = reinterpret_cast<__m256i*>(data + i);
+    __m256i bytes = _mm256_loadu_si256(ptr);
+    bytes = _mm256_subs_epu8(_mm256_adds_epu8(bytes, positive), negative);
+    _mm256_storeu_si256(ptr, bytes);
+    counters = _mm256_add_epi32(counters, step);
+  }
+
+  // The SSE4.1 kernel picks up the remaining 0-31 bytes.
+  ApplyUint8SSE41(data + i, count - i, first_element + i, seed, amplitude);
+}
+
+NOVEBROWSE_TARGET_AVX2 void ApplyFloat32AVX2(uint8_t* data,
+                                             size_t count,
+                                             size_t first_element,
+                                             uint32_t seed,
+                                             int amplitude) {
+  const __m256i key = _mm256_set1_epi32(static_cast<int>(seed));
+  const __m256i multiplier = _mm256_set1_epi32(static_cast<int>(kCounterMultiplier));
+  const __m256i span = _mm256_set1_epi32(2 * amplitude + 1);
+  const __m256i amp = _mm256_set1_epi32(amplitude);
+  const __m256i low_bits = _mm256_set1_epi32(kHalfWordMask);
+  const __m256i magnitude_mask =
+      _mm256_set1_epi32(static_cast<int>(kFloat32MagnitudeMask));
+  const __m256i max_finite = _mm256_set1_epi32(kFloat32MaxFinite);
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i step = _mm256_set1_epi32(8);
+  const int c0 = static_cast<int>(first_element);
+  __m256i counters = _mm256_setr_epi32(c0, c0 + 1, c0 + 2, c0 + 3,
+                                       c0 + 4, c0 + 5, c0 + 6, c0 + 7);
+
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i h = MixHashAVX2(_mm256_xor_si256(key, _mm256_mullo_epi32(counters, multiplier)));
+    __m256i scaled = _mm256_srli_epi32(
+        _mm256_mullo_epi32(_mm256_and_si256(h, low_bits), span), kHalfWordBits);
+    __m256i delta = _mm256_sub_epi32(scaled, amp);
+
+    __m256i* ptr = reinterpret_cast<__m256i*>(data + i * 4);
+    __m256i elements = _mm256_loadu_si256(ptr);
+    __m256i magnitude = _mm256_and_si256(elements, magnitude_mask);
+    __m256i keep = _mm256_or_si256(_mm256_cmpeq_epi32(magnitude, zero),
+                                   _mm256_cmpgt_epi32(magnitude, max_finite));
+    __m256i noised = _mm256_min_epi32(
+        _mm256_max_epi32(_mm256_add_epi32(magnitude, delta), one), max_finite);
+    noised = _mm256_or_si256(_mm256_andnot_si256(magnitude_mask, elements), noised);
+    _mm256_storeu_si256(ptr, _mm256_blendv_epi8(noised, elements, keep));
+    counters = _mm256_add_epi32(counters, step);
+  }
+
+  ApplyFloat32SSE41(data + i * 4, count - i, first_element + i, seed, amplitude);
+}
+
+#elif defined(ARCH_CPU_ARM64)
+
+inline uint32x4_t MixHashNEON(uint32x4_t h) {
+  h = veorq_u32(h, vshrq_n_u32(h, 16));
+  h = vmulq_u32(h, vdupq_n_u32(kMix1));
+  h = veorq_u32(h, vshrq_n_u32(h, 15));
+  h = vmulq_u32(h, vdupq_n_u32(kMix2));
+  h = veorq_u32(h, vshrq_n_u32(h, 16));
+  return h;
+}
+
+inline uint32x4_t InitialCounters(uint32_t first) {
+  const uint32_t counters[4] = {first, first + 1, first + 2, first + 3};
+  return vld1q_u32(counters);
+}
+
+inline void AccumulateByteNEON(uint32x4_t lane_bits,
+                               uint32x4_t span,
+                               int32x4_t amplitude,
+                               int32x4_t byte_shift,
+                               uint32x4_t* positive,
+                               uint32x4_t* negative) {
+  const int32x4_t zero = vdupq_n_s32(0);
+  uint32x4_t bits = vandq_u32(lane_bits, vdupq_n_u32(kUint8Mask));
+  uint32x4_t scaled = vshrq_n_u32(vmulq_u32(bits, span), kUint8Bits);
+  int32x4_t delta = vsubq_s32(vreinterpretq_s32_u32(scaled), amplitude);
+  uint32x4_t pos = vreinterpretq_u32_s32(vmaxq_s32(delta, zero));
+  uint32x4_t neg = vreinterpretq_u32_s32(vmaxq_s32(vnegq_s32(delta), zero));
+  *positive = vorrq_u32(*positive, vshlq_u32(pos, byte_shift));
+  *negative = vorrq_u32(*negative, vshlq_u32(neg, byte_shift));
+}
+
+void ApplyUint8NEON(uint8_t* data,
+                    size_t count,
+                    size_t first_element,
+                    uint32_t seed,
+                    int amplitude) {
+  const uint32x4_t key = vdupq_n_u32(seed);
+  const uint32x4_t multiplier = vdupq_n_u32(kCounterMultiplier);
+  const uint32x4_t span = vdupq_n_u32(static_cast<uint32_t>(2 * amplitude + 1));
+  const int32x4_t amp = vdupq_n_s32(amplitude);
+  const uint32x4_t step = vdupq_n_u32(4);
+  uint32x4_t counters = InitialCounters(static_cast<uint32_t>(first_element >> 2));
+
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    uint32x4_t h = MixHashNEON(veorq_u32(key, vmulq_u32(counters, multiplier)));
+    uint32x4_t positive = vdupq_n_u32(0);
+    uint32x4_t negative = vdupq_n_u32(0);
+    AccumulateByteNEON(h, span, amp, vdupq_n_s32(0), &positive, &negative);
+    AccumulateByteNEON(vshrq_n_u32(h, 8), span, amp, vdupq_n_s32(8), &positive,
+                       &negative);
+    AccumulateByteNEON(vshrq_n_u32(h, 16), span, amp, vdupq_n_s32(16), &positive,
+                       &negative);
+    AccumulateByteNEON(vshrq_n_u32(h, 24), span, amp, vdupq_n_s32(24), &positive,
+                       &negative);
+
+    uint8x16_t bytes = vld1q_u8(data + i);
+    bytes = vqaddq_u8(bytes, vreinterpretq_u8_u32(positive));
+    bytes = vqsubq_u8(bytes, vreinterpretq_u8_u32(negative));
+    vst1q_u8(data + i, bytes);
+    counters = vaddq_u32(counters, step);
+  }
+
+  ApplyUint8Scalar(data + i, count - i, first_element + i, seed, amplitude);
+}
+
+void ApplyFloat32NEON(uint8_t* data,
+                      size_t count,
+                      size_t first_element,
+                      uint32_t seed,
+                      int amplitude) {
+  const uint32x4_t key = vdupq_n_u32(seed);
+  const uint32x4_t multiplier = vdupq_n_u32(kCounterMultiplier);
+  const uint32x4_t span = vdupq_n_u32(static_cast<uint32_t>(2 * amplitude + 1));
+  const int32x4_t amp = vdupq_n_s32(amplitude);
+  const uint32x4_t low_bits = vdupq_n_u32(kHalfWordMask);
+  const uint32x4_t magnitude_mask = vdupq_n_u32(kFloat32MagnitudeMask);
+  const int32x4_t max_finite = vdupq_n_s32(kFloat32MaxFinite);
+  const int32x4_t one = vdupq_n_s32(1);
+  const int32x4_t zero = vdupq_n_s32(0);
+  const uint32x4_t step = vdupq_n_u32(4);
+  uint32x4_t counters = InitialCounters(static_cast<uint32_t>(first_element));
+
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    uint32x4_t h = MixHashNEON(veorq_u32(key, vmulq_u32(counters, multiplier)));
+    uint32x4_t scaled = vshrq_n_u32(vmulq_u32(vandq_u32(h, low_bits), span), kHalfWordBits);
+    int32x4_t delta = vsubq_s32(vreinterpretq_s32_u32(scaled), amp);
+
+    uint8_t* ptr = data + i * 4;
+    uint32x4_t elements = vreinterpretq_u32_u8(vld1q_u8(ptr));
+    int32x4_t magnitude = vreinterpretq_s32_u32(vandq_u32(elements, magnitude_mask));
+    uint32x4_t keep = vorrq_u32(vceqq_s32(magnitude, zero),
+                                vcgtq_s32(magnitude, max_finite));
+    int32x4_t noised =
+        vminq_s32(vmaxq_s32(vaddq_s32(magnitude, delta), one), max_finite);
+    uint32x4_t result = vorrq_u32(vbicq_u32(elements, magnitude_mask),
+                                  vreinterpretq_u32_s32(noised));
+    result = vbslq_u32(keep, elements, result);
+    vst1q_u8(ptr, vreinterpretq_u8_u32(result));
+    counters = vaddq_u32(counters, step);
+  }
+
+  ApplyFloat32Scalar(data + i * 4, count - i, first_element + i, seed, amplitude);
+}
+
+#endif
+
+struct ElementKernels {
+  ElementKernel uint8;
+  ElementKernel float32;
+};
+
+ElementKernels SelectKernels() {
+#if defined(ARCH_CPU_X86_FAMILY)
+  base::CPU cpu;
+  if (cpu.has_avx2()) {
+    return {&ApplyUint8AVX2, &ApplyFloat32AVX2};
+  }
+  if (cpu.has_sse41()) {
+    return {&ApplyUint8SSE41, &ApplyFloat32SSE41};
+  }
+  return {&ApplyUint8Scalar, &ApplyFloat32Scalar};
+#elif defined(ARCH_CPU_ARM64)
+  return {&ApplyUint8NEON, &ApplyFloat32NEON};
+#else
+  return {&ApplyUint8Scalar, &ApplyFloat32Scalar};
+#endif
+}
+
+void ApplyWithKernels(const ElementKernels& kernels,
+                      uint8_t* data,
+                      size_t element_count,
+                      size_t first_element,
+                      WebGLElementType type,
+                      uint32_t seed,
+                      int amplitude) {
+  amplitude = std::min(amplitude, MaxAmplitude(type));
+  switch (type) {
+    case WebGLElementType::kUint8: {
+      // The vector kernels expect their first byte to start a hash word.
+      size_t head = std::min(element_count, (4 - first_element % 4) % 4);
+      ApplyUint8Scalar(data, head, first_element, seed, amplitude);
+      kernels.uint8(data + head, element_count - head, first_element + head, seed,
+                    amplitude);
+      return;
+    }
+    case WebGLElementType::kUint16:
+      ApplyUint16Scalar(data, element_count, first_element, seed, amplitude);
+      return;
+    case WebGLElementType::kFloat16:
+      ApplyFloat16Scalar(data, element_count, first_element, seed, amplitude);
+      return;
+    case WebGLElementType::kFloat32:
+      kernels.float32(data, element_count, first_element, seed, amplitude);
+      return;
+  }
+}
+
+}  // namespace
+
+// static
+size_t WebGLNoiseKernel::ElementSize(WebGLElementType type) {
+  switch (type) {
+    case WebGLElementType::kUint8:
+      return 1;
+    case WebGLElementType::kUint16:
+    case WebGLElementType::kFloat16:
+      return 2;
+    case WebGLElementType::kFloat32:
+      return 4;
+  }
+  return 1;
+}
+
+// static
+int WebGLNoiseKernel::AmplitudeForNoiseLevel(WebGLElementType type,
+                                             double noise_level) {
+  if (!(noise_level > 0.0)) {
+    return 0;
+  }
+
+  // Integer elements scale to their full range, floats to a few ULPs: a
+  // relative error around 1e-6 is invisible in geometry but still changes
+  // the rendered bits a fingerprint hashes.
+  double max_amplitude = static_cast<double>(MaxAmplitude(type));
+  return static_cast<int>(std::min(std::ceil(noise_level * max_amplitude), max_amplitude));
+}
+
+// static
+void WebGLNoiseKernel::Apply(void* data,
+                             size_t element_count,
+                             size_t first_element,
+                             WebGLElementType type,
+                             uint32_t seed,
+                             int amplitude) {
+  if (!data || element_count == 0 || amplitude <= 0) {
+    return;
+  }
+
+  static const ElementKernels kernels = SelectKernels();
+  ApplyWithKernels(kernels, static_cast<uint8_t*>(data), element_count,
+                   first_element, type, seed, amplitude);
+}
+
+// static
+void WebGLNoiseKernel::ApplyScalar(void* data,
+                                   size_t element_count,
+                                   size_t first_element,
+                                   WebGLElementType type,
+                                   uint32_t seed,
+                                   int amplitude) {
+  if (!data || element_count == 0 || amplitude <= 0) {
+    return;
+  }
+
+  static constexpr ElementKernels kScalarKernels = {&ApplyUint8Scalar,
+                                                    &ApplyFloat32Scalar};
+  ApplyWithKernels(kScalarKernels, static_cast<uint8_t*>(data), element_count,
+                   first_element, type, seed, amplitude);
+}
+
+// static
+uint32_t WebGLNoiseKernel::HashCounter(uint32_t seed, uint32_t counter) {
+  return CounterHash(seed, counter);
+}
+
+}  // namespace novebrowse
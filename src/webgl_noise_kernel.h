@@ -0,0 +1,58 @@
+#ifndef NOVEBROWSE_WEBGL_NOISE_KERNEL_H_
+#define NOVEBROWSE_WEBGL_NOISE_KERNEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace novebrowse {
+
+// WebGL缓冲区/纹理数据的元素类型
+enum class WebGLElementType : uint8_t {
+  kUint8,
+  kUint16,
+  kFloat16,
+  kFloat32,
+};
+
+// WebGL元素噪声内核 - 按元素类型在元素空间加噪，使用计数器式哈希，无内部状态
+//
+// 第i个元素的偏移只由(seed, i)决定，因此数据可以分块在任意线程按任意顺序处理。
+// 整数元素做饱和加减；浮点元素在位模式上偏移少量ULP，零、无穷和NaN保持不变，
+// 结果不会改变符号或溢出为无穷。u8和f32有SSE4.1/AVX2/NEON实现，
+// 与标量路径的输出逐位一致；u16和f16只有标量实现。
+class WebGLNoiseKernel {
+ public:
+  // noise_level为1.0时浮点元素的最大ULP偏移
+  static constexpr int kFloat32UlpsPerNoiseLevel = 1024;
+  static constexpr int kFloat16UlpsPerNoiseLevel = 64;
+
+  // 单个元素的字节数
+  static size_t ElementSize(WebGLElementType type);
+
+  // 由noise_level换算该类型的噪声幅度，返回0表示不扰动
+  static int AmplitudeForNoiseLevel(WebGLElementType type, double noise_level);
+
+  // 对连续的element_count个元素加噪（自动选择SIMD实现）
+  // data指向第first_element个元素，即元素在整个缓冲区中的下标
+  static void Apply(void* data,
+                    size_t element_count,
+                    size_t first_element,
+                    WebGLElementType type,
+                    uint32_t seed,
+                    int amplitude);
+
+  // 标量参考实现
+  static void ApplyScalar(void* data,
+                          size_t element_count,
+                          size_t first_element,
+                          WebGLElementType type,
+                          uint32_t seed,
+                          int amplitude);
+
+  // 计数器哈希 - 第counter个哈希值，各类型从中取噪声位
+  static uint32_t HashCounter(uint32_t seed, uint32_t counter);
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_WEBGL_NOISE_KERNEL_H_
@@ -0,0 +1,107 @@
+#include "novebrowse/webgl_spoof_table.h"
+
+#include <utility>
+
+#include "third_party/blink/renderer/platform/bindings/v8_binding.h"
+#include "third_party/blink/renderer/platform/wtf/std_lib_extras.h"
+#include "v8/include/v8.h"
+
+namespace novebrowse {
+
+WebGLSpoofTable::WebGLSpoofTable(bool enabled, uint64_t generation)
+    : enabled_(enabled), generation_(generation) {}
+
+WebGLSpoofTable::~WebGLSpoofTable() = default;
+
+// static
+int WebGLSpoofTable::SlotForParameter(GLenum pname) {
+  switch (pname) {
+    case GL_VENDOR:
+      return kVendor;
+    case GL_RENDERER:
+      return kRenderer;
+    case GL_VERSION:
+      return kVersion;
+    case GL_SHADING_LANGUAGE_VERSION:
+      return kShadingLanguageVersion;
+    case GL_MAX_TEXTURE_SIZE:
+      return kMaxTextureSize;
+    case GL_MAX_CUBE_MAP_TEXTURE_SIZE:
+      return kMaxCubeMapTextureSize;
+    case GL_MAX_RENDERBUFFER_SIZE:
+      return kMaxRenderbufferSize;
+    case GL_MAX_VERTEX_ATTRIBS:
+      return kMaxVertexAttribs;
+    case GL_MAX_VERTEX_UNIFORM_VECTORS:
+      return kMaxVertexUniformVectors;
+    case GL_MAX_FRAGMENT_UNIFORM_VECTORS:
+      return kMaxFragmentUniformVectors;
+    case GL_MAX_VARYING_VECTORS:
+      return kMaxVaryingVectors;
+    case GL_MAX_VIEWPORT_DIMS:
+      return kMaxViewportDims;
+    default:
+      return kNoSlot;
+  }
+}
+
+void WebGLSpoofTable::SetInt(Slot slot, int value) {
+  Entry& entry = entries_[slot];
+  entry.kind = Kind::kInt;
+  entry.ints[0] = value;
+}
+
+void WebGLSpoofTable::SetIntPair(Slot slot, int first, int second) {
+  Entry& entry = entries_[slot];
+  entry.kind = Kind::kIntPair;
+  entry.ints[0] = first;
+  entry.ints[1] = second;
+}
+
+void WebGLSpoofTable::SetString(Slot slot, const WTF::String& value) {
+  Entry& entry = entries_[slot];
+  entry.kind = Kind::kString;
+  entry.string = value;
+}
+
+void WebGLSpoofTable::SetExtensions(std::vector<std::string> extensions) {
+  extensions_ = std::move(extensions);
+}
+
+const WTF::String& WebGLSpoofTable::GetString(int slot) const {
+  DEFINE_STATIC_LOCAL(const WTF::String, empty_string, ());
+  if (slot < 0 || slot >= kSlotCount ||
+      entries_[slot].kind != Kind::kString) {
+    return empty_string;
+  }
+  
+  return entries_[slot].string;
+}
+
+v8::Local<v8::Value> WebGLSpoofTable::ToV8(v8::Isolate* isolate,
+                                           v8::Local<v8::Context> context,
+                                           int slot) const {
+  if (slot < 0 || slot >= kSlotCount) {
+    return v8::Integer::New(isolate, 0);
+  }
+  
+  const Entry& entry = entries_[slot];
+  switch (entry.kind) {
+    case Kind::kInt:
+      return v8::Integer::New(isolate, entry.ints[0]);
+    case Kind::kString:
+      return blink::V8String(isolate, entry.string);
+    case Kind::kIntPair: {
+      v8::Local<v8::Array> array = v8::Array::New(isolate, 2);
+      array->Set(context, 0, v8::Integer::New(isolate, entry.ints[0])).Check();
+      array->Set(context, 1, v8::Integer::New(isolate, entry.ints[1])).Check();
+      return array;
+    }
+    case Kind::kNone:
+      break;
+  }
+  
+  return v8::Integer::New(isolate, 0);
+}
+
+}  // namespace novebrowse
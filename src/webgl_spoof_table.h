@@ -0,0 +1,87 @@
+#ifndef NOVEBROWSE_WEBGL_SPOOF_TABLE_H_
+#define NOVEBROWSE_WEBGL_SPOOF_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
+#include "third_party/khronos/GLES2/gl2.h"
+#include "v8/include/v8-forward.h"
+
+namespace novebrowse {
+
+// WebGL参数伪造表 - 每个上下文一份，按紧凑下标存放预先计算的伪造值
+//
+// 表在配置代数变化时整体重建，查询时只做一次下标读取，不复制配置。
+// 字符串以WTF::String保存，转换为V8值时命中Blink的字符串缓存。
+class WebGLSpoofTable {
+ public:
+  // 伪造参数的紧凑下标
+  enum Slot : uint8_t {
+    kVendor,
+    kRenderer,
+    kVersion,
+    kShadingLanguageVersion,
+    kMaxTextureSize,
+    kMaxCubeMapTextureSize,
+    kMaxRenderbufferSize,
+    kMaxVertexAttribs,
+    kMaxVertexUniformVectors,
+    kMaxFragmentUniformVectors,
+    kMaxVaryingVectors,
+    kMaxViewportDims,
+    kSlotCount,
+  };
+  
+  // 不伪造的参数
+  static constexpr int kNoSlot = -1;
+  
+  WebGLSpoofTable(bool enabled, uint64_t generation);
+  ~WebGLSpoofTable();
+  
+  WebGLSpoofTable(const WebGLSpoofTable&) = delete;
+  WebGLSpoofTable& operator=(const WebGLSpoofTable&) = delete;
+  
+  // pname对应的下标，不伪造时返回kNoSlot
+  static int SlotForParameter(GLenum pname);
+  
+  // 填充表项
+  void SetInt(Slot slot, int value);
+  void SetIntPair(Slot slot, int first, int second);
+  void SetString(Slot slot, const WTF::String& value);
+  void SetExtensions(std::vector<std::string> extensions);
+  
+  bool enabled() const { return enabled_; }
+  uint64_t generation() const { return generation_; }
+  const std::vector<std::string>& extensions() const { return extensions_; }
+  
+  // 表项的字符串值，非字符串表项返回空字符串
+  const WTF::String& GetString(int slot) const;
+  
+  // 表项的V8值；数组每次新建，避免页面通过对象同一性识别伪造
+  v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
+                            v8::Local<v8::Context> context,
+                            int slot) const;
+  
+ private:
+  enum class Kind : uint8_t { kNone, kInt, kIntPair, kString };
+  
+  struct Entry {
+    Kind kind = Kind::kNone;
+    int ints[2] = {0, 0};
+    WTF::String string;
+  };
+  
+  const bool enabled_;
+  const uint64_t generation_;
+  std::array<Entry, kSlotCount> entries_;
+  std::vector<std::string> extensions_;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_WEBGL_SPOOF_TABLE_H_
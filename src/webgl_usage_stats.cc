@@ -0,0 +1,171 @@
+#include "novebrowse/webgl_usage_stats.h"
+
+#include <algorithm>
+
+namespace novebrowse {
+
+namespace {
+
+// Parameters whose "queried" bit is tracked. The first kFingerprintingCount
+// entries are the classic fingerprinting strings.
+constexpr GLenum kTrackedParameters[] = {
+    GL_VENDOR,
+    GL_RENDERER,
+    GL_VERSION,
+    GL_SHADING_LANGUAGE_VERSION,
+    0x9245,  // UNMASKED_VENDOR_WEBGL
+    0x9246,  // UNMASKED_RENDERER_WEBGL
+    GL_MAX_TEXTURE_SIZE,
+    GL_MAX_CUBE_MAP_TEXTURE_SIZE,
+    GL_MAX_RENDERBUFFER_SIZE,
+    GL_MAX_VIEWPORT_DIMS,
+    GL_MAX_VERTEX_ATTRIBS,
+    GL_MAX_VERTEX_UNIFORM_VECTORS,
+    GL_MAX_FRAGMENT_UNIFORM_VECTORS,
+    GL_MAX_VARYING_VECTORS,
+    GL_ALIASED_LINE_WIDTH_RANGE,
+    GL_ALIASED_POINT_SIZE_RANGE,
+};
+constexpr int kFingerprintingCount = 4;
+
+static_assert(std::size(kTrackedParameters) <= 32,
+              "queried_parameters_ is a 32-bit set");
+  
+}  // namespace
+
+WebGLUsageStats::WebGLUsageStats() {
+  Reset();
+}
+
+WebGLUsageStats::~WebGLUsageStats() = default;
+
+void WebGLUsageStats::Record(WebGLOperation operation,
+                             GLenum pname,
+                             int64_t now_us) {
+  int64_t expected = 0;
+  first_operation_time_.compare_exchange_strong(expected, now_us,
+                                                std::memory_order_relaxed);
+  last_operation_time_.store(now_us, std::memory_order_relaxed);
+  
+  uint64_t index = operation_count_.load(std::memory_order_relaxed);
+  operation_sequence_[index % kSequenceCapacity].store(
+      static_cast<uint8_t>(operation), std::memory_order_relaxed);
+  operation_count_.store(index + 1, std::memory_order_release);
+  
+  switch (operation) {
+    case WebGLOperation::kGetParameter: {
+      parameter_queries_.fetch_add(1, std::memory_order_relaxed);
+      
+      uint64_t param_index = parameter_count_.load(std::memory_order_relaxed);
+      parameter_sequence_[param_index % kSequenceCapacity].store(
+          pname, std::memory_order_relaxed);
+      parameter_count_.store(param_index + 1, std::memory_order_release);
+      
+      int bit = TrackedParameterIndex(pname);
+      if (bit < 0) {
+        break;
+      }
+      
+      uint32_t mask = 1u << bit;
+      uint32_t previous =
+          queried_parameters_.fetch_or(mask, std::memory_order_relaxed);
+      if (!(previous & mask) && bit < kFingerprintingCount) {
+        distinct_fingerprinting_queries_.fetch_add(1, std::memory_order_relaxed);
+      }
+      break;
+    }
+    case WebGLOperation::kGetSupportedExtensions:
+      extension_queries_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case WebGLOperation::kGetShaderPrecisionFormat:
+      shader_queries_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case WebGLOperation::kBufferOperation:
+      buffer_operations_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case WebGLOperation::kTextureOperation:
+      texture_operations_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case WebGLOperation::kDrawArrays:
+    case WebGLOperation::kDrawElements:
+      rendering_operations_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case WebGLOperation::kOther:
+      break;
+  }
+}
+
+void WebGLUsageStats::Reset() {
+  for (std::atomic<int>* counter :
+       {&parameter_queries_, &extension_queries_, &shader_queries_,
+        &buffer_operations_, &texture_operations_, &rendering_operations_,
+        &distinct_fingerprinting_queries_}) {
+    counter->store(0, std::memory_order_relaxed);
+  }
+  first_operation_time_.store(0, std::memory_order_relaxed);
+  last_operation_time_.store(0, std::memory_order_relaxed);
+  queried_parameters_.store(0, std::memory_order_relaxed);
+  
+  for (auto& slot : operation_sequence_) {
+    slot.store(static_cast<uint8_t>(WebGLOperation::kOther),
+               std::memory_order_relaxed);
+  }
+  for (auto& slot : parameter_sequence_) {
+    slot.store(0, std::memory_order_relaxed);
+  }
+  operation_count_.store(0, std::memory_order_release);
+  parameter_count_.store(0, std::memory_order_release);
+}
+
+bool WebGLUsageStats::WasParameterQueried(GLenum pname) const {
+  int bit = TrackedParameterIndex(pname);
+  if (bit < 0) {
+    return false;
+  }
+  
+  return queried_parameters_.load(std::memory_order_relaxed) & (1u << bit);
+}
+
+size_t WebGLUsageStats::CopyRecentOperations(
+    base::span<WebGLOperation, kSequenceCapacity> out) const {
+  uint64_t count = operation_count_.load(std::memory_order_acquire);
+  size_t length = static_cast<size_t>(
+      std::min<uint64_t>(count, kSequenceCapacity));
+  uint64_t start = count - length;
+  
+  for (size_t i = 0; i < length; ++i) {
+    out[i] = static_cast<WebGLOperation>(
+        operation_sequence_[(start + i) % kSequenceCapacity].load(
+            std::memory_order_relaxed));
+  }
+  
+  return length;
+}
+
+size_t WebGLUsageStats::CopyRecentParameters(
+    base::span<GLenum, kSequenceCapacity> out) const {
+  uint64_t count = parameter_count_.load(std::memory_order_acquire);
+  size_t length = static_cast<size_t>(
+      std::min<uint64_t>(count, kSequenceCapacity));
+  uint64_t start = count - length;
+  
+  for (size_t i = 0; i < length; ++i) {
+    out[i] = parameter_sequence_[(start + i) % kSequenceCapacity].load(
+        std::memory_order_relaxed);
+  }
+  
+  return length;
+}
+
+// static
+int WebGLUsageStats::TrackedParameterIndex(GLenum pname) {
+  for (size_t i = 0; i < std::size(kTrackedParameters); ++i) {
+    if (kTrackedParameters[i] == pname) {
+      return static_cast<int>(i);
+    }
+  }
+  
+  return -1;
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,104 @@
+#ifndef NOVEBROWSE_WEBGL_USAGE_STATS_H_
+#define NOVEBROWSE_WEBGL_USAGE_STATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+
+#include "base/containers/span.h"
+#include "third_party/khronos/GLES2/gl2.h"
+
+namespace novebrowse {
+
+// WebGL操作类型 - 检测器记录的操作
+enum class WebGLOperation : uint8_t {
+  kGetParameter,
+  kGetSupportedExtensions,
+  kGetShaderPrecisionFormat,
+  kBufferOperation,
+  kTextureOperation,
+  kDrawArrays,
+  kDrawElements,
+  kOther,
+};
+
+// WebGL使用统计 - 每个上下文一份，由WebGLContextData持有
+//
+// 记录路径只做原子操作，不分配内存、不加锁。参数查询用位集合记录，
+// 指纹参数的查询数增量维护，判定时无需重新扫描。
+class WebGLUsageStats {
+ public:
+  // 操作序列和参数序列的保留长度
+  static constexpr size_t kSequenceCapacity = 100;
+  
+  WebGLUsageStats();
+  ~WebGLUsageStats();
+  
+  WebGLUsageStats(const WebGLUsageStats&) = delete;
+  WebGLUsageStats& operator=(const WebGLUsageStats&) = delete;
+  
+  // 记录一次操作，pname仅对kGetParameter有意义，now_us为单调时钟微秒数
+  void Record(WebGLOperation operation, GLenum pname, int64_t now_us);
+  
+  // 清空统计（上下文丢失时）
+  void Reset();
+  
+  int parameter_queries() const { return Load(parameter_queries_); }
+  int extension_queries() const { return Load(extension_queries_); }
+  int shader_queries() const { return Load(shader_queries_); }
+  int buffer_operations() const { return Load(buffer_operations_); }
+  int texture_operations() const { return Load(texture_operations_); }
+  int rendering_operations() const { return Load(rendering_operations_); }
+  int64_t first_operation_time() const {
+    return first_operation_time_.load(std::memory_order_relaxed);
+  }
+  int64_t last_operation_time() const {
+    return last_operation_time_.load(std::memory_order_relaxed);
+  }
+  
+  // 已查询过的不同指纹参数（VENDOR/RENDERER/VERSION/SHADING_LANGUAGE_VERSION）数量
+  int distinct_fingerprinting_queries() const {
+    return Load(distinct_fingerprinting_queries_);
+  }
+  
+  // 是否查询过指定参数（仅限kTrackedParameters中的参数）
+  bool WasParameterQueried(GLenum pname) const;
+  
+  // 按时间顺序复制最近的操作/参数序列到out，返回复制的数量
+  size_t CopyRecentOperations(
+      base::span<WebGLOperation, kSequenceCapacity> out) const;
+  size_t CopyRecentParameters(base::span<GLenum, kSequenceCapacity> out) const;
+  
+ private:
+  // 参数在位集合中的下标，不在跟踪范围内返回-1
+  static int TrackedParameterIndex(GLenum pname);
+  
+  static int Load(const std::atomic<int>& counter) {
+    return counter.load(std::memory_order_relaxed);
+  }
+  
+  std::atomic<int> parameter_queries_{0};
+  std::atomic<int> extension_queries_{0};
+  std::atomic<int> shader_queries_{0};
+  std::atomic<int> buffer_operations_{0};
+  std::atomic<int> texture_operations_{0};
+  std::atomic<int> rendering_operations_{0};
+  std::atomic<int> distinct_fingerprinting_queries_{0};
+  std::atomic<int64_t> first_operation_time_{0};
+  std::atomic<int64_t> last_operation_time_{0};
+  
+  // 已查询参数的位集合，下标见TrackedParameterIndex
+  std::atomic<uint32_t> queried_parameters_{0};
+  
+  // 环形缓冲区，*_count_为累计写入次数
+  std::array<std::atomic<uint8_t>, kSequenceCapacity> operation_sequence_;
+  std::atomic<uint64_t> operation_count_{0};
+  std::array<std::atomic<GLenum>, kSequenceCapacity> parameter_sequence_;
+  std::atomic<uint64_t> parameter_count_{0};
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_WEBGL_USAGE_STATS_H_
@@ -5,6 +5,10 @@
 // a number and applies it to a target window's taskbar button using
 // ITaskbarList3::SetOverlayIcon.
 //
+// The ITaskbarList3 instance is created once per thread (it lives in that
+// thread's COM apartment) and badge icons are rendered once per number and
+// DPI, so re-badging a window only costs the SetOverlayIcon call.
+//
 // Usage example (Win32/Main thread):
 //   HWND hwnd = ...; // top-level browser window handle
 //   novebrowse::TaskbarBadge::SetOverlayNumber(hwnd, 3);
@@ -16,10 +20,15 @@
 #include <shellapi.h>
 #include <shobjidl.h>
 
+#include <array>
+#include <vector>
+
 namespace novebrowse {
 
 class TaskbarBadge {
  public:
+  static constexpr int kMaxNumber = 99;
+
   // Applies an overlay number (1-99) to the taskbar icon for the given window.
   // If number <= 0, the overlay is cleared.
   static bool SetOverlayNumber(HWND window_handle, int number) {
@@ -29,18 +38,18 @@ class TaskbarBadge {
     if (number <= 0) {
       return ClearOverlay(window_handle);
     }
-    if (number > 99) {
-      number = 99;
+    if (number > kMaxNumber) {
+      number = kMaxNumber;
     }
 
-    HICON number_icon = CreateNumberOverlayIcon(number);
+    HICON number_icon = GetNumberOverlayIcon(number, GetWindowDpi(window_handle));
     if (number_icon == nullptr) {
       return false;
     }
 
-    bool result = ApplyOverlayIcon(window_handle, number_icon);
-    DestroyIcon(number_icon);
-    return result;
+    // The taskbar keeps its own copy of the icon, so the cached one stays
+    // valid for the next window.
+    return ApplyOverlayIcon(window_handle, number_icon);
   }
 
   // Clears any existing overlay icon on the taskbar button for the window.
@@ -48,8 +57,8 @@ class TaskbarBadge {
     if (window_handle == nullptr) {
       return false;
     }
-    CComPtr<ITaskbarList3> taskbar;
-    if (!CreateTaskbarInstance(&taskbar)) {
+    ITaskbarList3* taskbar = GetTaskbarInstance();
+    if (taskbar == nullptr) {
       return false;
     }
     HRESULT hr = taskbar->SetOverlayIcon(window_handle, nullptr, L"");
@@ -57,14 +66,55 @@ class TaskbarBadge {
   }
 
  private:
-  // Creates a 32x32 ARGB icon with a colored circle and white number text.
-  static HICON CreateNumberOverlayIcon(int number) {
-    const int kIconSize = 32;  // Windows scales overlay appropriately.
+  // Icon edge at 96 DPI; Windows scales the overlay down to fit the button.
+  static constexpr int kBaseIconSize = 32;
+
+  // Rendered icons for one DPI, indexed by number - 1.
+  struct DpiIcons {
+    UINT dpi = 0;
+    std::array<HICON, kMaxNumber> icons = {};
+  };
+
+  static UINT GetWindowDpi(HWND window_handle) {
+    UINT dpi = GetDpiForWindow(window_handle);
+    return dpi != 0 ? dpi : USER_DEFAULT_SCREEN_DPI;
+  }
+
+  // Returns the cached icon for |number| at |dpi|, rendering it on first use.
+  // Icons are kept until the process exits, at most one per number and DPI.
+  static HICON GetNumberOverlayIcon(int number, UINT dpi) {
+    static SRWLOCK lock = SRWLOCK_INIT;
+    static std::vector<DpiIcons>* cache = new std::vector<DpiIcons>();
+
+    AcquireSRWLockExclusive(&lock);
+    DpiIcons* entry = nullptr;
+    for (DpiIcons& candidate : *cache) {
+      if (candidate.dpi == dpi) {
+        entry = &candidate;
+        break;
+      }
+    }
+    if (entry == nullptr) {
+      cache->push_back(DpiIcons{dpi});
+      entry = &cache->back();
+    }
+
+    HICON& icon = entry->icons[number - 1];
+    if (icon == nullptr) {
+      icon = CreateNumberOverlayIcon(number, MulDiv(kBaseIconSize, dpi,
+                                                    USER_DEFAULT_SCREEN_DPI));
+    }
+    HICON result = icon;
+    ReleaseSRWLockExclusive(&lock);
+    return result;
+  }
 
+  // Creates an ARGB icon with a colored circle and white number text.
+  static HICON CreateNumberOverlayIcon(int number, int icon_size) {
     BITMAPV5HEADER header = {};
     header.bV5Size = sizeof(BITMAPV5HEADER);
-    header.bV5Width = kIconSize;
-    header.bV5Height = -kIconSize;  // Negative for top-down DIB.
+    header.bV5Width = icon_size;
+    header.bV5Height = -icon_size;  // Negative for top-down DIB.
     header.bV5Planes = 1;
     header.bV5BitCount = 32;
     header.bV5Compression = BI_BITFIELDS;
@@ -92,20 +142,17 @@ class TaskbarBadge {
     HGDIOBJ old_bitmap = SelectObject(mem_dc, color_bitmap);
 
     // Transparent background.
-    RECT rect = {0, 0, kIconSize, kIconSize};
-    HBRUSH transparent_brush = CreateSolidBrush(RGB(0, 0, 0));
-    BLENDFUNCTION blend = {AC_SRC_OVER, 0, 255, AC_SRC_ALPHA};
-    // Manually clear pixels to transparent.
-    ZeroMemory(bits, kIconSize * kIconSize * 4);
+    RECT rect = {0, 0, icon_size, icon_size};
+    ZeroMemory(bits, static_cast<size_t>(icon_size) * icon_size * 4);
 
     // Draw a filled red circle as the badge background.
     HBRUSH circle_brush = CreateSolidBrush(RGB(220, 0, 0));
-    HBRUSH old_brush = (HBRUSH)SelectObject(mem_dc, circle_brush);
-    HPEN null_pen = (HPEN)SelectObject(mem_dc, GetStockObject(NULL_PEN));
-    const int inset = 2;
-    Ellipse(mem_dc, inset, inset, kIconSize - inset, kIconSize - inset);
+    HGDIOBJ old_brush = SelectObject(mem_dc, circle_brush);
+    HGDIOBJ old_pen = SelectObject(mem_dc, GetStockObject(NULL_PEN));
+    const int inset = MulDiv(2, icon_size, kBaseIconSize);
+    Ellipse(mem_dc, inset, inset, icon_size - inset, icon_size - inset);
     SelectObject(mem_dc, old_brush);
-    SelectObject(mem_dc, null_pen);
+    SelectObject(mem_dc, old_pen);
     DeleteObject(circle_brush);
 
     // Draw white number text centered.
@@ -118,10 +165,10 @@ class TaskbarBadge {
     }
 
     HFONT font = CreateFontW(
-        20, 0, 0, 0, FW_HEAVY, FALSE, FALSE, FALSE, DEFAULT_CHARSET,
-        OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, ANTIALIASED_QUALITY,
-        DEFAULT_PITCH | FF_SWISS, L"Segoe UI");
-    HFONT old_font = (HFONT)SelectObject(mem_dc, font);
+        MulDiv(20, icon_size, kBaseIconSize), 0, 0, 0, FW_HEAVY, FALSE, FALSE,
+        FALSE, DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
+        ANTIALIASED_QUALITY, DEFAULT_PITCH | FF_SWISS, L"Segoe UI");
+    HGDIOBJ old_font = SelectObject(mem_dc, font);
     SetTextColor(mem_dc, RGB(255, 255, 255));
     SetBkMode(mem_dc, TRANSPARENT);
 
@@ -132,7 +179,7 @@ class TaskbarBadge {
     DeleteObject(font);
 
     // Create mask bitmap (unused for alpha icon, but required by API).
-    HBITMAP mask_bitmap = CreateBitmap(kIconSize, kIconSize, 1, 1, nullptr);
+    HBITMAP mask_bitmap = CreateBitmap(icon_size, icon_size, 1, 1, nullptr);
 
     ICONINFO icon_info = {};
     icon_info.fIcon = TRUE;
@@ -151,20 +198,26 @@ class TaskbarBadge {
   }
 
   static bool ApplyOverlayIcon(HWND window_handle, HICON icon) {
-    CComPtr<ITaskbarList3> taskbar;
-    if (!CreateTaskbarInstance(&taskbar)) {
+    ITaskbarList3* taskbar = GetTaskbarInstance();
+    if (taskbar == nullptr) {
       return false;
     }
     HRESULT hr = taskbar->SetOverlayIcon(window_handle, icon, L"NoveBrowse Badge");
     return SUCCEEDED(hr);
   }
 
-  static bool CreateTaskbarInstance(ITaskbarList3** out_taskbar) {
-    if (out_taskbar == nullptr) {
-      return false;
+  // Returns this thread's ITaskbarList3, creating it on first use. The
+  // instance belongs to the thread's apartment, so it is cached per thread
+  // rather than shared; it is never released, because the apartment may
+  // already be gone when thread-local destructors run.
+  static ITaskbarList3* GetTaskbarInstance() {
+    static thread_local ITaskbarList3* cached_taskbar = nullptr;
+    if (cached_taskbar != nullptr) {
+      return cached_taskbar;
     }
-    *out_taskbar = nullptr;
 
+    // COM stays initialized for the rest of the thread's life, as the
+    // cached object relies on the apartment.
     HRESULT hr = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
     bool need_uninit = SUCCEEDED(hr);
 
@@ -173,15 +226,16 @@ class TaskbarBadge {
                           IID_PPV_ARGS(&taskbar));
     if (FAILED(hr) || taskbar == nullptr) {
       if (need_uninit) CoUninitialize();
-      return false;
+      return nullptr;
+    }
+    if (FAILED(taskbar->HrInit())) {
+      taskbar->Release();
+      if (need_uninit) CoUninitialize();
+      return nullptr;
     }
-    taskbar->HrInit();
 
-    // The returned pointer is managed by caller. We do not uninitialize COM
-    // here because the taskbar object may rely on the apartment; the caller
-    // process should keep COM initialized for the lifetime of usage.
-    *out_taskbar = taskbar;
-    return true;
+    cached_taskbar = taskbar;
+    return cached_taskbar;
   }
 };
 
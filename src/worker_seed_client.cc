@@ -0,0 +1,53 @@
+#include "novebrowse/worker_seed_client.h"
+
+#include "novebrowse/blink_fingerprint_manager.h"
+#include "third_party/blink/renderer/core/execution_context/execution_context.h"
+#include "third_party/blink/renderer/core/frame/local_dom_window.h"
+#include "third_party/blink/renderer/core/frame/local_frame.h"
+#include "third_party/blink/renderer/core/workers/worker_global_scope.h"
+#include "third_party/blink/renderer/platform/wtf/casting.h"
+
+namespace novebrowse {
+
+const char WorkerSeedClient::kSupplementName[] = "NoveBrowseWorkerSeedClient";
+
+// static
+void WorkerSeedClient::ProvideForWorker(blink::WorkerClients& clients,
+                                        blink::ExecutionContext* parent) {
+  uint64_t profile_seed = 0;
+  if (auto* window = blink::DynamicTo<blink::LocalDOMWindow>(parent)) {
+    blink::LocalFrame* frame = window->GetFrame();
+    if (!frame) {
+      return;
+    }
+    profile_seed = BlinkFingerprintManager::FromFrame(frame)->GetProfileSeed();
+  } else if (auto* scope = blink::DynamicTo<blink::WorkerGlobalScope>(parent)) {
+    // Nested workers inherit whatever their parent worker was given.
+    WorkerSeedClient* parent_client = From(scope->Clients());
+    if (!parent_client) {
+      return;
+    }
+    profile_seed = parent_client->profile_seed();
+  } else {
+    return;
+  }
+  
+  Supplement<blink::WorkerClients>::ProvideTo(
+      clients, blink::MakeGarbageCollected<WorkerSeedClient>(clients, profile_seed));
+}
+
+// static
+WorkerSeedClient* WorkerSeedClient::From(blink::WorkerClients* clients) {
+  return clients ? Supplement<blink::WorkerClients>::From<WorkerSeedClient>(*clients)
+                 : nullptr;
+}
+
+WorkerSeedClient::WorkerSeedClient(blink::WorkerClients& clients,
+                                   uint64_t profile_seed)
+    : Supplement<blink::WorkerClients>(clients), profile_seed_(profile_seed) {}
+
+void WorkerSeedClient::Trace(blink::Visitor* visitor) const {
+  Supplement<blink::WorkerClients>::Trace(visitor);
+}
+
+}  // namespace novebrowse
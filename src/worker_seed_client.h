@@ -0,0 +1,47 @@
+#ifndef NOVEBROWSE_WORKER_SEED_CLIENT_H_
+#define NOVEBROWSE_WORKER_SEED_CLIENT_H_
+
+#include <stdint.h>
+
+#include "third_party/blink/renderer/core/workers/worker_clients.h"
+#include "third_party/blink/renderer/platform/heap/garbage_collected.h"
+#include "third_party/blink/renderer/platform/supplementable.h"
+
+namespace blink {
+class ExecutionContext;
+}
+
+namespace novebrowse {
+
+// Worker的配置种子 - 创建Worker时在父线程上记下父文档（或父Worker）的配置种子，
+// 随WorkerClients交给Worker线程
+//
+// Worker没有Frame可查，靠它与创建它的页面使用同一配置的噪声。共享Worker和
+// Service Worker不经由单个文档创建，没有此对象时回退到默认配置。
+class WorkerSeedClient final
+    : public blink::GarbageCollected<WorkerSeedClient>,
+      public blink::Supplement<blink::WorkerClients> {
+ public:
+  static const char kSupplementName[];
+  
+  // 在父线程上调用；父上下文没有可用的种子时不提供
+  static void ProvideForWorker(blink::WorkerClients& clients,
+                               blink::ExecutionContext* parent);
+  
+  // 没有提供时返回nullptr
+  static WorkerSeedClient* From(blink::WorkerClients* clients);
+  
+  WorkerSeedClient(blink::WorkerClients& clients, uint64_t profile_seed);
+  
+  uint64_t profile_seed() const { return profile_seed_; }
+  
+  void Trace(blink::Visitor* visitor) const override;
+  
+ private:
+  // 创建后不变，Worker线程只读
+  const uint64_t profile_seed_;
+};
+
+}  // namespace novebrowse
+
+#endif  // NOVEBROWSE_WORKER_SEED_CLIENT_H_
@@ -0,0 +1,87 @@
+// Cost of offline audio noise per render quantum, as a share of the
+// quantum's real-time budget at 48 kHz.
+
+#include <cmath>
+#include <string>
+
+#include "base/memory/scoped_refptr.h"
+#include "base/timer/elapsed_timer.h"
+#include "novebrowse/audio_fingerprint_protection.h"
+#include "novebrowse/audio_noise_kernel.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/blink/renderer/platform/audio/audio_bus.h"
+
+namespace novebrowse {
+
+namespace {
+
+constexpr int kIterations = 200000;
+constexpr int kWarmupIterations = 10000;
+
+constexpr size_t kRenderQuantumFrames = 128;
+constexpr double kSampleRate = 48000.0;
+
+// Protection may add at most this share of a quantum's budget.
+constexpr double kMaxBudgetPercent = 1.0;
+
+constexpr char kMetricPrefix[] = "AudioNoise.";
+constexpr char kMetricRenderQuantum[] = ".render_quantum";
+constexpr char kMetricBudgetShare[] = ".budget_share";
+
+// Returns nanoseconds per render quantum. Frame offsets advance as in a real
+// render, so every quantum hashes fresh indices.
+double TimeRenderQuanta(const AudioNoiseParams& params, blink::AudioBus* bus) {
+  for (int i = 0; i < kWarmupIterations; ++i) {
+    AudioFingerprintProtection::ProcessRenderQuantum(
+        params, bus, kRenderQuantumFrames, i * kRenderQuantumFrames);
+  }
+  
+  base::ElapsedTimer timer;
+  for (int i = 0; i < kIterations; ++i) {
+    AudioFingerprintProtection::ProcessRenderQuantum(
+        params, bus, kRenderQuantumFrames, i * kRenderQuantumFrames);
+  }
+  return timer.Elapsed().InNanosecondsF() / kIterations;
+}
+
+void RunAndReport(const std::string& story, unsigned channel_count) {
+  AudioNoiseParams params;
+  params.enabled = true;
+  params.seed = 0x5eed;
+  params.gain_amplitude = AudioNoiseKernel::GainAmplitudeForNoiseLevel(0.001);
+  AudioNoiseKernel::Initialize();
+  
+  scoped_refptr<blink::AudioBus> bus =
+      blink::AudioBus::Create(channel_count, kRenderQuantumFrames);
+  for (unsigned channel = 0; channel < channel_count; ++channel) {
+    float* samples = bus->Channel(channel)->MutableData();
+    for (size_t i = 0; i < kRenderQuantumFrames; ++i) {
+      samples[i] = std::sin(0.05f * static_cast<float>(i + channel));
+    }
+  }
+  
+  double quantum_ns = TimeRenderQuanta(params, bus.get());
+  double budget_ns = kRenderQuantumFrames / kSampleRate * 1e9;
+  double budget_percent = quantum_ns / budget_ns * 100.0;
+  
+  perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+  reporter.RegisterImportantMetric(kMetricRenderQuantum, "ns");
+  reporter.RegisterImportantMetric(kMetricBudgetShare, "%");
+  reporter.AddResult(kMetricRenderQuantum, quantum_ns);
+  reporter.AddResult(kMetricBudgetShare, budget_percent);
+  
+  EXPECT_LT(budget_percent, kMaxBudgetPercent);
+}
+
+}  // namespace
+
+TEST(AudioNoisePerfTest, Stereo) {
+  RunAndReport("stereo", 2);
+}
+
+TEST(AudioNoisePerfTest, Surround) {
+  RunAndReport("5.1", 6);
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,174 @@
+// Every field of the cache keys must take part in lookups, and a draw
+// (a new content generation) must drop what was cached before it.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "novebrowse/canvas_noise_cache.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace novebrowse {
+
+namespace {
+
+CanvasNoiseCache::ImageDataKey MakeImageDataKey() {
+  CanvasNoiseCache::ImageDataKey key;
+  key.generation = 3;
+  key.seed = 0x1234;
+  key.noise_level = 0.1;
+  key.canvas_width = 300;
+  key.canvas_height = 150;
+  key.x = 10;
+  key.y = 20;
+  key.width = 16;
+  key.height = 8;
+  return key;
+}
+
+CanvasNoiseCache::DataURLKey MakeDataURLKey() {
+  CanvasNoiseCache::DataURLKey key;
+  key.generation = 3;
+  key.seed = 0x1234;
+  key.noise_level = 0.1;
+  key.canvas_width = 300;
+  key.canvas_height = 150;
+  key.mime_type = 1;
+  key.quality = 0.92;
+  return key;
+}
+
+std::vector<uint8_t> Pixels(size_t size, uint8_t value) {
+  return std::vector<uint8_t>(size, value);
+}
+
+}  // namespace
+
+TEST(CanvasNoiseCacheTest, FindsStoredImageData) {
+  CanvasNoiseCache cache;
+  std::vector<uint8_t> pixels = Pixels(16 * 8 * 4, 7);
+  cache.StoreImageData(MakeImageDataKey(), pixels);
+
+  base::span<const uint8_t> found = cache.FindImageData(MakeImageDataKey());
+  ASSERT_EQ(found.size(), pixels.size());
+  EXPECT_TRUE(std::equal(found.begin(), found.end(), pixels.begin()));
+  EXPECT_EQ(cache.memory_usage(), pixels.size());
+}
+
+// Each field on its own distinguishes entries of the same generation.
+TEST(CanvasNoiseCacheTest, ImageDataKeyFieldsDistinguishEntries) {
+  using Key = CanvasNoiseCache::ImageDataKey;
+  void (*const kMutations[])(Key&) = {
+      [](Key& key) { key.seed ^= 1; },
+      [](Key& key) { key.noise_level += 0.05; },
+      [](Key& key) { key.canvas_width += 1; },
+      [](Key& key) { key.canvas_height += 1; },
+      [](Key& key) { key.x += 1; },
+      [](Key& key) { key.y += 1; },
+      [](Key& key) { key.width += 1; },
+      [](Key& key) { key.height += 1; },
+      [](Key& key) { key.color_space += 1; },
+      [](Key& key) { key.storage_format += 1; },
+  };
+
+  for (size_t i = 0; i < std::size(kMutations); ++i) {
+    SCOPED_TRACE(i);
+    CanvasNoiseCache cache;
+    cache.StoreImageData(MakeImageDataKey(), Pixels(64, 1));
+
+    Key other = MakeImageDataKey();
+    kMutations[i](other);
+    EXPECT_FALSE(other == MakeImageDataKey());
+    EXPECT_TRUE(cache.FindImageData(other).empty());
+    EXPECT_FALSE(cache.FindImageData(MakeImageDataKey()).empty());
+  }
+}
+
+TEST(CanvasNoiseCacheTest, DataURLKeyFieldsDistinguishEntries) {
+  using Key = CanvasNoiseCache::DataURLKey;
+  void (*const kMutations[])(Key&) = {
+      [](Key& key) { key.seed ^= 1; },
+      [](Key& key) { key.noise_level += 0.05; },
+      [](Key& key) { key.canvas_width += 1; },
+      [](Key& key) { key.canvas_height += 1; },
+      [](Key& key) { key.mime_type += 1; },
+      [](Key& key) { key.quality -= 0.1; },
+  };
+
+  for (size_t i = 0; i < std::size(kMutations); ++i) {
+    SCOPED_TRACE(i);
+    CanvasNoiseCache cache;
+    cache.StoreDataURL(MakeDataURLKey(), "data:image/png;base64,AAAA");
+
+    Key other = MakeDataURLKey();
+    kMutations[i](other);
+    EXPECT_FALSE(other == MakeDataURLKey());
+    EXPECT_TRUE(cache.FindDataURL(other).IsNull());
+    EXPECT_EQ(cache.FindDataURL(MakeDataURLKey()), "data:image/png;base64,AAAA");
+  }
+}
+
+// A lookup with a newer generation drops both kinds of entries.
+TEST(CanvasNoiseCacheTest, NewGenerationDropsEntries) {
+  CanvasNoiseCache cache;
+  cache.StoreImageData(MakeImageDataKey(), Pixels(64, 1));
+  cache.StoreDataURL(MakeDataURLKey(), "data:image/png;base64,AAAA");
+  ASSERT_GT(cache.memory_usage(), 0u);
+
+  CanvasNoiseCache::ImageDataKey next = MakeImageDataKey();
+  next.generation++;
+  EXPECT_TRUE(cache.FindImageData(next).empty());
+  EXPECT_EQ(cache.memory_usage(), 0u);
+  EXPECT_TRUE(cache.FindImageData(MakeImageDataKey()).empty());
+  EXPECT_TRUE(cache.FindDataURL(MakeDataURLKey()).IsNull());
+}
+
+// Over the limit the least recently used entry goes first.
+TEST(CanvasNoiseCacheTest, EvictsLeastRecentlyUsed) {
+  CanvasNoiseCache cache;
+  cache.SetMemoryLimit(CanvasNoiseCache::process_memory_usage() + 200);
+
+  CanvasNoiseCache::ImageDataKey first = MakeImageDataKey();
+  CanvasNoiseCache::ImageDataKey second = MakeImageDataKey();
+  second.x++;
+  CanvasNoiseCache::ImageDataKey third = MakeImageDataKey();
+  third.x += 2;
+
+  cache.StoreImageData(first, Pixels(80, 1));
+  cache.StoreImageData(second, Pixels(80, 2));
+  ASSERT_FALSE(cache.FindImageData(first).empty());
+
+  cache.StoreImageData(third, Pixels(80, 3));
+  EXPECT_FALSE(cache.FindImageData(first).empty());
+  EXPECT_TRUE(cache.FindImageData(second).empty());
+  EXPECT_FALSE(cache.FindImageData(third).empty());
+  EXPECT_EQ(cache.memory_usage(), 160u);
+}
+
+TEST(CanvasNoiseCacheTest, SkipsEntriesLargerThanTheLimit) {
+  CanvasNoiseCache cache;
+  cache.SetMemoryLimit(32);
+  cache.StoreImageData(MakeImageDataKey(), Pixels(64, 1));
+
+  EXPECT_TRUE(cache.FindImageData(MakeImageDataKey()).empty());
+  EXPECT_EQ(cache.memory_usage(), 0u);
+}
+
+TEST(CanvasNoiseCacheTest, ClearReleasesProcessUsage) {
+  size_t baseline = CanvasNoiseCache::process_memory_usage();
+  {
+    CanvasNoiseCache cache;
+    cache.StoreImageData(MakeImageDataKey(), Pixels(64, 1));
+    EXPECT_EQ(CanvasNoiseCache::process_memory_usage(), baseline + 64);
+
+    cache.Clear();
+    EXPECT_EQ(CanvasNoiseCache::process_memory_usage(), baseline);
+
+    cache.StoreImageData(MakeImageDataKey(), Pixels(64, 1));
+  }
+  EXPECT_EQ(CanvasNoiseCache::process_memory_usage(), baseline);
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,96 @@
+// The dispatched row kernel (AVX2, SSE4.1 or NEON, whichever the CPU has)
+// must match ApplyToRowScalar bit for bit, since exports from machines with
+// different CPUs have to carry identical noise.
+
+#include <stdint.h>
+
+#include <random>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "novebrowse/canvas_noise_kernel.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace novebrowse {
+
+namespace {
+
+// Covers every tail length of the 4- and 8-pixel loops, plus a long row.
+constexpr int kMaxShortWidth = 35;
+constexpr int kLongWidth = 1921;
+
+constexpr int kAmplitudes[] = {1, 2, 10, 127, 255, 300};
+constexpr int kRowsPerCase = 4;
+
+std::vector<uint8_t> RandomRow(std::mt19937& rng, int width) {
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::vector<uint8_t> row(static_cast<size_t>(width) * 4);
+  for (uint8_t& value : row) {
+    value = static_cast<uint8_t>(byte(rng));
+  }
+  return row;
+}
+
+void ExpectMatchesScalar(std::mt19937& rng, int width, int amplitude) {
+  std::uniform_int_distribution<uint32_t> seed_dist;
+  std::uniform_int_distribution<int> origin_dist(-4096, 4096);
+  for (int i = 0; i < kRowsPerCase; ++i) {
+    uint32_t seed = seed_dist(rng);
+    int x_origin = origin_dist(rng);
+    int y = origin_dist(rng);
+    std::vector<uint8_t> expected = RandomRow(rng, width);
+    std::vector<uint8_t> actual = expected;
+
+    CanvasNoiseKernel::ApplyToRowScalar(expected.data(), width, x_origin, y, seed,
+                                        amplitude);
+    CanvasNoiseKernel::ApplyToRow(actual.data(), width, x_origin, y, seed,
+                                  amplitude);
+    ASSERT_EQ(expected, actual) << base::StringPrintf(
+        "width=%d amplitude=%d seed=%u x_origin=%d y=%d", width, amplitude, seed,
+        x_origin, y);
+  }
+}
+
+}  // namespace
+
+TEST(CanvasNoiseKernelTest, ShortRowsMatchScalar) {
+  std::mt19937 rng(0x5eed);
+  for (int amplitude : kAmplitudes) {
+    for (int width = 1; width <= kMaxShortWidth; ++width) {
+      ExpectMatchesScalar(rng, width, amplitude);
+    }
+  }
+}
+
+TEST(CanvasNoiseKernelTest, LongRowMatchesScalar) {
+  std::mt19937 rng(0xca57);
+  for (int amplitude : kAmplitudes) {
+    ExpectMatchesScalar(rng, kLongWidth, amplitude);
+  }
+}
+
+// Fully saturated pixels exercise the clamp in both directions.
+TEST(CanvasNoiseKernelTest, SaturatedPixelsMatchScalar) {
+  for (uint8_t fill : {uint8_t{0}, uint8_t{255}}) {
+    for (int width : {1, 7, 8, 9, 33}) {
+      std::vector<uint8_t> expected(static_cast<size_t>(width) * 4, fill);
+      std::vector<uint8_t> actual = expected;
+      CanvasNoiseKernel::ApplyToRowScalar(expected.data(), width, 3, 5, 0x5eed, 255);
+      CanvasNoiseKernel::ApplyToRow(actual.data(), width, 3, 5, 0x5eed, 255);
+      EXPECT_EQ(expected, actual) << "fill=" << int{fill} << " width=" << width;
+    }
+  }
+}
+
+// The alpha byte is never touched.
+TEST(CanvasNoiseKernelTest, AlphaUnchanged) {
+  std::mt19937 rng(0xa1fa);
+  std::vector<uint8_t> row = RandomRow(rng, kLongWidth);
+  std::vector<uint8_t> original = row;
+  CanvasNoiseKernel::ApplyToRow(row.data(), kLongWidth, 0, 0, 0x5eed, 255);
+  for (size_t i = 3; i < row.size(); i += 4) {
+    ASSERT_EQ(original[i], row[i]) << "pixel " << i / 4;
+  }
+}
+
+}  // namespace novebrowse
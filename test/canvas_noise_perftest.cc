@@ -0,0 +1,121 @@
+// Cost of canvas pixel noise per export at common canvas sizes, through the
+// region entry point used by getImageData and the SkBitmap one used by
+// toDataURL.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/check.h"
+#include "base/test/task_environment.h"
+#include "base/timer/elapsed_timer.h"
+#include "novebrowse/canvas_fingerprint_protection.h"
+#include "novebrowse/fingerprint_config.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkImageInfo.h"
+
+namespace novebrowse {
+
+namespace {
+
+// Each size runs for about this many pixels in total, so small canvases
+// get enough iterations to time and 4K ones do not take minutes.
+constexpr int64_t kPixelBudget = int64_t{1} << 28;
+constexpr int kMinIterations = 8;
+
+constexpr uint32_t kSeed = 0x5eed;
+
+constexpr char kMetricPrefix[] = "CanvasNoise.";
+constexpr char kMetricProcessPixelData[] = ".process_pixel_data";
+constexpr char kMetricProcessPixelDataSerial[] = ".process_pixel_data_serial";
+constexpr char kMetricAddCanvasNoise[] = ".add_canvas_noise";
+constexpr char kMetricThroughput[] = ".throughput";
+
+int IterationsFor(int width, int height) {
+  return static_cast<int>(
+      std::max<int64_t>(kMinIterations,
+                        kPixelBudget / (static_cast<int64_t>(width) * height)));
+}
+
+class CanvasNoisePerfTest : public testing::Test {
+ protected:
+  // Returns microseconds per call; one untimed call warms the pixels and
+  // selects the kernel.
+  double TimeProcessPixelData(int width, int height, const CanvasConfig& config) {
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4, 0x80);
+    CanvasPixelRegion region;
+    region.pixels = pixels.data();
+    region.width = width;
+    region.height = height;
+    region.row_bytes = static_cast<size_t>(width) * 4;
+    
+    CanvasFingerprintProtection::ProcessPixelData(region, kSeed, config);
+    
+    int iterations = IterationsFor(width, height);
+    base::ElapsedTimer timer;
+    for (int i = 0; i < iterations; ++i) {
+      CanvasFingerprintProtection::ProcessPixelData(region, kSeed, config);
+    }
+    return timer.Elapsed().InMicrosecondsF() / iterations;
+  }
+  
+  double TimeAddCanvasNoise(int width, int height, const CanvasConfig& config) {
+    SkBitmap bitmap;
+    CHECK(bitmap.tryAllocPixels(SkImageInfo::Make(
+        width, height, kRGBA_8888_SkColorType, kPremul_SkAlphaType)));
+    bitmap.eraseARGB(0xFF, 0x80, 0x80, 0x80);
+    
+    CanvasFingerprintProtection::AddCanvasNoise(bitmap, kSeed, config);
+    
+    int iterations = IterationsFor(width, height);
+    base::ElapsedTimer timer;
+    for (int i = 0; i < iterations; ++i) {
+      CanvasFingerprintProtection::AddCanvasNoise(bitmap, kSeed, config);
+    }
+    return timer.Elapsed().InMicrosecondsF() / iterations;
+  }
+  
+  void RunAndReport(const std::string& story, int width, int height) {
+    CanvasConfig config;
+    CanvasConfig serial_config;
+    serial_config.parallel_max_threads = 1;
+    
+    double process_us = TimeProcessPixelData(width, height, config);
+    double serial_us = TimeProcessPixelData(width, height, serial_config);
+    double bitmap_us = TimeAddCanvasNoise(width, height, config);
+    double megabytes = static_cast<double>(width) * height * 4 / (1024.0 * 1024.0);
+    
+    perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+    reporter.RegisterImportantMetric(kMetricProcessPixelData, "us");
+    reporter.RegisterImportantMetric(kMetricProcessPixelDataSerial, "us");
+    reporter.RegisterImportantMetric(kMetricAddCanvasNoise, "us");
+    reporter.RegisterImportantMetric(kMetricThroughput, "MB/s");
+    reporter.AddResult(kMetricProcessPixelData, process_us);
+    reporter.AddResult(kMetricProcessPixelDataSerial, serial_us);
+    reporter.AddResult(kMetricAddCanvasNoise, bitmap_us);
+    reporter.AddResult(kMetricThroughput, megabytes / (process_us / 1e6));
+  }
+  
+  // Large canvases are split into row bands on the thread pool.
+  base::test::TaskEnvironment task_environment_;
+};
+
+}  // namespace
+
+TEST_F(CanvasNoisePerfTest, Size256) {
+  RunAndReport("256x256", 256, 256);
+}
+
+TEST_F(CanvasNoisePerfTest, Size1080p) {
+  RunAndReport("1080p", 1920, 1080);
+}
+
+TEST_F(CanvasNoisePerfTest, Size4K) {
+  RunAndReport("4k", 3840, 2160);
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,229 @@
+// Compiled stores are memory-mapped and read in place, so Open() has to
+// reject any file whose header or references point outside the mapping.
+// The files are written here byte by byte in the layout
+// scripts/compile_profiles.py produces.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/stringprintf.h"
+#include "novebrowse/compiled_profile_store.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace novebrowse {
+
+namespace {
+
+// Header field offsets, in the order of CompiledProfileStore::Header.
+constexpr size_t kFormatVersionOffset = 8;
+constexpr size_t kKindOffset = 12;
+constexpr size_t kRecordCountOffset = 16;
+constexpr size_t kRecordSizeOffset = 20;
+constexpr size_t kBucketCountOffset = 24;
+constexpr size_t kBucketsOffsetOffset = 28;
+constexpr size_t kRecordsOffsetOffset = 32;
+constexpr size_t kStringRefsOffsetOffset = 36;
+constexpr size_t kStringRefsCountOffset = 40;
+constexpr size_t kStringsOffsetOffset = 44;
+constexpr size_t kStringsSizeOffset = 48;
+constexpr size_t kFileSizeOffset = 52;
+constexpr uint32_t kHeaderSize = 64;
+
+// One behavior pattern named "calm": two buckets, one record, no string
+// references and a four-byte string pool.
+constexpr char kPatternName[] = "calm";
+constexpr uint32_t kPatternNameLength = 4;
+constexpr uint32_t kBucketCount = 2;
+constexpr uint32_t kBucketsOffset = kHeaderSize;
+constexpr uint32_t kRecordsOffset = kBucketsOffset + 4 * kBucketCount;
+constexpr uint32_t kRecordSize = 120;
+constexpr uint32_t kStringsOffset = kRecordsOffset + kRecordSize;
+constexpr uint32_t kFileSize = kStringsOffset + kPatternNameLength;
+
+// Offsets inside BehaviorPatternRecord.
+constexpr size_t kNameLengthOffset = 4;
+constexpr size_t kMovementSpeedOffset = 16;
+constexpr size_t kFieldsOffset = 108;
+
+uint32_t HashName(std::string_view name) {
+  uint32_t hash = 0x811C9DC5u;
+  for (char c : name) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x01000193u;
+  }
+  return hash;
+}
+
+void Put32(std::vector<uint8_t>& file, size_t offset, uint32_t value) {
+  memcpy(file.data() + offset, &value, sizeof(value));
+}
+
+std::vector<uint8_t> BuildPatternStore() {
+  std::vector<uint8_t> file(kFileSize, 0);
+  memcpy(file.data(), "NVBSTORE", 8);
+  Put32(file, kFormatVersionOffset, CompiledProfileStore::kFormatVersion);
+  Put32(file, kKindOffset,
+        static_cast<uint32_t>(CompiledProfileStore::Kind::kBehaviorPatterns));
+  Put32(file, kRecordCountOffset, 1);
+  Put32(file, kRecordSizeOffset, kRecordSize);
+  Put32(file, kBucketCountOffset, kBucketCount);
+  Put32(file, kBucketsOffsetOffset, kBucketsOffset);
+  Put32(file, kRecordsOffsetOffset, kRecordsOffset);
+  Put32(file, kStringRefsOffsetOffset, kStringsOffset);
+  Put32(file, kStringRefsCountOffset, 0);
+  Put32(file, kStringsOffsetOffset, kStringsOffset);
+  Put32(file, kStringsSizeOffset, kPatternNameLength);
+  Put32(file, kFileSizeOffset, kFileSize);
+
+  uint32_t slot = HashName(kPatternName) & (kBucketCount - 1);
+  Put32(file, kBucketsOffset + 4 * slot, 1);
+
+  // name = {0, 4}; only movement_speed is present.
+  Put32(file, kRecordsOffset + kNameLengthOffset, kPatternNameLength);
+  double movement_speed = 2.5;
+  memcpy(file.data() + kRecordsOffset + kMovementSpeedOffset, &movement_speed,
+         sizeof(movement_speed));
+  Put32(file, kRecordsOffset + kFieldsOffset, 1u << 0);
+
+  memcpy(file.data() + kStringsOffset, kPatternName, kPatternNameLength);
+  return file;
+}
+
+class CompiledProfileStoreTest : public testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  scoped_refptr<const CompiledProfileStore> Open(
+      const std::vector<uint8_t>& file,
+      CompiledProfileStore::Kind kind =
+          CompiledProfileStore::Kind::kBehaviorPatterns) {
+    base::FilePath path = temp_dir_.GetPath().AppendASCII(
+        base::StringPrintf("store_%d.bin", file_index_++));
+    EXPECT_TRUE(base::WriteFile(path, file));
+    return CompiledProfileStore::Open(path, kind);
+  }
+
+  base::ScopedTempDir temp_dir_;
+  int file_index_ = 0;
+};
+
+}  // namespace
+
+// The hand-built file is valid, so the failures below come from the one
+// field each of them breaks.
+TEST_F(CompiledProfileStoreTest, OpensValidStore) {
+  scoped_refptr<const CompiledProfileStore> store = Open(BuildPatternStore());
+  ASSERT_TRUE(store);
+  EXPECT_EQ(store->kind(), CompiledProfileStore::Kind::kBehaviorPatterns);
+  ASSERT_EQ(store->size(), 1u);
+  EXPECT_EQ(store->NameAt(0), kPatternName);
+
+  std::optional<CompiledProfileStore::BehaviorPatternView> view =
+      store->FindBehaviorPattern(kPatternName);
+  ASSERT_TRUE(view);
+  EXPECT_TRUE(view->description().empty());
+
+  BehaviorPattern pattern = view->ToBehaviorPattern();
+  EXPECT_EQ(pattern.name, kPatternName);
+  EXPECT_EQ(pattern.mouse.movement_speed, 2.5);
+  EXPECT_EQ(pattern.keyboard.typing_speed_wpm,
+            BehaviorPattern().keyboard.typing_speed_wpm);
+
+  EXPECT_FALSE(store->FindBehaviorPattern("calmer"));
+  EXPECT_FALSE(store->FindBehaviorPattern(""));
+}
+
+TEST_F(CompiledProfileStoreTest, RejectsMissingFile) {
+  EXPECT_FALSE(CompiledProfileStore::Open(
+      temp_dir_.GetPath().AppendASCII("missing.bin"),
+      CompiledProfileStore::Kind::kBehaviorPatterns));
+}
+
+TEST_F(CompiledProfileStoreTest, RejectsWrongKind) {
+  EXPECT_FALSE(Open(BuildPatternStore(),
+                    CompiledProfileStore::Kind::kDeviceProfiles));
+}
+
+// Every truncation, including one that leaves a complete header, fails
+// the file size check or the header size check.
+TEST_F(CompiledProfileStoreTest, RejectsTruncatedFile) {
+  const std::vector<uint8_t> file = BuildPatternStore();
+  for (uint32_t length : {1u, kHeaderSize - 1, kHeaderSize, kRecordsOffset,
+                          kStringsOffset, kFileSize - 1}) {
+    SCOPED_TRACE(length);
+    EXPECT_FALSE(Open(std::vector<uint8_t>(file.begin(), file.begin() + length)));
+  }
+}
+
+TEST_F(CompiledProfileStoreTest, RejectsTrailingBytes) {
+  std::vector<uint8_t> file = BuildPatternStore();
+  file.push_back(0);
+  EXPECT_FALSE(Open(file));
+}
+
+TEST_F(CompiledProfileStoreTest, RejectsBadMagic) {
+  std::vector<uint8_t> file = BuildPatternStore();
+  file[0] = 'X';
+  EXPECT_FALSE(Open(file));
+}
+
+// Corrupt header fields, one at a time.
+TEST_F(CompiledProfileStoreTest, RejectsCorruptHeader) {
+  struct Corruption {
+    const char* name;
+    size_t offset;
+    uint32_t value;
+  };
+  const Corruption kCorruptions[] = {
+      {"format_version", kFormatVersionOffset,
+       CompiledProfileStore::kFormatVersion + 1},
+      {"record_size", kRecordSizeOffset, kRecordSize - 8},
+      {"record_count past the file", kRecordCountOffset, 2},
+      {"zero buckets", kBucketCountOffset, 0},
+      {"bucket_count not a power of two", kBucketCountOffset, 3},
+      {"bucket_count not above record_count", kBucketCountOffset, 1},
+      {"misaligned buckets", kBucketsOffsetOffset, kBucketsOffset + 4},
+      {"misaligned records", kRecordsOffsetOffset, kRecordsOffset + 4},
+      {"records past the file", kRecordsOffsetOffset, kStringsOffset},
+      {"string refs past the file", kStringRefsCountOffset, 1000},
+      {"misaligned string refs", kStringRefsOffsetOffset, kStringsOffset + 4},
+      {"strings past the file", kStringsSizeOffset, 5},
+      {"strings offset wraps", kStringsOffsetOffset, 0xFFFFFFFFu},
+  };
+
+  for (const Corruption& corruption : kCorruptions) {
+    SCOPED_TRACE(corruption.name);
+    std::vector<uint8_t> file = BuildPatternStore();
+    Put32(file, corruption.offset, corruption.value);
+    EXPECT_FALSE(Open(file));
+  }
+}
+
+// A bucket naming a record that does not exist would index past the
+// record table on lookup.
+TEST_F(CompiledProfileStoreTest, RejectsBucketPastRecords) {
+  std::vector<uint8_t> file = BuildPatternStore();
+  Put32(file, kBucketsOffset, 2);
+  EXPECT_FALSE(Open(file));
+}
+
+TEST_F(CompiledProfileStoreTest, RejectsRecordStringPastPool) {
+  std::vector<uint8_t> file = BuildPatternStore();
+  Put32(file, kRecordsOffset + kNameLengthOffset, kPatternNameLength + 1);
+  EXPECT_FALSE(Open(file));
+
+  // Offset and length that overflow 32 bits when added.
+  file = BuildPatternStore();
+  Put32(file, kRecordsOffset, 0xFFFFFFFFu);
+  EXPECT_FALSE(Open(file));
+}
+
+}  // namespace novebrowse
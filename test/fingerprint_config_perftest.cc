@@ -0,0 +1,87 @@
+// Cost of hashing and (de)serializing the shipped sample config, the work
+// done on every config load, hot reload and profile switch.
+
+#include <optional>
+#include <string>
+
+#include "base/check.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/path_service.h"
+#include "base/timer/elapsed_timer.h"
+#include "base/values.h"
+#include "novebrowse/fingerprint_config.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace novebrowse {
+
+namespace {
+
+constexpr int kIterations = 2000;
+constexpr int kWarmupIterations = 100;
+
+constexpr char kMetricPrefix[] = "FingerprintConfig.";
+constexpr char kMetricConfigHash[] = ".get_config_hash";
+constexpr char kMetricStructuralHash[] = ".get_structural_hash";
+constexpr char kMetricFromValue[] = ".from_value";
+constexpr char kMetricToValue[] = ".to_value";
+constexpr char kMetricParseJson[] = ".parse_json";
+
+// Runs |body| in a loop and returns microseconds per iteration.
+template <typename Body>
+double TimeLoop(Body body) {
+  for (int i = 0; i < kWarmupIterations; ++i) {
+    body();
+  }
+  
+  base::ElapsedTimer timer;
+  for (int i = 0; i < kIterations; ++i) {
+    body();
+  }
+  return timer.Elapsed().InMicrosecondsF() / kIterations;
+}
+
+std::string ReadSampleConfig(const char* name) {
+  base::FilePath path = base::PathService::CheckedGet(base::DIR_SRC_TEST_DATA_ROOT)
+                            .AppendASCII("novebrowse")
+                            .AppendASCII("config")
+                            .AppendASCII(name);
+  std::string contents;
+  CHECK(base::ReadFileToString(path, &contents)) << path;
+  return contents;
+}
+
+}  // namespace
+
+TEST(FingerprintConfigPerfTest, SampleConfig) {
+  const std::string json = ReadSampleConfig("fingerprint_config.json");
+  std::optional<base::Value> value = base::JSONReader::Read(json);
+  ASSERT_TRUE(value);
+  
+  FingerprintConfig config = FingerprintConfig::FromValue(*value);
+  ASSERT_TRUE(config.IsValid());
+  
+  perf_test::PerfResultReporter reporter(kMetricPrefix, "fingerprint_config");
+  reporter.RegisterImportantMetric(kMetricConfigHash, "us");
+  reporter.RegisterImportantMetric(kMetricStructuralHash, "us");
+  reporter.RegisterImportantMetric(kMetricFromValue, "us");
+  reporter.RegisterImportantMetric(kMetricToValue, "us");
+  reporter.RegisterImportantMetric(kMetricParseJson, "us");
+  
+  reporter.AddResult(kMetricConfigHash,
+                     TimeLoop([&] { config.GetConfigHash(); }));
+  reporter.AddResult(kMetricStructuralHash,
+                     TimeLoop([&] { config.GetStructuralHash(); }));
+  reporter.AddResult(kMetricFromValue,
+                     TimeLoop([&] { FingerprintConfig::FromValue(*value); }));
+  reporter.AddResult(kMetricToValue, TimeLoop([&] { config.ToValue(); }));
+  // Everything LoadConfig does before validation.
+  reporter.AddResult(kMetricParseJson, TimeLoop([&] {
+                       std::optional<base::Value> parsed = base::JSONReader::Read(json);
+                       FingerprintConfig::FromValue(*parsed);
+                     }));
+}
+
+}  // namespace novebrowse
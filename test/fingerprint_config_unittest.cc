@@ -0,0 +1,106 @@
+// GetStructuralHash() keys the renderer's shared SpoofRecords and the
+// browser's config caches, so equal configs must hash equally and any
+// field that changes behavior must change the hash.
+
+#include <stdint.h>
+
+#include <iterator>
+
+#include "novebrowse/fingerprint_config.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace novebrowse {
+
+namespace {
+
+FingerprintConfig MakeConfig() {
+  FingerprintConfig config;
+  config.profile_name = "windows_chrome";
+  config.noise_seed = 42;
+  config.webgl.parameters["MAX_TEXTURE_SIZE"] = "16384";
+  config.webgl.parameters["MAX_VIEWPORT_DIMS"] = "32767,32767";
+  config.font.font_metrics_offsets["Arial"] = 0.1;
+  config.font.font_metrics_offsets["Verdana"] = 0.2;
+  return config;
+}
+
+}  // namespace
+
+TEST(FingerprintConfigTest, StructuralHashIsStable) {
+  EXPECT_EQ(MakeConfig().GetStructuralHash(), MakeConfig().GetStructuralHash());
+  EXPECT_EQ(FingerprintConfig().GetStructuralHash(),
+            FingerprintConfig().GetStructuralHash());
+}
+
+// Re-saving an unchanged profile only touches the timestamps.
+TEST(FingerprintConfigTest, StructuralHashIgnoresTimestamps) {
+  FingerprintConfig config = MakeConfig();
+  config.created_at = "2024-01-01T00:00:00Z";
+  config.updated_at = "2024-06-01T00:00:00Z";
+  EXPECT_EQ(config.GetStructuralHash(), MakeConfig().GetStructuralHash());
+}
+
+// Maps iterate in unspecified order; the hash must not depend on it.
+TEST(FingerprintConfigTest, StructuralHashIgnoresMapOrder) {
+  FingerprintConfig config = MakeConfig();
+  config.webgl.parameters.clear();
+  config.webgl.parameters["MAX_VIEWPORT_DIMS"] = "32767,32767";
+  config.webgl.parameters["MAX_TEXTURE_SIZE"] = "16384";
+  config.webgl.parameters.rehash(64);
+  config.font.font_metrics_offsets.rehash(64);
+  EXPECT_EQ(config.GetStructuralHash(), MakeConfig().GetStructuralHash());
+}
+
+// One field from each section, including those ToValue() leaves out.
+TEST(FingerprintConfigTest, StructuralHashCoversSections) {
+  using Mutation = void (*)(FingerprintConfig&);
+  const Mutation kMutations[] = {
+      [](FingerprintConfig& c) { c.enabled = !c.enabled; },
+      [](FingerprintConfig& c) { c.profile_name += "_2"; },
+      [](FingerprintConfig& c) { c.noise_seed++; },
+      [](FingerprintConfig& c) { c.canvas.noise_level += 0.01; },
+      [](FingerprintConfig& c) { c.webgl.renderer += " "; },
+      [](FingerprintConfig& c) { c.webgl.parameters["MAX_TEXTURE_SIZE"] = "8192"; },
+      [](FingerprintConfig& c) { c.navigator.platform += " "; },
+      [](FingerprintConfig& c) { c.navigator.languages.push_back("de"); },
+      [](FingerprintConfig& c) { c.audio.enabled = !c.audio.enabled; },
+      [](FingerprintConfig& c) { c.font.font_metrics_offsets["Arial"] = 0.3; },
+      [](FingerprintConfig& c) { c.font.available_fonts.push_back("Tahoma"); },
+      [](FingerprintConfig& c) { c.webrtc.fake_public_ip = "1.1.1.1"; },
+      [](FingerprintConfig& c) { c.geolocation.latitude += 1.0; },
+      [](FingerprintConfig& c) { c.screen.width += 1; },
+      [](FingerprintConfig& c) { c.anti_detection.enabled = !c.anti_detection.enabled; },
+      [](FingerprintConfig& c) { c.custom_js_injections.push_back("void 0;"); },
+  };
+
+  const uint64_t base_hash = MakeConfig().GetStructuralHash();
+  for (size_t i = 0; i < std::size(kMutations); ++i) {
+    SCOPED_TRACE(i);
+    FingerprintConfig config = MakeConfig();
+    kMutations[i](config);
+    EXPECT_NE(config.GetStructuralHash(), base_hash);
+  }
+}
+
+// Adjacent strings are length-prefixed, so moving a character across the
+// boundary changes the hash.
+TEST(FingerprintConfigTest, StructuralHashSeparatesAdjacentStrings) {
+  FingerprintConfig first = MakeConfig();
+  first.profile_name = "ab";
+  first.device_profile = "c";
+  FingerprintConfig second = MakeConfig();
+  second.profile_name = "a";
+  second.device_profile = "bc";
+  EXPECT_NE(first.GetStructuralHash(), second.GetStructuralHash());
+}
+
+TEST(FingerprintConfigTest, SnapshotKeepsHashAndGeneration) {
+  FingerprintConfig config = MakeConfig();
+  scoped_refptr<const FingerprintConfigSnapshot> snapshot =
+      FingerprintConfigSnapshot::Create(config, 7);
+  EXPECT_EQ(snapshot->generation(), 7u);
+  EXPECT_EQ(snapshot->structural_hash(), config.GetStructuralHash());
+  EXPECT_EQ(snapshot->GetStructuralHash(), config.GetStructuralHash());
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,130 @@
+// Telemetry batches come from renderers, so the browser-side parser has to
+// reject malformed batches and skip stats it does not know about.
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "base/time/time.h"
+#include "novebrowse/fingerprint_stats.h"
+#include "novebrowse/fingerprint_telemetry.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace novebrowse {
+
+namespace {
+
+struct ParsedRecord {
+  FingerprintStat stat;
+  TelemetryRecord record;
+};
+
+int Parse(const std::vector<uint8_t>& batch, std::vector<ParsedRecord>* parsed) {
+  return ForEachTelemetryRecord(
+      batch, [parsed](FingerprintStat stat, const TelemetryRecord& record) {
+        parsed->push_back({stat, record});
+      });
+}
+
+std::vector<uint8_t> Serialize(const std::vector<TelemetryRecord>& records) {
+  std::vector<uint8_t> batch(records.size() * sizeof(TelemetryRecord));
+  if (!batch.empty()) {
+    memcpy(batch.data(), records.data(), batch.size());
+  }
+  return batch;
+}
+
+}  // namespace
+
+TEST(FingerprintTelemetryTest, RoundTripsBufferedRecords) {
+  TelemetryBuffer buffer;
+  base::TimeTicks start = base::TimeTicks() + base::Seconds(100);
+  buffer.Append(FingerprintStat::kCanvasOperationsSpoofed, 3, start);
+  buffer.Append(FingerprintStat::kWebGLParametersSpoofed, 0x1F01,
+                start + base::Milliseconds(250), 2);
+  EXPECT_EQ(buffer.size(), 2u);
+
+  std::vector<uint8_t> batch = buffer.TakeBatch();
+  EXPECT_TRUE(buffer.empty());
+  ASSERT_EQ(batch.size(), 2 * sizeof(TelemetryRecord));
+
+  std::vector<ParsedRecord> parsed;
+  EXPECT_EQ(Parse(batch, &parsed), 2);
+  ASSERT_EQ(parsed.size(), 2u);
+  EXPECT_EQ(parsed[0].stat, FingerprintStat::kCanvasOperationsSpoofed);
+  EXPECT_EQ(parsed[0].record.payload, 3u);
+  EXPECT_EQ(parsed[0].record.time_delta_ms, 0u);
+  EXPECT_EQ(parsed[1].stat, FingerprintStat::kWebGLParametersSpoofed);
+  EXPECT_EQ(parsed[1].record.payload, 0x1F01u);
+  EXPECT_EQ(parsed[1].record.detail, 2u);
+  EXPECT_EQ(parsed[1].record.time_delta_ms, 250u);
+}
+
+// Times restart with each batch.
+TEST(FingerprintTelemetryTest, TimesAreRelativeToBatchStart) {
+  TelemetryBuffer buffer;
+  base::TimeTicks start = base::TimeTicks() + base::Seconds(100);
+  buffer.Append(FingerprintStat::kCanvasOperationsSpoofed, 0, start);
+  buffer.TakeBatch();
+
+  buffer.Append(FingerprintStat::kCanvasOperationsSpoofed, 0,
+                start + base::Seconds(10));
+  buffer.Append(FingerprintStat::kCanvasOperationsSpoofed, 0,
+                start + base::Seconds(11));
+
+  std::vector<ParsedRecord> parsed;
+  EXPECT_EQ(Parse(buffer.TakeBatch(), &parsed), 2);
+  ASSERT_EQ(parsed.size(), 2u);
+  EXPECT_EQ(parsed[0].record.time_delta_ms, 0u);
+  EXPECT_EQ(parsed[1].record.time_delta_ms, 1000u);
+}
+
+TEST(FingerprintTelemetryTest, AppendReportsFlushThreshold) {
+  TelemetryBuffer buffer;
+  base::TimeTicks now = base::TimeTicks() + base::Seconds(1);
+  for (size_t i = 1; i < TelemetryBuffer::kFlushRecordCount; ++i) {
+    EXPECT_FALSE(buffer.Append(FingerprintStat::kCanvasOperationsSpoofed, 0, now));
+  }
+  EXPECT_TRUE(buffer.Append(FingerprintStat::kCanvasOperationsSpoofed, 0, now));
+}
+
+TEST(FingerprintTelemetryTest, EmptyBatchHasNoRecords) {
+  std::vector<ParsedRecord> parsed;
+  EXPECT_EQ(Parse({}, &parsed), 0);
+  EXPECT_TRUE(parsed.empty());
+
+  TelemetryBuffer buffer;
+  EXPECT_TRUE(buffer.TakeBatch().empty());
+}
+
+// A batch that is not a whole number of records is rejected outright.
+TEST(FingerprintTelemetryTest, RejectsTruncatedBatch) {
+  TelemetryRecord record;
+  record.stat = static_cast<uint8_t>(FingerprintStat::kCanvasOperationsSpoofed);
+  std::vector<uint8_t> batch = Serialize({record, record});
+
+  for (size_t trim = 1; trim < sizeof(TelemetryRecord); ++trim) {
+    SCOPED_TRACE(trim);
+    std::vector<uint8_t> truncated(batch.begin(), batch.end() - trim);
+    std::vector<ParsedRecord> parsed;
+    EXPECT_EQ(Parse(truncated, &parsed), -1);
+    EXPECT_TRUE(parsed.empty());
+  }
+}
+
+TEST(FingerprintTelemetryTest, SkipsUnknownStats) {
+  TelemetryRecord known;
+  known.stat = static_cast<uint8_t>(FingerprintStat::kAudioContextsProtected);
+  TelemetryRecord unknown;
+  unknown.stat = static_cast<uint8_t>(kFingerprintStatCount);
+  TelemetryRecord garbage;
+  garbage.stat = 0xFF;
+
+  std::vector<ParsedRecord> parsed;
+  EXPECT_EQ(Parse(Serialize({unknown, known, garbage}), &parsed), 1);
+  ASSERT_EQ(parsed.size(), 1u);
+  EXPECT_EQ(parsed[0].stat, FingerprintStat::kAudioContextsProtected);
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,129 @@
+// Latency of GetConfigForFrame with 1, 100 and 10k frames holding their own
+// config, alone and while other threads hammer the same lookup.
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/threading/simple_thread.h"
+#include "base/timer/elapsed_timer.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/test/test_renderer_host.h"
+#include "novebrowse/fingerprint_config.h"
+#include "novebrowse/fingerprint_manager.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace novebrowse {
+
+namespace {
+
+constexpr int kLookups = 1000000;
+constexpr int kWarmupLookups = 10000;
+
+constexpr int kFrameCounts[] = {1, 100, 10000};
+constexpr int kContendingThreads = 4;
+
+constexpr char kMetricPrefix[] = "FrameConfig.";
+constexpr char kMetricLookup[] = ".get_config_for_frame";
+constexpr char kMetricLookupContended[] = ".get_config_for_frame_contended";
+
+// Looks up the frames' configs in a loop until told to stop.
+class ContendingReader : public base::DelegateSimpleThread::Delegate {
+ public:
+  ContendingReader(const std::vector<content::RenderFrameHost*>& frames,
+                   const std::atomic<bool>& stop)
+      : frames_(frames), stop_(stop) {}
+  
+  void Run() override {
+    size_t index = 0;
+    while (!stop_.load(std::memory_order_relaxed)) {
+      FINGERPRINT_MANAGER()->GetConfigForFrame(frames_[index]);
+      index = (index + 1) % frames_.size();
+    }
+  }
+  
+ private:
+  const std::vector<content::RenderFrameHost*>& frames_;
+  const std::atomic<bool>& stop_;
+};
+
+}  // namespace
+
+class FrameConfigPerfTest : public content::RenderViewHostTestHarness {
+ protected:
+  void TearDown() override {
+    for (content::RenderFrameHost* frame : frames_) {
+      FINGERPRINT_MANAGER()->RemoveFrameConfig(frame);
+    }
+    frames_.clear();
+    content::RenderViewHostTestHarness::TearDown();
+  }
+  
+  // Adds child frames until |count| frames have a config of their own.
+  void GrowTo(int count) {
+    if (frames_.empty()) {
+      frames_.push_back(main_rfh());
+    }
+    content::RenderFrameHostTester* main_tester =
+        content::RenderFrameHostTester::For(main_rfh());
+    while (static_cast<int>(frames_.size()) < count) {
+      frames_.push_back(main_tester->AppendChild(
+          base::StringPrintf("child%zu", frames_.size())));
+    }
+    
+    FingerprintConfig config;
+    config.profile_name = "perftest";
+    for (content::RenderFrameHost* frame : frames_) {
+      FINGERPRINT_MANAGER()->SetConfigForFrame(frame, config);
+    }
+  }
+  
+  // Returns nanoseconds per lookup, cycling through all frames.
+  double TimeLookups() {
+    size_t index = 0;
+    for (int i = 0; i < kWarmupLookups; ++i) {
+      FINGERPRINT_MANAGER()->GetConfigForFrame(frames_[index]);
+      index = (index + 1) % frames_.size();
+    }
+    
+    base::ElapsedTimer timer;
+    for (int i = 0; i < kLookups; ++i) {
+      FINGERPRINT_MANAGER()->GetConfigForFrame(frames_[index]);
+      index = (index + 1) % frames_.size();
+    }
+    return timer.Elapsed().InNanosecondsF() / kLookups;
+  }
+  
+  double TimeContendedLookups() {
+    std::atomic<bool> stop{false};
+    ContendingReader reader(frames_, stop);
+    base::DelegateSimpleThreadPool pool("FrameConfigPerfTest", kContendingThreads);
+    pool.Start();
+    pool.AddWork(&reader, kContendingThreads);
+    
+    double lookup_ns = TimeLookups();
+    
+    stop.store(true, std::memory_order_relaxed);
+    pool.JoinAll();
+    return lookup_ns;
+  }
+  
+  std::vector<content::RenderFrameHost*> frames_;
+};
+
+TEST_F(FrameConfigPerfTest, GetConfigForFrame) {
+  for (int frame_count : kFrameCounts) {
+    GrowTo(frame_count);
+    
+    perf_test::PerfResultReporter reporter(
+        kMetricPrefix, base::StringPrintf("%d_frames", frame_count));
+    reporter.RegisterImportantMetric(kMetricLookup, "ns");
+    reporter.RegisterImportantMetric(kMetricLookupContended, "ns");
+    reporter.AddResult(kMetricLookup, TimeLookups());
+    reporter.AddResult(kMetricLookupContended, TimeContendedLookups());
+  }
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,100 @@
+// FrameConfigRegistry is copy-on-write: every change returns a new table
+// with the next generation and leaves tables readers still hold untouched.
+
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+
+#include "base/memory/scoped_refptr.h"
+#include "content/public/browser/global_routing_id.h"
+#include "novebrowse/fingerprint_config.h"
+#include "novebrowse/frame_config_registry.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace novebrowse {
+
+namespace {
+
+scoped_refptr<const FingerprintConfigSnapshot> MakeSnapshot(
+    const std::string& profile_name) {
+  FingerprintConfig config;
+  config.profile_name = profile_name;
+  return FingerprintConfigSnapshot::Create(std::move(config), 1);
+}
+
+}  // namespace
+
+TEST(FrameConfigRegistryTest, StartsEmpty) {
+  auto registry = base::MakeRefCounted<FrameConfigRegistry>();
+  EXPECT_EQ(registry->generation(), 1u);
+  EXPECT_EQ(registry->size(), 0u);
+  EXPECT_FALSE(registry->Find(content::GlobalRenderFrameHostId(1, 1)));
+}
+
+TEST(FrameConfigRegistryTest, SetReturnsNewTable) {
+  const content::GlobalRenderFrameHostId frame(1, 2);
+  auto empty = base::MakeRefCounted<FrameConfigRegistry>();
+  scoped_refptr<const FingerprintConfigSnapshot> config = MakeSnapshot("first");
+
+  scoped_refptr<const FrameConfigRegistry> registry = empty->Set(frame, config);
+  ASSERT_TRUE(registry);
+  EXPECT_EQ(registry->generation(), 2u);
+  EXPECT_EQ(registry->size(), 1u);
+  EXPECT_EQ(registry->Find(frame), config);
+
+  // The old table is unchanged.
+  EXPECT_EQ(empty->size(), 0u);
+  EXPECT_FALSE(empty->Find(frame));
+}
+
+// Frames are keyed by process and routing id together.
+TEST(FrameConfigRegistryTest, KeysOnProcessAndRoutingId) {
+  scoped_refptr<const FingerprintConfigSnapshot> first = MakeSnapshot("first");
+  scoped_refptr<const FingerprintConfigSnapshot> second = MakeSnapshot("second");
+
+  scoped_refptr<const FrameConfigRegistry> registry =
+      base::MakeRefCounted<FrameConfigRegistry>()
+          ->Set(content::GlobalRenderFrameHostId(1, 2), first)
+          ->Set(content::GlobalRenderFrameHostId(2, 1), second);
+  EXPECT_EQ(registry->size(), 2u);
+  EXPECT_EQ(registry->Find(content::GlobalRenderFrameHostId(1, 2)), first);
+  EXPECT_EQ(registry->Find(content::GlobalRenderFrameHostId(2, 1)), second);
+  EXPECT_FALSE(registry->Find(content::GlobalRenderFrameHostId(1, 1)));
+  EXPECT_FALSE(registry->Find(content::GlobalRenderFrameHostId(2, 2)));
+}
+
+TEST(FrameConfigRegistryTest, SetReplacesExistingEntry) {
+  const content::GlobalRenderFrameHostId frame(1, 2);
+  scoped_refptr<const FingerprintConfigSnapshot> second = MakeSnapshot("second");
+
+  scoped_refptr<const FrameConfigRegistry> registry =
+      base::MakeRefCounted<FrameConfigRegistry>()
+          ->Set(frame, MakeSnapshot("first"))
+          ->Set(frame, second);
+  EXPECT_EQ(registry->generation(), 3u);
+  EXPECT_EQ(registry->size(), 1u);
+  EXPECT_EQ(registry->Find(frame), second);
+}
+
+TEST(FrameConfigRegistryTest, Remove) {
+  const content::GlobalRenderFrameHostId frame(1, 2);
+  const content::GlobalRenderFrameHostId other_frame(1, 3);
+  scoped_refptr<const FrameConfigRegistry> registry =
+      base::MakeRefCounted<FrameConfigRegistry>()
+          ->Set(frame, MakeSnapshot("first"))
+          ->Set(other_frame, MakeSnapshot("second"));
+
+  scoped_refptr<const FrameConfigRegistry> removed = registry->Remove(frame);
+  ASSERT_TRUE(removed);
+  EXPECT_EQ(removed->generation(), registry->generation() + 1);
+  EXPECT_EQ(removed->size(), 1u);
+  EXPECT_FALSE(removed->Find(frame));
+  EXPECT_TRUE(removed->Find(other_frame));
+  EXPECT_TRUE(registry->Find(frame));
+
+  // Removing a missing frame does not publish a new table.
+  EXPECT_FALSE(removed->Remove(frame));
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,124 @@
+// Per-call cost of spoofed surfaces with the JS injection layer versus
+// native binding hooks only (anti_detection.mode = "js" / "native").
+
+#include <string>
+
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "novebrowse/blink_fingerprint_manager.h"
+#include "novebrowse/fingerprint_config.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/blink/renderer/core/frame/local_dom_window.h"
+#include "third_party/blink/renderer/core/script/classic_script.h"
+#include "third_party/blink/renderer/core/testing/page_test_base.h"
+#include "third_party/blink/renderer/platform/weborigin/kurl.h"
+
+namespace novebrowse {
+
+namespace {
+
+constexpr int kIterations = 200000;
+constexpr int kWarmupIterations = 10000;
+
+// Documents injected into by the per-frame test.
+constexpr int kFrameIterations = 200;
+
+constexpr char kMetricPrefix[] = "InjectionMode.";
+constexpr char kMetricNavigatorUserAgent[] = ".navigator_user_agent";
+constexpr char kMetricNavigatorPlatform[] = ".navigator_platform";
+constexpr char kMetricMeasureText[] = ".canvas_measure_text";
+constexpr char kMetricInjection[] = ".bundle_injection";
+constexpr char kMetricInjectionPerFrame[] = ".bundle_injection_per_frame";
+
+class InjectionModePerfTest : public blink::PageTestBase {
+ protected:
+  void ApplyMode(mojom::SpoofingMode mode) {
+    config_.navigator.user_agent =
+        "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36";
+    config_.navigator.platform = "Win32";
+    config_.anti_detection.mode = mode;
+    
+    BlinkFingerprintManager::FromFrame(&GetFrame())->UpdateConfig(config_);
+    
+    base::ElapsedTimer timer;
+    JSInjectionManager::InjectProtectionBundle(&GetFrame(), config_);
+    injection_time_ = timer.Elapsed();
+  }
+  
+  // Runs |body| in a tight loop and returns nanoseconds per iteration.
+  double TimeLoop(const char* setup, const char* body) {
+    RunScript(base::StringPrintf("%s; for (let i = 0; i < %d; ++i) { %s; }",
+                                 setup, kWarmupIterations, body));
+    
+    base::ElapsedTimer timer;
+    RunScript(base::StringPrintf("%s; for (let i = 0; i < %d; ++i) { %s; }",
+                                 setup, kIterations, body));
+    return timer.Elapsed().InNanosecondsF() / kIterations;
+  }
+  
+  void RunScript(const std::string& source) {
+    blink::ClassicScript::CreateUnspecifiedScript(WTF::String::FromUTF8(source))
+        ->RunScript(GetFrame().DomWindow());
+  }
+  
+  void RunAndReport(const std::string& story, mojom::SpoofingMode mode) {
+    ApplyMode(mode);
+    
+    perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+    reporter.RegisterImportantMetric(kMetricNavigatorUserAgent, "ns");
+    reporter.RegisterImportantMetric(kMetricNavigatorPlatform, "ns");
+    reporter.RegisterImportantMetric(kMetricMeasureText, "ns");
+    reporter.RegisterImportantMetric(kMetricInjection, "us");
+    
+    reporter.AddResult(kMetricNavigatorUserAgent,
+                       TimeLoop("let v", "v = navigator.userAgent"));
+    reporter.AddResult(kMetricNavigatorPlatform,
+                       TimeLoop("let v", "v = navigator.platform"));
+    reporter.AddResult(
+        kMetricMeasureText,
+        TimeLoop("const ctx = document.createElement('canvas').getContext('2d')",
+                 "ctx.measureText('fingerprint')"));
+    reporter.AddResult(kMetricInjection, injection_time_.InMicrosecondsF());
+  }
+  
+  // Injects into a fresh document |kFrameIterations| times and returns the
+  // mean in microseconds. The first injection compiles the bundle, so every
+  // timed one takes the cached path a newly committed frame sees.
+  double TimePerFrameInjection(mojom::SpoofingMode mode) {
+    ApplyMode(mode);
+    
+    base::TimeDelta total;
+    for (int i = 0; i < kFrameIterations; ++i) {
+      NavigateTo(blink::KURL("about:blank"));
+      BlinkFingerprintManager::FromFrame(&GetFrame())->UpdateConfig(config_);
+      
+      base::ElapsedTimer timer;
+      JSInjectionManager::InjectProtectionBundle(&GetFrame(), config_);
+      total += timer.Elapsed();
+    }
+    return total.InMicrosecondsF() / kFrameIterations;
+  }
+  
+  FingerprintConfig config_;
+  base::TimeDelta injection_time_;
+};
+
+}  // namespace
+
+TEST_F(InjectionModePerfTest, JavaScriptMode) {
+  RunAndReport("js", mojom::SpoofingMode::kJavaScript);
+}
+
+TEST_F(InjectionModePerfTest, NativeMode) {
+  RunAndReport("native", mojom::SpoofingMode::kNative);
+}
+
+TEST_F(InjectionModePerfTest, InjectionPerFrame) {
+  perf_test::PerfResultReporter reporter(kMetricPrefix, "per_frame");
+  reporter.RegisterImportantMetric(kMetricInjectionPerFrame, "us");
+  reporter.AddResult(kMetricInjectionPerFrame,
+                     TimePerFrameInjection(mojom::SpoofingMode::kJavaScript));
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,151 @@
+// ProfilePool builds the configs a profile switch picks up, so the build
+// rules and behavior pattern choice have to be stable, and misses must not
+// grow the pool past its capacity.
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "novebrowse/fingerprint_config.h"
+#include "novebrowse/profile_pool.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace novebrowse {
+
+namespace {
+
+scoped_refptr<const FingerprintConfigSnapshot> MakeSnapshot(
+    const std::string& profile_name) {
+  FingerprintConfig config;
+  config.profile_name = profile_name;
+  return FingerprintConfigSnapshot::Create(std::move(config), 1);
+}
+
+DeviceProfile MakeDeviceProfile() {
+  DeviceProfile profile;
+  profile.name = "windows_chrome";
+  profile.navigator.user_agent = "Mozilla/5.0 (Windows NT 10.0; Win64; x64)";
+  profile.navigator.platform = "Win32";
+  profile.navigator.languages = {"en-US", "en"};
+  profile.navigator.hardware_concurrency = 12;
+  profile.navigator.device_memory = 16;
+  profile.screen.width = 2560;
+  profile.screen.height = 1440;
+  profile.screen.device_pixel_ratio = 1.25;
+  profile.webgl.vendor = "Google Inc. (NVIDIA)";
+  profile.webgl.renderer = "ANGLE (NVIDIA GeForce RTX 3060)";
+  return profile;
+}
+
+}  // namespace
+
+TEST(ProfilePoolTest, BuildConfigTakesDeviceFields) {
+  FingerprintConfig base;
+  base.noise_seed = 42;
+  base.canvas.noise_level = 0.3;
+  base.webgl.enabled = false;
+
+  FingerprintConfig config =
+      ProfilePool::BuildConfig(base, MakeDeviceProfile(), "casual");
+  EXPECT_EQ(config.profile_name, "windows_chrome");
+  EXPECT_EQ(config.device_profile, "windows_chrome");
+  EXPECT_EQ(config.behavior_pattern, "casual");
+  EXPECT_EQ(config.navigator.platform, "Win32");
+  EXPECT_EQ(config.navigator.languages, std::vector<std::string>({"en-US", "en"}));
+  EXPECT_EQ(config.navigator.hardware_concurrency, 12);
+  EXPECT_EQ(config.screen.width, 2560);
+  EXPECT_EQ(config.screen.device_pixel_ratio, 1.25);
+  EXPECT_EQ(config.webgl.renderer, "ANGLE (NVIDIA GeForce RTX 3060)");
+
+  // Everything else, including the section switches, comes from the base.
+  EXPECT_EQ(config.noise_seed, 42u);
+  EXPECT_EQ(config.canvas.noise_level, 0.3);
+  EXPECT_FALSE(config.webgl.enabled);
+}
+
+// Strings a profile leaves empty keep the base values.
+TEST(ProfilePoolTest, BuildConfigKeepsBaseForMissingStrings) {
+  FingerprintConfig base;
+  base.behavior_pattern = "default";
+  base.navigator.platform = "MacIntel";
+  base.navigator.languages = {"fr-FR"};
+
+  DeviceProfile profile = MakeDeviceProfile();
+  profile.navigator.platform.clear();
+  profile.navigator.languages.clear();
+
+  FingerprintConfig config = ProfilePool::BuildConfig(base, profile, "");
+  EXPECT_EQ(config.behavior_pattern, "default");
+  EXPECT_EQ(config.navigator.platform, "MacIntel");
+  EXPECT_EQ(config.navigator.languages, std::vector<std::string>({"fr-FR"}));
+}
+
+TEST(ProfilePoolTest, PickBehaviorPatternIsStable) {
+  const std::vector<std::string> patterns = {"careful", "casual", "fast"};
+  const std::string fallback = "default";
+
+  const std::string& picked =
+      ProfilePool::PickBehaviorPattern("windows_chrome", patterns, fallback);
+  EXPECT_NE(std::find(patterns.begin(), patterns.end(), picked), patterns.end());
+  EXPECT_EQ(ProfilePool::PickBehaviorPattern("windows_chrome", patterns, fallback),
+            picked);
+
+  // A copy of the list (a reload) picks the same pattern.
+  const std::vector<std::string> reloaded = patterns;
+  EXPECT_EQ(ProfilePool::PickBehaviorPattern("windows_chrome", reloaded, fallback),
+            picked);
+}
+
+TEST(ProfilePoolTest, PickBehaviorPatternFallsBack) {
+  const std::string fallback = "default";
+  EXPECT_EQ(&ProfilePool::PickBehaviorPattern("windows_chrome", {}, fallback),
+            &fallback);
+}
+
+TEST(ProfilePoolTest, ReplaceAndFind) {
+  ProfilePool pool;
+  scoped_refptr<const FingerprintConfigSnapshot> windows =
+      MakeSnapshot("windows_chrome");
+  scoped_refptr<const FingerprintConfigSnapshot> mac = MakeSnapshot("mac_safari");
+
+  std::vector<ProfilePool::Entry> entries;
+  entries.emplace_back("windows_chrome", windows);
+  entries.emplace_back("mac_safari", mac);
+  pool.Replace(std::move(entries));
+  EXPECT_EQ(pool.size(), 2u);
+  EXPECT_EQ(pool.Find("windows_chrome"), windows);
+  EXPECT_EQ(pool.Find("mac_safari"), mac);
+  EXPECT_FALSE(pool.Find("linux_firefox"));
+  EXPECT_EQ(pool.GetAll().size(), 2u);
+
+  // Replace drops what is not in the new list.
+  std::vector<ProfilePool::Entry> reloaded;
+  reloaded.emplace_back("mac_safari", mac);
+  pool.Replace(std::move(reloaded));
+  EXPECT_EQ(pool.size(), 1u);
+  EXPECT_FALSE(pool.Find("windows_chrome"));
+}
+
+// Misses built on demand are only kept while the pool has room, but an
+// existing entry can always be refreshed.
+TEST(ProfilePoolTest, AddRespectsCapacity) {
+  ProfilePool pool;
+  EXPECT_EQ(pool.capacity(), 0u);
+  pool.Add("windows_chrome", MakeSnapshot("windows_chrome"));
+  EXPECT_EQ(pool.size(), 0u);
+
+  pool.set_capacity(1);
+  pool.Add("windows_chrome", MakeSnapshot("windows_chrome"));
+  pool.Add("mac_safari", MakeSnapshot("mac_safari"));
+  EXPECT_EQ(pool.size(), 1u);
+  EXPECT_TRUE(pool.Find("windows_chrome"));
+  EXPECT_FALSE(pool.Find("mac_safari"));
+
+  scoped_refptr<const FingerprintConfigSnapshot> refreshed =
+      MakeSnapshot("windows_chrome");
+  pool.Add("windows_chrome", refreshed);
+  EXPECT_EQ(pool.Find("windows_chrome"), refreshed);
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,223 @@
+// The compiled automaton must find what a naive substring search finds, in
+// one pass and regardless of how the body is split into chunks.
+
+#include <stdint.h>
+
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "novebrowse/script_pattern_matcher.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace novebrowse {
+
+namespace {
+
+const std::vector<std::string>& DetectionPatterns() {
+  static const std::vector<std::string> patterns = {
+      "navigator.webdriver", "__selenium", "puppeteer", "he", "she", "hers",
+  };
+  return patterns;
+}
+
+// Naive reference: the pattern whose first occurrence ends earliest, the
+// longest one when several end at the same byte.
+std::optional<std::string> FirstMatchNaive(const ScriptPatternMatcher& matcher,
+                                           std::string_view text) {
+  std::string lower(text);
+  for (char& c : lower) {
+    if (c >= 'A' && c <= 'Z') {
+      c = static_cast<char>(c - 'A' + 'a');
+    }
+  }
+
+  std::optional<std::string> best;
+  size_t best_end = std::string::npos;
+  for (size_t i = 0; i < matcher.pattern_count(); ++i) {
+    const std::string& pattern = matcher.pattern(i);
+    size_t pos = lower.find(pattern);
+    if (pos == std::string::npos) {
+      continue;
+    }
+    size_t end = pos + pattern.size();
+    if (end < best_end || (end == best_end && pattern.size() > best->size())) {
+      best_end = end;
+      best = pattern;
+    }
+  }
+  return best;
+}
+
+}  // namespace
+
+TEST(ScriptPatternMatcherTest, EmptyListCompilesToNothing) {
+  EXPECT_FALSE(ScriptPatternMatcher::Compile({}));
+  EXPECT_FALSE(ScriptPatternMatcher::Compile({"", ""}));
+  EXPECT_FALSE(ScriptPatternMatcher::GetOrCompile({}));
+  EXPECT_FALSE(ScriptPatternScan::Start(nullptr, "https://example.com/a.js"));
+}
+
+// Patterns are lowercased, deduplicated and sorted before compiling.
+TEST(ScriptPatternMatcherTest, NormalizesPatterns) {
+  scoped_refptr<const ScriptPatternMatcher> matcher =
+      ScriptPatternMatcher::Compile({"Puppeteer", "", "puppeteer", "Axe"});
+  ASSERT_TRUE(matcher);
+  ASSERT_EQ(matcher->pattern_count(), 2u);
+  EXPECT_EQ(matcher->pattern(0), "axe");
+  EXPECT_EQ(matcher->pattern(1), "puppeteer");
+
+  scoped_refptr<const ScriptPatternMatcher> same =
+      ScriptPatternMatcher::Compile({"axe", "PUPPETEER"});
+  EXPECT_EQ(matcher->fingerprint(), same->fingerprint());
+}
+
+// Equal lists share one instance.
+TEST(ScriptPatternMatcherTest, GetOrCompileShares) {
+  scoped_refptr<const ScriptPatternMatcher> first =
+      ScriptPatternMatcher::GetOrCompile({"puppeteer", "__selenium"});
+  scoped_refptr<const ScriptPatternMatcher> second =
+      ScriptPatternMatcher::GetOrCompile({"__SELENIUM", "Puppeteer"});
+  EXPECT_EQ(first, second);
+}
+
+TEST(ScriptPatternMatcherTest, FindIsCaseInsensitive) {
+  scoped_refptr<const ScriptPatternMatcher> matcher =
+      ScriptPatternMatcher::Compile(DetectionPatterns());
+  ASSERT_TRUE(matcher);
+
+  std::optional<size_t> match = matcher->Find("if (NAVIGATOR.WebDriver) {}");
+  ASSERT_TRUE(match);
+  EXPECT_EQ(matcher->pattern(*match), "navigator.webdriver");
+  EXPECT_FALSE(matcher->Find("console.log('nothing to see')"));
+  EXPECT_FALSE(matcher->Find(""));
+}
+
+// Overlapping patterns and matches reached only through fail links, checked
+// against the naive search.
+TEST(ScriptPatternMatcherTest, MatchesNaiveSearch) {
+  scoped_refptr<const ScriptPatternMatcher> matcher =
+      ScriptPatternMatcher::Compile(DetectionPatterns());
+  ASSERT_TRUE(matcher);
+
+  const char* const kTexts[] = {
+      "ushers",
+      "hers",
+      "ahishers",
+      "xshe",
+      "sh",
+      "h e r s",
+      "\xff\xfeshe",
+      "puppetee",
+      "window.__SELENIUM_unwrapped",
+      "navigator.web",
+      "navigator.webdriveR",
+      "",
+  };
+  for (const char* text : kTexts) {
+    SCOPED_TRACE(text);
+    std::optional<size_t> match = matcher->Find(text);
+    std::optional<std::string> expected = FirstMatchNaive(*matcher, text);
+    ASSERT_EQ(match.has_value(), expected.has_value());
+    if (match) {
+      EXPECT_EQ(matcher->pattern(*match), *expected);
+    }
+  }
+}
+
+// Splitting the body at every offset gives the same verdict as one chunk.
+TEST(ScriptPatternMatcherTest, StreamingScanMatchesAcrossChunks) {
+  scoped_refptr<const ScriptPatternMatcher> matcher =
+      ScriptPatternMatcher::Compile(DetectionPatterns());
+  ASSERT_TRUE(matcher);
+
+  const std::string body = "var d = window.navigator.webdriver;";
+  for (size_t split = 0; split <= body.size(); ++split) {
+    SCOPED_TRACE(split);
+    std::unique_ptr<ScriptPatternScan> scan =
+        ScriptPatternScan::Start(matcher, "https://example.com/app.js");
+    ASSERT_TRUE(scan);
+    scan->Feed(base::as_byte_span(std::string_view(body).substr(0, split)));
+    scan->Feed(base::as_byte_span(std::string_view(body).substr(split)));
+    EXPECT_TRUE(scan->Finish());
+    EXPECT_EQ(scan->matched_pattern(), "navigator.webdriver");
+  }
+}
+
+TEST(ScriptPatternMatcherTest, StreamingScanWithoutMatch) {
+  scoped_refptr<const ScriptPatternMatcher> matcher =
+      ScriptPatternMatcher::Compile({"puppeteer"});
+  std::unique_ptr<ScriptPatternScan> scan =
+      ScriptPatternScan::Start(matcher, "https://example.com/app.js");
+  scan->Feed(base::as_byte_span(std::string_view("var puppet")));
+  scan->Feed(base::as_byte_span(std::string_view("= 1; eer")));
+  EXPECT_FALSE(scan->decided());
+  EXPECT_FALSE(scan->Finish());
+  EXPECT_TRUE(scan->matched_pattern().empty());
+}
+
+// A match in the URL decides before any body arrives.
+TEST(ScriptPatternMatcherTest, UrlMatchDecidesEarly) {
+  scoped_refptr<const ScriptPatternMatcher> matcher =
+      ScriptPatternMatcher::Compile({"puppeteer"});
+  std::unique_ptr<ScriptPatternScan> scan =
+      ScriptPatternScan::Start(matcher, "https://example.com/puppeteer-check.js");
+  EXPECT_TRUE(scan->decided());
+  EXPECT_TRUE(scan->matched());
+  EXPECT_TRUE(scan->Finish());
+}
+
+// Decoded bodies are scanned as UTF-8, matching the raw byte stream.
+TEST(ScriptPatternMatcherTest, DecodedBodiesMatchUtf8) {
+  scoped_refptr<const ScriptPatternMatcher> matcher =
+      ScriptPatternMatcher::Compile({"caf\xc3\xa9"});
+
+  const uint8_t kLatin1[] = {'c', 'a', 'f', 0xE9};
+  std::unique_ptr<ScriptPatternScan> latin1 =
+      ScriptPatternScan::Start(matcher, "https://example.com/a.js");
+  latin1->FeedLatin1(kLatin1);
+  EXPECT_TRUE(latin1->Finish());
+
+  const char16_t kUtf16[] = u"le café";
+  std::unique_ptr<ScriptPatternScan> utf16 =
+      ScriptPatternScan::Start(matcher, "https://example.com/a.js");
+  utf16->FeedUTF16(base::span<const char16_t>(kUtf16, std::size(kUtf16) - 1));
+  EXPECT_TRUE(utf16->Finish());
+}
+
+// With an HTTP validator the verdict is cached and the next load of the
+// same resource skips the body.
+TEST(ScriptPatternMatcherTest, CachesVerdictByValidator) {
+  scoped_refptr<const ScriptPatternMatcher> matcher =
+      ScriptPatternMatcher::Compile({"puppeteer"});
+  const char kUrl[] = "https://example.com/app.js";
+
+  EXPECT_FALSE(matcher->ResourceKey(kUrl, "", ""));
+  ASSERT_TRUE(matcher->ResourceKey(kUrl, "\"v1\"", ""));
+  EXPECT_NE(matcher->ResourceKey(kUrl, "\"v1\"", ""),
+            matcher->ResourceKey(kUrl, "\"v2\"", ""));
+
+  std::unique_ptr<ScriptPatternScan> first = ScriptPatternScan::Start(matcher, kUrl);
+  first->OnResponse("\"v1\"", "");
+  EXPECT_FALSE(first->decided());
+  first->Feed(base::as_byte_span(std::string_view("puppeteer.launch()")));
+  EXPECT_TRUE(first->Finish());
+
+  std::unique_ptr<ScriptPatternScan> second = ScriptPatternScan::Start(matcher, kUrl);
+  second->OnResponse("\"v1\"", "");
+  EXPECT_TRUE(second->decided());
+  EXPECT_TRUE(second->Finish());
+
+  // A changed resource is scanned again.
+  std::unique_ptr<ScriptPatternScan> changed = ScriptPatternScan::Start(matcher, kUrl);
+  changed->OnResponse("\"v2\"", "");
+  EXPECT_FALSE(changed->decided());
+  changed->Feed(base::as_byte_span(std::string_view("console.log(1)")));
+  EXPECT_FALSE(changed->Finish());
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,122 @@
+// Seeds must be stable across processes and runs: the same (profile seed,
+// origin, surface) always derives the same value, and any change to one of
+// them gives an unrelated one.
+
+#include <stdint.h>
+
+#include <set>
+#include <string>
+#include <string_view>
+
+#include "novebrowse/fingerprint_config.h"
+#include "novebrowse/seed_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/blink/renderer/platform/weborigin/security_origin.h"
+
+namespace novebrowse {
+
+namespace {
+
+constexpr char kOrigin[] = "https://example.com";
+constexpr char kOtherOrigin[] = "https://example.org";
+
+FingerprintConfig MakeConfig(uint64_t noise_seed, const std::string& profile_name) {
+  FingerprintConfig config;
+  config.noise_seed = noise_seed;
+  config.profile_name = profile_name;
+  return config;
+}
+
+}  // namespace
+
+// Pinned so a change to the hash shows up as a test failure instead of as
+// every user's fingerprint silently changing.
+TEST(SeedServiceTest, KeyedHashIsPinned) {
+  EXPECT_EQ(SeedService::KeyedHash(0, ""), 0x6b3c89e238a4996eull);
+  EXPECT_EQ(SeedService::KeyedHash(42, kOrigin), 0x70f104ec42564536ull);
+
+  uint64_t profile_seed = SeedService::ProfileSeed(MakeConfig(42, "default"));
+  EXPECT_EQ(SeedService::DeriveSeed(profile_seed, kOrigin, SeedSurface::kCanvas),
+            0x14b486a3457c355bull);
+}
+
+// The length is part of the hash, so trailing zero bytes are not lost.
+TEST(SeedServiceTest, KeyedHashSeparatesInputs) {
+  EXPECT_NE(SeedService::KeyedHash(0, ""), SeedService::KeyedHash(1, ""));
+  EXPECT_NE(SeedService::KeyedHash(0, "a"), SeedService::KeyedHash(0, "b"));
+  EXPECT_NE(SeedService::KeyedHash(0, "ab"),
+            SeedService::KeyedHash(0, std::string_view("ab\0", 3)));
+  EXPECT_NE(SeedService::KeyedHash(0, "01234567"),
+            SeedService::KeyedHash(0, std::string_view("01234567\0", 9)));
+}
+
+TEST(SeedServiceTest, ProfileSeedDependsOnSeedAndName) {
+  uint64_t seed = SeedService::ProfileSeed(MakeConfig(42, "default"));
+  EXPECT_EQ(seed, SeedService::ProfileSeed(MakeConfig(42, "default")));
+  EXPECT_NE(seed, SeedService::ProfileSeed(MakeConfig(43, "default")));
+  EXPECT_NE(seed, SeedService::ProfileSeed(MakeConfig(42, "windows_chrome")));
+
+  // Fields outside the two inputs do not move the seed.
+  FingerprintConfig config = MakeConfig(42, "default");
+  config.canvas.noise_level = 0.5;
+  config.navigator.platform = "Linux x86_64";
+  EXPECT_EQ(seed, SeedService::ProfileSeed(config));
+}
+
+TEST(SeedServiceTest, DeriveSeedIsDeterministic) {
+  uint64_t profile_seed = SeedService::ProfileSeed(MakeConfig(42, "default"));
+  for (size_t i = 0; i < kSeedSurfaceCount; ++i) {
+    SeedSurface surface = static_cast<SeedSurface>(i);
+    EXPECT_EQ(SeedService::DeriveSeed(profile_seed, kOrigin, surface),
+              SeedService::DeriveSeed(profile_seed, kOrigin, surface));
+  }
+}
+
+// Surfaces of one origin, and one surface across origins, are independent.
+TEST(SeedServiceTest, DeriveSeedSeparatesSurfacesAndOrigins) {
+  uint64_t profile_seed = SeedService::ProfileSeed(MakeConfig(42, "default"));
+  std::set<uint64_t> seeds;
+  for (size_t i = 0; i < kSeedSurfaceCount; ++i) {
+    SeedSurface surface = static_cast<SeedSurface>(i);
+    seeds.insert(SeedService::DeriveSeed(profile_seed, kOrigin, surface));
+    seeds.insert(SeedService::DeriveSeed(profile_seed, kOtherOrigin, surface));
+    seeds.insert(SeedService::DeriveSeed(profile_seed + 1, kOrigin, surface));
+  }
+  EXPECT_EQ(seeds.size(), 3 * kSeedSurfaceCount);
+}
+
+// The per-frame cache returns what a one-off derivation would, and follows
+// origin and profile seed changes.
+TEST(SeedServiceTest, GetSeedMatchesDeriveSeed) {
+  uint64_t profile_seed = SeedService::ProfileSeed(MakeConfig(42, "default"));
+  scoped_refptr<const blink::SecurityOrigin> origin =
+      blink::SecurityOrigin::CreateFromString(kOrigin);
+  scoped_refptr<const blink::SecurityOrigin> other_origin =
+      blink::SecurityOrigin::CreateFromString(kOtherOrigin);
+  std::string origin_string = origin->ToString().Utf8();
+  std::string other_origin_string = other_origin->ToString().Utf8();
+
+  SeedService service;
+  for (size_t i = 0; i < kSeedSurfaceCount; ++i) {
+    SeedSurface surface = static_cast<SeedSurface>(i);
+    EXPECT_EQ(service.GetSeed(profile_seed, origin.get(), surface),
+              SeedService::DeriveSeed(profile_seed, origin_string, surface));
+  }
+
+  EXPECT_EQ(service.GetSeed(profile_seed, other_origin.get(), SeedSurface::kCanvas),
+            SeedService::DeriveSeed(profile_seed, other_origin_string,
+                                    SeedSurface::kCanvas));
+  EXPECT_EQ(service.GetSeed(profile_seed + 1, other_origin.get(),
+                            SeedSurface::kCanvas),
+            SeedService::DeriveSeed(profile_seed + 1, other_origin_string,
+                                    SeedSurface::kCanvas));
+}
+
+TEST(SeedServiceTest, Fold32MixesBothHalves) {
+  EXPECT_EQ(SeedService::Fold32(0), 0u);
+  EXPECT_EQ(SeedService::Fold32(0x0000000100000000ull), 1u);
+  EXPECT_EQ(SeedService::Fold32(0x0000000100000001ull), 0u);
+  EXPECT_EQ(SeedService::Fold32(0x12345678ull), 0x12345678u);
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,111 @@
+// SpoofRecords are shared by every frame with the same config hash and
+// kept after the last frame lets go, up to kRendererCachedConfigs records;
+// eviction must never drop a record a frame still holds.
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "novebrowse/fingerprint_config.h"
+#include "novebrowse/profile_pool.h"
+#include "novebrowse/seed_service.h"
+#include "novebrowse/spoof_record.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/blink/renderer/platform/testing/task_environment.h"
+
+namespace novebrowse {
+
+namespace {
+
+// The record cache is process-wide, so every test uses its own names.
+FingerprintConfig MakeConfig(const std::string& profile_name) {
+  FingerprintConfig config;
+  config.profile_name = profile_name;
+  config.noise_seed = 42;
+  config.navigator.user_agent = "Mozilla/5.0 (X11; Linux x86_64)";
+  return config;
+}
+
+}  // namespace
+
+class SpoofRecordTest : public testing::Test {
+ protected:
+  blink::test::TaskEnvironment task_environment_;
+};
+
+TEST_F(SpoofRecordTest, SharesRecordsByConfigHash) {
+  FingerprintConfig config = MakeConfig("shares");
+  scoped_refptr<const SpoofRecord> record = SpoofRecord::GetOrCreate(config);
+  ASSERT_TRUE(record);
+  EXPECT_EQ(SpoofRecord::GetOrCreate(MakeConfig("shares")), record);
+  EXPECT_EQ(SpoofRecord::Find(config.GetStructuralHash()), record);
+
+  FingerprintConfig other = MakeConfig("shares");
+  other.canvas.noise_level += 0.1;
+  EXPECT_NE(SpoofRecord::GetOrCreate(other), record);
+}
+
+TEST_F(SpoofRecordTest, FindMissesUnknownHash) {
+  EXPECT_FALSE(SpoofRecord::Find(MakeConfig("never_created").GetStructuralHash()));
+}
+
+TEST_F(SpoofRecordTest, PrecomputesFromConfig) {
+  FingerprintConfig config = MakeConfig("precomputes");
+  scoped_refptr<const SpoofRecord> record = SpoofRecord::GetOrCreate(config);
+  EXPECT_EQ(record->profile_seed, SeedService::ProfileSeed(config));
+  EXPECT_EQ(record->user_agent, "Mozilla/5.0 (X11; Linux x86_64)");
+  EXPECT_TRUE(record->protect_canvas);
+
+  // Disabled sections leave their values empty.
+  config.profile_name = "precomputes_disabled";
+  config.navigator.enabled = false;
+  config.canvas.enabled = false;
+  scoped_refptr<const SpoofRecord> disabled = SpoofRecord::GetOrCreate(config);
+  EXPECT_TRUE(disabled->user_agent.IsNull());
+  EXPECT_FALSE(disabled->protect_canvas);
+}
+
+// Filling the cache evicts the least recently used record no one holds,
+// and skips the ones still in use.
+TEST_F(SpoofRecordTest, EvictsUnheldRecordsFirst) {
+  scoped_refptr<const SpoofRecord> held =
+      SpoofRecord::GetOrCreate(MakeConfig("evicts_held"));
+  const uint64_t held_hash = MakeConfig("evicts_held").GetStructuralHash();
+  const uint64_t oldest_hash = MakeConfig("evicts_oldest").GetStructuralHash();
+  SpoofRecord::GetOrCreate(MakeConfig("evicts_oldest"));
+
+  std::vector<uint64_t> hashes;
+  for (size_t i = 0; i < ProfilePool::kRendererCachedConfigs; ++i) {
+    FingerprintConfig config =
+        MakeConfig(base::StringPrintf("evicts_filler_%zu", i));
+    hashes.push_back(config.GetStructuralHash());
+    SpoofRecord::GetOrCreate(config);
+  }
+
+  EXPECT_EQ(SpoofRecord::Find(held_hash), held);
+  EXPECT_FALSE(SpoofRecord::Find(oldest_hash));
+  EXPECT_TRUE(SpoofRecord::Find(hashes.back()));
+}
+
+// A lookup counts as a use, so a record just found is not evicted next.
+TEST_F(SpoofRecordTest, FindRefreshesRecord) {
+  const uint64_t refreshed_hash = MakeConfig("refreshes").GetStructuralHash();
+  SpoofRecord::GetOrCreate(MakeConfig("refreshes"));
+  const uint64_t oldest_hash = MakeConfig("refreshes_oldest").GetStructuralHash();
+  SpoofRecord::GetOrCreate(MakeConfig("refreshes_oldest"));
+
+  for (size_t i = 0; i + 2 < ProfilePool::kRendererCachedConfigs; ++i) {
+    SpoofRecord::GetOrCreate(
+        MakeConfig(base::StringPrintf("refreshes_filler_%zu", i)));
+  }
+  ASSERT_TRUE(SpoofRecord::Find(refreshed_hash));
+
+  // One more insert past the limit evicts the oldest unheld record.
+  SpoofRecord::GetOrCreate(MakeConfig("refreshes_last"));
+  EXPECT_TRUE(SpoofRecord::Find(refreshed_hash));
+  EXPECT_FALSE(SpoofRecord::Find(oldest_hash));
+}
+
+}  // namespace novebrowse
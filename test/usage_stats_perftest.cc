@@ -0,0 +1,110 @@
+// Throughput of canvas and WebGL operation recording when several threads
+// record into the same stats object, as workers sharing a transferred
+// OffscreenCanvas do. Each call does what RecordCanvasOperation and
+// RecordWebGLOperation do once the host is resolved: a clock read and the
+// stats update.
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "base/memory/raw_ptr.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "novebrowse/canvas_usage_stats.h"
+#include "novebrowse/webgl_usage_stats.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/khronos/GLES2/gl2.h"
+
+namespace novebrowse {
+
+namespace {
+
+constexpr int kOperationsPerThread = 1000000;
+constexpr int kThreadCounts[] = {1, 4, 8};
+
+constexpr char kMetricPrefixCanvas[] = "CanvasUsageStats.";
+constexpr char kMetricPrefixWebGL[] = "WebGLUsageStats.";
+constexpr char kMetricThroughput[] = ".record_throughput";
+constexpr char kMetricLatency[] = ".record_latency";
+
+int64_t NowMicroseconds() {
+  return (base::TimeTicks::Now() - base::TimeTicks()).InMicroseconds();
+}
+
+class CanvasRecorder : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit CanvasRecorder(CanvasUsageStats* stats) : stats_(stats) {}
+  
+  void Run() override {
+    for (int i = 0; i < kOperationsPerThread; ++i) {
+      stats_->Record(i % 8 == 0 ? CanvasOperation::kGetImageData
+                                : CanvasOperation::kFillRect,
+                     NowMicroseconds());
+    }
+  }
+  
+ private:
+  const raw_ptr<CanvasUsageStats> stats_;
+};
+
+class WebGLRecorder : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit WebGLRecorder(WebGLUsageStats* stats) : stats_(stats) {}
+  
+  void Run() override {
+    for (int i = 0; i < kOperationsPerThread; ++i) {
+      stats_->Record(WebGLOperation::kGetParameter,
+                     i % 2 == 0 ? GL_RENDERER : GL_VENDOR, NowMicroseconds());
+    }
+  }
+  
+ private:
+  const raw_ptr<WebGLUsageStats> stats_;
+};
+
+// Runs |delegate| on |thread_count| threads at once and reports aggregate
+// operations per second and the mean wall time per recorded operation on
+// one thread.
+void RunAndReport(const char* metric_prefix,
+                  int thread_count,
+                  base::DelegateSimpleThread::Delegate* delegate) {
+  base::DelegateSimpleThreadPool pool("UsageStatsPerfTest", thread_count);
+  base::ElapsedTimer timer;
+  pool.Start();
+  pool.AddWork(delegate, thread_count);
+  pool.JoinAll();
+  double seconds = timer.Elapsed().InSecondsF();
+  
+  double operations = static_cast<double>(kOperationsPerThread) * thread_count;
+  perf_test::PerfResultReporter reporter(
+      metric_prefix, base::StringPrintf("%d_threads", thread_count));
+  reporter.RegisterImportantMetric(kMetricThroughput, "ops/s");
+  reporter.RegisterImportantMetric(kMetricLatency, "ns");
+  reporter.AddResult(kMetricThroughput, operations / seconds);
+  reporter.AddResult(kMetricLatency, seconds * 1e9 / kOperationsPerThread);
+}
+
+}  // namespace
+
+TEST(UsageStatsPerfTest, RecordCanvasOperation) {
+  for (int thread_count : kThreadCounts) {
+    auto stats = std::make_unique<CanvasUsageStats>();
+    CanvasRecorder recorder(stats.get());
+    RunAndReport(kMetricPrefixCanvas, thread_count, &recorder);
+  }
+}
+
+TEST(UsageStatsPerfTest, RecordWebGLOperation) {
+  for (int thread_count : kThreadCounts) {
+    auto stats = std::make_unique<WebGLUsageStats>();
+    WebGLRecorder recorder(stats.get());
+    RunAndReport(kMetricPrefixWebGL, thread_count, &recorder);
+  }
+}
+
+}  // namespace novebrowse
@@ -0,0 +1,143 @@
+// Cost of WebGL buffer noise at several upload sizes, and per-call latency
+// of a spoofed getParameter.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/timer/elapsed_timer.h"
+#include "novebrowse/blink_fingerprint_manager.h"
+#include "novebrowse/fingerprint_config.h"
+#include "novebrowse/webgl_fingerprint_protection.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/blink/renderer/core/html/canvas/canvas_context_creation_attributes_core.h"
+#include "third_party/blink/renderer/core/html/canvas/html_canvas_element.h"
+#include "third_party/blink/renderer/core/testing/page_test_base.h"
+#include "third_party/blink/renderer/platform/bindings/script_state.h"
+#include "third_party/blink/renderer/platform/wtf/casting.h"
+#include "v8/include/v8.h"
+
+namespace novebrowse {
+
+namespace {
+
+// Each buffer size runs for about this many bytes in total.
+constexpr size_t kByteBudget = size_t{1} << 30;
+constexpr int kMinIterations = 8;
+
+constexpr int kParameterIterations = 200000;
+constexpr int kParameterWarmupIterations = 10000;
+
+constexpr uint32_t kSeed = 0x5eed;
+
+constexpr char kMetricPrefix[] = "WebGLFingerprint.";
+constexpr char kMetricApplyBufferNoise[] = ".apply_buffer_noise";
+constexpr char kMetricThroughput[] = ".throughput";
+constexpr char kMetricGetSpoofedParameter[] = ".get_spoofed_parameter";
+constexpr char kMetricGetParameterPassThrough[] = ".get_parameter_pass_through";
+
+struct BufferCase {
+  const char* story;
+  WebGLElementType element_type;
+  size_t bytes;
+};
+
+// 16 MiB is past buffer_parallel_min_bytes and takes the chunked path.
+constexpr BufferCase kBufferCases[] = {
+    {"f32_64k", WebGLElementType::kFloat32, 64 * 1024},
+    {"f32_1m", WebGLElementType::kFloat32, 1024 * 1024},
+    {"f32_16m", WebGLElementType::kFloat32, 16 * 1024 * 1024},
+    {"u8_64k", WebGLElementType::kUint8, 64 * 1024},
+    {"u8_1m", WebGLElementType::kUint8, 1024 * 1024},
+    {"u8_16m", WebGLElementType::kUint8, 16 * 1024 * 1024},
+};
+
+}  // namespace
+
+class WebGLFingerprintPerfTest : public blink::PageTestBase {
+ protected:
+  void SetUp() override {
+    blink::PageTestBase::SetUp();
+    BlinkFingerprintManager::FromFrame(&GetFrame())->UpdateConfig(config_);
+  }
+  
+  // Returns the canvas' WebGL context, or null when the test platform has
+  // no GPU context provider.
+  blink::WebGLRenderingContextBase* CreateContext() {
+    auto* canvas = MakeGarbageCollected<blink::HTMLCanvasElement>(GetDocument());
+    GetDocument().body()->AppendChild(canvas);
+    blink::CanvasContextCreationAttributesCore attributes;
+    return blink::DynamicTo<blink::WebGLRenderingContextBase>(
+        canvas->GetCanvasRenderingContext("webgl", attributes));
+  }
+  
+  // Returns nanoseconds per GetSpoofedParameter call.
+  double TimeGetSpoofedParameter(blink::WebGLRenderingContextBase* context,
+                                 GLenum pname) {
+    blink::ScriptState* script_state = context->GetScriptState();
+    blink::ScriptState::Scope scope(script_state);
+    v8::Isolate* isolate = script_state->GetIsolate();
+    
+    for (int i = 0; i < kParameterWarmupIterations; ++i) {
+      v8::HandleScope handles(isolate);
+      WebGLFingerprintProtection::GetSpoofedParameter(pname, context);
+    }
+    
+    base::ElapsedTimer timer;
+    for (int i = 0; i < kParameterIterations; ++i) {
+      v8::HandleScope handles(isolate);
+      WebGLFingerprintProtection::GetSpoofedParameter(pname, context);
+    }
+    return timer.Elapsed().InNanosecondsF() / kParameterIterations;
+  }
+  
+  FingerprintConfig config_;
+};
+
+TEST_F(WebGLFingerprintPerfTest, ApplyBufferNoise) {
+  for (const BufferCase& buffer_case : kBufferCases) {
+    std::vector<uint8_t> buffer(buffer_case.bytes, 0x40);
+    WebGLFingerprintProtection::ApplyBufferNoise(
+        buffer.data(), buffer.size(), buffer_case.element_type, kSeed,
+        config_.webgl);
+    
+    int iterations = static_cast<int>(
+        std::max<size_t>(kMinIterations, kByteBudget / buffer_case.bytes));
+    base::ElapsedTimer timer;
+    for (int i = 0; i < iterations; ++i) {
+      WebGLFingerprintProtection::ApplyBufferNoise(
+          buffer.data(), buffer.size(), buffer_case.element_type, kSeed,
+          config_.webgl);
+    }
+    double call_us = timer.Elapsed().InMicrosecondsF() / iterations;
+    double megabytes = static_cast<double>(buffer_case.bytes) / (1024.0 * 1024.0);
+    
+    perf_test::PerfResultReporter reporter(kMetricPrefix, buffer_case.story);
+    reporter.RegisterImportantMetric(kMetricApplyBufferNoise, "us");
+    reporter.RegisterImportantMetric(kMetricThroughput, "MB/s");
+    reporter.AddResult(kMetricApplyBufferNoise, call_us);
+    reporter.AddResult(kMetricThroughput, megabytes / (call_us / 1e6));
+  }
+}
+
+TEST_F(WebGLFingerprintPerfTest, GetSpoofedParameter) {
+  blink::WebGLRenderingContextBase* context = CreateContext();
+  if (!context) {
+    GTEST_SKIP() << "No WebGL context on this platform";
+  }
+  
+  perf_test::PerfResultReporter reporter(kMetricPrefix, "webgl1");
+  reporter.RegisterImportantMetric(kMetricGetSpoofedParameter, "ns");
+  reporter.RegisterImportantMetric(kMetricGetParameterPassThrough, "ns");
+  // A spoofed string, and a parameter the table does not cover, which only
+  // pays for the lookup and the usage record.
+  reporter.AddResult(kMetricGetSpoofedParameter,
+                     TimeGetSpoofedParameter(context, GL_RENDERER));
+  reporter.AddResult(kMetricGetParameterPassThrough,
+                     TimeGetSpoofedParameter(context, GL_BLEND));
+}
+
+}  // namespace novebrowse